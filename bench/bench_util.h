@@ -0,0 +1,551 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "message_frame_memory.h"
+#include "opcode_table.h"
+#include "storage_memory.h"
+#include "tracer_callback.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <dlfcn.h>
+#endif
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace besu {
+namespace evm {
+
+/**
+ * Shared pieces of the native benchmarks (bench/).
+ *
+ * - Assembler: builds bytecode with labels, so workloads stay readable
+ * - Engine: one interpreter build (dispatch variant), loaded with dlopen
+ * - BenchFrame: a checked or guard-page frame that can be reset between runs
+ * - PerfCounters: user-space instructions and cycles via perf_event_open
+ * - CacheCounters: the calling thread's L1D and last-level cache misses
+ */
+namespace bench {
+
+// ===== BYTECODE ASSEMBLER =====
+
+class Assembler {
+public:
+    Assembler& op(uint8_t opcode) {
+        code_.push_back(opcode);
+        return *this;
+    }
+
+    /** Shortest PUSHn for value (PUSH1 for zero, so the code runs before Shanghai). */
+    Assembler& push(uint64_t value) {
+        uint8_t bytes[8];
+        int n = 0;
+        do {
+            bytes[n++] = static_cast<uint8_t>(value);
+            value >>= 8;
+        } while (value != 0);
+        code_.push_back(static_cast<uint8_t>(opcodes::PUSH1 + n - 1));
+        for (int i = n - 1; i >= 0; i--) code_.push_back(bytes[i]);
+        return *this;
+    }
+
+    /** PUSHn of n big-endian bytes (1 <= n <= 32). */
+    Assembler& push_bytes(const uint8_t* bytes, size_t n) {
+        code_.push_back(static_cast<uint8_t>(opcodes::PUSH1 + n - 1));
+        for (size_t i = 0; i < n; i++) code_.push_back(bytes[i]);
+        return *this;
+    }
+
+    /** DUPn, 1 <= n <= 16. */
+    Assembler& dup(int n) { return op(static_cast<uint8_t>(opcodes::DUP1 + n - 1)); }
+
+    /** SWAPn, 1 <= n <= 16. */
+    Assembler& swap(int n) { return op(static_cast<uint8_t>(opcodes::SWAP1 + n - 1)); }
+
+    /** Place a JUMPDEST named name. */
+    Assembler& label(const std::string& name) {
+        labels_[name] = static_cast<uint32_t>(code_.size());
+        return op(opcodes::JUMPDEST);
+    }
+
+    /** PUSH2 of a label's position, resolved by build(). */
+    Assembler& push_label(const std::string& name) {
+        code_.push_back(static_cast<uint8_t>(opcodes::PUSH1 + 1));
+        fixups_.push_back({static_cast<uint32_t>(code_.size()), name});
+        code_.push_back(0);
+        code_.push_back(0);
+        return *this;
+    }
+
+    Assembler& jump(const std::string& name) { return push_label(name).op(opcodes::JUMP); }
+
+    /** Jump to name if the top of the stack (popped) is non-zero. */
+    Assembler& jumpi(const std::string& name) { return push_label(name).op(opcodes::JUMPI); }
+
+    /** Bytecode with all label references filled in. Unknown labels resolve to 0. */
+    std::vector<uint8_t> build() const {
+        std::vector<uint8_t> code = code_;
+        for (const Fixup& fixup : fixups_) {
+            auto it = labels_.find(fixup.label);
+            uint32_t target = it == labels_.end() ? 0 : it->second;
+            code[fixup.at] = static_cast<uint8_t>(target >> 8);
+            code[fixup.at + 1] = static_cast<uint8_t>(target);
+        }
+        return code;
+    }
+
+private:
+    struct Fixup {
+        uint32_t at;
+        std::string label;
+    };
+
+    std::vector<uint8_t> code_;
+    std::vector<Fixup> fixups_;
+    std::map<std::string, uint32_t> labels_;
+};
+
+// ===== INTERPRETER BUILDS =====
+
+typedef void (*ExecuteFn)(MessageFrameMemory*, TracerCallbacks*);
+typedef const char* (*DispatchPolicyFn)(void);
+typedef MessageFrameMemory* (*GuardedCreateFn)(uint64_t, uint64_t);
+typedef void (*GuardedFrameFn)(MessageFrameMemory*);
+
+/**
+ * One build of the interpreter library. Every dispatch variant exports the same
+ * C symbols, so each is loaded into its own dlopen handle.
+ */
+struct Engine {
+    std::string name;                      // Dispatch policy reported by the build
+    std::string path;
+    void* handle = nullptr;
+    ExecuteFn execute = nullptr;
+    GuardedCreateFn guarded_create = nullptr;
+    GuardedFrameFn guarded_reset = nullptr;
+    GuardedFrameFn guarded_destroy = nullptr;
+
+    bool hasGuardedFrames() const { return guarded_create != nullptr; }
+};
+
+/**
+ * Load an interpreter build.
+ * @return false (with error set) if the library or execute_message is missing
+ */
+inline bool load_engine(const std::string& path, Engine& engine, std::string& error) {
+#if defined(__unix__) || defined(__APPLE__)
+    void* handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        error = dlerror();
+        return false;
+    }
+    engine.path = path;
+    engine.handle = handle;
+    engine.execute = reinterpret_cast<ExecuteFn>(dlsym(handle, "execute_message"));
+    if (!engine.execute) {
+        error = path + ": no execute_message";
+        dlclose(handle);
+        return false;
+    }
+    auto policy = reinterpret_cast<DispatchPolicyFn>(dlsym(handle, "besu_dispatch_policy"));
+    engine.name = policy ? policy() : "unknown";
+    engine.guarded_create = reinterpret_cast<GuardedCreateFn>(dlsym(handle, "besu_guarded_frame_create"));
+    engine.guarded_reset = reinterpret_cast<GuardedFrameFn>(dlsym(handle, "besu_guarded_frame_reset"));
+    engine.guarded_destroy = reinterpret_cast<GuardedFrameFn>(dlsym(handle, "besu_guarded_frame_destroy"));
+    return true;
+#else
+    (void)path;
+    (void)engine;
+    error = "dynamic loading not supported on this platform";
+    return false;
+#endif
+}
+
+/**
+ * Load the dispatch variants built next to the benchmark (BESU_BENCH_VARIANT_DIR),
+ * skipping any that are missing or duplicate another variant's policy.
+ */
+inline std::vector<Engine> load_variants(const std::string& dir) {
+#if defined(__APPLE__)
+    const char* suffix = ".dylib";
+#else
+    const char* suffix = ".so";
+#endif
+    std::vector<Engine> engines;
+    for (const char* variant : {"table", "switch", "goto", "tailcall"}) {
+        Engine engine;
+        std::string error;
+        std::string path = dir + "/libbesu_native_evm_" + variant + suffix;
+        if (!load_engine(path, engine, error)) continue;
+        bool duplicate = std::any_of(engines.begin(), engines.end(),
+                                     [&](const Engine& e) { return e.name == engine.name; });
+        if (!duplicate) engines.push_back(engine);
+    }
+    return engines;
+}
+
+/**
+ * Engines for a benchmark run: the libraries in libs, or the variants in dir when
+ * libs is empty, keeping only the dispatch policy named variant if it is set.
+ * @return empty (with error set) if nothing could be loaded
+ */
+inline std::vector<Engine> load_engines(const std::vector<std::string>& libs, const std::string& dir,
+                                        const std::string& variant, std::string& error) {
+    std::vector<Engine> engines;
+    if (libs.empty()) {
+        engines = load_variants(dir);
+    } else {
+        for (const std::string& lib : libs) {
+            Engine engine;
+            if (!load_engine(lib, engine, error)) return {};
+            engines.push_back(engine);
+        }
+    }
+    if (!variant.empty()) {
+        engines.erase(std::remove_if(engines.begin(), engines.end(),
+                                     [&](const Engine& e) { return e.name != variant; }),
+                      engines.end());
+    }
+    if (engines.empty()) error = "No interpreter variants found";
+    return engines;
+}
+
+// ===== FRAMES =====
+
+/** A storage slot preloaded into the frame before every run. */
+struct StorageInit {
+    uint8_t key[32];
+    uint8_t value[32];
+};
+
+/** Bytecode plus the state it runs against. */
+struct Program {
+    std::vector<uint8_t> code;
+    std::vector<StorageInit> storage;
+    uint8_t contract[20];
+    uint32_t max_storage_slots = 256;
+    int64_t gas = 1000000000;
+    Revision revision = LATEST_REVISION;
+};
+
+/**
+ * Frame for repeated runs of one program. reset() restores the initial state
+ * outside the timed region, so every run does identical work.
+ */
+class BenchFrame {
+public:
+    static constexpr uint64_t MEMORY_CAPACITY = 1024 * 1024;  // The checked interpreter's limit
+
+    /**
+     * @param guarded use a guard-page frame from the engine (stack and memory
+     *        checks compile away); falls back to false if unsupported
+     */
+    BenchFrame(const Engine& engine, const Program& program, bool guarded)
+        : engine_(engine), program_(program) {
+        const uint64_t code_bytes = align(program.code.size());
+        const uint64_t storage_bytes = align(program.max_storage_slots * sizeof(StorageEntry));
+        const uint64_t tail = code_bytes + storage_bytes;
+
+        if (guarded && engine.hasGuardedFrames()) {
+            frame_ = engine.guarded_create(MEMORY_CAPACITY, tail);
+        }
+        if (frame_) {
+            guarded_ = true;
+        } else {
+            const uint64_t stack_off = 4096;
+            const uint64_t memory_off = stack_off + MAX_STACK_SIZE * STACK_ITEM_SIZE;
+            const uint64_t tail_off = memory_off + MEMORY_CAPACITY;
+            buffer_size_ = tail_off + tail;
+            frame_ = static_cast<MessageFrameMemory*>(std::aligned_alloc(4096, align(buffer_size_, 4096)));
+            std::memset(frame_, 0, buffer_size_);
+            frame_->stack_ptr = stack_off;
+            frame_->memory_ptr = memory_off;
+            frame_->code_ptr = tail_off;
+        }
+
+        frame_->storage_ptr = frame_->code_ptr + code_bytes;
+        frame_->max_storage_slots = program.max_storage_slots;
+        frame_->code_size = static_cast<uint32_t>(program.code.size());
+        std::memcpy(base() + frame_->code_ptr, program.code.data(), program.code.size());
+        std::memcpy(frame_->contract, program.contract, 20);
+        std::memcpy(frame_->recipient, program.contract, 20);
+        frame_->revision = static_cast<uint8_t>(program.revision);
+        reset();
+    }
+
+    ~BenchFrame() {
+        if (guarded_) {
+            engine_.guarded_destroy(frame_);
+        } else {
+            std::free(frame_);
+        }
+    }
+
+    BenchFrame(const BenchFrame&) = delete;
+    BenchFrame& operator=(const BenchFrame&) = delete;
+
+    void reset() {
+        if (guarded_) {
+            engine_.guarded_reset(frame_);
+        } else {
+            frame_->pc = 0;
+            frame_->gas_refund = 0;
+            frame_->stack_size = 0;
+            frame_->memory_size = 0;  // Memory is zeroed as it grows
+            frame_->state = 0;
+            frame_->halt_reason = 0;
+        }
+        frame_->gas_remaining = program_.gas;
+
+        StorageEntry* entries = reinterpret_cast<StorageEntry*>(base() + frame_->storage_ptr);
+        std::memset(entries, 0, program_.storage.size() * sizeof(StorageEntry));
+        for (size_t i = 0; i < program_.storage.size(); i++) {
+            std::memcpy(entries[i].address, program_.contract, 20);
+            std::memcpy(entries[i].key, program_.storage[i].key, 32);
+            std::memcpy(entries[i].value, program_.storage[i].value, 32);
+            std::memcpy(entries[i].original, program_.storage[i].value, 32);
+        }
+        frame_->storage_slot_count = static_cast<uint32_t>(program_.storage.size());
+    }
+
+    void run(TracerCallbacks* tracer = nullptr) { engine_.execute(frame_, tracer); }
+
+    MessageFrameMemory* frame() { return frame_; }
+    bool guarded() const { return guarded_; }
+    bool succeeded() const { return frame_->state == 7; }
+    int64_t gasUsed() const { return program_.gas - frame_->gas_remaining; }
+
+private:
+    static uint64_t align(uint64_t size, uint64_t to = 64) { return (size + to - 1) / to * to; }
+
+    uint8_t* base() { return reinterpret_cast<uint8_t*>(frame_); }
+
+    const Engine& engine_;
+    const Program& program_;
+    MessageFrameMemory* frame_ = nullptr;
+    uint64_t buffer_size_ = 0;
+    bool guarded_ = false;
+};
+
+// ===== MEASUREMENT =====
+
+#ifdef __linux__
+/**
+ * User-space counter for the calling thread, read as a group through group_fd
+ * (-1 opens a disabled group leader).
+ */
+inline int open_perf_counter(uint32_t type, uint64_t config, int group_fd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = group_fd < 0 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+#endif
+
+/**
+ * User-space instruction and cycle counters for the calling thread. Unavailable
+ * outside Linux, or when perf_event_paranoid or the hypervisor forbids them.
+ */
+class PerfCounters {
+public:
+    struct Sample {
+        uint64_t instructions = 0;
+        uint64_t cycles = 0;
+    };
+
+    PerfCounters() {
+#ifdef __linux__
+        instructions_fd_ = open_perf_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, -1);
+        if (instructions_fd_ < 0) return;
+        cycles_fd_ = open_perf_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, instructions_fd_);
+        ioctl(instructions_fd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(instructions_fd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    ~PerfCounters() {
+#ifdef __linux__
+        if (cycles_fd_ >= 0) close(cycles_fd_);
+        if (instructions_fd_ >= 0) close(instructions_fd_);
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const { return instructions_fd_ >= 0; }
+    bool hasCycles() const { return cycles_fd_ >= 0; }
+
+    Sample read() const {
+        Sample sample;
+#ifdef __linux__
+        if (instructions_fd_ < 0) return sample;
+        struct {
+            uint64_t nr;
+            uint64_t values[2];
+        } group = {};
+        if (::read(instructions_fd_, &group, sizeof(group)) > 0) {
+            sample.instructions = group.values[0];
+            if (group.nr > 1) sample.cycles = group.values[1];
+        }
+#endif
+        return sample;
+    }
+
+private:
+    int instructions_fd_ = -1;
+    int cycles_fd_ = -1;
+};
+
+/**
+ * L1 data cache read misses and last-level cache misses of the calling thread,
+ * in user space. Lines bouncing between cores (false sharing, shared counters)
+ * show up as misses that grow with the thread count while the work per thread
+ * stays the same. Unavailable under the same conditions as PerfCounters; some
+ * PMUs have the L1D event but no last-level one.
+ */
+class CacheCounters {
+public:
+    struct Sample {
+        uint64_t l1d_misses = 0;
+        uint64_t llc_misses = 0;
+    };
+
+    CacheCounters() {
+#ifdef __linux__
+        const uint64_t l1d_read_miss = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                       (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        l1d_fd_ = open_perf_counter(PERF_TYPE_HW_CACHE, l1d_read_miss, -1);
+        if (l1d_fd_ < 0) return;
+        llc_fd_ = open_perf_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, l1d_fd_);
+        ioctl(l1d_fd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(l1d_fd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    ~CacheCounters() {
+#ifdef __linux__
+        if (llc_fd_ >= 0) close(llc_fd_);
+        if (l1d_fd_ >= 0) close(l1d_fd_);
+#endif
+    }
+
+    CacheCounters(const CacheCounters&) = delete;
+    CacheCounters& operator=(const CacheCounters&) = delete;
+
+    bool available() const { return l1d_fd_ >= 0; }
+    bool hasLastLevel() const { return llc_fd_ >= 0; }
+
+    Sample read() const {
+        Sample sample;
+#ifdef __linux__
+        if (l1d_fd_ < 0) return sample;
+        struct {
+            uint64_t nr;
+            uint64_t values[2];
+        } group = {};
+        if (::read(l1d_fd_, &group, sizeof(group)) > 0) {
+            sample.l1d_misses = group.values[0];
+            if (group.nr > 1) sample.llc_misses = group.values[1];
+        }
+#endif
+        return sample;
+    }
+
+private:
+    int l1d_fd_ = -1;
+    int llc_fd_ = -1;
+};
+
+/** Per-run cost of one program on one frame. */
+struct Measurement {
+    double ns_per_run = 0;            // Median
+    double instructions_per_run = 0;  // Mean, 0 if counters are unavailable
+    double cycles_per_run = 0;        // Mean, 0 if counters are unavailable
+    int64_t gas_per_run = 0;
+    uint64_t runs = 0;
+    bool ok = true;                   // Every run ended in success
+};
+
+/**
+ * Run the frame's program repeatedly: warmup runs, then timed runs until both
+ * min_runs and min_seconds are reached. Only execute_message is inside the
+ * timed and counted region; the constant overhead of reading the clock and the
+ * counters around an empty region is subtracted.
+ */
+inline Measurement measure(BenchFrame& frame, const PerfCounters& counters,
+                           uint64_t min_runs, double min_seconds, uint64_t warmup = 3) {
+    using Clock = std::chrono::steady_clock;
+    Measurement m;
+
+    for (uint64_t i = 0; i < warmup; i++) {
+        frame.reset();
+        frame.run();
+        m.ok = m.ok && frame.succeeded();
+    }
+
+    // Cost of an empty measured region
+    double empty_ns = 1e30, empty_instructions = 1e30, empty_cycles = 1e30;
+    for (int i = 0; i < 64; i++) {
+        auto t0 = Clock::now();
+        PerfCounters::Sample c0 = counters.read();
+        PerfCounters::Sample c1 = counters.read();
+        auto t1 = Clock::now();
+        empty_ns = std::min(empty_ns, std::chrono::duration<double, std::nano>(t1 - t0).count());
+        empty_instructions = std::min(empty_instructions, static_cast<double>(c1.instructions - c0.instructions));
+        empty_cycles = std::min(empty_cycles, static_cast<double>(c1.cycles - c0.cycles));
+    }
+
+    std::vector<double> times;
+    double instructions = 0, cycles = 0;
+    const auto start = Clock::now();
+    while (times.size() < min_runs ||
+           std::chrono::duration<double>(Clock::now() - start).count() < min_seconds) {
+        frame.reset();
+        auto t0 = Clock::now();
+        PerfCounters::Sample c0 = counters.read();
+        frame.run();
+        PerfCounters::Sample c1 = counters.read();
+        auto t1 = Clock::now();
+
+        times.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count() - empty_ns);
+        instructions += static_cast<double>(c1.instructions - c0.instructions) - empty_instructions;
+        cycles += static_cast<double>(c1.cycles - c0.cycles) - empty_cycles;
+        m.ok = m.ok && frame.succeeded();
+    }
+
+    std::sort(times.begin(), times.end());
+    m.runs = times.size();
+    m.ns_per_run = std::max(0.0, times[times.size() / 2]);
+    if (counters.available()) {
+        m.instructions_per_run = std::max(0.0, instructions / m.runs);
+        m.cycles_per_run = counters.hasCycles() ? std::max(0.0, cycles / m.runs) : 0;
+    }
+    m.gas_per_run = frame.gasUsed();
+    return m;
+}
+
+} // namespace bench
+
+} // namespace evm
+} // namespace besu
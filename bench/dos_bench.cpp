@@ -0,0 +1,498 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Gas-versus-time calibration: worst-case patterns per opcode.
+ *
+ * An operation whose native cost is high compared to its gas price lets an
+ * attacker fill a block that takes much longer to execute than its gas suggests.
+ * Each pattern here is the known worst case for one kind of operation (cold
+ * storage misses, warm lookups in a full slot array, memory expansion, 1-gas
+ * dispatch, large code that barely runs, small hashes), and the report is the
+ * time per unit of gas:
+ *
+ *   ns/gas = median time of one run / (gas the frame used + call gas)
+ *
+ * where call gas is what a caller pays to start the frame beyond its own
+ * execution (a cold CALL, for patterns whose cost is per call). A pattern above
+ * its ceiling fails the run, so this doubles as a regression gate.
+ *
+ * Patterns whose cost is in code analysis rather than execution (the JUMPDEST
+ * analysis bomb) add the time of the code analysis execute_message runs on
+ * them (jumpdest bitmap and basic blocks, code_analysis.h). execute_message caches the analysis per thread, so repeated runs only
+ * pay for it once; a contract seen for the first time pays it in full.
+ *
+ * Precompiles (MODEXP, BLAKE2F, ...) are not executed by the native
+ * interpreter, so they have no patterns here; they are listed as skipped.
+ *
+ * Correctness gaps found on the way are probed on every engine, and any that
+ * comes back is reported as a finding, which also fails the run (JUMP into
+ * PUSH data must halt).
+ *
+ * Usage:
+ *   besu_native_evm_dos_bench [--variant NAME] [--pattern NAME] [--bounds checked|guarded|both]
+ *                             [--ceiling NS | NAME=NS]... [--seconds S] [--json FILE] [--lib PATH]...
+ */
+
+#include "bench_util.h"
+#include "code_analysis.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#ifndef BESU_BENCH_VARIANT_DIR
+#define BESU_BENCH_VARIANT_DIR "."
+#endif
+
+using namespace besu::evm;
+using namespace besu::evm::bench;
+
+namespace {
+
+// 30 Mgas in under a second on a single core, with headroom for slower machines
+constexpr double DEFAULT_CEILING_NS = 30.0;
+
+// Gas a caller pays to enter a contract it has not touched yet (EIP-2929)
+constexpr int64_t COLD_CALL_GAS = 2600;
+
+constexpr uint32_t MAX_CODE_SIZE = 24576;  // EIP-170
+
+Program base_program() {
+    Program program;
+    program.revision = LATEST_REVISION;
+    std::memset(program.contract, 0x22, 20);
+    return program;
+}
+
+/**
+ * Loop body times count: [counter] body... counter-1, JUMPI while non-zero.
+ * The body runs with the counter (count..1) on top of the stack and must leave
+ * the stack as it found it. Loop overhead is 26 gas per iteration. prologue,
+ * if given, runs once before the loop.
+ */
+template <typename Body>
+std::vector<uint8_t> loop(uint64_t count, Body body, void (*prologue)(Assembler&) = nullptr) {
+    Assembler a;
+    if (prologue) prologue(a);
+    a.push(count);
+    a.label("loop");
+    body(a);
+    a.push(1).swap(1).op(opcodes::SUB);
+    a.dup(1).jumpi("loop");
+    a.op(opcodes::POP).op(opcodes::STOP);
+    return a.build();
+}
+
+// ===== PATTERNS =====
+
+/** SLOAD of distinct slots that are not in the witness: every access is a cold miss. */
+Program sload_cold_spam() {
+    Program program = base_program();
+    program.max_storage_slots = 4096;
+    program.code = loop(4000, [](Assembler& a) { a.dup(1).op(opcodes::SLOAD).op(opcodes::POP); });
+    return program;
+}
+
+/** Warm SLOAD of the last of 1024 preloaded slots, the longest lookup at 100 gas. */
+Program sload_warm_scan() {
+    Program program = base_program();
+    program.max_storage_slots = 1024;
+    for (uint64_t i = 0; i < 1024; i++) {
+        StorageInit slot = {};
+        for (int b = 0; b < 8; b++) slot.key[31 - b] = static_cast<uint8_t>(i >> (8 * b));
+        slot.value[31] = 1;
+        program.storage.push_back(slot);
+    }
+    program.code = loop(4000, [](Assembler& a) { a.push(1023).op(opcodes::SLOAD).op(opcodes::POP); });
+    return program;
+}
+
+/** SSTORE to fresh slots (cold, zero to non-zero). */
+Program sstore_fresh_spam() {
+    Program program = base_program();
+    program.max_storage_slots = 1024;
+    program.code = loop(1000, [](Assembler& a) { a.dup(1).dup(1).op(opcodes::SSTORE); });
+    return program;
+}
+
+/** One MSTORE at the top of the checked interpreter's 1 MB memory. */
+Program memory_expand_1mb() {
+    Program program = base_program();
+    Assembler a;
+    a.push(1).push(1024 * 1024 - 32).op(opcodes::MSTORE).op(opcodes::STOP);
+    program.code = a.build();
+    return program;
+}
+
+/** MSTOREs that each grow memory by one word, while expansion is still cheap. */
+Program memory_grow_words() {
+    Program program = base_program();
+    constexpr uint64_t WORDS = 2048;
+    program.code = loop(WORDS, [](Assembler& a) {
+        a.dup(1).dup(1).push(WORDS).op(opcodes::SUB);  // [c, c, WORDS - c]
+        a.push(32).op(opcodes::MUL).op(opcodes::MSTORE);
+    });
+    return program;
+}
+
+/** A maximum-size contract of JUMPDESTs: 1 gas per dispatched instruction. */
+Program jumpdest_sled() {
+    Program program = base_program();
+    program.code.assign(MAX_CODE_SIZE - 1, opcodes::JUMPDEST);
+    program.code.push_back(opcodes::STOP);
+    return program;
+}
+
+/**
+ * A maximum-size contract that stops at once, its code PUSH32s full of 0x5b
+ * (JUMPDEST analysis bomb). The caller pays for a cold CALL only, the engine for
+ * analysing 24 KB of code (timed separately, see analysis_ns).
+ */
+Program jumpdest_bomb() {
+    Program program = base_program();
+    program.code.push_back(opcodes::STOP);
+    while (program.code.size() + 33 <= MAX_CODE_SIZE) {
+        program.code.push_back(opcodes::PUSH1 + 31);
+        for (int i = 0; i < 32; i++) program.code.push_back(opcodes::JUMPDEST);
+    }
+    return program;
+}
+
+/** The tightest backward-jump loop. */
+Program jumpi_loop() {
+    Program program = base_program();
+    program.code = loop(20000, [](Assembler&) {});
+    return program;
+}
+
+/** KECCAK256 of one word: the smallest hash for its 36 gas. */
+Program keccak_word() {
+    Program program = base_program();
+    program.code = loop(5000, [](Assembler& a) {
+        a.push(32).push(0).op(opcodes::KECCAK256).op(opcodes::POP);
+    });
+    return program;
+}
+
+/** KECCAK256 of 1 KB, memory expanded before the loop. */
+Program keccak_1k() {
+    Program program = base_program();
+    program.code = loop(
+        500, [](Assembler& a) { a.push(1024).push(0).op(opcodes::KECCAK256).op(opcodes::POP); },
+        [](Assembler& a) { a.push(1).push(1024 - 32).op(opcodes::MSTORE); });
+    return program;
+}
+
+/** DIV with a full 64-bit dividend, the widest the native arithmetic takes. */
+Program div_spam() {
+    Program program = base_program();
+    program.code = loop(10000, [](Assembler& a) {
+        a.dup(1).push(~uint64_t(0)).op(opcodes::DIV).op(opcodes::POP);
+    });
+    return program;
+}
+
+struct Pattern {
+    const char* name;
+    const char* what;
+    int64_t call_gas;
+    Program (*build)();
+    bool analyzed = false;  // Add the jumpdest analysis of the code to the run time
+};
+
+std::vector<Pattern> patterns() {
+    return {
+        {"sload_cold_spam", "SLOAD misses on distinct slots", 0, sload_cold_spam},
+        {"sload_warm_scan", "warm SLOAD, 1024 slots loaded", 0, sload_warm_scan},
+        {"sstore_fresh_spam", "SSTORE to new slots", 0, sstore_fresh_spam},
+        {"memory_expand_1mb", "one expansion to 1 MB", 0, memory_expand_1mb},
+        {"memory_grow_words", "expansion one word at a time", 0, memory_grow_words},
+        {"jumpdest_sled", "24 KB of JUMPDEST", 0, jumpdest_sled},
+        {"jumpdest_bomb", "24 KB of 0x5b data, analysis + cold CALL", COLD_CALL_GAS, jumpdest_bomb, true},
+        {"jumpi_loop", "empty JUMPI loop", 0, jumpi_loop},
+        {"keccak_word", "KECCAK256 of 32 bytes", 0, keccak_word},
+        {"keccak_1k", "KECCAK256 of 1 KB", 0, keccak_1k},
+        {"div_spam", "DIV", 0, div_spam},
+    };
+}
+
+/** Not executed natively: reported as skipped so the coverage gap stays visible. */
+const char* const SKIPPED[] = {
+    "MODEXP (precompile 0x05)", "BLAKE2F (precompile 0x09)", "ECPAIRING (precompile 0x08)",
+    "EXTCODESIZE/CALL family (Java side)",
+};
+
+/**
+ * Median time of the jumpdest and basic block analysis of code, run for at
+ * least seconds. The analysis is engine independent (header only).
+ */
+double analysis_ns(const std::vector<uint8_t>& code, double seconds) {
+    using Clock = std::chrono::steady_clock;
+    const uint32_t size = static_cast<uint32_t>(code.size());
+    std::vector<uint8_t> bitmap(code_analysis::jumpdest_bitmap_size(size));
+    std::vector<code_analysis::BlockInfo> blocks;
+    std::vector<double> times;
+    const auto start = Clock::now();
+    while (times.size() < 10 || std::chrono::duration<double>(Clock::now() - start).count() < seconds) {
+        auto t0 = Clock::now();
+        code_analysis::analyze_jumpdests(code.data(), size, bitmap.data());
+        code_analysis::analyze_blocks(code.data(), size, LATEST_REVISION, blocks);
+        auto t1 = Clock::now();
+        times.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+    }
+    volatile size_t sink = bitmap[0] + blocks.size();  // Keep the analysis from being optimised away
+    (void)sink;
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+/** A correctness probe: a program that a correct engine must halt on. */
+struct Probe {
+    const char* name;
+    const char* finding;  // Reported when the frame does not halt
+    Program (*build)();
+};
+
+/** JUMP to a 0x5b byte that is PUSH1 data: must halt with an invalid jump destination. */
+Program jump_into_push_data() {
+    Program program = base_program();
+    Assembler a;
+    a.push(4).op(opcodes::JUMP);               // 0: PUSH1 4, 2: JUMP
+    a.push(opcodes::JUMPDEST).op(opcodes::STOP);  // 3: PUSH1 0x5b, 5: STOP
+    program.code = a.build();
+    return program;
+}
+
+const Probe PROBES[] = {
+    {"jump_into_push_data",
+     "JUMP into PUSH data accepted: JUMP/JUMPI must check the jumpdest bitmap, not code[dest] == JUMPDEST",
+     jump_into_push_data},
+};
+
+struct Finding {
+    std::string engine;
+    const char* bounds;
+    const Probe* probe;
+};
+
+struct Options {
+    std::string variant;
+    std::string pattern;
+    bool checked = true;
+    bool guarded = false;
+    double seconds = 0.2;
+    double ceiling = DEFAULT_CEILING_NS;
+    std::map<std::string, double> ceilings;  // Per pattern
+    std::string json;
+    std::vector<std::string> libs;
+};
+
+struct Result {
+    std::string engine;
+    const char* bounds;
+    const Pattern* pattern;
+    int64_t gas;
+    double ns;
+    double ns_per_gas;
+    double ceiling;
+    bool ok;
+};
+
+void usage(const char* argv0) {
+    std::fprintf(stderr,
+                 "Usage: %s [--variant NAME] [--pattern NAME] [--bounds checked|guarded|both]\n"
+                 "          [--ceiling NS | NAME=NS]... [--seconds S] [--json FILE] [--lib PATH]...\n"
+                 "\n"
+                 "Fails if a pattern takes more than the ceiling in ns per gas (default %.0f), or if\n"
+                 "an engine runs a correctness probe it must halt on.\n",
+                 argv0, DEFAULT_CEILING_NS);
+}
+
+bool parse(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (arg == "--help" || arg == "-h") return false;
+        if (!value) {
+            std::fprintf(stderr, "%s needs a value\n", arg.c_str());
+            return false;
+        }
+        i++;
+        if (arg == "--variant") {
+            options.variant = value;
+        } else if (arg == "--pattern") {
+            options.pattern = value;
+        } else if (arg == "--bounds") {
+            std::string bounds = value;
+            options.checked = bounds == "checked" || bounds == "both";
+            options.guarded = bounds == "guarded" || bounds == "both";
+            if (!options.checked && !options.guarded) return false;
+        } else if (arg == "--ceiling") {
+            std::string ceiling = value;
+            size_t eq = ceiling.find('=');
+            double ns = std::atof(ceiling.c_str() + (eq == std::string::npos ? 0 : eq + 1));
+            if (ns <= 0) return false;
+            if (eq == std::string::npos) {
+                options.ceiling = ns;
+            } else {
+                options.ceilings[ceiling.substr(0, eq)] = ns;
+            }
+        } else if (arg == "--seconds") {
+            options.seconds = std::atof(value);
+        } else if (arg == "--json") {
+            options.json = value;
+        } else if (arg == "--lib") {
+            options.libs.push_back(value);
+        } else {
+            std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool write_json(const std::string& path, const std::vector<Result>& results,
+                const std::vector<Finding>& findings) {
+    FILE* out = std::fopen(path.c_str(), "w");
+    if (!out) return false;
+    std::fprintf(out, "{\n  \"revision\": %d,\n  \"results\": [\n", static_cast<int>(LATEST_REVISION));
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        std::fprintf(out,
+                     "    {\"pattern\": \"%s\", \"dispatch\": \"%s\", \"bounds\": \"%s\", \"gas\": %lld, "
+                     "\"ns\": %.0f, \"ns_per_gas\": %.3f, \"ceiling\": %.3f, \"ok\": %s}%s\n",
+                     r.pattern->name, r.engine.c_str(), r.bounds, static_cast<long long>(r.gas), r.ns,
+                     r.ns_per_gas, r.ceiling, r.ok ? "true" : "false", i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(out, "  ],\n  \"skipped\": [");
+    for (size_t i = 0; i < sizeof(SKIPPED) / sizeof(SKIPPED[0]); i++) {
+        std::fprintf(out, "%s\"%s\"", i ? ", " : "", SKIPPED[i]);
+    }
+    std::fprintf(out, "],\n  \"findings\": [\n");
+    for (size_t i = 0; i < findings.size(); i++) {
+        const Finding& f = findings[i];
+        std::fprintf(out, "    {\"probe\": \"%s\", \"dispatch\": \"%s\", \"bounds\": \"%s\", \"finding\": \"%s\"}%s\n",
+                     f.probe->name, f.engine.c_str(), f.bounds, f.probe->finding,
+                     i + 1 < findings.size() ? "," : "");
+    }
+    std::fprintf(out, "  ]\n}\n");
+    return std::fclose(out) == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse(argc, argv, options)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::string error;
+    std::vector<Engine> engines = load_engines(options.libs, BESU_BENCH_VARIANT_DIR, options.variant, error);
+    if (engines.empty()) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    std::vector<Pattern> selected;
+    for (const Pattern& pattern : patterns()) {
+        if (options.pattern.empty() || options.pattern == pattern.name) selected.push_back(pattern);
+    }
+    if (selected.empty()) {
+        std::fprintf(stderr, "Unknown pattern %s\n", options.pattern.c_str());
+        return 1;
+    }
+    for (const auto& entry : options.ceilings) {
+        bool known = false;
+        for (const Pattern& pattern : selected) known = known || entry.first == pattern.name;
+        if (!known && options.pattern.empty()) {
+            std::fprintf(stderr, "Unknown pattern %s in --ceiling\n", entry.first.c_str());
+            return 1;
+        }
+    }
+
+    PerfCounters counters;  // Unused counters cost nothing; measure() wants them
+    std::printf("%-18s %-9s %-8s %10s %12s %9s %8s  %s\n",
+                "pattern", "dispatch", "bounds", "gas", "ns/run", "ns/gas", "ceiling", "worst case");
+
+    std::vector<Result> results;
+    int over = 0, failures = 0;
+    for (const Pattern& pattern : selected) {
+        const Program program = pattern.build();
+        auto it = options.ceilings.find(pattern.name);
+        const double ceiling = it == options.ceilings.end() ? options.ceiling : it->second;
+        const double analysis = pattern.analyzed ? analysis_ns(program.code, options.seconds) : 0;
+
+        for (const Engine& engine : engines) {
+            for (int mode = 0; mode < 2; mode++) {
+                const bool guarded = mode == 1;
+                if ((guarded && !options.guarded) || (!guarded && !options.checked)) continue;
+                if (guarded && !engine.hasGuardedFrames()) continue;
+
+                BenchFrame frame(engine, program, guarded);
+                if (guarded && !frame.guarded()) continue;  // Guard pages unsupported at runtime
+                Measurement m = measure(frame, counters, 10, options.seconds);
+
+                Result r;
+                r.engine = engine.name;
+                r.bounds = guarded ? "guarded" : "checked";
+                r.pattern = &pattern;
+                r.gas = m.gas_per_run + pattern.call_gas;
+                r.ns = m.ns_per_run + analysis;
+                r.ns_per_gas = r.gas > 0 ? r.ns / static_cast<double>(r.gas) : 0;
+                r.ceiling = ceiling;
+                r.ok = m.ok;
+                results.push_back(r);
+
+                const bool above = r.ns_per_gas > ceiling;
+                over += above;
+                failures += !m.ok;
+                std::printf("%-18s %-9s %-8s %10lld %12.0f %9.2f %8.1f  %s%s\n", pattern.name,
+                            engine.name.c_str(), r.bounds, static_cast<long long>(r.gas), r.ns, r.ns_per_gas,
+                            ceiling, pattern.what, !m.ok ? "  FAILED" : above ? "  OVER CEILING" : "");
+            }
+        }
+    }
+
+    std::printf("\nskipped (not executed natively):");
+    for (const char* skipped : SKIPPED) std::printf(" %s;", skipped);
+    std::printf("\n");
+    if (over) std::printf("%d pattern run(s) above their ns/gas ceiling\n", over);
+
+    std::vector<Finding> findings;
+    for (const Probe& probe : PROBES) {
+        const Program program = probe.build();
+        for (const Engine& engine : engines) {
+            for (int mode = 0; mode < 2; mode++) {
+                const bool guarded = mode == 1;
+                if ((guarded && !options.guarded) || (!guarded && !options.checked)) continue;
+                if (guarded && !engine.hasGuardedFrames()) continue;
+
+                BenchFrame frame(engine, program, guarded);
+                if (guarded && !frame.guarded()) continue;
+                frame.reset();
+                frame.run();
+                if (frame.frame()->state == 4) continue;  // Halted, as it must
+                findings.push_back({engine.name, guarded ? "guarded" : "checked", &probe});
+            }
+        }
+    }
+    if (!findings.empty()) {
+        std::printf("\nfindings:\n");
+        for (const Finding& f : findings) {
+            std::printf("  %-20s %-9s %-8s %s\n", f.probe->name, f.engine.c_str(), f.bounds, f.probe->finding);
+        }
+    }
+
+    if (!options.json.empty() && !write_json(options.json, results, findings)) {
+        std::fprintf(stderr, "Cannot write %s\n", options.json.c_str());
+        return 1;
+    }
+    return over == 0 && failures == 0 && findings.empty() ? 0 : 1;
+}
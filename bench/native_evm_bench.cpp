@@ -0,0 +1,154 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Native EVM benchmark suite.
+ *
+ * Runs the contract workloads (workloads.h) on every interpreter dispatch variant,
+ * with checked and guard-page bounds, and reports per transaction:
+ *
+ * - ns/op: median wall time of one execute_message
+ * - Mgas/s: gas used over that time
+ * - insn/op, cycles/op: user-space hardware counters, when perf allows it
+ *
+ * Usage:
+ *   besu_native_evm_bench [--variant NAME] [--workload NAME] [--bounds checked|guarded|both]
+ *                         [--runs N] [--seconds S] [--lib PATH]...
+ */
+
+#include "bench_util.h"
+#include "workloads.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifndef BESU_BENCH_VARIANT_DIR
+#define BESU_BENCH_VARIANT_DIR "."
+#endif
+
+using namespace besu::evm;
+using namespace besu::evm::bench;
+
+namespace {
+
+struct Options {
+    std::string variant;
+    std::string workload;
+    bool checked = true;
+    bool guarded = true;
+    uint64_t runs = 200;
+    double seconds = 0.2;
+    std::vector<std::string> libs;
+};
+
+void usage(const char* argv0) {
+    std::fprintf(stderr,
+                 "Usage: %s [--variant NAME] [--workload NAME] [--bounds checked|guarded|both]\n"
+                 "          [--runs N] [--seconds S] [--lib PATH]...\n"
+                 "\n"
+                 "Variants are loaded from " BESU_BENCH_VARIANT_DIR " unless --lib is given.\n",
+                 argv0);
+}
+
+bool parse(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (arg == "--help" || arg == "-h") return false;
+        if (!value) {
+            std::fprintf(stderr, "%s needs a value\n", arg.c_str());
+            return false;
+        }
+        i++;
+        if (arg == "--variant") {
+            options.variant = value;
+        } else if (arg == "--workload") {
+            options.workload = value;
+        } else if (arg == "--bounds") {
+            std::string bounds = value;
+            options.checked = bounds == "checked" || bounds == "both";
+            options.guarded = bounds == "guarded" || bounds == "both";
+            if (!options.checked && !options.guarded) return false;
+        } else if (arg == "--runs") {
+            options.runs = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--seconds") {
+            options.seconds = std::atof(value);
+        } else if (arg == "--lib") {
+            options.libs.push_back(value);
+        } else {
+            std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string format_counter(double value) {
+    if (value <= 0) return "n/a";
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.0f", value);
+    return buffer;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse(argc, argv, options)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::string error;
+    std::vector<Engine> engines = load_engines(options.libs, BESU_BENCH_VARIANT_DIR, options.variant, error);
+    if (engines.empty()) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    std::vector<Workload> selected;
+    for (const Workload& workload : workloads()) {
+        if (options.workload.empty() || options.workload == workload.name) selected.push_back(workload);
+    }
+    if (selected.empty()) {
+        std::fprintf(stderr, "Unknown workload %s\n", options.workload.c_str());
+        return 1;
+    }
+
+    PerfCounters counters;
+    if (!counters.available()) {
+        std::fprintf(stderr, "Hardware counters unavailable (perf_event_paranoid or no PMU): insn/cycles are n/a\n");
+    }
+
+    std::printf("%-16s %-9s %-8s %10s %12s %10s %12s %12s\n",
+                "workload", "dispatch", "bounds", "gas", "ns/op", "Mgas/s", "insn/op", "cycles/op");
+
+    int failures = 0;
+    for (const Workload& workload : selected) {
+        const Program program = workload.build();
+        for (const Engine& engine : engines) {
+            for (int mode = 0; mode < 2; mode++) {
+                const bool guarded = mode == 1;
+                if ((guarded && !options.guarded) || (!guarded && !options.checked)) continue;
+                if (guarded && !engine.hasGuardedFrames()) continue;
+
+                BenchFrame frame(engine, program, guarded);
+                if (guarded && !frame.guarded()) continue;  // Guard pages unsupported at runtime
+                Measurement m = measure(frame, counters, options.runs, options.seconds);
+
+                const double mgas = m.ns_per_run > 0 ? m.gas_per_run / m.ns_per_run * 1e3 : 0;
+                std::printf("%-16s %-9s %-8s %10lld %12.0f %10.1f %12s %12s%s\n",
+                            workload.name, engine.name.c_str(), guarded ? "guarded" : "checked",
+                            static_cast<long long>(m.gas_per_run), m.ns_per_run, mgas,
+                            format_counter(m.instructions_per_run).c_str(),
+                            format_counter(m.cycles_per_run).c_str(),
+                            m.ok ? "" : "  FAILED");
+                if (!m.ok) failures++;
+            }
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
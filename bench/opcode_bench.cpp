@@ -0,0 +1,325 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Per-opcode microbenchmark.
+ *
+ * Measures the cost of each natively implemented opcode in isolation. For every
+ * opcode two straight-line programs run N repetitions of the same block:
+ *
+ *   measured:  PUSH operands..., OP, POP results...
+ *   baseline:  PUSH operands..., POP operands...
+ *
+ * Both keep the stack balanced and differ only in OP and the number of POPs, so
+ *
+ *   cost(OP) = (t(measured) - t(baseline)) / N + (operands - results) * cost(POP)
+ *
+ * with cost(POP) taken as half of a calibrated PUSH1/POP pair. Operands are
+ * chosen so every repetition takes the opcode's normal path (non-zero divisors,
+ * small memory offsets, warm storage slots, jumps to the next JUMPDEST).
+ *
+ * Usage:
+ *   besu_native_evm_opcode_bench [--variant NAME] [--opcode NAME] [--bounds checked|guarded|both]
+ *                                [--repeat N] [--seconds S] [--json FILE] [--lib PATH]...
+ */
+
+#include "bench_util.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifndef BESU_BENCH_VARIANT_DIR
+#define BESU_BENCH_VARIANT_DIR "."
+#endif
+
+using namespace besu::evm;
+using namespace besu::evm::bench;
+
+namespace {
+
+constexpr Revision REVISION = LATEST_REVISION;
+
+/** An opcode with the operands its block pushes, bottom of the stack first. */
+struct OpcodeCase {
+    uint8_t opcode;
+    std::vector<uint64_t> operands;
+    bool jump_target = false;   // Last operand is the JUMPDEST after the opcode
+};
+
+/**
+ * Operands for opcodes that need particular values to take their normal path;
+ * any other opcode gets stack_in small non-zero operands.
+ */
+const std::vector<OpcodeCase>& special_cases() {
+    using namespace opcodes;
+    static const std::vector<OpcodeCase> cases = {
+        {DIV, {3, 100}},       {MOD, {3, 100}},        {KECCAK256, {32, 0}},
+        {MLOAD, {64}},         {MSTORE, {5, 64}},      {MSTORE8, {5, 64}},
+        {SLOAD, {1}},          {SSTORE, {1, 1}},       {JUMP, {0}, true},
+        {JUMPI, {1, 0}, true},
+    };
+    return cases;
+}
+
+/**
+ * The opcodes implemented natively by evm_optimized.cpp (NATIVE in the opcode
+ * metadata; the others are Java-side), except those that end the frame.
+ */
+std::vector<OpcodeCase> native_cases() {
+    std::vector<OpcodeCase> cases;
+    for (int op = 0; op < 256; op++) {
+        const OpcodeInfo& info = opcodes::info(REVISION, static_cast<uint8_t>(op));
+        if (!(info.flags & opcodes::NATIVE) || (info.flags & opcodes::TERMINATES)) continue;
+        OpcodeCase c{static_cast<uint8_t>(op), {}};
+        for (const OpcodeCase& special : special_cases()) {
+            if (special.opcode == op) c = special;
+        }
+        // DUPn/SWAPn take their operands from the prologue
+        const bool from_prologue = op >= opcodes::DUP1 && op <= opcodes::SWAP1 + 15;
+        if (c.operands.empty() && !from_prologue) {
+            for (int i = 0; i < info.stack_in; i++) c.operands.push_back(static_cast<uint64_t>(3 + 2 * i));
+        }
+        cases.push_back(c);
+    }
+    return cases;
+}
+
+/** Items the block pops after the opcode so the stack stays balanced. */
+int result_count(const OpcodeCase& c) {
+    const OpcodeInfo& info = opcodes::info(REVISION, c.opcode);
+    return static_cast<int>(c.operands.size()) + info.stack_out - info.stack_in;
+}
+
+/**
+ * Straight-line program of repeat blocks. The prologue fills 17 stack items so
+ * DUPn/SWAPn (which take no operands of their own) always have enough.
+ */
+Program build(const OpcodeCase& c, int repeat, bool measured) {
+    const OpcodeInfo& info = opcodes::info(REVISION, c.opcode);
+    Assembler a;
+    for (int i = 0; i < 17; i++) a.push(i + 1);
+
+    for (int r = 0; r < repeat; r++) {
+        const std::string target = "t" + std::to_string(r);
+        for (size_t i = 0; i < c.operands.size(); i++) {
+            if (c.jump_target && i + 1 == c.operands.size()) {
+                a.push_label(target);
+            } else {
+                a.push(c.operands[i]);
+            }
+        }
+        const int pops = measured ? result_count(c) : static_cast<int>(c.operands.size());
+        if (measured) {
+            a.op(c.opcode);
+            for (int i = 0; i < info.immediate; i++) a.op(0);
+        }
+        for (int i = 0; i < pops; i++) a.op(opcodes::POP);
+        if (c.jump_target) a.label(target);
+    }
+    a.op(opcodes::STOP);
+
+    Program program;
+    program.code = a.build();
+    program.revision = REVISION;
+    std::memset(program.contract, 0x11, 20);
+    StorageInit slot = {};
+    slot.key[31] = 1;
+    slot.value[31] = 1;
+    program.storage.push_back(slot);
+    return program;
+}
+
+/** PUSH1/POP pairs, and the same prologue with no blocks. */
+Program build_pairs(int repeat, bool with_pairs) {
+    Assembler a;
+    for (int i = 0; i < 17; i++) a.push(i + 1);
+    if (with_pairs) {
+        for (int r = 0; r < repeat; r++) a.push(1).op(opcodes::POP);
+    }
+    a.op(opcodes::STOP);
+
+    Program program;
+    program.code = a.build();
+    program.revision = REVISION;
+    std::memset(program.contract, 0x11, 20);
+    return program;
+}
+
+struct Options {
+    std::string variant;
+    std::string opcode;
+    bool checked = true;
+    bool guarded = false;
+    int repeat = 1000;
+    double seconds = 0.02;
+    std::string json;
+    std::vector<std::string> libs;
+};
+
+struct Result {
+    std::string engine;
+    const char* bounds;
+    const char* opcode;
+    double ns;
+    double cycles;  // 0 if counters are unavailable
+    bool ok;
+};
+
+struct Sample {
+    double ns;
+    double cycles;
+    bool ok;
+};
+
+Sample run(const Engine& engine, const Program& program, bool guarded, const PerfCounters& counters,
+           const Options& options) {
+    BenchFrame frame(engine, program, guarded);
+    Measurement m = measure(frame, counters, 30, options.seconds);
+    return {m.ns_per_run, m.cycles_per_run, m.ok};
+}
+
+void usage(const char* argv0) {
+    std::fprintf(stderr,
+                 "Usage: %s [--variant NAME] [--opcode NAME] [--bounds checked|guarded|both]\n"
+                 "          [--repeat N] [--seconds S] [--json FILE] [--lib PATH]...\n",
+                 argv0);
+}
+
+bool parse(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (arg == "--help" || arg == "-h") return false;
+        if (!value) {
+            std::fprintf(stderr, "%s needs a value\n", arg.c_str());
+            return false;
+        }
+        i++;
+        if (arg == "--variant") {
+            options.variant = value;
+        } else if (arg == "--opcode") {
+            options.opcode = value;
+        } else if (arg == "--bounds") {
+            std::string bounds = value;
+            options.checked = bounds == "checked" || bounds == "both";
+            options.guarded = bounds == "guarded" || bounds == "both";
+            if (!options.checked && !options.guarded) return false;
+        } else if (arg == "--repeat") {
+            options.repeat = std::atoi(value);
+            if (options.repeat <= 0) return false;
+        } else if (arg == "--seconds") {
+            options.seconds = std::atof(value);
+        } else if (arg == "--json") {
+            options.json = value;
+        } else if (arg == "--lib") {
+            options.libs.push_back(value);
+        } else {
+            std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool write_json(const std::string& path, const Options& options, const std::vector<Result>& results) {
+    FILE* out = std::fopen(path.c_str(), "w");
+    if (!out) return false;
+    std::fprintf(out, "{\n  \"revision\": %d,\n  \"repeat\": %d,\n  \"results\": [\n",
+                 static_cast<int>(REVISION), options.repeat);
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        std::fprintf(out, "    {\"opcode\": \"%s\", \"dispatch\": \"%s\", \"bounds\": \"%s\", \"ns\": %.3f, ",
+                     r.opcode, r.engine.c_str(), r.bounds, r.ns);
+        if (r.cycles > 0) {
+            std::fprintf(out, "\"cycles\": %.2f, ", r.cycles);
+        } else {
+            std::fprintf(out, "\"cycles\": null, ");
+        }
+        std::fprintf(out, "\"ok\": %s}%s\n", r.ok ? "true" : "false", i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(out, "  ]\n}\n");
+    return std::fclose(out) == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse(argc, argv, options)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::string error;
+    std::vector<Engine> engines = load_engines(options.libs, BESU_BENCH_VARIANT_DIR, options.variant, error);
+    if (engines.empty()) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    std::vector<OpcodeCase> cases;
+    for (const OpcodeCase& c : native_cases()) {
+        if (options.opcode.empty() || options.opcode == opcodes::info(REVISION, c.opcode).name) cases.push_back(c);
+    }
+    if (cases.empty()) {
+        std::fprintf(stderr, "Unknown or non-native opcode %s\n", options.opcode.c_str());
+        return 1;
+    }
+
+    PerfCounters counters;
+    if (!counters.available()) {
+        std::fprintf(stderr, "Hardware counters unavailable (perf_event_paranoid or no PMU): cycles are n/a\n");
+    }
+
+    const double n = options.repeat;
+    const Program pairs = build_pairs(options.repeat, true);
+    const Program empty = build_pairs(options.repeat, false);
+
+    std::vector<Result> results;
+    int failures = 0;
+    for (const Engine& engine : engines) {
+        for (int mode = 0; mode < 2; mode++) {
+            const bool guarded = mode == 1;
+            if ((guarded && !options.guarded) || (!guarded && !options.checked)) continue;
+            if (guarded && !engine.hasGuardedFrames()) continue;
+            const char* bounds = guarded ? "guarded" : "checked";
+
+            Sample pair = run(engine, pairs, guarded, counters, options);
+            Sample none = run(engine, empty, guarded, counters, options);
+            const double pop_ns = (pair.ns - none.ns) / n / 2;
+            const double pop_cycles = (pair.cycles - none.cycles) / n / 2;
+
+            std::printf("\n%s dispatch, %s bounds (POP ~ %.2f ns)\n", engine.name.c_str(), bounds, pop_ns);
+            std::printf("%-14s %10s %12s\n", "opcode", "ns/op", "cycles/op");
+            for (const OpcodeCase& c : cases) {
+                const int unbalanced = static_cast<int>(c.operands.size()) - result_count(c);
+                Sample measured = run(engine, build(c, options.repeat, true), guarded, counters, options);
+                Sample baseline = run(engine, build(c, options.repeat, false), guarded, counters, options);
+
+                Result r;
+                r.engine = engine.name;
+                r.bounds = bounds;
+                r.opcode = opcodes::info(REVISION, c.opcode).name;
+                r.ns = (measured.ns - baseline.ns) / n + unbalanced * pop_ns;
+                r.cycles = counters.hasCycles()
+                    ? (measured.cycles - baseline.cycles) / n + unbalanced * pop_cycles
+                    : 0;
+                r.ok = measured.ok && baseline.ok;
+                if (!r.ok) failures++;
+                results.push_back(r);
+
+                char cycles[32] = "n/a";
+                if (counters.hasCycles()) std::snprintf(cycles, sizeof(cycles), "%.2f", r.cycles);
+                std::printf("%-14s %10.2f %12s%s\n", r.opcode, r.ns, cycles, r.ok ? "" : "  FAILED");
+            }
+        }
+    }
+
+    if (!options.json.empty() && !write_json(options.json, options, results)) {
+        std::fprintf(stderr, "Cannot write %s\n", options.json.c_str());
+        return 1;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,362 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Multi-core scalability of concurrent execute_message calls.
+ *
+ * Besu calls into the library from many Java threads at once, each with its own
+ * frame. This runs every contract workload on 1, 2, 4, ... up to --threads
+ * threads the same way: one frame per thread, no coordination between runs, for
+ * a fixed time per step. Per step it reports total throughput, the median and
+ * 99th percentile time of a single run across all threads, and the scaling
+ * efficiency:
+ *
+ *   efficiency = throughput(N threads) / (N x throughput(1 thread))
+ *
+ * Anything the threads share (allocator, caches, counters, lines written by more
+ * than one core) lowers efficiency. To tell cache-line contention apart from
+ * plain memory bandwidth, each thread also counts its own L1D and last-level
+ * cache misses per run where perf events are available; a thread whose misses
+ * per run grow well past the single-thread figure is flagged.
+ *
+ * Usage:
+ *   besu_native_evm_scaling_bench [--variant NAME] [--workload NAME] [--bounds checked|guarded|both]
+ *                                 [--threads N] [--seconds S] [--json FILE] [--lib PATH]...
+ */
+
+#include "bench_util.h"
+#include "workloads.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifndef BESU_BENCH_VARIANT_DIR
+#define BESU_BENCH_VARIANT_DIR "."
+#endif
+
+using namespace besu::evm;
+using namespace besu::evm::bench;
+
+namespace {
+
+// Misses per run this many times the single-thread figure flag a step
+constexpr double CONTENTION_RATIO = 2.0;
+
+// Below this many misses per run the ratio is noise
+constexpr double CONTENTION_FLOOR = 64.0;
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string variant;
+    std::string workload;
+    bool checked = true;
+    bool guarded = true;
+    uint32_t threads = 0;  // 0 = hardware threads
+    double seconds = 0.5;
+    std::string json;
+    std::vector<std::string> libs;
+};
+
+void usage(const char* argv0) {
+    std::fprintf(stderr,
+                 "Usage: %s [--variant NAME] [--workload NAME] [--bounds checked|guarded|both]\n"
+                 "          [--threads N] [--seconds S] [--json FILE] [--lib PATH]...\n"
+                 "\n"
+                 "Runs each workload on 1, 2, 4, ... N threads (default: hardware threads) for S\n"
+                 "seconds per step.\n",
+                 argv0);
+}
+
+bool parse(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (arg == "--help" || arg == "-h") return false;
+        if (!value) {
+            std::fprintf(stderr, "%s needs a value\n", arg.c_str());
+            return false;
+        }
+        i++;
+        if (arg == "--variant") {
+            options.variant = value;
+        } else if (arg == "--workload") {
+            options.workload = value;
+        } else if (arg == "--bounds") {
+            std::string bounds = value;
+            options.checked = bounds == "checked" || bounds == "both";
+            options.guarded = bounds == "guarded" || bounds == "both";
+            if (!options.checked && !options.guarded) return false;
+        } else if (arg == "--threads") {
+            options.threads = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+            if (options.threads == 0) return false;
+        } else if (arg == "--seconds") {
+            options.seconds = std::atof(value);
+        } else if (arg == "--json") {
+            options.json = value;
+        } else if (arg == "--lib") {
+            options.libs.push_back(value);
+        } else {
+            std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+/** 1, 2, 4, ... below max, then max. */
+std::vector<uint32_t> thread_steps(uint32_t max) {
+    std::vector<uint32_t> steps;
+    for (uint32_t n = 1; n < max; n *= 2) steps.push_back(n);
+    steps.push_back(max);
+    return steps;
+}
+
+/** One thread's share of a step, written once when the thread stops. */
+struct alignas(64) ThreadResult {
+    std::vector<double> times;  // ns per run
+    int64_t gas = 0;
+    Clock::time_point end;
+    CacheCounters::Sample misses;
+    bool counted = false;       // Cache counters were available
+    bool counted_llc = false;
+    bool ok = true;
+};
+
+/** One step: a workload on one engine, bounds mode and thread count. */
+struct Step {
+    const char* workload = "";
+    std::string engine;
+    const char* bounds = "";
+    uint32_t threads = 0;
+    uint64_t runs = 0;
+    double runs_per_second = 0;
+    double mgas_per_second = 0;
+    double efficiency = 0;
+    double p50_ns = 0;
+    double p99_ns = 0;
+    double l1d_per_run = -1;    // Highest of any thread, -1 if not counted
+    double llc_per_run = -1;
+    bool contended = false;
+    bool ok = true;
+};
+
+/**
+ * Run program on threads threads for seconds. Every thread builds its own frame
+ * (first touched by that thread) and warms it up before the clock starts.
+ */
+Step run_step(const Engine& engine, const Program& program, bool guarded, uint32_t threads, double seconds) {
+    std::vector<ThreadResult> results(threads);
+    std::atomic<uint32_t> ready{0};
+    std::atomic<bool> go{false};
+    std::atomic<bool> stop{false};
+
+    auto worker = [&](ThreadResult& result) {
+        BenchFrame frame(engine, program, guarded);
+        double fastest = 0;
+        for (int i = 0; i < 3; i++) {
+            frame.reset();
+            auto t0 = Clock::now();
+            frame.run();
+            const double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+            if (i == 0 || ns < fastest) fastest = ns;
+        }
+        // Room for twice the runs the warm-up rate predicts, so the timed loop
+        // does not reallocate
+        std::vector<double> times;
+        times.reserve(static_cast<size_t>(2 * seconds * 1e9 / std::max(fastest, 1.0)) + 1024);
+        int64_t gas = 0;
+        bool ok = true;
+        CacheCounters counters;
+
+        ready.fetch_add(1);
+        while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+
+        const CacheCounters::Sample c0 = counters.read();
+        while (!stop.load(std::memory_order_relaxed)) {
+            frame.reset();
+            auto t0 = Clock::now();
+            frame.run();
+            auto t1 = Clock::now();
+            times.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+            gas += frame.gasUsed();
+            ok = ok && frame.succeeded();
+        }
+        const CacheCounters::Sample c1 = counters.read();
+        result.end = Clock::now();
+        result.times = std::move(times);
+        result.gas = gas;
+        result.ok = ok;
+        result.counted = counters.available();
+        result.misses.l1d_misses = c1.l1d_misses - c0.l1d_misses;
+        result.counted_llc = counters.hasLastLevel();
+        result.misses.llc_misses = c1.llc_misses - c0.llc_misses;
+    };
+
+    std::vector<std::thread> pool;
+    for (uint32_t i = 0; i < threads; i++) pool.emplace_back(worker, std::ref(results[i]));
+    while (ready.load() < threads) std::this_thread::yield();
+
+    const Clock::time_point start = Clock::now();
+    go.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop.store(true, std::memory_order_relaxed);
+    for (std::thread& thread : pool) thread.join();
+
+    Step step;
+    step.threads = threads;
+    std::vector<double> times;
+    Clock::time_point end = start;
+    int64_t gas = 0;
+    for (const ThreadResult& result : results) {
+        times.insert(times.end(), result.times.begin(), result.times.end());
+        end = std::max(end, result.end);
+        gas += result.gas;
+        step.ok = step.ok && result.ok;
+        if (result.counted && !result.times.empty()) {
+            const double runs = static_cast<double>(result.times.size());
+            step.l1d_per_run = std::max(step.l1d_per_run, result.misses.l1d_misses / runs);
+            if (result.counted_llc) step.llc_per_run = std::max(step.llc_per_run, result.misses.llc_misses / runs);
+        }
+    }
+
+    step.runs = times.size();
+    const double elapsed = std::chrono::duration<double>(end - start).count();
+    if (step.runs > 0 && elapsed > 0) {
+        std::sort(times.begin(), times.end());
+        step.p50_ns = times[times.size() / 2];
+        step.p99_ns = times[std::min(times.size() - 1, times.size() * 99 / 100)];
+        step.runs_per_second = step.runs / elapsed;
+        step.mgas_per_second = gas / elapsed / 1e6;
+    }
+    return step;
+}
+
+std::string format_misses(double value) {
+    if (value < 0) return "n/a";
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.0f", value);
+    return buffer;
+}
+
+std::string json_misses(double value) {
+    if (value < 0) return "null";
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.1f", value);
+    return buffer;
+}
+
+bool write_json(const std::string& path, const std::vector<Step>& steps) {
+    FILE* out = std::fopen(path.c_str(), "w");
+    if (!out) return false;
+    std::fprintf(out, "{\n  \"hardware_threads\": %u,\n  \"results\": [\n", std::thread::hardware_concurrency());
+    for (size_t i = 0; i < steps.size(); i++) {
+        const Step& s = steps[i];
+        std::fprintf(out,
+                     "    {\"workload\": \"%s\", \"dispatch\": \"%s\", \"bounds\": \"%s\", \"threads\": %u, "
+                     "\"runs\": %llu, \"runs_per_second\": %.1f, \"mgas_per_second\": %.1f, "
+                     "\"efficiency\": %.3f, \"p50_ns\": %.0f, \"p99_ns\": %.0f, "
+                     "\"l1d_misses_per_run\": %s, \"llc_misses_per_run\": %s, "
+                     "\"contended\": %s, \"ok\": %s}%s\n",
+                     s.workload, s.engine.c_str(), s.bounds, s.threads, static_cast<unsigned long long>(s.runs),
+                     s.runs_per_second, s.mgas_per_second, s.efficiency, s.p50_ns, s.p99_ns,
+                     json_misses(s.l1d_per_run).c_str(), json_misses(s.llc_per_run).c_str(), s.contended ? "true" : "false", s.ok ? "true" : "false",
+                     i + 1 < steps.size() ? "," : "");
+    }
+    std::fprintf(out, "  ]\n}\n");
+    return std::fclose(out) == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse(argc, argv, options)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::string error;
+    std::vector<Engine> engines = load_engines(options.libs, BESU_BENCH_VARIANT_DIR, options.variant, error);
+    if (engines.empty()) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    std::vector<Workload> selected;
+    for (const Workload& workload : workloads()) {
+        if (options.workload.empty() || options.workload == workload.name) selected.push_back(workload);
+    }
+    if (selected.empty()) {
+        std::fprintf(stderr, "Unknown workload %s\n", options.workload.c_str());
+        return 1;
+    }
+
+    const uint32_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    const uint32_t max_threads = options.threads ? options.threads : hardware;
+    if (!CacheCounters().available()) {
+        std::fprintf(stderr, "Cache counters unavailable (perf_event_paranoid or no PMU): misses are n/a\n");
+    }
+    if (max_threads > hardware) {
+        std::fprintf(stderr, "%u threads on %u hardware threads: steps above %u are oversubscribed\n",
+                     max_threads, hardware, hardware);
+    }
+
+    std::printf("%-16s %-9s %-8s %7s %12s %10s %6s %10s %10s %10s %10s\n", "workload", "dispatch", "bounds",
+                "threads", "runs/s", "Mgas/s", "eff", "p50 ns", "p99 ns", "L1D/run", "LLC/run");
+
+    std::vector<Step> steps;
+    int failures = 0;
+    for (const Workload& workload : selected) {
+        const Program program = workload.build();
+        for (const Engine& engine : engines) {
+            for (int mode = 0; mode < 2; mode++) {
+                const bool guarded = mode == 1;
+                if ((guarded && !options.guarded) || (!guarded && !options.checked)) continue;
+                if (guarded && !engine.hasGuardedFrames()) continue;
+                if (guarded && !BenchFrame(engine, program, true).guarded()) continue;  // Unsupported at runtime
+
+                Step single;  // The 1-thread step every other step is compared with
+                for (uint32_t threads : thread_steps(max_threads)) {
+                    Step step = run_step(engine, program, guarded, threads, options.seconds);
+                    step.workload = workload.name;
+                    step.engine = engine.name;
+                    step.bounds = guarded ? "guarded" : "checked";
+                    if (threads == 1) single = step;
+                    if (single.runs_per_second > 0) {
+                        step.efficiency = step.runs_per_second / (threads * single.runs_per_second);
+                    }
+                    if (threads > 1 && step.l1d_per_run >= 0 && single.l1d_per_run >= 0) {
+                        const auto grew = [](double now, double base) {
+                            return now >= CONTENTION_FLOOR && now > CONTENTION_RATIO * std::max(base, 1.0);
+                        };
+                        step.contended = grew(step.l1d_per_run, single.l1d_per_run) ||
+                                         (step.llc_per_run >= 0 && grew(step.llc_per_run, single.llc_per_run));
+                    }
+                    steps.push_back(step);
+                    failures += !step.ok;
+
+                    std::printf("%-16s %-9s %-8s %7u %12.0f %10.1f %6.2f %10.0f %10.0f %10s %10s%s%s\n",
+                                workload.name, engine.name.c_str(), step.bounds, threads, step.runs_per_second,
+                                step.mgas_per_second, step.efficiency, step.p50_ns, step.p99_ns,
+                                format_misses(step.l1d_per_run).c_str(), format_misses(step.llc_per_run).c_str(),
+                                step.contended ? "  CACHE CONTENTION" : "", step.ok ? "" : "  FAILED");
+                    std::fflush(stdout);
+                }
+            }
+        }
+    }
+
+    if (!options.json.empty() && !write_json(options.json, steps)) {
+        std::fprintf(stderr, "Cannot write %s\n", options.json.c_str());
+        return 1;
+    }
+    return failures == 0 ? 0 : 1;
+}
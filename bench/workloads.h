@@ -0,0 +1,376 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "bench_util.h"
+#include "keccak.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace besu {
+namespace evm {
+namespace bench {
+
+/**
+ * Contract workloads for the native benchmarks.
+ *
+ * Each program is the hot path of a well-known contract, hand-assembled from the
+ * opcodes the native interpreter implements (arithmetic is 64-bit). Solidity
+ * output cannot run as-is: CALLDATALOAD, LOG, RETURN and friends are still
+ * handled on the Java side. Storage layouts match Solidity's (mapping slots are
+ * keccak256(key . slot)), so SLOAD/SSTORE see realistic keys and access patterns.
+ *
+ * Every program ends in STOP; a failed check jumps to INVALID, so a workload
+ * that does not run to completion shows up as a failure instead of a fast number.
+ */
+
+namespace workload {
+
+typedef uint8_t Word[32];
+
+inline void to_word(uint64_t value, Word out) {
+    std::memset(out, 0, 32);
+    for (int i = 31; i >= 24; i--) {
+        out[i] = static_cast<uint8_t>(value);
+        value >>= 8;
+    }
+}
+
+inline void address_word(const uint8_t* address, Word out) {
+    std::memset(out, 0, 12);
+    std::memcpy(out + 12, address, 20);
+}
+
+/** Solidity mapping slot: keccak256(key . slot). */
+inline void mapping_slot(const Word key, uint64_t slot, Word out) {
+    uint8_t preimage[64];
+    std::memcpy(preimage, key, 32);
+    to_word(slot, preimage + 32);
+    keccak::keccak256(preimage, 64, out);
+}
+
+inline void set_slot(Program& program, const Word key, uint64_t value) {
+    StorageInit init;
+    std::memcpy(init.key, key, 32);
+    to_word(value, init.value);
+    program.storage.push_back(init);
+}
+
+inline void set_slot(Program& program, uint64_t key, uint64_t value) {
+    Word word;
+    to_word(key, word);
+    set_slot(program, word, value);
+}
+
+/** Set a mapping(address => uint) entry. */
+inline void set_balance(Program& program, const uint8_t* address, uint64_t slot, uint64_t value) {
+    Word key, entry;
+    address_word(address, key);
+    mapping_slot(key, slot, entry);
+    set_slot(program, entry, value);
+}
+
+constexpr uint8_t TOKEN[20] = {0xa0, 0xb8, 0x69, 0x91, 0xc6, 0x21, 0x8b, 0x36, 0xc1, 0xd1,
+                               0x9d, 0x4a, 0x2e, 0x9e, 0xb0, 0xce, 0x36, 0x06, 0xeb, 0x48};
+constexpr uint8_t ALICE[20] = {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                               0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11};
+constexpr uint8_t BOB[20] = {0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+                             0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22};
+constexpr uint8_t PAIR[20] = {0xb4, 0xe1, 0x6d, 0x01, 0x68, 0xe5, 0x2d, 0x35, 0xca, 0xcd,
+                              0x2c, 0x61, 0x85, 0xb4, 0x42, 0x81, 0xec, 0x28, 0xc9, 0xdc};
+
+constexpr uint64_t TRANSFER_AMOUNT = 250000;
+
+/** Stack: [key] -> [keccak256(key . slot)], using memory [0, 64). */
+inline Assembler& emit_mapping_slot(Assembler& a, uint64_t slot) {
+    a.push(0).op(opcodes::MSTORE);
+    a.push(slot).push(32).op(opcodes::MSTORE);
+    return a.push(64).push(0).op(opcodes::KECCAK256);
+}
+
+inline Assembler& push_address(Assembler& a, const uint8_t* address) {
+    return a.push_bytes(address, 20);
+}
+
+inline Assembler& emit_revert(Assembler& a) {
+    return a.label("revert").op(opcodes::INVALID);
+}
+
+/** ERC20.transfer(BOB, amount) from ALICE: balanceOf is slot 0. */
+inline Program erc20_transfer() {
+    Assembler a;
+    push_address(a, ALICE);
+    emit_mapping_slot(a, 0);                                // [sFrom]
+    a.dup(1).op(opcodes::SLOAD);                            // [bal, sFrom]
+    a.dup(1).push(TRANSFER_AMOUNT).op(opcodes::GT);         // [amount > bal, bal, sFrom]
+    a.jumpi("revert");
+    a.push(TRANSFER_AMOUNT).swap(1).op(opcodes::SUB);       // [bal - amount, sFrom]
+    a.swap(1).op(opcodes::SSTORE);                          // []
+
+    push_address(a, BOB);
+    emit_mapping_slot(a, 0);                                // [sTo]
+    a.dup(1).op(opcodes::SLOAD);                            // [bal, sTo]
+    a.push(TRANSFER_AMOUNT).op(opcodes::ADD);               // [bal + amount, sTo]
+    a.dup(1).push(TRANSFER_AMOUNT).op(opcodes::GT);         // [overflowed, sum, sTo]
+    a.jumpi("revert");
+    a.swap(1).op(opcodes::SSTORE);
+    a.op(opcodes::STOP);
+    emit_revert(a);
+
+    Program program;
+    program.code = a.build();
+    std::memcpy(program.contract, TOKEN, 20);
+    set_balance(program, ALICE, 0, 1000000000000000000ULL);
+    set_balance(program, BOB, 0, 42);
+    return program;
+}
+
+/** ERC20.approve(BOB, amount) from ALICE: allowance is slot 1, a nested mapping. */
+inline Program erc20_approve() {
+    Assembler a;
+    push_address(a, ALICE);
+    emit_mapping_slot(a, 1);                                // [inner]
+    push_address(a, BOB);
+    a.push(0).op(opcodes::MSTORE);                          // mem[0] = spender
+    a.push(32).op(opcodes::MSTORE);                         // mem[32] = inner
+    a.push(64).push(0).op(opcodes::KECCAK256);              // [slot]
+    a.push(TRANSFER_AMOUNT).swap(1).op(opcodes::SSTORE);
+    a.op(opcodes::STOP);
+
+    Program program;
+    program.code = a.build();
+    std::memcpy(program.contract, TOKEN, 20);
+    return program;
+}
+
+/**
+ * UniswapV2Pair.swap(0, amountOut, BOB) after 1000 token0 were sent to the pair:
+ * lock, getAmountOut with the 0.3% fee, token transfer, the constant-product
+ * check, price accumulators and the reserve update.
+ *
+ * Both tokens' balance mappings live in the pair's storage (slots 10 and 11),
+ * standing in for the token contracts' balanceOf calls.
+ */
+inline Program uniswap_v2_swap() {
+    constexpr uint64_t RESERVE0 = 8, RESERVE1 = 9, TIMESTAMP = 12;
+    constexpr uint64_t PRICE0 = 13, PRICE1 = 14, LOCK = 15;
+    constexpr uint64_t BALANCE0 = 10, BALANCE1 = 11;
+    constexpr uint64_t NOW = 1700000000, ELAPSED = 12;
+    constexpr uint64_t RESERVE = 1000000, AMOUNT_IN = 1000;
+
+    Assembler a;
+    // lock modifier: unlocked == 1
+    a.push(LOCK).op(opcodes::SLOAD).push(1).op(opcodes::EQ).op(opcodes::ISZERO).jumpi("revert");
+    a.push(2).push(LOCK).op(opcodes::SSTORE);
+
+    a.push(RESERVE0).op(opcodes::SLOAD);                    // [r0]
+    a.push(RESERVE1).op(opcodes::SLOAD);                    // [r1, r0]
+    push_address(a, PAIR);
+    emit_mapping_slot(a, BALANCE0).op(opcodes::SLOAD);      // [bal0, r1, r0]
+
+    // amountOut = in * 997 * r1 / (r0 * 1000 + in * 997)
+    a.dup(3).dup(2).op(opcodes::SUB);                       // [in, bal0, r1, r0]
+    a.push(997).op(opcodes::MUL);                           // [in997, bal0, r1, r0]
+    a.dup(1).dup(4).op(opcodes::MUL);                       // [num, in997, bal0, r1, r0]
+    a.swap(1);                                              // [in997, num, ...]
+    a.dup(5).push(1000).op(opcodes::MUL).op(opcodes::ADD);  // [den, num, ...]
+    a.swap(1).op(opcodes::DIV);                             // [out, bal0, r1, r0]
+    a.dup(3).dup(2).op(opcodes::LT).op(opcodes::ISZERO).jumpi("revert");
+
+    // token1.transfer(BOB, out)
+    push_address(a, PAIR);
+    emit_mapping_slot(a, BALANCE1);                         // [s1, out, bal0, r1, r0]
+    a.dup(1).op(opcodes::SLOAD);                            // [bal1, s1, out, ...]
+    a.dup(3).swap(1).op(opcodes::SUB);                      // [bal1 - out, s1, out, ...]
+    a.dup(1).swap(2).op(opcodes::SSTORE);                   // [bal1, out, bal0, r1, r0]
+    push_address(a, BOB);
+    emit_mapping_slot(a, BALANCE1);                         // [sTo, bal1, out, ...]
+    a.dup(1).op(opcodes::SLOAD).dup(4).op(opcodes::ADD);
+    a.swap(1).op(opcodes::SSTORE);                          // [bal1, out, bal0, r1, r0]
+
+    // require(bal0Adj * bal1Adj >= r0 * r1 * 1000^2)
+    a.dup(5).dup(4).op(opcodes::SUB);                       // [in, bal1, out, bal0, r1, r0]
+    a.push(3).op(opcodes::MUL);
+    a.dup(4).push(1000).op(opcodes::MUL).op(opcodes::SUB);  // [bal0Adj, bal1, ...]
+    a.dup(2).push(1000).op(opcodes::MUL).op(opcodes::MUL);  // [lhs, bal1, ...]
+    a.dup(6).dup(6).op(opcodes::MUL).push(1000000).op(opcodes::MUL);
+    a.op(opcodes::GT).jumpi("revert");                      // [bal1, out, bal0, r1, r0]
+
+    // _update: price accumulators, reserves, timestamp
+    a.push(PRICE0).op(opcodes::SLOAD);
+    a.dup(6).dup(6).push(1000000).op(opcodes::MUL).op(opcodes::DIV);
+    a.push(ELAPSED).op(opcodes::MUL).op(opcodes::ADD).push(PRICE0).op(opcodes::SSTORE);
+    a.push(PRICE1).op(opcodes::SLOAD);
+    a.dup(5).dup(7).push(1000000).op(opcodes::MUL).op(opcodes::DIV);
+    a.push(ELAPSED).op(opcodes::MUL).op(opcodes::ADD).push(PRICE1).op(opcodes::SSTORE);
+    a.dup(3).push(RESERVE0).op(opcodes::SSTORE);
+    a.dup(1).push(RESERVE1).op(opcodes::SSTORE);
+    a.push(NOW).push(TIMESTAMP).op(opcodes::SSTORE);
+    a.push(1).push(LOCK).op(opcodes::SSTORE);
+    for (int i = 0; i < 5; i++) a.op(opcodes::POP);
+    a.op(opcodes::STOP);
+    emit_revert(a);
+
+    Program program;
+    program.code = a.build();
+    std::memcpy(program.contract, PAIR, 20);
+    set_slot(program, RESERVE0, RESERVE);
+    set_slot(program, RESERVE1, RESERVE);
+    set_slot(program, TIMESTAMP, NOW - ELAPSED);
+    set_slot(program, PRICE0, 7000000);
+    set_slot(program, PRICE1, 7000000);
+    set_slot(program, LOCK, 1);
+    set_balance(program, PAIR, BALANCE0, RESERVE + AMOUNT_IN);
+    set_balance(program, PAIR, BALANCE1, RESERVE);
+    set_balance(program, BOB, BALANCE1, 5);
+    return program;
+}
+
+/** 1000 chained keccak256 over one 32-byte word. */
+inline Program keccak_loop() {
+    Assembler a;
+    a.push(0x5eed).push(0).op(opcodes::MSTORE);
+    a.push(1000);                                           // [i]
+    a.label("loop");
+    a.push(32).push(0).op(opcodes::KECCAK256);              // [h, i]
+    a.push(0).op(opcodes::MSTORE);                          // [i]
+    a.push(1).swap(1).op(opcodes::SUB);                     // [i - 1]
+    a.dup(1).jumpi("loop");
+    a.op(opcodes::POP).op(opcodes::STOP);
+
+    Program program;
+    program.code = a.build();
+    std::memcpy(program.contract, TOKEN, 20);
+    return program;
+}
+
+/** Write 50 fresh slots, then read, sum and overwrite each of them. */
+inline Program storage_loop() {
+    constexpr uint64_t SLOTS = 50;
+
+    Assembler a;
+    a.push(0);                                              // [i]
+    a.label("fill");
+    a.dup(1).dup(1).op(opcodes::SSTORE);                    // slot i = i
+    a.push(1).op(opcodes::ADD);
+    a.dup(1).push(SLOTS).op(opcodes::GT).jumpi("fill");
+    a.op(opcodes::POP);
+
+    a.push(0).push(0);                                      // [i, sum]
+    a.label("read");
+    a.dup(1).op(opcodes::SLOAD);                            // [v, i, sum]
+    a.dup(3).op(opcodes::ADD);                              // [sum + v, i, sum]
+    a.swap(2).op(opcodes::POP);                             // [i, sum]
+    a.dup(2).dup(2).op(opcodes::SSTORE);                    // slot i = sum
+    a.push(1).op(opcodes::ADD);
+    a.dup(1).push(SLOTS).op(opcodes::GT).jumpi("read");
+    a.op(opcodes::POP).op(opcodes::POP).op(opcodes::STOP);
+
+    Program program;
+    program.code = a.build();
+    std::memcpy(program.contract, TOKEN, 20);
+    program.max_storage_slots = 64;
+    return program;
+}
+
+/** Fill 4 KB of memory, then copy it word by word four times. */
+inline Program memory_copy() {
+    constexpr uint64_t SIZE = 4096;
+
+    Assembler a;
+    a.push(0);                                              // [off]
+    a.label("fill");
+    a.dup(1).push(7).op(opcodes::MUL).push(1).op(opcodes::ADD);
+    a.dup(2).op(opcodes::MSTORE);                           // mem[off] = off * 7 + 1
+    a.push(32).op(opcodes::ADD);
+    a.dup(1).push(SIZE).op(opcodes::GT).jumpi("fill");
+    a.op(opcodes::POP);
+
+    a.push(4);                                              // [pass]
+    a.label("pass");
+    a.push(0);                                              // [off, pass]
+    a.label("copy");
+    a.dup(1).op(opcodes::MLOAD);                            // [v, off, pass]
+    a.dup(2).push(SIZE).op(opcodes::ADD).op(opcodes::MSTORE);
+    a.push(32).op(opcodes::ADD);
+    a.dup(1).push(SIZE).op(opcodes::GT).jumpi("copy");
+    a.op(opcodes::POP);
+    a.push(1).swap(1).op(opcodes::SUB);
+    a.dup(1).jumpi("pass");
+    a.op(opcodes::POP).op(opcodes::STOP);
+
+    Program program;
+    program.code = a.build();
+    std::memcpy(program.contract, TOKEN, 20);
+    return program;
+}
+
+/**
+ * Snailtracer-style compute: shade a 32x32 image of a sphere (ray/sphere test,
+ * Newton square root for the depth), writing one byte per pixel.
+ */
+inline Program snailtracer() {
+    constexpr uint64_t WIDTH = 32, PIXELS = WIDTH * WIDTH, SCALE = 1000;
+    constexpr uint64_t CENTER = 16 * SCALE, RADIUS = 12 * SCALE;
+
+    Assembler a;
+    a.push(0).push(0);                                      // [i, acc]
+    a.label("pixel");
+    a.push(WIDTH).dup(2).op(opcodes::MOD).push(SCALE).op(opcodes::MUL);  // [x, i, acc]
+    a.push(WIDTH).dup(3).op(opcodes::DIV).push(SCALE).op(opcodes::MUL);  // [y, x, i, acc]
+    a.push(CENTER).swap(1).op(opcodes::SUB).dup(1).op(opcodes::MUL);
+    a.swap(1).push(CENTER).swap(1).op(opcodes::SUB);
+    a.dup(1).op(opcodes::MUL).op(opcodes::ADD);             // [d2, i, acc]
+
+    a.dup(1).push(RADIUS * RADIUS).op(opcodes::GT).op(opcodes::ISZERO).jumpi("miss");
+    a.push(RADIUS * RADIUS).op(opcodes::SUB);               // [z2, i, acc]
+    a.push(RADIUS);                                         // [z, z2, i, acc]
+    for (int i = 0; i < 4; i++) {
+        a.dup(1).dup(3).op(opcodes::DIV).op(opcodes::ADD);
+        a.push(2).swap(1).op(opcodes::DIV);                 // z = (z + z2 / z) / 2
+    }
+    a.swap(1).op(opcodes::POP);                             // [z, i, acc]
+    a.push(255).op(opcodes::MUL).push(RADIUS).swap(1).op(opcodes::DIV);  // [color, i, acc]
+    a.jump("shade");
+    a.label("miss");
+    a.op(opcodes::POP).push(16);                            // [background, i, acc]
+
+    a.label("shade");
+    a.dup(1).dup(3).op(opcodes::MSTORE8);                   // image[i] = color
+    a.dup(3).op(opcodes::ADD).swap(2).op(opcodes::POP);     // [i, acc]
+    a.push(1).op(opcodes::ADD);
+    a.dup(1).push(PIXELS).op(opcodes::GT).jumpi("pixel");
+    a.op(opcodes::POP).push(2 * PIXELS).op(opcodes::MSTORE);
+    a.op(opcodes::STOP);
+
+    Program program;
+    program.code = a.build();
+    std::memcpy(program.contract, TOKEN, 20);
+    return program;
+}
+
+} // namespace workload
+
+struct Workload {
+    const char* name;
+    Program (*build)();
+};
+
+/** All contract workloads, in report order. */
+inline std::vector<Workload> workloads() {
+    return {
+        {"erc20_transfer", workload::erc20_transfer},
+        {"erc20_approve", workload::erc20_approve},
+        {"uniswap_v2_swap", workload::uniswap_v2_swap},
+        {"keccak_loop", workload::keccak_loop},
+        {"storage_loop", workload::storage_loop},
+        {"memory_copy", workload::memory_copy},
+        {"snailtracer", workload::snailtracer},
+    };
+}
+
+} // namespace bench
+} // namespace evm
+} // namespace besu
@@ -118,8 +118,12 @@ else
     echo -e "${BLUE}Output: $OUTPUT${NC}"
     echo ""
 
+    # Same sources as the CMake build (the SOURCES list in CMakeLists.txt)
+    SOURCES=$(sed -n '/^set(SOURCES/,/^)/p' CMakeLists.txt | grep -o 'src/[A-Za-z0-9_]*\.cpp' | tr '\n' ' ')
+    echo -e "${BLUE}Sources: $SOURCES${NC}"
+
     # Compile
-    c++ $FLAGS -o "$OUTPUT" src/evm_optimized.cpp -I./include
+    c++ $FLAGS -o "$OUTPUT" $SOURCES -I./include -pthread
 
     echo -e "${GREEN}Build complete!${NC}"
     echo -e "${GREEN}Library: $(pwd)/$OUTPUT${NC}"
@@ -0,0 +1,118 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace besu {
+namespace evm {
+
+/**
+ * Native bump arena for frame pools, witnesses and code stores.
+ *
+ * Block-level witnesses and frame pools can run to tens of MB. Backing them with
+ * 2 MB pages cuts dTLB misses on witness scans and frame reuse. Java allocates
+ * through these entry points and wraps the returned pointers with
+ * MemorySegment.ofAddress(), so the layout structs are unchanged.
+ *
+ * Page selection (requested via flags, best effort):
+ * - ARENA_HUGE_EXPLICIT:    mmap(MAP_HUGETLB) from the hugetlbfs pool,
+ *                           falling back to transparent huge pages
+ * - ARENA_HUGE_TRANSPARENT: 2 MB aligned anonymous mapping + madvise(MADV_HUGEPAGE),
+ *                           falling back to regular pages
+ * - ARENA_HUGE_NONE:        regular anonymous pages
+ *
+ * The page type actually obtained is reported by besu_arena_stats(). For transparent
+ * huge pages the kernel decides at fault time, so huge_bytes is read back from
+ * /proc/self/smaps rather than assumed.
+ *
+ * On multi-socket machines besu_arena_create_on_node() binds the pages to one NUMA
+ * node so a worker's frames and witnesses stay local to the socket it runs on.
+ *
+ * Arenas are NOT thread-safe: use one arena per worker thread.
+ */
+
+/** Requested page backing (flags for besu_arena_create). */
+enum ArenaFlags : uint32_t {
+    ARENA_HUGE_NONE        = 0,
+    ARENA_HUGE_TRANSPARENT = 1u << 0,
+    ARENA_HUGE_EXPLICIT    = 1u << 1,
+};
+
+/** Page backing actually obtained (ArenaStats::page_type). */
+enum ArenaPageType : uint32_t {
+    ARENA_PAGES_HEAP             = 0,  // malloc fallback (no mmap available)
+    ARENA_PAGES_REGULAR          = 1,  // Base pages (4 KB / 16 KB)
+    ARENA_PAGES_TRANSPARENT_HUGE = 2,  // THP advised on a 2 MB aligned range
+    ARENA_PAGES_EXPLICIT_HUGE    = 3,  // MAP_HUGETLB reserved pages
+};
+
+/**
+ * Arena statistics (shared with Java via Panama FFM).
+ * CRITICAL: Must match ArenaStatsLayout.java.
+ */
+struct ArenaStats {
+    uint64_t capacity;     // Bytes reserved for the arena
+    uint64_t used;         // Bytes currently handed out
+    uint64_t high_water;   // Maximum of used since creation
+    uint64_t huge_bytes;   // Bytes actually backed by huge pages
+    uint64_t allocations;  // Successful besu_arena_alloc calls
+    uint64_t resets;       // besu_arena_reset calls
+    uint32_t page_type;    // ArenaPageType
+    uint32_t page_size;    // Page size in bytes for page_type
+    int32_t  numa_node;    // Node the pages are bound to (-1 = unbound / first touch)
+    uint32_t reserved;
+};
+
+static_assert(sizeof(ArenaStats) == 64, "ArenaStats must be 64 bytes");
+
+constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+struct Arena;
+
+extern "C" {
+
+/**
+ * Create an arena of at least capacity bytes.
+ * @param capacity Requested size (rounded up to the page size obtained)
+ * @param flags ArenaFlags
+ * @return Arena handle, or nullptr if no memory could be reserved at all
+ */
+Arena* besu_arena_create(uint64_t capacity, uint32_t flags);
+
+/**
+ * Create an arena whose pages are bound to a NUMA node (mbind before first touch).
+ * If binding is unavailable (single node, non-Linux) the arena is still created and
+ * relies on first-touch placement by the calling thread; stats report numa_node = -1.
+ * @param node NUMA node, or -1 for the calling thread's current node
+ */
+Arena* besu_arena_create_on_node(uint64_t capacity, uint32_t flags, int32_t node);
+
+/**
+ * Bump-allocate size bytes.
+ * @param alignment Power of two (0 = 64-byte cache line), applied to the address
+ * @return Pointer into the arena, or nullptr if exhausted
+ */
+void* besu_arena_alloc(Arena* arena, uint64_t size, uint64_t alignment);
+
+/**
+ * Release every allocation at once. Pages stay mapped (and stay huge).
+ */
+void besu_arena_reset(Arena* arena);
+
+/**
+ * Unmap the arena. Pointers handed out become invalid.
+ */
+void besu_arena_destroy(Arena* arena);
+
+/**
+ * Fill stats for the arena.
+ */
+void besu_arena_stats(const Arena* arena, ArenaStats* out);
+
+} // extern "C"
+
+} // namespace evm
+} // namespace besu
@@ -0,0 +1,129 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "account_witness.h"
+#include "arena.h"
+#include "storage_memory.h"
+#include <cstdint>
+
+namespace besu {
+namespace evm {
+
+/**
+ * Double-buffered block pipeline: prepare block N+1 while block N executes.
+ *
+ * The pipeline owns two buffers, each with a witness arena and a frame arena. A
+ * background stage takes the next submitted block and, into the free buffer:
+ * 1. Copies the raw witness (TransactionWitness at offset 0, offsets relative to it)
+ * 2. Builds hash indexes over its accounts and storage slots (witness_index.h)
+ * 3. Analyses the jump destinations of every contract's code (code_analysis.h)
+ * 4. Records the hot set: warm (access-listed) entries, index tables and code heads
+ *
+ * besu_pipeline_acquire() hands the next block to the executing thread in
+ * submission order and issues software prefetches over its hot set there, so the
+ * first transactions start on warm caches. The buffer is returned with
+ * besu_pipeline_release(), which resets both of its arenas for block N+2.
+ *
+ *   submit(N+1) ──► [prepare stage] ──► buffer B ready
+ *   acquire(N)  ──► execute on buffer A ──► release(A)
+ *
+ * Single producer (submit) and single consumer (acquire/release).
+ */
+
+/** PreparedBlock::status values. */
+enum PipelineStatus : uint32_t {
+    PIPELINE_OK               = 0,
+    PIPELINE_MALFORMED        = 1,  // Witness offsets/counts out of range
+    PIPELINE_ARENA_EXHAUSTED  = 2,  // Witness arena too small for copy + indexes
+};
+
+/**
+ * A prepared block (shared with Java via Panama FFM, read only).
+ * Pointers are absolute and stay valid until besu_pipeline_release().
+ */
+struct PreparedBlock {
+    uint64_t       block_number;
+    uint32_t       status;              // PipelineStatus
+    uint32_t       account_count;
+    uint32_t       storage_count;
+    uint32_t       code_count;          // Accounts with analysed code
+    uint8_t*       witness;             // Witness copy (TransactionWitness at offset 0)
+    uint64_t       witness_size;
+    AccountEntry*  accounts;
+    StorageEntry*  storage;
+    uint32_t*      account_index;       // Open-addressing slots (entry index + 1, 0 = empty)
+    uint32_t*      storage_index;
+    uint32_t       account_index_mask;
+    uint32_t       storage_index_mask;
+    uint8_t**      jumpdests;           // Per account jumpdest bitmap (nullptr = no code)
+    Arena*         frame_arena;         // Frames for executing this block
+    uint64_t       prepare_ns;          // Time spent in the prepare stage
+};
+
+/**
+ * Pipeline statistics (shared with Java via Panama FFM).
+ */
+struct BlockPipelineStats {
+    uint64_t submitted;       // Blocks submitted
+    uint64_t prepared;        // Blocks prepared successfully
+    uint64_t failed;          // Blocks prepared with a non-OK status
+    uint64_t prepare_ns;      // Total prepare stage time
+    uint64_t acquire_wait_ns; // Time acquire blocked on an unfinished block (not overlapped)
+    uint64_t submit_wait_ns;  // Time submit blocked on a busy buffer
+};
+
+struct BlockPipeline;
+
+extern "C" {
+
+/**
+ * Create a pipeline and start its prepare stage.
+ * @param witness_bytes Per-buffer arena for the witness copy, indexes and bitmaps
+ * @param frame_bytes Per-buffer arena for execution frames (0 = none)
+ * @param arena_flags ArenaFlags for all four arenas
+ * @return Pipeline, or nullptr if the arenas could not be created
+ */
+BlockPipeline* besu_pipeline_create(uint64_t witness_bytes, uint64_t frame_bytes,
+                                    uint32_t arena_flags);
+
+/**
+ * Queue the next block for preparation. Blocks while both buffers are in use.
+ * The witness bytes are copied by the prepare stage: keep them alive until the
+ * block has been acquired.
+ * @return false if the pipeline is shutting down
+ */
+bool besu_pipeline_submit(BlockPipeline* pipeline, uint64_t block_number,
+                          const uint8_t* witness, uint64_t witness_size);
+
+/**
+ * Take the next prepared block (in submission order), waiting for its preparation
+ * if needed. Prefetches the block's hot set into the calling thread's caches.
+ * @return Prepared block, or nullptr if nothing is submitted
+ */
+const PreparedBlock* besu_pipeline_acquire(BlockPipeline* pipeline);
+
+/**
+ * Return an acquired block's buffer to the prepare stage.
+ */
+void besu_pipeline_release(BlockPipeline* pipeline, const PreparedBlock* block);
+
+/**
+ * Indexed lookups on a prepared block. Return nullptr if not found.
+ */
+AccountEntry* besu_pipeline_find_account(const PreparedBlock* block, const uint8_t* address);
+StorageEntry* besu_pipeline_find_storage(const PreparedBlock* block,
+                                         const uint8_t* address, const uint8_t* key);
+
+void besu_pipeline_stats(const BlockPipeline* pipeline, BlockPipelineStats* out);
+
+/**
+ * Stop the prepare stage and release both buffers.
+ */
+void besu_pipeline_destroy(BlockPipeline* pipeline);
+
+} // extern "C"
+
+} // namespace evm
+} // namespace besu
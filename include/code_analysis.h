@@ -0,0 +1,146 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "opcode_table.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace besu {
+namespace evm {
+
+/**
+ * Bytecode pre-analysis.
+ *
+ * A jumpdest bitmap has one bit per code byte, set when the byte is a JUMPDEST
+ * opcode (0x5b) and not part of PUSH immediate data. Bit i lives in
+ * bitmap[i / 8] at position i % 8.
+ */
+namespace code_analysis {
+
+constexpr uint8_t OP_SLOAD = 0x54;
+constexpr uint8_t OP_SSTORE = 0x55;
+constexpr uint8_t OP_JUMPDEST = 0x5b;
+constexpr uint8_t OP_PUSH1 = 0x60;
+constexpr uint8_t OP_PUSH32 = 0x7f;
+
+constexpr int STACK_LIMIT = 1024;
+
+/**
+ * Bytes needed for the jumpdest bitmap of code_size bytes of code.
+ */
+inline uint32_t jumpdest_bitmap_size(uint32_t code_size) {
+    return (code_size + 7) / 8;
+}
+
+/**
+ * Fill bitmap (jumpdest_bitmap_size(size) bytes) with the valid jump destinations.
+ */
+inline void analyze_jumpdests(const uint8_t* code, uint32_t size, uint8_t* bitmap) {
+    memset(bitmap, 0, jumpdest_bitmap_size(size));
+    for (uint32_t pc = 0; pc < size; pc++) {
+        uint8_t op = code[pc];
+        if (op == OP_JUMPDEST) {
+            bitmap[pc >> 3] |= static_cast<uint8_t>(1u << (pc & 7));
+        } else if (op >= OP_PUSH1 && op <= OP_PUSH32) {
+            pc += op - OP_PUSH1 + 1;  // Skip immediate data
+        }
+    }
+}
+
+/**
+ * Check a jump destination against an analysed bitmap.
+ */
+inline bool is_jumpdest(const uint8_t* bitmap, uint32_t code_size, uint64_t dest) {
+    return dest < code_size && ((bitmap[dest >> 3] >> (dest & 7)) & 1) != 0;
+}
+
+/**
+ * Call fn(immediate, length) for every SLOAD/SSTORE whose key is pushed by the
+ * PUSH right before it, the usual pattern for fixed storage variables. Lets the
+ * frame prefetch those slots in one batch.
+ */
+template <typename Fn>
+inline void for_each_constant_slot(const uint8_t* code, uint32_t size, Fn&& fn) {
+    uint32_t last_push = size;  // pc of the previous instruction if it was a PUSH
+    for (uint32_t pc = 0; pc < size; pc++) {
+        uint8_t op = code[pc];
+        if ((op == OP_SLOAD || op == OP_SSTORE) && last_push < size) {
+            fn(code + last_push + 1, static_cast<uint32_t>(code[last_push] - OP_PUSH1 + 1));
+        }
+        if (op >= OP_PUSH1 && op <= OP_PUSH32) {
+            uint32_t length = op - OP_PUSH1 + 1;
+            last_push = (pc + length < size) ? pc : size;  // Truncated PUSH is not a key
+            pc += length;
+        } else {
+            last_push = size;
+        }
+    }
+}
+
+/**
+ * Requirements of one basic block. A block starts at pc 0 and at every JUMPDEST,
+ * and ends after a jump, a terminating or undefined opcode, an opcode with
+ * dynamic gas, or one with no native handler (its stub does not follow the
+ * metadata). Every instruction but the last costs exactly its constant gas and
+ * has the stack effect of the metadata, so one check on entry covers them all.
+ */
+struct BlockInfo {
+    uint32_t start;             // pc of the first instruction
+    uint32_t end;               // pc after the last instruction
+    uint32_t length;            // Number of instructions
+    uint32_t base_gas;          // Sum of the constant gas of its instructions
+    int16_t stack_required;     // Stack height needed on entry
+    int16_t stack_max_growth;   // Highest point above the entry height
+};
+
+/**
+ * Split code into basic blocks, in pc order.
+ */
+inline void analyze_blocks(const uint8_t* code, uint32_t size, Revision revision,
+                           std::vector<BlockInfo>& blocks) {
+    blocks.clear();
+    BlockInfo block{0, 0, 0, 0, 0, 0};
+    int height = 0;  // Relative to the entry height
+
+    uint32_t pc = 0;
+    while (pc < size) {
+        const uint8_t op = code[pc];
+        if (op == OP_JUMPDEST && pc != block.start) {
+            block.end = pc;
+            blocks.push_back(block);
+            block = BlockInfo{pc, 0, 0, 0, 0, 0};
+            height = 0;
+        }
+
+        // Stack bounds saturate past the stack limit; such a block never passes the check
+        const OpcodeInfo& info = opcodes::info(revision, op);
+        block.length++;
+        block.base_gas += info.base_gas;
+        if (info.stack_in - height > block.stack_required) {
+            block.stack_required = static_cast<int16_t>(std::min(info.stack_in - height, STACK_LIMIT + 1));
+        }
+        height += info.stack_out - info.stack_in;
+        if (height > block.stack_max_growth) {
+            block.stack_max_growth = static_cast<int16_t>(std::min(height, STACK_LIMIT + 1));
+        }
+        pc = std::min(pc + 1 + info.immediate, size);
+
+        const bool ends = (info.flags & opcodes::NATIVE) == 0 ||
+                          (info.flags & (opcodes::JUMPS | opcodes::TERMINATES | opcodes::DYNAMIC_GAS)) != 0;
+        if (ends || pc == size) {
+            block.end = pc;
+            blocks.push_back(block);
+            block = BlockInfo{pc, 0, 0, 0, 0, 0};
+            height = 0;
+        }
+    }
+}
+
+} // namespace code_analysis
+
+} // namespace evm
+} // namespace besu
@@ -0,0 +1,126 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "account_witness.h"
+#include "message_frame_memory.h"
+#include "storage_memory.h"
+#include <atomic>
+#include <cstdint>
+
+namespace besu {
+namespace evm {
+
+/**
+ * Execution recorder: captures the input of every execute_message call so that
+ * production traffic can be replayed offline (tools/evm-replay).
+ *
+ * Start it with besu_recorder_start() or by setting BESU_EVM_RECORD=<path>
+ * before the library loads. While it runs, execute_message appends one record
+ * per call, before executing, from any thread.
+ *
+ * File layout (host byte order):
+ *
+ * ┌─────────────────────────┐
+ * │ RecordingHeader         │ 32 bytes
+ * ├─────────────────────────┤
+ * │ RecordedFrame           │ 72 bytes
+ * │ MessageFrameMemory      │ frame_header_size bytes, as passed in
+ * │ stack                   │ stack_size x 32 bytes
+ * │ memory                  │ memory_size bytes
+ * │ code                    │ code_size bytes
+ * │ input                   │ input_size bytes (calldata)
+ * │ storage                 │ storage_slot_count x StorageEntry
+ * │ witness                 │ TransactionWitness and everything it references
+ * ├─────────────────────────┤
+ * │ RecordedFrame ...       │
+ * └─────────────────────────┘
+ *
+ * Each section starts 8-byte aligned; RecordedFrame::section_size holds the
+ * unpadded sizes. Block context travels in the header (originator,
+ * mining_beneficiary, gas_price, revision). The header's offsets are those of the
+ * recorded frame: a replay lays the sections out again and rewrites them.
+ */
+
+constexpr uint64_t RECORDING_MAGIC = 0x3143455255534542ull;  // "BESUREC1"
+constexpr uint32_t RECORDING_VERSION = 1;
+constexpr uint32_t RECORDED_FRAME_MAGIC = 0x4d415246u;       // "FRAM"
+
+constexpr uint32_t RECORD_FLAG_TRACED = 1u << 0;   // A tracer was attached
+constexpr uint32_t RECORD_FLAG_GUARDED = 1u << 1;  // Guarded frame (besu_guarded_frame_create)
+
+enum RecordSection : uint32_t {
+    RECORD_STACK = 0,
+    RECORD_MEMORY,
+    RECORD_CODE,
+    RECORD_INPUT,
+    RECORD_STORAGE,
+    RECORD_WITNESS,
+    RECORD_SECTION_COUNT
+};
+
+struct RecordingHeader {
+    uint64_t magic;              // RECORDING_MAGIC
+    uint32_t version;            // RECORDING_VERSION
+    uint32_t frame_header_size;  // sizeof(MessageFrameMemory) of the recording library
+    uint64_t reserved[2];
+};
+
+struct RecordedFrame {
+    uint32_t magic;              // RECORDED_FRAME_MAGIC
+    uint32_t flags;              // RECORD_FLAG_*
+    uint64_t size;               // Whole record including this header and padding
+    uint64_t sequence;           // Call order in the recording
+    uint64_t section_size[RECORD_SECTION_COUNT];
+};
+
+static_assert(sizeof(RecordingHeader) == 32, "RecordingHeader layout");
+static_assert(sizeof(RecordedFrame) == 72, "RecordedFrame layout");
+
+namespace recorder {
+
+extern std::atomic<bool> g_recording;
+
+/** True while a recording is open; one relaxed load on the execute_message path. */
+inline bool active() { return g_recording.load(std::memory_order_relaxed); }
+
+/** Append frame's input to the open recording. */
+void record(const MessageFrameMemory* frame, bool traced);
+
+/**
+ * Extent in bytes of the witness at witness_base: its header and every account,
+ * code and storage array it points to.
+ */
+inline uint64_t witness_extent(const uint8_t* witness_base) {
+    const auto* w = reinterpret_cast<const TransactionWitness*>(witness_base);
+    uint64_t end = sizeof(TransactionWitness);
+    auto extend = [&end](uint64_t offset, uint64_t bytes) {
+        if (bytes && offset + bytes > end) end = offset + bytes;
+    };
+    extend(w->accounts_ptr, uint64_t(w->max_accounts) * sizeof(AccountEntry));
+    extend(w->codes_ptr, w->codes_size);
+    extend(w->storage_ptr, uint64_t(w->max_storage) * sizeof(StorageEntry));
+    return end;
+}
+
+} // namespace recorder
+
+extern "C" {
+
+/**
+ * Start recording to path (truncated). Stops any recording already open.
+ * @return false if the file could not be created
+ */
+bool besu_recorder_start(const char* path);
+
+/** Flush and close the recording, if any. */
+void besu_recorder_stop(void);
+
+/** Frames written to the current (or last) recording. */
+uint64_t besu_recorder_count(void);
+
+} // extern "C"
+
+} // namespace evm
+} // namespace besu
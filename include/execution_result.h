@@ -0,0 +1,55 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace besu {
+namespace evm {
+
+/**
+ * Compact execution result written by native code when execute_message returns.
+ *
+ * CRITICAL: This struct MUST match ExecutionResultLayout.java exactly!
+ *
+ * Java reads back the outcome of a call from this single 64-byte block instead of
+ * gathering state, gas, refund, halt reason, output and logs from scattered header
+ * fields. The first 16 bytes answer the common "did it succeed, how much gas" question,
+ * so the hot path is one cache-line read.
+ *
+ * The block lives inside the frame segment at MessageFrameMemory::result_ptr
+ * (relative offset, 0 = not requested). Offsets below are relative to the frame
+ * start, like every other *_ptr field.
+ */
+struct __attribute__((aligned(64))) ExecutionResult {
+    uint32_t  state;               // Final MessageFrameState (as int)
+    uint32_t  halt_reason;         // ExceptionalHaltReason enum (0 = none)
+    int64_t   gas_used;            // Gas consumed by this call (initial - remaining)
+    int64_t   gas_remaining;       // Gas left when execution stopped
+    int64_t   gas_refund;          // Accumulated refund counter
+
+    uint64_t  output_ptr;          // Offset to output data
+    uint32_t  output_size;         // Output data size in bytes
+    uint32_t  logs_count;          // Number of logs emitted
+    uint64_t  logs_ptr;            // Offset to logs array
+
+    uint32_t  dirty_storage_count; // Storage entries whose value differs from original
+    uint32_t  storage_slot_count;  // Storage entries touched (loaded or written)
+};
+
+static_assert(sizeof(ExecutionResult) == 64,
+              "ExecutionResult must be exactly 64 bytes (one cache line)");
+
+static_assert(offsetof(ExecutionResult, gas_used) == 8,
+              "gas_used must be at offset 8");
+
+static_assert(offsetof(ExecutionResult, output_ptr) == 32,
+              "output_ptr must be at offset 32");
+
+static_assert(offsetof(ExecutionResult, dirty_storage_count) == 56,
+              "dirty_storage_count must be at offset 56");
+
+} // namespace evm
+} // namespace besu
@@ -0,0 +1,264 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "types.h"
+#include "witness_index.h"
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace besu {
+namespace evm {
+
+/**
+ * Open-addressing hash containers for per-frame access tracking.
+ *
+ * Warm address/slot sets, transient storage and self-destruct bookkeeping are
+ * queried on nearly every state-touching opcode. Node-based std::set/std::map
+ * chase a pointer per tree level and allocate per insert; these tables probe
+ * linearly over one flat slot array instead.
+ *
+ * - Power-of-two capacity, max load factor 3/4, backward-shift erase (no tombstones)
+ * - The first InlineSlots slots live inside the object, so small transactions
+ *   never allocate; larger tables move to the heap and keep their capacity
+ * - clear() only resets the occupancy bytes, so a reused frame keeps its storage
+ *
+ * Keys must be trivially copyable with operator==. Pointers returned by find() and
+ * insert() are invalidated by the next insert or erase.
+ */
+
+/** (address, storage slot) key for warm storage and transient storage. */
+using AddressSlot = std::pair<Address, Bytes32>;
+
+struct AddressHash {
+    uint64_t operator()(const Address& address) const {
+        return witness_index::hash_address(address.data().data());
+    }
+};
+
+struct AddressSlotHash {
+    uint64_t operator()(const AddressSlot& key) const {
+        return witness_index::hash_slot(key.first.data().data(), key.second.data());
+    }
+};
+
+namespace flat_hash {
+
+struct NoValue {};
+
+template <typename Key, typename Value, typename Hash, size_t InlineSlots>
+class Table {
+    static_assert((InlineSlots & (InlineSlots - 1)) == 0 && InlineSlots >= 4,
+                  "InlineSlots must be a power of two >= 4");
+
+public:
+    struct Slot {
+        Key key;
+        Value value;
+    };
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t capacity() const { return mask_ + 1; }
+
+    /** Remove every entry; allocated capacity is kept. */
+    void clear() {
+        if (size_ == 0) return;
+        memset(used(), 0, capacity());
+        size_ = 0;
+    }
+
+    Value* find(const Key& key) {
+        size_t index;
+        return locate(key, index) ? &slots()[index].value : nullptr;
+    }
+
+    const Value* find(const Key& key) const {
+        return const_cast<Table*>(this)->find(key);
+    }
+
+    bool contains(const Key& key) const { return find(key) != nullptr; }
+
+    /**
+     * Insert key with value unless already present.
+     * @return Entry value and whether it was inserted
+     */
+    std::pair<Value*, bool> insert(const Key& key, const Value& value) {
+        size_t index;
+        if (locate(key, index)) {
+            return {&slots()[index].value, false};
+        }
+        if ((size_ + 1) * 4 > capacity() * 3) {
+            grow();
+            locate(key, index);
+        }
+        slots()[index].key = key;
+        slots()[index].value = value;
+        used()[index] = 1;
+        size_++;
+        return {&slots()[index].value, true};
+    }
+
+    bool erase(const Key& key) {
+        size_t hole;
+        if (!locate(key, hole)) return false;
+
+        Slot* slot = slots();
+        uint8_t* occupied = used();
+        occupied[hole] = 0;
+        size_--;
+
+        // Shift back followers whose home slot is not between the hole and them
+        for (size_t next = (hole + 1) & mask_; occupied[next]; next = (next + 1) & mask_) {
+            size_t home = Hash()(slot[next].key) & mask_;
+            bool stays = (hole <= next) ? (home > hole && home <= next)
+                                        : (home > hole || home <= next);
+            if (stays) continue;
+            slot[hole] = slot[next];
+            occupied[hole] = 1;
+            occupied[next] = 0;
+            hole = next;
+        }
+        return true;
+    }
+
+    /** Call fn(key, value) for every entry, in unspecified order. */
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        const Slot* slot = slots();
+        const uint8_t* occupied = used();
+        for (size_t i = 0; i <= mask_; i++) {
+            if (occupied[i]) fn(slot[i].key, slot[i].value);
+        }
+    }
+
+    /** As above, with a mutable value. fn must not insert or erase. */
+    template <typename Fn>
+    void forEach(Fn&& fn) {
+        Slot* slot = slots();
+        const uint8_t* occupied = used();
+        for (size_t i = 0; i <= mask_; i++) {
+            if (occupied[i]) fn(static_cast<const Key&>(slot[i].key), slot[i].value);
+        }
+    }
+
+private:
+    Slot* slots() { return heap_slots_.empty() ? inline_slots_.data() : heap_slots_.data(); }
+    const Slot* slots() const { return heap_slots_.empty() ? inline_slots_.data() : heap_slots_.data(); }
+    uint8_t* used() { return heap_used_.empty() ? inline_used_.data() : heap_used_.data(); }
+    const uint8_t* used() const { return heap_used_.empty() ? inline_used_.data() : heap_used_.data(); }
+
+    /** True and the key's slot if present, else false and the insertion slot. */
+    bool locate(const Key& key, size_t& index) const {
+        const Slot* slot = slots();
+        const uint8_t* occupied = used();
+        index = Hash()(key) & mask_;
+        while (occupied[index]) {
+            if (slot[index].key == key) return true;
+            index = (index + 1) & mask_;
+        }
+        return false;
+    }
+
+    void grow() {
+        std::vector<Slot> old_slots(slots(), slots() + capacity());
+        std::vector<uint8_t> old_used(used(), used() + capacity());
+
+        size_t new_capacity = capacity() * 2;
+        heap_slots_.assign(new_capacity, Slot());
+        heap_used_.assign(new_capacity, 0);
+        mask_ = new_capacity - 1;
+
+        Slot* slot = heap_slots_.data();
+        uint8_t* occupied = heap_used_.data();
+        for (size_t i = 0; i < old_slots.size(); i++) {
+            if (!old_used[i]) continue;
+            size_t index = Hash()(old_slots[i].key) & mask_;
+            while (occupied[index]) {
+                index = (index + 1) & mask_;
+            }
+            slot[index] = old_slots[i];
+            occupied[index] = 1;
+        }
+    }
+
+    std::array<Slot, InlineSlots> inline_slots_{};
+    std::array<uint8_t, InlineSlots> inline_used_{};
+    std::vector<Slot> heap_slots_;
+    std::vector<uint8_t> heap_used_;
+    size_t mask_ = InlineSlots - 1;
+    size_t size_ = 0;
+};
+
+} // namespace flat_hash
+
+/**
+ * Flat hash set.
+ */
+template <typename Key, typename Hash, size_t InlineSlots = 16>
+class FlatHashSet {
+public:
+    size_t size() const { return table_.size(); }
+    bool empty() const { return table_.empty(); }
+    void clear() { table_.clear(); }
+
+    bool contains(const Key& key) const { return table_.contains(key); }
+
+    /** @return true if key was not present before */
+    bool insert(const Key& key) { return table_.insert(key, flat_hash::NoValue()).second; }
+
+    bool erase(const Key& key) { return table_.erase(key); }
+
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        table_.forEach([&fn](const Key& key, const flat_hash::NoValue&) { fn(key); });
+    }
+
+private:
+    flat_hash::Table<Key, flat_hash::NoValue, Hash, InlineSlots> table_;
+};
+
+/**
+ * Flat hash map.
+ */
+template <typename Key, typename Value, typename Hash, size_t InlineSlots = 16>
+class FlatHashMap {
+public:
+    size_t size() const { return table_.size(); }
+    bool empty() const { return table_.empty(); }
+    void clear() { table_.clear(); }
+
+    Value* find(const Key& key) { return table_.find(key); }
+    const Value* find(const Key& key) const { return table_.find(key); }
+    bool contains(const Key& key) const { return table_.contains(key); }
+
+    /** Insert unless present. @return true if key was not present before */
+    bool insert(const Key& key, const Value& value) { return table_.insert(key, value).second; }
+
+    /** Insert or overwrite. */
+    void put(const Key& key, const Value& value) {
+        auto result = table_.insert(key, value);
+        if (!result.second) *result.first = value;
+    }
+
+    /** Value for key, inserting a default-constructed one if absent. */
+    Value& operator[](const Key& key) { return *table_.insert(key, Value()).first; }
+
+    bool erase(const Key& key) { return table_.erase(key); }
+
+    template <typename Fn>
+    void forEach(Fn&& fn) const { table_.forEach(fn); }
+
+    template <typename Fn>
+    void forEach(Fn&& fn) { table_.forEach(fn); }
+
+private:
+    flat_hash::Table<Key, Value, Hash, InlineSlots> table_;
+};
+
+} // namespace evm
+} // namespace besu
@@ -0,0 +1,206 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace besu {
+namespace evm {
+
+/**
+ * Packed MessageFrame transfer format for the JNI engine.
+ *
+ * NativeMessageFrame::fromJava and syncToJava exchange the whole frame as one
+ * byte[] each way instead of one JNI call per stack item, memory region or log:
+ *
+ *   fromJava:   NativeFrameBridge.exportFrame(frame) -> byte[]   (PackedFrameIn)
+ *   syncToJava: NativeFrameBridge.importFrame(frame, byte[])     (PackedFrameOut)
+ *
+ * Each message is a fixed header followed by variable sections in the order listed
+ * on the header struct. Every section starts on an 8-byte boundary. Integers are
+ * little-endian, addresses are 20 raw bytes, and words (stack items, Wei values,
+ * storage slots, topics) are 32 bytes big-endian. The stack is ordered bottom
+ * first.
+ *
+ * CRITICAL: Must match NativeFrameBridge.java.
+ */
+
+constexpr uint32_t PACKED_FRAME_IN_MAGIC = 0x4e494642;   // "BFIN"
+constexpr uint32_t PACKED_FRAME_OUT_MAGIC = 0x54554f42;  // "BOUT"
+constexpr uint16_t PACKED_FRAME_VERSION = 2;
+
+constexpr uint16_t PACKED_IN_STATIC = 1u << 0;             // isStatic
+constexpr uint16_t PACKED_IN_CONTRACT_CREATION = 1u << 1;  // Type CONTRACT_CREATION
+
+constexpr uint16_t PACKED_OUT_HAS_REVERT_REASON = 1u << 0;
+
+/**
+ * Java -> native header.
+ * Sections: stack[stack_size][32], memory, code, input, return data,
+ *           warm addresses[warm_address_count][20],
+ *           warm slots[warm_slot_count][20 + 32]
+ */
+struct PackedFrameIn {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;                  // PACKED_IN_*
+    int32_t  pc;
+    int32_t  section;
+    int64_t  gas_remaining;
+    int64_t  gas_refund;
+    int32_t  depth;
+    int32_t  max_stack_size;
+    uint32_t stack_size;
+    uint32_t memory_size;
+    uint32_t code_size;
+    uint32_t input_size;
+    uint32_t return_data_size;
+    uint32_t warm_address_count;
+    uint32_t warm_slot_count;
+    uint32_t reserved;
+    uint8_t  recipient[20];
+    uint8_t  sender[20];
+    uint8_t  contract[20];
+    uint8_t  originator[20];
+    uint8_t  mining_beneficiary[20];
+    uint8_t  value[32];
+    uint8_t  apparent_value[32];
+    uint8_t  gas_price[32];
+    uint8_t  padding[4];
+};
+
+static_assert(sizeof(PackedFrameIn) == 272, "PackedFrameIn must be 272 bytes");
+static_assert(offsetof(PackedFrameIn, recipient) == 72, "recipient must be at offset 72");
+static_assert(offsetof(PackedFrameIn, value) == 172, "value must be at offset 172");
+
+/**
+ * Native -> Java header.
+ * Sections: stack[stack_size][32], memory, output, return data, revert reason,
+ *           logs[log_count] (logger[20], topic_count u32, data_size u32,
+ *                            topics[topic_count][32], data, padded to 8),
+ *           self-destructs[self_destruct_count][20], creates[create_count][20],
+ *           refunds[refund_count][20 + 32], warm addresses[warm_address_count][20],
+ *           warm slots[warm_slot_count][20 + 32],
+ *           storage writes[storage_write_count][20 + 32 + 32] (address, slot, value)
+ */
+struct PackedFrameOut {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;                  // PACKED_OUT_*
+    int32_t  pc;
+    int32_t  section;
+    int64_t  gas_remaining;
+    int64_t  gas_refund;
+    uint32_t state;                  // MessageFrameState ordinal
+    uint32_t halt_reason;            // ExceptionalHaltReason ordinal (0 = NONE)
+    uint32_t stack_size;
+    uint32_t memory_size;
+    uint32_t output_size;
+    uint32_t return_data_size;
+    uint32_t revert_reason_size;
+    uint32_t log_count;
+    uint32_t self_destruct_count;
+    uint32_t create_count;
+    uint32_t refund_count;
+    uint32_t warm_address_count;
+    uint32_t warm_slot_count;
+    uint32_t storage_write_count;    // Dirty slots from the native StorageCache
+};
+
+static_assert(sizeof(PackedFrameOut) == 88, "PackedFrameOut must be 88 bytes");
+static_assert(offsetof(PackedFrameOut, state) == 32, "state must be at offset 32");
+
+/**
+ * Section readers and writers for the packed format.
+ */
+namespace frame_codec {
+
+inline size_t align8(size_t value) {
+    return (value + 7) & ~static_cast<size_t>(7);
+}
+
+/**
+ * Appends sections to a byte buffer. Reuse one buffer across frames to avoid
+ * reallocating on every sync.
+ */
+class Writer {
+public:
+    explicit Writer(std::vector<uint8_t>& out) : out_(out) { out_.clear(); }
+
+    /** Reserve a zeroed header of type T and return its offset. */
+    template <typename T>
+    size_t header() {
+        size_t offset = out_.size();
+        out_.resize(offset + align8(sizeof(T)), 0);
+        return offset;
+    }
+
+    template <typename T>
+    T* at(size_t offset) { return reinterpret_cast<T*>(out_.data() + offset); }
+
+    void bytes(const void* data, size_t size) {
+        if (size > 0) {
+            const uint8_t* begin = static_cast<const uint8_t*>(data);
+            out_.insert(out_.end(), begin, begin + size);
+        }
+    }
+
+    template <typename T>
+    void value(const T& v) { bytes(&v, sizeof(T)); }
+
+    /** Close a section by padding to the next 8-byte boundary. */
+    void end_section() { out_.resize(align8(out_.size()), 0); }
+
+private:
+    std::vector<uint8_t>& out_;
+};
+
+/**
+ * Bounds-checked section reader. Every accessor returns nullptr/false once the
+ * input is exhausted, so a truncated message fails cleanly.
+ */
+class Reader {
+public:
+    Reader(const uint8_t* data, size_t size) : data_(data), size_(size), offset_(0) {}
+
+    template <typename T>
+    const T* header() {
+        const T* result = reinterpret_cast<const T*>(take(sizeof(T)));
+        end_section();
+        return result;
+    }
+
+    const uint8_t* take(size_t size) {
+        if (size > size_ - offset_) return nullptr;
+        const uint8_t* result = data_ + offset_;
+        offset_ += size;
+        return result;
+    }
+
+    template <typename T>
+    bool value(T& out) {
+        const uint8_t* p = take(sizeof(T));
+        if (!p) return false;
+        memcpy(&out, p, sizeof(T));
+        return true;
+    }
+
+    void end_section() {
+        size_t aligned = align8(offset_);
+        offset_ = aligned < size_ ? aligned : size_;
+    }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t offset_;
+};
+
+} // namespace frame_codec
+
+} // namespace evm
+} // namespace besu
@@ -0,0 +1,45 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "opcode_table.h"
+#include <cstdint>
+
+namespace besu {
+namespace evm {
+
+/**
+ * Dynamic gas constants of a revision, resolved at compile time.
+ *
+ * The constant part of each opcode's cost lives in the opcode metadata table;
+ * this holds the parts handlers add on top of it: storage access (EIP-2200,
+ * EIP-2929) and refunds (EIP-3529). Interpreters take the revision as a template
+ * parameter, so every constant below folds into the handler that uses it.
+ */
+template <Revision R>
+struct GasSchedule {
+    /** EIP-2929 warm/cold access tracking (Berlin). */
+    static constexpr bool access_lists = R >= Revision::BERLIN;
+
+    /** SLOAD of a warm slot; 800 before Berlin (EIP-1884), then the warm read cost. */
+    static constexpr int64_t sload = opcodes::TABLE<R>[opcodes::SLOAD].base_gas;
+
+    /** Surcharge-inclusive cost of the first access to a slot (EIP-2929). */
+    static constexpr int64_t cold_sload = access_lists ? 2100 : sload;
+
+    /** SSTORE of a non-zero value over a zero original value. */
+    static constexpr int64_t sstore_set = 20000;
+
+    /** SSTORE over a non-zero original value; Berlin moves 2100 into the cold surcharge. */
+    static constexpr int64_t sstore_reset = access_lists ? 5000 - 2100 : 5000;
+
+    /** Refund for clearing a slot; EIP-3529 (London) cuts it to reset + access list key. */
+    static constexpr int64_t sstore_clears_refund = R >= Revision::LONDON ? sstore_reset + 1900 : 15000;
+
+    /** SSTORE fails unless more than this much gas is left (EIP-2200). */
+    static constexpr int64_t sstore_sentry = 2300;
+};
+
+} // namespace evm
+} // namespace besu
@@ -0,0 +1,136 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "message_frame_memory.h"
+#include <cstdint>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <csetjmp>
+#define BESU_HAS_GUARDED_FRAMES 1
+#endif
+
+namespace besu {
+namespace evm {
+
+/**
+ * Guard-page protected frame arena.
+ *
+ * A guarded frame is a single native mapping in which the stack and the memory
+ * region sit between PROT_NONE pages:
+ *
+ * ┌─────────────────────────┐  offset 0
+ * │ MessageFrameMemory      │  384 bytes
+ * │ GuardedFrameControl     │  native only (rest of the first page)
+ * ├─────────────────────────┤
+ * │ guard (PROT_NONE)       │  1 page    - stack underflow traps here
+ * ├─────────────────────────┤  stack_ptr
+ * │ Stack                   │  1024 x 32 bytes
+ * ├─────────────────────────┤
+ * │ guard (PROT_NONE)       │  1 page    - stack overflow traps here
+ * ├─────────────────────────┤  memory_ptr
+ * │ Memory                  │  memory_capacity (zero filled)
+ * ├─────────────────────────┤
+ * │ guard (PROT_NONE)       │  1 page
+ * ├─────────────────────────┤  code_ptr (tail start)
+ * │ Tail                    │  code, input, output, return data, logs, storage...
+ * └─────────────────────────┘
+ *
+ * execute_message runs guarded frames with an interpreter instantiation that skips
+ * the per-push/peek stack checks. Memory growth is still checked in software, as
+ * it is charged gas anyway, against the memory limit capped at memory_capacity.
+ * A SIGSEGV/SIGBUS on one of the guards is converted into an exceptional halt
+ * with the halt_reason the checked path reports for the same access
+ * (STACK_UNDERFLOW, STACK_OVERFLOW, INSUFFICIENT_GAS). Faults anywhere
+ * else are chained to the previously installed handler (the JVM's, when loaded
+ * into Besu - preload libjsig for reliable chaining).
+ *
+ * Java lays out the tail starting at code_ptr and must not set FRAME_FLAG_GUARDED
+ * itself: the interpreter also checks the control block magic and falls back to
+ * the checked path if either is missing.
+ */
+
+constexpr uint32_t FRAME_FLAG_GUARDED = 1u << 0;
+
+constexpr uint64_t GUARDED_FRAME_MAGIC = 0x4755415244454446ull;  // "GUARDEDF"
+
+/**
+ * Native bookkeeping stored right after the 384-byte header.
+ */
+struct GuardedFrameControl {
+    uint64_t  magic;             // GUARDED_FRAME_MAGIC
+    uint64_t  mapping_size;      // Total bytes mapped (for munmap)
+    uint64_t  memory_capacity;   // Usable EVM memory bytes
+    uint64_t  tail_size;         // Usable tail bytes from code_ptr
+    uintptr_t underflow_lo;      // Guard below the stack [lo, hi)
+    uintptr_t underflow_hi;
+    uintptr_t overflow_lo;       // Guard above the stack [lo, hi)
+    uintptr_t overflow_hi;
+    uintptr_t memory_guard_lo;   // Guard after memory [lo, hi)
+    uintptr_t memory_guard_hi;
+};
+
+namespace guard {
+
+/**
+ * Control block of a guarded frame, or nullptr if frame is not a valid guarded frame.
+ */
+inline const GuardedFrameControl* control(const MessageFrameMemory* frame) {
+    if ((frame->flags & FRAME_FLAG_GUARDED) == 0) return nullptr;
+    const auto* control = reinterpret_cast<const GuardedFrameControl*>(
+        reinterpret_cast<const uint8_t*>(frame) + sizeof(MessageFrameMemory));
+    return control->magic == GUARDED_FRAME_MAGIC ? control : nullptr;
+}
+
+} // namespace guard
+
+#ifdef BESU_HAS_GUARDED_FRAMES
+
+/**
+ * Per-execution trap target, linked so nested execute_message calls on the same
+ * thread (tracer upcall -> Java -> native) each recover into their own frame.
+ */
+struct GuardTrap {
+    sigjmp_buf env;
+    const GuardedFrameControl* control;
+    GuardTrap* previous;
+};
+
+namespace guard {
+
+/**
+ * Trap target of the innermost guarded execution on this thread.
+ */
+GuardTrap*& active();
+
+} // namespace guard
+
+#endif // BESU_HAS_GUARDED_FRAMES
+
+extern "C" {
+
+/**
+ * Map a guarded frame.
+ * @param memory_capacity EVM memory bytes (rounded up to the page size)
+ * @param tail_size Bytes for code, input, output, logs... (rounded up to the page size)
+ * @return Zeroed frame with stack_ptr, memory_ptr, code_ptr and flags set and the
+ *         latest revision selected, or nullptr
+ */
+MessageFrameMemory* besu_guarded_frame_create(uint64_t memory_capacity, uint64_t tail_size);
+
+/**
+ * Prepare a guarded frame for reuse: re-zeroes the touched memory and clears the
+ * machine state. Pointers, capacities and the tail contents are kept.
+ */
+void besu_guarded_frame_reset(MessageFrameMemory* frame);
+
+/**
+ * Unmap a guarded frame.
+ */
+void besu_guarded_frame_destroy(MessageFrameMemory* frame);
+
+} // extern "C"
+
+} // namespace evm
+} // namespace besu
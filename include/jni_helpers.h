@@ -6,6 +6,7 @@
 #include <jni.h>
 #include "types.h"
 #include <functional>
+#include <memory>
 #include <optional>
 #include <string>
 
@@ -31,12 +32,27 @@ private:
 
 /**
  * RAII wrapper for JNI critical section (GetPrimitiveArrayCritical).
+ *
+ * Pins (or copies) the whole array with one JNI call so a region can be moved with
+ * a single memcpy. No other JNI calls may be made while it is alive. A readOnly
+ * array is released with JNI_ABORT, skipping the copy-back when the VM copied.
  */
 template<typename T>
 class CriticalArray {
 public:
-    CriticalArray(JNIEnv* env, jarray array, bool isCopy = false);
-    ~CriticalArray();
+    CriticalArray(JNIEnv* env, jarray array, bool readOnly = false)
+        : env_(env), array_(array), ptr_(nullptr), length_(0), readOnly_(readOnly) {
+        if (array_ == nullptr) return;
+        length_ = env_->GetArrayLength(array_);
+        ptr_ = static_cast<T*>(env_->GetPrimitiveArrayCritical(array_, nullptr));
+        if (ptr_ == nullptr) length_ = 0;
+    }
+
+    ~CriticalArray() {
+        if (ptr_ != nullptr) {
+            env_->ReleasePrimitiveArrayCritical(array_, ptr_, readOnly_ ? JNI_ABORT : 0);
+        }
+    }
 
     CriticalArray(const CriticalArray&) = delete;
     CriticalArray& operator=(const CriticalArray&) = delete;
@@ -49,6 +65,7 @@ private:
     jarray array_;
     T* ptr_;
     jsize length_;
+    bool readOnly_;
 };
 
 /**
@@ -94,7 +111,9 @@ void throwIllegalStateException(JNIEnv* env, const char* message);
 
 /**
  * JNI method and field ID cache for performance.
- * Caches method and field IDs to avoid repeated lookups.
+ * Caches method and field IDs to avoid repeated lookups. Populated once from
+ * JNI_OnLoad (load()) so no lookup happens on the execution path; IDs that cannot
+ * be resolved are left nullptr.
  */
 class JniCache {
 public:
@@ -118,6 +137,7 @@ public:
     jclass codeClass;
     jclass worldUpdaterClass;
     jclass blockValuesClass;
+    jclass nativeFrameBridgeClass;
 
     // org.apache.tuweni.bytes.Bytes methods
     jmethodID bytesWrap;
@@ -164,6 +184,12 @@ public:
     jmethodID mfGetRecipientAddress;
     jmethodID mfGetSenderAddress;
     jmethodID mfGetContractAddress;
+    jmethodID mfGetBlockValues;
+
+    // NativeFrameBridge static methods (packed frame transfer, see frame_codec.h)
+    jmethodID bridgeExportFrame;   // byte[] exportFrame(MessageFrame)
+    jmethodID bridgeImportFrame;   // void importFrame(MessageFrame, byte[])
+    jmethodID bridgeLoadStorage;   // byte[] loadStorage(WorldUpdater, byte[] keys)
 
     // OperationTracer methods
     jmethodID otTracePreExecution;
@@ -181,6 +207,12 @@ public:
 
     static JniCache& getInstance(JNIEnv* env);
 
+    /** Build the cache (called from JNI_OnLoad). */
+    static void load(JNIEnv* env);
+
+    /** Release the cached global class references (called from JNI_OnUnload). */
+    static void unload(JNIEnv* env);
+
 private:
     static std::unique_ptr<JniCache> instance_;
 };
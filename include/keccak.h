@@ -0,0 +1,105 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace besu {
+namespace evm {
+
+/**
+ * Keccak-256 as used by Ethereum (original Keccak padding, not SHA3-256).
+ *
+ * Header-only so the interpreter can inline it into KECCAK256; tools use it for
+ * code hashes, trie nodes and mapping slots.
+ */
+namespace keccak {
+
+constexpr size_t HASH_SIZE = 32;
+constexpr size_t RATE = 136;  // 1600 - 2 * 256 bits, in bytes
+
+namespace detail {
+
+constexpr uint64_t ROUND_CONSTANTS[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+};
+
+constexpr int ROTATIONS[24] = {1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14,
+                               27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44};
+
+constexpr int LANES[24] = {10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4,
+                           15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1};
+
+inline uint64_t rotl(uint64_t x, int n) {
+    return (x << n) | (x >> (64 - n));
+}
+
+inline uint64_t load_le(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, 8);  // Little-endian hosts only, like the frame layout
+    return v;
+}
+
+inline void keccak_f1600(uint64_t st[25]) {
+    for (int round = 0; round < 24; round++) {
+        uint64_t bc[5];
+        for (int i = 0; i < 5; i++) {
+            bc[i] = st[i] ^ st[i + 5] ^ st[i + 10] ^ st[i + 15] ^ st[i + 20];
+        }
+        for (int i = 0; i < 5; i++) {
+            uint64_t t = bc[(i + 4) % 5] ^ rotl(bc[(i + 1) % 5], 1);
+            for (int j = 0; j < 25; j += 5) st[j + i] ^= t;
+        }
+
+        uint64_t t = st[1];
+        for (int i = 0; i < 24; i++) {
+            int j = LANES[i];
+            uint64_t next = st[j];
+            st[j] = rotl(t, ROTATIONS[i]);
+            t = next;
+        }
+
+        for (int j = 0; j < 25; j += 5) {
+            for (int i = 0; i < 5; i++) bc[i] = st[j + i];
+            for (int i = 0; i < 5; i++) st[j + i] ^= (~bc[(i + 1) % 5]) & bc[(i + 2) % 5];
+        }
+
+        st[0] ^= ROUND_CONSTANTS[round];
+    }
+}
+
+} // namespace detail
+
+/** Keccak-256 of data[0..size) into out[0..32). */
+inline void keccak256(const uint8_t* data, size_t size, uint8_t* out) {
+    uint64_t st[25] = {};
+
+    while (size >= RATE) {
+        for (size_t i = 0; i < RATE / 8; i++) st[i] ^= detail::load_le(data + i * 8);
+        detail::keccak_f1600(st);
+        data += RATE;
+        size -= RATE;
+    }
+
+    uint8_t block[RATE] = {};
+    if (size > 0) std::memcpy(block, data, size);
+    block[size] ^= 0x01;
+    block[RATE - 1] ^= 0x80;
+    for (size_t i = 0; i < RATE / 8; i++) st[i] ^= detail::load_le(block + i * 8);
+    detail::keccak_f1600(st);
+
+    std::memcpy(out, st, HASH_SIZE);
+}
+
+} // namespace keccak
+
+} // namespace evm
+} // namespace besu
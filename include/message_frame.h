@@ -101,6 +101,15 @@ public:
     virtual void writeMemory(int64_t offset, int64_t length, const Bytes& value, bool explicit_update) = 0;
     virtual void copyMemory(int64_t dest, int64_t src, int64_t length, bool explicit_update) = 0;
 
+    // Zero-copy memory access. Views point into frame-owned memory and are valid
+    // until the next call that can resize it (expandMemory, writeMemory, memoryWriteView).
+    /** [offset, offset + length) if already inside memory, else an empty view. */
+    virtual ByteView memoryView(int64_t offset, int64_t length) const = 0;
+    /** Writable [offset, offset + length), expanding memory to cover it. Empty on bad range. */
+    virtual MutableByteView memoryWriteView(int64_t offset, int64_t length) = 0;
+    /** Copy value into [offset, offset + length), zero-filling past its end. */
+    virtual void writeMemory(int64_t offset, int64_t length, ByteView value) = 0;
+
     // State and context
     virtual MessageFrameState getState() const = 0;
     virtual void setState(MessageFrameState state) = 0;
@@ -110,6 +119,8 @@ public:
     // Code and input
     virtual const Code& getCode() const = 0;
     virtual Bytes getInputData() const = 0;
+    /** Call data without a copy; valid for the life of the frame. */
+    virtual ByteView getInputDataView() const = 0;
 
     // Addresses
     virtual Address getRecipientAddress() const = 0;
@@ -138,6 +149,13 @@ public:
     virtual void setReturnData(const Bytes& data) = 0;
     virtual void clearReturnData() = 0;
 
+    // Output and return data without a copy. Views are valid until the data is
+    // next set or cleared. setOutputData(ByteView) copies straight from the source
+    // (e.g. memoryView for RETURN) without an intermediate Bytes.
+    virtual ByteView getOutputDataView() const = 0;
+    virtual void setOutputData(ByteView output) = 0;
+    virtual ByteView getReturnDataView() const = 0;
+
     // Exceptional halt
     virtual std::optional<ExceptionalHaltReason> getExceptionalHaltReason() const = 0;
     virtual void setExceptionalHaltReason(std::optional<ExceptionalHaltReason> reason) = 0;
@@ -219,6 +237,13 @@ public:
     void writeMemory(int64_t offset, int64_t length, const Bytes& value, bool explicit_update) override;
     void copyMemory(int64_t dest, int64_t src, int64_t length, bool explicit_update) override;
 
+    // Views are backed by per-frame copies of the Java data (*_scratch_), so they
+    // save the caller's copy but not the JNI one. memoryWriteView() cannot write
+    // through to Java and returns an empty view; use writeMemory() instead.
+    ByteView memoryView(int64_t offset, int64_t length) const override;
+    MutableByteView memoryWriteView(int64_t offset, int64_t length) override;
+    void writeMemory(int64_t offset, int64_t length, ByteView value) override;
+
     MessageFrameState getState() const override;
     void setState(MessageFrameState state) override;
     MessageFrameType getType() const override;
@@ -226,6 +251,7 @@ public:
 
     const Code& getCode() const override;
     Bytes getInputData() const override;
+    ByteView getInputDataView() const override;
 
     Address getRecipientAddress() const override;
     Address getContractAddress() const override;
@@ -248,6 +274,9 @@ public:
     Bytes getReturnData() const override;
     void setReturnData(const Bytes& data) override;
     void clearReturnData() override;
+    ByteView getOutputDataView() const override;
+    void setOutputData(ByteView output) override;
+    ByteView getReturnDataView() const override;
 
     std::optional<ExceptionalHaltReason> getExceptionalHaltReason() const override;
     void setExceptionalHaltReason(std::optional<ExceptionalHaltReason> reason) override;
@@ -278,6 +307,12 @@ private:
     mutable std::unique_ptr<Code> code_cache_;
     mutable std::unique_ptr<BlockValues> block_values_cache_;
     mutable std::unique_ptr<WorldUpdater> world_updater_cache_;
+
+    // Backing copies for the view accessors
+    mutable Bytes memory_scratch_;
+    mutable Bytes input_scratch_;
+    mutable Bytes output_scratch_;
+    mutable Bytes return_scratch_;
 };
 
 }  // namespace evm
@@ -7,6 +7,8 @@
 #include <cstddef>
 #include <cstring>
 
+#include "execution_result.h"
+
 namespace besu {
 namespace evm {
 
@@ -28,6 +30,7 @@ namespace evm {
  * - Return data (dynamic): returnDataSize bytes
  * - Logs (dynamic): logCount * sizeof(Log)
  * - Access lists (dynamic)
+ * - Execution result (optional): 64-byte ExecutionResult at result_ptr
  *
  * PORTABILITY NOTES:
  * - Endianness: Assumes little-endian (x86-64, aarch64 Linux/Darwin). Not tested on big-endian.
@@ -100,9 +103,21 @@ struct __attribute__((aligned(64))) MessageFrameMemory {
 
     uint32_t  halt_reason;         // ExceptionalHaltReason enum (0 = none)
 
-    // ========== Reserved for Future Use (16 bytes) ==========
+    // ========== Execution Result (8 bytes) ==========
+
+    uint64_t  result_ptr;          // Offset to ExecutionResult block (0 = not requested)
+
+    // ========== Native Frame Flags (4 bytes) ==========
+
+    uint32_t  flags;               // FRAME_FLAG_* (set by native frame constructors only)
 
-    uint8_t   reserved[16];        // Padding to 384 bytes total
+    // ========== EVM Revision (1 byte) ==========
+
+    uint8_t   revision;            // Revision enum (opcode_table.h): fork rules to execute with
+
+    // ========== Reserved for Future Use (3 bytes) ==========
+
+    uint8_t   reserved[3];         // Padding to 384 bytes total
 };
 
 // Static assertions to verify struct layout
@@ -127,6 +142,15 @@ static_assert(offsetof(MessageFrameMemory, value) == 264,
 static_assert(offsetof(MessageFrameMemory, halt_reason) == 360,
               "halt_reason must be at offset 360");
 
+static_assert(offsetof(MessageFrameMemory, result_ptr) == 368,
+              "result_ptr must be at offset 368");
+
+static_assert(offsetof(MessageFrameMemory, flags) == 376,
+              "flags must be at offset 376");
+
+static_assert(offsetof(MessageFrameMemory, revision) == 380,
+              "revision must be at offset 380");
+
 // Constants
 constexpr size_t STACK_ITEM_SIZE = 32;
 constexpr size_t MAX_STACK_SIZE = 1024;
@@ -206,6 +230,19 @@ inline void setReturnData(MessageFrameMemory* frame, const uint8_t* data, uint32
     frame->return_data_size = size;
 }
 
+/**
+ * Get pointer to the execution result block.
+ * @param frame The frame memory
+ * @return Pointer to ExecutionResult, or nullptr if the caller did not request one
+ */
+inline ExecutionResult* getResult(MessageFrameMemory* frame) {
+    if (frame->result_ptr == 0) {
+        return nullptr;
+    }
+    uint8_t* base = reinterpret_cast<uint8_t*>(frame);
+    return reinterpret_cast<ExecutionResult*>(base + frame->result_ptr);
+}
+
 } // namespace frame_memory
 
 } // namespace evm
@@ -3,13 +3,16 @@
 
 #pragma once
 
+#include "flat_hash.h"
 #include "message_frame.h"
+#include "storage_cache.h"
 #include "types.h"
 #include <jni.h>
-#include <map>
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <optional>
-#include <set>
 #include <utility>
 #include <vector>
 
@@ -20,7 +23,6 @@ namespace evm {
 class Code;
 class WorldUpdater;
 class BlockValues;
-class Log;
 
 /**
  * Native (pure C++) implementation of MessageFrame.
@@ -30,9 +32,14 @@ class Log;
  * at the boundaries (entry/exit of runToHalt), but all operations during EVM
  * execution are pure C++ with native data structures.
  *
+ * The boundary copy is bulk: fromJava and syncToJava each exchange the whole frame
+ * as one packed byte[] (frame_codec.h) with a single critical-array copy, rather
+ * than one JNI call per stack item, memory region, log or warm entry.
+ *
  * Performance characteristics:
  * - JNI calls per execution: ~2 (copy in, copy out)
- * - Operations during execution: 0 JNI calls (except SLOAD/SSTORE)
+ * - Operations during execution: 0 JNI calls, except one per batch of storage
+ *   cache misses (SLOAD/SSTORE, see storage_cache.h)
  * - Speedup vs JNI wrapper: 10-1000x depending on contract complexity
  */
 class NativeMessageFrame : public IMessageFrame {
@@ -57,8 +64,17 @@ public:
      *
      * @param env JNI environment
      * @param jframe Java MessageFrame object to update
+     * @return false, with a Java exception pending, if the frame was not updated
      */
-    void syncToJava(JNIEnv* env, jobject jframe) const;
+    bool syncToJava(JNIEnv* env, jobject jframe) const;
+
+    /**
+     * Delete the global refs to the Java code, world updater and block values.
+     *
+     * Call once after syncToJava(), before the frame is dropped: the caller owns
+     * the refs' lifetime, the destructor does not release them. Idempotent.
+     */
+    void releaseJavaRefs();
 
     /**
      * Constructor (typically use fromJava() instead).
@@ -106,13 +122,64 @@ public:
         gasRefund_ += amount;
     }
 
-    // Stack operations - pure C++ with std::vector
-    Bytes getStackItem(int offset) const override;
-    Bytes popStackItem() override;
-    void popStackItems(int n) override;
-    void pushStackItem(const Bytes& value) override;
-    void setStackItem(int offset, const Bytes& value) override;
-    int stackSize() const override { return static_cast<int>(stack_.size()); }
+    // Stack operations - fixed inline 1024 x 32-byte stack, never allocates.
+    // The Bytes-based overrides are kept for IMessageFrame callers; native operations
+    // use the word accessors below, which return references into the stack.
+    Bytes getStackItem(int offset) const override {
+        if (offset < 0 || offset >= stackSize_) return Bytes();
+        const Bytes32& item = stackTop(offset);
+        return Bytes(item.begin(), item.end());
+    }
+
+    Bytes popStackItem() override {
+        if (stackSize_ == 0) {
+            haltReason_ = ExceptionalHaltReason::INSUFFICIENT_STACK_ITEMS;
+            return Bytes();
+        }
+        const Bytes32& item = popStackWord();
+        return Bytes(item.begin(), item.end());
+    }
+
+    void popStackItems(int n) override {
+        if (n > stackSize_) {
+            haltReason_ = ExceptionalHaltReason::INSUFFICIENT_STACK_ITEMS;
+            stackSize_ = 0;
+            return;
+        }
+        stackSize_ -= n;
+    }
+
+    void pushStackItem(const Bytes& value) override {
+        if (!hasStackSpace(1)) {
+            haltReason_ = ExceptionalHaltReason::TOO_MANY_STACK_ITEMS;
+            return;
+        }
+        toWord(value, pushStackSlot());
+    }
+
+    void setStackItem(int offset, const Bytes& value) override {
+        if (offset < 0 || offset >= stackSize_) {
+            haltReason_ = ExceptionalHaltReason::INSUFFICIENT_STACK_ITEMS;
+            return;
+        }
+        toWord(value, stackTop(offset));
+    }
+
+    int stackSize() const override { return stackSize_; }
+
+    /** Item offset slots below the top (0 = top). Caller checks hasStackItems(). */
+    Bytes32& stackTop(int offset = 0) { return stack_[stackSize_ - 1 - offset]; }
+    const Bytes32& stackTop(int offset = 0) const { return stack_[stackSize_ - 1 - offset]; }
+
+    /** Claim a new top slot for the caller to fill. Caller checks hasStackSpace(). */
+    Bytes32& pushStackSlot() { return stack_[stackSize_++]; }
+    void pushStackWord(const Bytes32& value) { stack_[stackSize_++] = value; }
+
+    /** Pop the top item. The reference stays valid until the next push. */
+    const Bytes32& popStackWord() { return stack_[--stackSize_]; }
+
+    bool hasStackItems(int n) const { return stackSize_ >= n; }
+    bool hasStackSpace(int n) const { return stackSize_ + n <= maxStackSize_; }
 
     // Memory operations - pure C++ with std::vector
     int64_t calculateMemoryExpansion(int64_t offset, int64_t length) override;
@@ -123,6 +190,26 @@ public:
     void writeMemory(int64_t offset, int64_t length, const Bytes& value, bool explicit_update) override;
     void copyMemory(int64_t dest, int64_t src, int64_t length, bool explicit_update) override;
 
+    // Zero-copy memory access straight into memory_
+    ByteView memoryView(int64_t offset, int64_t length) const override {
+        if (!inRange(offset, length) || offset + length > memoryByteSize()) return ByteView();
+        return ByteView(memory_.data() + offset, static_cast<size_t>(length));
+    }
+
+    MutableByteView memoryWriteView(int64_t offset, int64_t length) override {
+        if (!inRange(offset, length)) return MutableByteView();
+        ensureMemory(offset + length);
+        return MutableByteView(memory_.data() + offset, static_cast<size_t>(length));
+    }
+
+    void writeMemory(int64_t offset, int64_t length, ByteView value) override {
+        MutableByteView target = memoryWriteView(offset, length);
+        if (target.empty()) return;
+        size_t copied = value.size() < target.size() ? value.size() : target.size();
+        std::copy(value.begin(), value.begin() + copied, target.begin());
+        std::fill(target.begin() + copied, target.end(), 0);
+    }
+
     // State and context
     MessageFrameState getState() const override { return state_; }
     void setState(MessageFrameState state) override { state_ = state; }
@@ -132,6 +219,7 @@ public:
     // Code and input (cached from Java)
     const Code& getCode() const override;
     Bytes getInputData() const override { return inputData_; }
+    ByteView getInputDataView() const override { return inputData_; }
 
     // Addresses (cached from Java)
     Address getRecipientAddress() const override { return recipient_; }
@@ -159,6 +247,9 @@ public:
     Bytes getReturnData() const override { return returnData_; }
     void setReturnData(const Bytes& data) override { returnData_ = data; }
     void clearReturnData() override { returnData_.clear(); }
+    ByteView getOutputDataView() const override { return outputData_; }
+    void setOutputData(ByteView output) override { outputData_.assign(output.begin(), output.end()); }
+    ByteView getReturnDataView() const override { return returnData_; }
 
     // Exceptional halt
     std::optional<ExceptionalHaltReason> getExceptionalHaltReason() const override {
@@ -176,13 +267,37 @@ public:
     WorldUpdater& getWorldUpdater() override;
 
     // Warm/cold access tracking (pure C++)
-    bool warmUpAddress(const Address& address) override;
-    bool isAddressWarm(const Address& address) const override;
-    bool warmUpStorage(const Address& address, const Bytes32& slot) override;
+    // warmUp* return true if the entry was already warm
+    bool warmUpAddress(const Address& address) override {
+        return !warmAddresses_.insert(address);
+    }
+    bool isAddressWarm(const Address& address) const override {
+        return warmAddresses_.contains(address);
+    }
+    bool warmUpStorage(const Address& address, const Bytes32& slot) override {
+        return !warmStorage_.insert(AddressSlot(address, slot));
+    }
 
     // Transient storage (pure C++ - EIP-1153)
-    Bytes32 getTransientStorageValue(const Address& address, const Bytes32& slot) const override;
-    void setTransientStorageValue(const Address& address, const Bytes32& slot, const Bytes32& value) override;
+    Bytes32 getTransientStorageValue(const Address& address, const Bytes32& slot) const override {
+        const Bytes32* value = transientStorage_.find(AddressSlot(address, slot));
+        return value ? *value : Bytes32{};
+    }
+    void setTransientStorageValue(const Address& address, const Bytes32& slot, const Bytes32& value) override {
+        transientStorage_.put(AddressSlot(address, slot), value);
+    }
+
+    // Persistent storage (SLOAD/SSTORE) through the native cache.
+    // Writes reach Java once, with the packed sync-out in syncToJava().
+    /** @return nullptr if the slot could not be loaded from Java */
+    const StorageValue* getStorageValue(const Address& address, const Bytes32& slot) {
+        return storage_.get(address, slot);
+    }
+    /** @return false if the slot could not be loaded from Java */
+    bool setStorageValue(const Address& address, const Bytes32& slot, const Bytes32& value) {
+        return storage_.put(address, slot, value);
+    }
+    const StorageCacheStats& getStorageCacheStats() const { return storage_.stats(); }
 
     // Rollback
     void rollback() override;
@@ -193,10 +308,24 @@ public:
     // Not applicable for native frame (no underlying Java object)
     jobject getJavaObject() const override { return nullptr; }
 
+    /**
+     * Clear access tracking, transient storage and self-destruct bookkeeping so the
+     * frame object can be reused for the next transaction. Table storage is kept.
+     */
+    void clearAccessTracking() {
+        selfDestructs_.clear();
+        creates_.clear();
+        refunds_.clear();
+        warmAddresses_.clear();
+        warmStorage_.clear();
+        transientStorage_.clear();
+    }
+
     // Access to JNI environment (needed for SLOAD/SSTORE and child frames)
     JNIEnv* getEnv() const { return env_; }
 
-    // Access to Java WorldUpdater reference (for storage operations)
+    // Access to Java WorldUpdater reference (for account operations; storage
+    // goes through getStorageValue/setStorageValue)
     jobject getJavaWorldUpdater() const { return jworldUpdater_; }
 
 private:
@@ -211,9 +340,12 @@ private:
     int64_t gasRemaining_;
     int64_t gasRefund_;
 
-    // Stack (std::vector for performance)
-    std::vector<Bytes> stack_;
-    int maxStackSize_;
+    // Stack: inline and cache-line aligned, item i at stack_[i] (top = stackSize_ - 1).
+    // Left uninitialised; only [0, stackSize_) is ever read.
+    static constexpr int STACK_CAPACITY = 1024;
+    alignas(64) std::array<Bytes32, STACK_CAPACITY> stack_;
+    int stackSize_ = 0;
+    int maxStackSize_ = STACK_CAPACITY;
 
     // Memory (std::vector, expandable)
     std::vector<uint8_t> memory_;
@@ -259,39 +391,57 @@ private:
     std::vector<Log> logs_;
 
     // Self-destructs
-    std::set<Address> selfDestructs_;
+    FlatHashSet<Address, AddressHash> selfDestructs_;
 
     // Creates (CREATE/CREATE2)
-    std::set<Address> creates_;
+    FlatHashSet<Address, AddressHash> creates_;
 
     // Refunds (for SELFDESTRUCT)
-    std::map<Address, Wei> refunds_;
+    FlatHashMap<Address, Wei, AddressHash> refunds_;
 
     // ========== Access Tracking (EIP-2929) ==========
 
-    std::set<Address> warmAddresses_;
-    std::map<std::pair<Address, Bytes32>, bool> warmStorage_;
+    FlatHashSet<Address, AddressHash> warmAddresses_;
+    FlatHashSet<AddressSlot, AddressSlotHash> warmStorage_;
 
     // ========== Transient Storage (EIP-1153) ==========
 
-    std::map<std::pair<Address, Bytes32>, Bytes32> transientStorage_;
+    FlatHashMap<AddressSlot, Bytes32, AddressSlotHash> transientStorage_;
+
+    // ========== Persistent Storage Cache ==========
+
+    StorageCache storage_;
+    std::unique_ptr<StorageLoader> storageLoader_;  // Batched loads via jworldUpdater_
 
     // ========== Helper Methods ==========
 
-    void copyPrimitiveFields(JNIEnv* env, jobject jframe);
-    void copyStack(JNIEnv* env, jobject jframe);
-    void copyMemory(JNIEnv* env, jobject jframe);
-    void copyImmutableContext(JNIEnv* env, jobject jframe);
-    void copyAccessLists(JNIEnv* env, jobject jframe);
+    /** Non-empty range that fits in int64 (callers charge gas before expanding). */
+    static bool inRange(int64_t offset, int64_t length) {
+        return offset >= 0 && length > 0 && length <= INT64_MAX - offset;
+    }
 
-    void syncPrimitiveFields(JNIEnv* env, jobject jframe) const;
-    void syncStack(JNIEnv* env, jobject jframe) const;
-    void syncMemory(JNIEnv* env, jobject jframe) const;
-    void syncLogs(JNIEnv* env, jobject jframe) const;
-    void syncSelfDestructs(JNIEnv* env, jobject jframe) const;
-    void syncAccessLists(JNIEnv* env, jobject jframe) const;
+    /** Grow memory (word aligned, zero filled) to at least end bytes. */
+    void ensureMemory(int64_t end) {
+        size_t size = static_cast<size_t>((end + 31) / 32 * 32);
+        if (size > memory_.size()) memory_.resize(size, 0);
+    }
 
-    void releaseJavaRefs();
+    /** Left-pad value into a 32-byte word (values over 32 bytes keep the low 32). */
+    static void toWord(const Bytes& value, Bytes32& out) {
+        size_t size = value.size() < 32 ? value.size() : 32;
+        size_t pad = 32 - size;
+        std::fill(out.begin(), out.begin() + pad, 0);
+        std::copy(value.end() - size, value.end(), out.begin() + pad);
+    }
+
+    /**
+     * Load machine state, context and access lists from a PackedFrameIn message
+     * (frame_codec.h). @return false if the message is malformed
+     */
+    bool decodePacked(const uint8_t* data, size_t size);
+
+    /** Encode the state to sync back as a PackedFrameOut message into out. */
+    void encodePacked(std::vector<uint8_t>& out) const;
 };
 
 }  // namespace evm
@@ -0,0 +1,55 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace besu {
+namespace evm {
+
+/**
+ * Minimal NUMA topology and placement helpers.
+ *
+ * Implemented directly on sysfs, sched_setaffinity and the mbind syscall so the
+ * library keeps no libnuma dependency. On non-Linux platforms (or single-node
+ * machines) everything reports one node and placement calls are no-ops that
+ * return false.
+ */
+namespace numa {
+
+constexpr int MAX_NODES = 64;
+
+/**
+ * Number of online NUMA nodes (at least 1).
+ */
+int node_count();
+
+/**
+ * Node the calling thread is currently running on (0 if unknown).
+ */
+int current_node();
+
+/**
+ * Number of online CPUs belonging to node (0 if unknown).
+ */
+int cpu_count(int node);
+
+/**
+ * Restrict the calling thread to the CPUs of node.
+ * @return true if the affinity mask was applied
+ */
+bool pin_thread_to_node(int node);
+
+/**
+ * Bind [addr, addr + size) to node before first touch (MPOL_BIND).
+ * Pages already faulted in elsewhere are migrated (MPOL_MF_MOVE).
+ * @return true if the policy was applied
+ */
+bool bind_memory(void* addr, size_t size, int node);
+
+} // namespace numa
+
+} // namespace evm
+} // namespace besu
@@ -0,0 +1,333 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace besu {
+namespace evm {
+
+/**
+ * EVM revisions (hard forks) with distinct opcode sets or gas schedules.
+ * Values are stable: they are stored in MessageFrameMemory and passed over FFM.
+ */
+enum class Revision : uint8_t {
+    ISTANBUL = 0,
+    BERLIN = 1,
+    LONDON = 2,
+    SHANGHAI = 3,
+    CANCUN = 4,
+    PRAGUE = 5
+};
+
+constexpr size_t REVISION_COUNT = 6;
+constexpr Revision LATEST_REVISION = Revision::PRAGUE;
+
+/**
+ * Opcode metadata.
+ *
+ * One constexpr table per revision holds the name, constant gas, stack inputs and
+ * outputs, immediate size and flags of every opcode. Dispatch tables, code
+ * analysis, benchmarks and tracers all read it, so costs and stack
+ * effects are not repeated as literals across engines and constant gas folds
+ * into each handler at compile time.
+ *
+ * base_gas is the constant part of the cost. For DYNAMIC_GAS opcodes the handler
+ * adds the rest (memory expansion, copy words, cold access surcharge, ...). For
+ * the EIP-2929 opcodes from Berlin on, base_gas is the warm access cost.
+ */
+struct OpcodeInfo {
+    const char* name;       // nullptr if undefined in this revision
+    uint16_t base_gas;
+    uint8_t stack_in;       // Items the opcode needs on the stack
+    uint8_t stack_out;      // Items it leaves in their place
+    uint8_t immediate;      // Immediate bytes after the opcode (PUSHn)
+    uint8_t flags;
+};
+
+namespace opcodes {
+
+constexpr uint8_t DEFINED = 1u << 0;
+constexpr uint8_t DYNAMIC_GAS = 1u << 1;
+constexpr uint8_t TERMINATES = 1u << 2;     // Ends execution of the frame
+constexpr uint8_t JUMPS = 1u << 3;          // Ends a basic block by branching
+constexpr uint8_t WRITES_STATE = 1u << 4;   // Not allowed in a static frame
+constexpr uint8_t NATIVE = 1u << 5;         // Has a handler in the native interpreter; others run as stubs
+
+constexpr uint8_t STOP = 0x00;
+constexpr uint8_t ADD = 0x01;
+constexpr uint8_t MUL = 0x02;
+constexpr uint8_t SUB = 0x03;
+constexpr uint8_t DIV = 0x04;
+constexpr uint8_t SDIV = 0x05;
+constexpr uint8_t MOD = 0x06;
+constexpr uint8_t SMOD = 0x07;
+constexpr uint8_t ADDMOD = 0x08;
+constexpr uint8_t MULMOD = 0x09;
+constexpr uint8_t EXP = 0x0a;
+constexpr uint8_t SIGNEXTEND = 0x0b;
+constexpr uint8_t LT = 0x10;
+constexpr uint8_t GT = 0x11;
+constexpr uint8_t SLT = 0x12;
+constexpr uint8_t SGT = 0x13;
+constexpr uint8_t EQ = 0x14;
+constexpr uint8_t ISZERO = 0x15;
+constexpr uint8_t AND = 0x16;
+constexpr uint8_t OR = 0x17;
+constexpr uint8_t XOR = 0x18;
+constexpr uint8_t NOT = 0x19;
+constexpr uint8_t BYTE = 0x1a;
+constexpr uint8_t SHL = 0x1b;
+constexpr uint8_t SHR = 0x1c;
+constexpr uint8_t SAR = 0x1d;
+constexpr uint8_t KECCAK256 = 0x20;
+constexpr uint8_t ADDRESS = 0x30;
+constexpr uint8_t BALANCE = 0x31;
+constexpr uint8_t ORIGIN = 0x32;
+constexpr uint8_t CALLER = 0x33;
+constexpr uint8_t CALLVALUE = 0x34;
+constexpr uint8_t CALLDATALOAD = 0x35;
+constexpr uint8_t CALLDATASIZE = 0x36;
+constexpr uint8_t CALLDATACOPY = 0x37;
+constexpr uint8_t CODESIZE = 0x38;
+constexpr uint8_t CODECOPY = 0x39;
+constexpr uint8_t GASPRICE = 0x3a;
+constexpr uint8_t EXTCODESIZE = 0x3b;
+constexpr uint8_t EXTCODECOPY = 0x3c;
+constexpr uint8_t RETURNDATASIZE = 0x3d;
+constexpr uint8_t RETURNDATACOPY = 0x3e;
+constexpr uint8_t EXTCODEHASH = 0x3f;
+constexpr uint8_t BLOCKHASH = 0x40;
+constexpr uint8_t COINBASE = 0x41;
+constexpr uint8_t TIMESTAMP = 0x42;
+constexpr uint8_t NUMBER = 0x43;
+constexpr uint8_t PREVRANDAO = 0x44;
+constexpr uint8_t GASLIMIT = 0x45;
+constexpr uint8_t CHAINID = 0x46;
+constexpr uint8_t SELFBALANCE = 0x47;
+constexpr uint8_t BASEFEE = 0x48;
+constexpr uint8_t BLOBHASH = 0x49;
+constexpr uint8_t BLOBBASEFEE = 0x4a;
+constexpr uint8_t POP = 0x50;
+constexpr uint8_t MLOAD = 0x51;
+constexpr uint8_t MSTORE = 0x52;
+constexpr uint8_t MSTORE8 = 0x53;
+constexpr uint8_t SLOAD = 0x54;
+constexpr uint8_t SSTORE = 0x55;
+constexpr uint8_t JUMP = 0x56;
+constexpr uint8_t JUMPI = 0x57;
+constexpr uint8_t PC = 0x58;
+constexpr uint8_t MSIZE = 0x59;
+constexpr uint8_t GAS = 0x5a;
+constexpr uint8_t JUMPDEST = 0x5b;
+constexpr uint8_t TLOAD = 0x5c;
+constexpr uint8_t TSTORE = 0x5d;
+constexpr uint8_t MCOPY = 0x5e;
+constexpr uint8_t PUSH0 = 0x5f;
+constexpr uint8_t PUSH1 = 0x60;
+constexpr uint8_t PUSH32 = 0x7f;
+constexpr uint8_t DUP1 = 0x80;
+constexpr uint8_t DUP16 = 0x8f;
+constexpr uint8_t SWAP1 = 0x90;
+constexpr uint8_t SWAP16 = 0x9f;
+constexpr uint8_t LOG0 = 0xa0;
+constexpr uint8_t LOG4 = 0xa4;
+constexpr uint8_t CREATE = 0xf0;
+constexpr uint8_t CALL = 0xf1;
+constexpr uint8_t CALLCODE = 0xf2;
+constexpr uint8_t RETURN = 0xf3;
+constexpr uint8_t DELEGATECALL = 0xf4;
+constexpr uint8_t CREATE2 = 0xf5;
+constexpr uint8_t STATICCALL = 0xfa;
+constexpr uint8_t REVERT = 0xfd;
+constexpr uint8_t INVALID = 0xfe;
+constexpr uint8_t SELFDESTRUCT = 0xff;
+
+namespace detail {
+
+constexpr OpcodeInfo op(const char* name, uint16_t gas, uint8_t in, uint8_t out, uint8_t flags = 0) {
+    return OpcodeInfo{name, gas, in, out, 0, static_cast<uint8_t>(flags | DEFINED)};
+}
+
+constexpr std::array<OpcodeInfo, 256> make_table(Revision revision) {
+    std::array<OpcodeInfo, 256> t{};
+    const bool berlin = revision >= Revision::BERLIN;
+
+    t[STOP] = op("STOP", 0, 0, 0, TERMINATES);
+    t[ADD] = op("ADD", 3, 2, 1);
+    t[MUL] = op("MUL", 5, 2, 1);
+    t[SUB] = op("SUB", 3, 2, 1);
+    t[DIV] = op("DIV", 5, 2, 1);
+    t[SDIV] = op("SDIV", 5, 2, 1);
+    t[MOD] = op("MOD", 5, 2, 1);
+    t[SMOD] = op("SMOD", 5, 2, 1);
+    t[ADDMOD] = op("ADDMOD", 8, 3, 1);
+    t[MULMOD] = op("MULMOD", 8, 3, 1);
+    t[EXP] = op("EXP", 10, 2, 1, DYNAMIC_GAS);
+    t[SIGNEXTEND] = op("SIGNEXTEND", 5, 2, 1);
+
+    t[LT] = op("LT", 3, 2, 1);
+    t[GT] = op("GT", 3, 2, 1);
+    t[SLT] = op("SLT", 3, 2, 1);
+    t[SGT] = op("SGT", 3, 2, 1);
+    t[EQ] = op("EQ", 3, 2, 1);
+    t[ISZERO] = op("ISZERO", 3, 1, 1);
+    t[AND] = op("AND", 3, 2, 1);
+    t[OR] = op("OR", 3, 2, 1);
+    t[XOR] = op("XOR", 3, 2, 1);
+    t[NOT] = op("NOT", 3, 1, 1);
+    t[BYTE] = op("BYTE", 3, 2, 1);
+    t[SHL] = op("SHL", 3, 2, 1);
+    t[SHR] = op("SHR", 3, 2, 1);
+    t[SAR] = op("SAR", 3, 2, 1);
+
+    t[KECCAK256] = op("KECCAK256", 30, 2, 1, DYNAMIC_GAS);
+
+    // EIP-2929 (Berlin): account access costs become warm cost + cold surcharge
+    const uint16_t account_gas = berlin ? 100 : 700;
+    t[ADDRESS] = op("ADDRESS", 2, 0, 1);
+    t[BALANCE] = op("BALANCE", account_gas, 1, 1, berlin ? DYNAMIC_GAS : 0);
+    t[ORIGIN] = op("ORIGIN", 2, 0, 1);
+    t[CALLER] = op("CALLER", 2, 0, 1);
+    t[CALLVALUE] = op("CALLVALUE", 2, 0, 1);
+    t[CALLDATALOAD] = op("CALLDATALOAD", 3, 1, 1);
+    t[CALLDATASIZE] = op("CALLDATASIZE", 2, 0, 1);
+    t[CALLDATACOPY] = op("CALLDATACOPY", 3, 3, 0, DYNAMIC_GAS);
+    t[CODESIZE] = op("CODESIZE", 2, 0, 1);
+    t[CODECOPY] = op("CODECOPY", 3, 3, 0, DYNAMIC_GAS);
+    t[GASPRICE] = op("GASPRICE", 2, 0, 1);
+    t[EXTCODESIZE] = op("EXTCODESIZE", account_gas, 1, 1, berlin ? DYNAMIC_GAS : 0);
+    t[EXTCODECOPY] = op("EXTCODECOPY", account_gas, 4, 0, DYNAMIC_GAS);
+    t[RETURNDATASIZE] = op("RETURNDATASIZE", 2, 0, 1);
+    t[RETURNDATACOPY] = op("RETURNDATACOPY", 3, 3, 0, DYNAMIC_GAS);
+    t[EXTCODEHASH] = op("EXTCODEHASH", account_gas, 1, 1, berlin ? DYNAMIC_GAS : 0);
+
+    t[BLOCKHASH] = op("BLOCKHASH", 20, 1, 1);
+    t[COINBASE] = op("COINBASE", 2, 0, 1);
+    t[TIMESTAMP] = op("TIMESTAMP", 2, 0, 1);
+    t[NUMBER] = op("NUMBER", 2, 0, 1);
+    t[PREVRANDAO] = op(revision >= Revision::LONDON ? "PREVRANDAO" : "DIFFICULTY", 2, 0, 1);
+    t[GASLIMIT] = op("GASLIMIT", 2, 0, 1);
+    t[CHAINID] = op("CHAINID", 2, 0, 1);
+    t[SELFBALANCE] = op("SELFBALANCE", 5, 0, 1);
+    if (revision >= Revision::LONDON) {
+        t[BASEFEE] = op("BASEFEE", 2, 0, 1);
+    }
+    if (revision >= Revision::CANCUN) {
+        t[BLOBHASH] = op("BLOBHASH", 3, 1, 1);
+        t[BLOBBASEFEE] = op("BLOBBASEFEE", 2, 0, 1);
+    }
+
+    t[POP] = op("POP", 2, 1, 0);
+    t[MLOAD] = op("MLOAD", 3, 1, 1, DYNAMIC_GAS);
+    t[MSTORE] = op("MSTORE", 3, 2, 0, DYNAMIC_GAS);
+    t[MSTORE8] = op("MSTORE8", 3, 2, 0, DYNAMIC_GAS);
+    t[SLOAD] = op("SLOAD", berlin ? 100 : 800, 1, 1, berlin ? DYNAMIC_GAS : 0);
+    t[SSTORE] = op("SSTORE", 0, 2, 0, DYNAMIC_GAS | WRITES_STATE);
+    t[JUMP] = op("JUMP", 8, 1, 0, JUMPS);
+    t[JUMPI] = op("JUMPI", 10, 2, 0, JUMPS);
+    t[PC] = op("PC", 2, 0, 1);
+    t[MSIZE] = op("MSIZE", 2, 0, 1);
+    t[GAS] = op("GAS", 2, 0, 1);
+    t[JUMPDEST] = op("JUMPDEST", 1, 0, 0);
+    if (revision >= Revision::CANCUN) {
+        t[TLOAD] = op("TLOAD", 100, 1, 1);
+        t[TSTORE] = op("TSTORE", 100, 2, 0, WRITES_STATE);
+        t[MCOPY] = op("MCOPY", 3, 3, 0, DYNAMIC_GAS);
+    }
+    if (revision >= Revision::SHANGHAI) {
+        t[PUSH0] = op("PUSH0", 2, 0, 1);
+    }
+
+    constexpr const char* push_names[32] = {
+        "PUSH1", "PUSH2", "PUSH3", "PUSH4", "PUSH5", "PUSH6", "PUSH7", "PUSH8",
+        "PUSH9", "PUSH10", "PUSH11", "PUSH12", "PUSH13", "PUSH14", "PUSH15", "PUSH16",
+        "PUSH17", "PUSH18", "PUSH19", "PUSH20", "PUSH21", "PUSH22", "PUSH23", "PUSH24",
+        "PUSH25", "PUSH26", "PUSH27", "PUSH28", "PUSH29", "PUSH30", "PUSH31", "PUSH32"};
+    constexpr const char* dup_names[16] = {
+        "DUP1", "DUP2", "DUP3", "DUP4", "DUP5", "DUP6", "DUP7", "DUP8",
+        "DUP9", "DUP10", "DUP11", "DUP12", "DUP13", "DUP14", "DUP15", "DUP16"};
+    constexpr const char* swap_names[16] = {
+        "SWAP1", "SWAP2", "SWAP3", "SWAP4", "SWAP5", "SWAP6", "SWAP7", "SWAP8",
+        "SWAP9", "SWAP10", "SWAP11", "SWAP12", "SWAP13", "SWAP14", "SWAP15", "SWAP16"};
+    constexpr const char* log_names[5] = {"LOG0", "LOG1", "LOG2", "LOG3", "LOG4"};
+
+    for (int n = 1; n <= 32; n++) {
+        t[PUSH1 + n - 1] = op(push_names[n - 1], 3, 0, 1);
+        t[PUSH1 + n - 1].immediate = static_cast<uint8_t>(n);
+    }
+    for (int n = 1; n <= 16; n++) {
+        t[DUP1 + n - 1] = op(dup_names[n - 1], 3, static_cast<uint8_t>(n), static_cast<uint8_t>(n + 1));
+        t[SWAP1 + n - 1] = op(swap_names[n - 1], 3, static_cast<uint8_t>(n + 1), static_cast<uint8_t>(n + 1));
+    }
+    for (int n = 0; n <= 4; n++) {
+        t[LOG0 + n] = op(log_names[n], static_cast<uint16_t>(375 * (n + 1)), static_cast<uint8_t>(n + 2), 0,
+                         DYNAMIC_GAS | WRITES_STATE);
+    }
+
+    const uint16_t call_gas = berlin ? 100 : 700;
+    t[CREATE] = op("CREATE", 32000, 3, 1, DYNAMIC_GAS | WRITES_STATE);
+    t[CALL] = op("CALL", call_gas, 7, 1, DYNAMIC_GAS);  // Writes state only with value
+    t[CALLCODE] = op("CALLCODE", call_gas, 7, 1, DYNAMIC_GAS);
+    t[RETURN] = op("RETURN", 0, 2, 0, DYNAMIC_GAS | TERMINATES);
+    t[DELEGATECALL] = op("DELEGATECALL", call_gas, 6, 1, DYNAMIC_GAS);
+    t[CREATE2] = op("CREATE2", 32000, 4, 1, DYNAMIC_GAS | WRITES_STATE);
+    t[STATICCALL] = op("STATICCALL", call_gas, 6, 1, DYNAMIC_GAS);
+    t[REVERT] = op("REVERT", 0, 2, 0, DYNAMIC_GAS | TERMINATES);
+    t[SELFDESTRUCT] = op("SELFDESTRUCT", 5000, 1, 0, DYNAMIC_GAS | WRITES_STATE | TERMINATES);
+    // INVALID (0xfe) stays undefined: executing it is an exceptional halt
+
+    // Opcodes evm_optimized.cpp implements natively; its dispatch tables are
+    // checked against this at compile time, and tools use it to spot stubs
+    constexpr uint8_t native[] = {
+        STOP, ADD, MUL, SUB, DIV, MOD, LT, GT, EQ, ISZERO, AND, OR, XOR, NOT, KECCAK256,
+        POP, MLOAD, MSTORE, MSTORE8, SLOAD, SSTORE, JUMP, JUMPI, PC, MSIZE, GAS, JUMPDEST, PUSH0};
+    for (uint8_t opcode : native) {
+        if (t[opcode].flags & DEFINED) t[opcode].flags |= NATIVE;
+    }
+    for (int opcode = PUSH1; opcode <= SWAP1 + 15; opcode++) {
+        t[opcode].flags |= NATIVE;
+    }
+    return t;
+}
+
+constexpr std::array<std::array<OpcodeInfo, 256>, REVISION_COUNT> make_tables() {
+    return {{
+        make_table(Revision::ISTANBUL),
+        make_table(Revision::BERLIN),
+        make_table(Revision::LONDON),
+        make_table(Revision::SHANGHAI),
+        make_table(Revision::CANCUN),
+        make_table(Revision::PRAGUE),
+    }};
+}
+
+} // namespace detail
+
+/** Metadata for every opcode, per revision. */
+constexpr std::array<std::array<OpcodeInfo, 256>, REVISION_COUNT> TABLES = detail::make_tables();
+
+/** Opcode metadata for revision, usable in constant expressions. */
+template <Revision R>
+constexpr const std::array<OpcodeInfo, 256>& TABLE = TABLES[static_cast<size_t>(R)];
+
+constexpr const OpcodeInfo& info(Revision revision, uint8_t opcode) {
+    return TABLES[static_cast<size_t>(revision)][opcode];
+}
+
+constexpr bool is_defined(Revision revision, uint8_t opcode) {
+    return (info(revision, opcode).flags & DEFINED) != 0;
+}
+
+/** True if the native interpreter has a handler for opcode in revision. */
+constexpr bool is_native(Revision revision, uint8_t opcode) {
+    return (info(revision, opcode).flags & NATIVE) != 0;
+}
+
+} // namespace opcodes
+
+} // namespace evm
+} // namespace besu
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "message_frame.h"
+#include "opcode_table.h"
 #include <optional>
 #include <string>
 
@@ -47,22 +48,29 @@ public:
     virtual uint8_t getOpcode() const = 0;
 
     /**
-     * Get the operation name.
+     * Get the operation name. Defaults to the opcode metadata table.
      * @return The name (e.g., "ADD", "MUL", "SSTORE")
      */
-    virtual const char* getName() const = 0;
+    virtual const char* getName() const {
+        const char* name = opcodes::info(LATEST_REVISION, getOpcode()).name;
+        return name ? name : "INVALID";
+    }
 
     /**
-     * Get the number of stack items consumed.
+     * Get the number of stack items consumed. Defaults to the opcode metadata table.
      * @return Number of items popped from stack
      */
-    virtual int getStackItemsConsumed() const = 0;
+    virtual int getStackItemsConsumed() const {
+        return opcodes::info(LATEST_REVISION, getOpcode()).stack_in;
+    }
 
     /**
-     * Get the number of stack items produced.
+     * Get the number of stack items produced. Defaults to the opcode metadata table.
      * @return Number of items pushed to stack
      */
-    virtual int getStackItemsProduced() const = 0;
+    virtual int getStackItemsProduced() const {
+        return opcodes::info(LATEST_REVISION, getOpcode()).stack_out;
+    }
 
     /**
      * Check if this is a virtual operation (not a real opcode).
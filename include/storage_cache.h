@@ -0,0 +1,198 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "flat_hash.h"
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace besu {
+namespace evm {
+
+/**
+ * Read-through storage cache in front of the Java WorldUpdater.
+ *
+ * SLOAD/SSTORE on a NativeMessageFrame go through this cache instead of calling
+ * into Java per access:
+ *
+ * - Misses are loaded in batches: the missed slot plus every slot queued with
+ *   prefetch() go to the StorageLoader in one call (one JNI round trip)
+ * - Writes stay native and are marked dirty; the frame writes all dirty slots
+ *   back once, in the packed sync-out message (frame_codec.h)
+ * - rollback() drops the writes and restores the values as loaded
+ *
+ * The cache lives for one native execution of a frame (fromJava to syncToJava).
+ * Java may roll back a child frame's writes without the native side seeing it, so
+ * entries are not carried over to the next frame.
+ */
+
+/** Current and original (transaction start) value of a slot, as EIP-2200 needs. */
+struct StorageValue {
+    Bytes32 current;
+    Bytes32 original;
+};
+
+/**
+ * Source for cache misses.
+ */
+class StorageLoader {
+public:
+    virtual ~StorageLoader() = default;
+
+    /**
+     * Load count slots into out[0..count).
+     * @return false if the values could not be loaded
+     */
+    virtual bool load(const AddressSlot* keys, size_t count, StorageValue* out) = 0;
+};
+
+/**
+ * Per-frame storage cache counters.
+ */
+struct StorageCacheStats {
+    uint64_t hits;
+    uint64_t misses;         // Accesses that had to wait for a load
+    uint64_t batches;        // Loader calls
+    uint64_t slots_loaded;   // Slots received over all batches
+};
+
+class StorageCache {
+public:
+    /** Slots per loader call, including the one that missed. */
+    static constexpr size_t MAX_BATCH = 64;
+
+    /**
+     * Drop all entries and queued prefetches and use loader for misses.
+     * Table capacity is kept.
+     */
+    void reset(StorageLoader* loader) {
+        entries_.clear();
+        pending_.clear();
+        loader_ = loader;
+        dirty_count_ = 0;
+        stats_ = StorageCacheStats{};
+    }
+
+    /**
+     * Queue a slot for the next batch. No-op if it is cached, already queued, or
+     * the batch is full.
+     */
+    void prefetch(const Address& address, const Bytes32& slot) {
+        if (pending_.size() + 1 >= MAX_BATCH) return;
+        AddressSlot key(address, slot);
+        if (entries_.insert(key, Entry{})) {
+            pending_.push_back(key);
+        }
+    }
+
+    /**
+     * Value of a slot, loading it (and any queued prefetches) on a miss.
+     * @return nullptr if the loader failed. Invalidated by the next cache call.
+     */
+    const StorageValue* get(const Address& address, const Bytes32& slot) {
+        Entry* entry = lookup(AddressSlot(address, slot));
+        return entry ? &entry->value : nullptr;
+    }
+
+    /**
+     * Set the current value of a slot, loading it first if needed so the
+     * original value is known.
+     * @return false if the loader failed
+     */
+    bool put(const Address& address, const Bytes32& slot, const Bytes32& value) {
+        Entry* entry = lookup(AddressSlot(address, slot));
+        if (!entry) return false;
+        if (entry->state != DIRTY) {
+            entry->state = DIRTY;
+            dirty_count_++;
+        }
+        entry->value.current = value;
+        return true;
+    }
+
+    /** Discard all writes since reset(). */
+    void rollback() {
+        if (dirty_count_ == 0) return;
+        entries_.forEach([](const AddressSlot&, Entry& entry) {
+            if (entry.state == DIRTY) {
+                entry.value.current = entry.loaded;
+                entry.state = CLEAN;
+            }
+        });
+        dirty_count_ = 0;
+    }
+
+    size_t dirtyCount() const { return dirty_count_; }
+
+    /** Call fn(key, current value) for every written slot, in unspecified order. */
+    template <typename Fn>
+    void forEachDirty(Fn&& fn) const {
+        if (dirty_count_ == 0) return;
+        entries_.forEach([&fn](const AddressSlot& key, const Entry& entry) {
+            if (entry.state == DIRTY) fn(key, entry.value.current);
+        });
+    }
+
+    const StorageCacheStats& stats() const { return stats_; }
+
+private:
+    enum State : uint8_t { PENDING, CLEAN, DIRTY };
+
+    struct Entry {
+        StorageValue value;
+        Bytes32 loaded;       // Value as loaded, for rollback
+        State state = PENDING;
+    };
+
+    Entry* lookup(const AddressSlot& key) {
+        Entry* entry = entries_.find(key);
+        if (entry && entry->state != PENDING) {
+            stats_.hits++;
+            return entry;
+        }
+        stats_.misses++;
+        if (!entry) {
+            entries_.insert(key, Entry{});
+            pending_.push_back(key);
+        }
+        if (!flush()) return nullptr;
+        return entries_.find(key);
+    }
+
+    /** Load every queued slot in one loader call. */
+    bool flush() {
+        if (pending_.empty()) return true;
+        values_.resize(pending_.size());
+
+        bool loaded = loader_ != nullptr && loader_->load(pending_.data(), pending_.size(), values_.data());
+        for (size_t i = 0; i < pending_.size(); i++) {
+            if (!loaded) {
+                entries_.erase(pending_[i]);
+                continue;
+            }
+            Entry* entry = entries_.find(pending_[i]);
+            entry->value = values_[i];
+            entry->loaded = values_[i].current;
+            entry->state = CLEAN;
+        }
+        if (loaded) {
+            stats_.batches++;
+            stats_.slots_loaded += pending_.size();
+        }
+        pending_.clear();
+        return loaded;
+    }
+
+    FlatHashMap<AddressSlot, Entry, AddressSlotHash, 64> entries_;
+    std::vector<AddressSlot> pending_;
+    std::vector<StorageValue> values_;
+    StorageLoader* loader_ = nullptr;
+    size_t dirty_count_ = 0;
+    StorageCacheStats stats_{};
+};
+
+} // namespace evm
+} // namespace besu
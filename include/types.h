@@ -4,18 +4,18 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace besu {
 namespace evm {
 
-// Forward declarations
-class UInt256;
-
 /**
  * Type alias for arbitrary byte sequences.
  * Corresponds to org.apache.tuweni.bytes.Bytes in Java.
@@ -28,6 +28,62 @@ using Bytes = std::vector<uint8_t>;
  */
 using Bytes32 = std::array<uint8_t, 32>;
 
+/**
+ * Non-owning read-only view of contiguous bytes (pointer + length).
+ * Views returned by IMessageFrame point into frame-owned storage; see the
+ * invalidation rules there.
+ */
+class ByteView {
+public:
+    constexpr ByteView() : data_(nullptr), size_(0) {}
+    constexpr ByteView(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+    ByteView(const Bytes& bytes) : data_(bytes.data()), size_(bytes.size()) {}
+    constexpr ByteView(const Bytes32& word) : data_(word.data()), size_(word.size()) {}
+
+    constexpr const uint8_t* data() const { return data_; }
+    constexpr size_t size() const { return size_; }
+    constexpr bool empty() const { return size_ == 0; }
+    constexpr const uint8_t* begin() const { return data_; }
+    constexpr const uint8_t* end() const { return data_ + size_; }
+    constexpr uint8_t operator[](size_t index) const { return data_[index]; }
+
+    /** Bytes [offset, offset + length), clamped to the view. */
+    constexpr ByteView slice(size_t offset, size_t length) const {
+        if (offset >= size_) return ByteView();
+        return ByteView(data_ + offset, length < size_ - offset ? length : size_ - offset);
+    }
+
+    /** Owning copy. */
+    Bytes toBytes() const { return Bytes(begin(), end()); }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+};
+
+/**
+ * Non-owning writable view of contiguous bytes, for in-place writes into
+ * frame-owned storage.
+ */
+class MutableByteView {
+public:
+    constexpr MutableByteView() : data_(nullptr), size_(0) {}
+    constexpr MutableByteView(uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    constexpr uint8_t* data() const { return data_; }
+    constexpr size_t size() const { return size_; }
+    constexpr bool empty() const { return size_ == 0; }
+    constexpr uint8_t* begin() const { return data_; }
+    constexpr uint8_t* end() const { return data_ + size_; }
+    constexpr uint8_t& operator[](size_t index) const { return data_[index]; }
+
+    constexpr operator ByteView() const { return ByteView(data_, size_); }
+
+private:
+    uint8_t* data_;
+    size_t size_;
+};
+
 /**
  * Ethereum address (20 bytes).
  * Corresponds to org.hyperledger.besu.datatypes.Address in Java.
@@ -81,101 +137,310 @@ private:
     DataType data_;
 };
 
-/**
- * Wei value (256-bit unsigned integer representing value in wei).
- * Corresponds to org.hyperledger.besu.datatypes.Wei in Java.
- */
-class Wei {
-public:
-    Wei();
-    explicit Wei(uint64_t value);
-    explicit Wei(const UInt256& value);
-    explicit Wei(const Bytes& bytes);
-
-    const UInt256& value() const;
-    Bytes toBytes() const;
-
-    bool isZero() const;
-
-    Wei operator+(const Wei& other) const;
-    Wei operator-(const Wei& other) const;
-    Wei operator*(const Wei& other) const;
-    Wei operator/(const Wei& other) const;
-
-    bool operator==(const Wei& other) const;
-    bool operator!=(const Wei& other) const;
-    bool operator<(const Wei& other) const;
-    bool operator>(const Wei& other) const;
-    bool operator<=(const Wei& other) const;
-    bool operator>=(const Wei& other) const;
-
-    std::string toString() const;
-
-private:
-    std::unique_ptr<UInt256> value_;
-};
-
 /**
  * 256-bit unsigned integer.
  * Corresponds to org.apache.tuweni.units.bigints.UInt256 in Java.
  *
- * This is a simplified interface. For production, consider using:
- * - boost::multiprecision::uint256_t
- * - intx library
- * - Custom optimized implementation
+ * Four 64-bit limbs held inline (limbs[0] = least significant), trivially
+ * copyable and fully constexpr, so temporaries never touch the heap. Arithmetic
+ * wraps modulo 2^256; division and modulo by zero return zero (EVM semantics).
+ * String conversions are out of line in src/types/uint256.cpp.
  */
 class UInt256 {
 public:
-    UInt256();
-    explicit UInt256(uint64_t value);
+    using Limbs = std::array<uint64_t, 4>;
+
+    constexpr UInt256() : limbs_{} {}
+    constexpr explicit UInt256(uint64_t value) : limbs_{value, 0, 0, 0} {}
+    constexpr UInt256(uint64_t l0, uint64_t l1, uint64_t l2, uint64_t l3) : limbs_{l0, l1, l2, l3} {}
     explicit UInt256(const Bytes& bytes);
-    UInt256(const UInt256& other);
-    UInt256(UInt256&& other) noexcept;
-    ~UInt256();
 
-    UInt256& operator=(const UInt256& other);
-    UInt256& operator=(UInt256&& other) noexcept;
+    constexpr const Limbs& limbs() const { return limbs_; }
+    constexpr uint64_t limb(size_t i) const { return limbs_[i]; }
 
     // Arithmetic operations
-    UInt256 operator+(const UInt256& other) const;
-    UInt256 operator-(const UInt256& other) const;
-    UInt256 operator*(const UInt256& other) const;
-    UInt256 operator/(const UInt256& other) const;
-    UInt256 operator%(const UInt256& other) const;
+    constexpr UInt256 operator+(const UInt256& other) const {
+        UInt256 result;
+        uint64_t carry = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            uint64_t sum = limbs_[i] + other.limbs_[i];
+            uint64_t carry_out = sum < limbs_[i];
+            result.limbs_[i] = sum + carry;
+            carry = carry_out | (result.limbs_[i] < sum);
+        }
+        return result;
+    }
+
+    constexpr UInt256 operator-(const UInt256& other) const {
+        UInt256 result;
+        uint64_t borrow = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            uint64_t diff = limbs_[i] - other.limbs_[i];
+            uint64_t borrow_out = limbs_[i] < other.limbs_[i];
+            result.limbs_[i] = diff - borrow;
+            borrow = borrow_out | (diff < borrow);
+        }
+        return result;
+    }
+
+    constexpr UInt256 operator*(const UInt256& other) const {
+        UInt256 result;
+        for (size_t i = 0; i < 4; ++i) {
+            uint64_t carry = 0;
+            for (size_t j = 0; i + j < 4; ++j) {
+                uint64_t hi = 0;
+                uint64_t lo = mul64(limbs_[i], other.limbs_[j], hi);
+                lo += carry;
+                hi += lo < carry;
+                uint64_t acc = result.limbs_[i + j] + lo;
+                hi += acc < lo;
+                result.limbs_[i + j] = acc;
+                carry = hi;
+            }
+        }
+        return result;
+    }
+
+    constexpr UInt256 operator/(const UInt256& other) const {
+        UInt256 quotient;
+        UInt256 remainder;
+        divmod(*this, other, quotient, remainder);
+        return quotient;
+    }
+
+    constexpr UInt256 operator%(const UInt256& other) const {
+        UInt256 quotient;
+        UInt256 remainder;
+        divmod(*this, other, quotient, remainder);
+        return remainder;
+    }
+
+    constexpr UInt256& operator+=(const UInt256& other) { return *this = *this + other; }
+    constexpr UInt256& operator-=(const UInt256& other) { return *this = *this - other; }
+    constexpr UInt256& operator*=(const UInt256& other) { return *this = *this * other; }
 
     // Bitwise operations
-    UInt256 operator&(const UInt256& other) const;
-    UInt256 operator|(const UInt256& other) const;
-    UInt256 operator^(const UInt256& other) const;
-    UInt256 operator~() const;
-    UInt256 operator<<(unsigned int shift) const;
-    UInt256 operator>>(unsigned int shift) const;
+    constexpr UInt256 operator&(const UInt256& other) const {
+        return UInt256(limbs_[0] & other.limbs_[0], limbs_[1] & other.limbs_[1],
+                       limbs_[2] & other.limbs_[2], limbs_[3] & other.limbs_[3]);
+    }
+
+    constexpr UInt256 operator|(const UInt256& other) const {
+        return UInt256(limbs_[0] | other.limbs_[0], limbs_[1] | other.limbs_[1],
+                       limbs_[2] | other.limbs_[2], limbs_[3] | other.limbs_[3]);
+    }
+
+    constexpr UInt256 operator^(const UInt256& other) const {
+        return UInt256(limbs_[0] ^ other.limbs_[0], limbs_[1] ^ other.limbs_[1],
+                       limbs_[2] ^ other.limbs_[2], limbs_[3] ^ other.limbs_[3]);
+    }
+
+    constexpr UInt256 operator~() const {
+        return UInt256(~limbs_[0], ~limbs_[1], ~limbs_[2], ~limbs_[3]);
+    }
+
+    constexpr UInt256 operator<<(unsigned int shift) const {
+        UInt256 result;
+        if (shift >= 256) return result;
+        const unsigned int words = shift / 64;
+        const unsigned int bits = shift % 64;
+        for (size_t i = 4; i-- > words;) {
+            uint64_t value = limbs_[i - words] << bits;
+            if (bits != 0 && i > words) {
+                value |= limbs_[i - words - 1] >> (64 - bits);
+            }
+            result.limbs_[i] = value;
+        }
+        return result;
+    }
+
+    constexpr UInt256 operator>>(unsigned int shift) const {
+        UInt256 result;
+        if (shift >= 256) return result;
+        const unsigned int words = shift / 64;
+        const unsigned int bits = shift % 64;
+        for (size_t i = 0; i + words < 4; ++i) {
+            uint64_t value = limbs_[i + words] >> bits;
+            if (bits != 0 && i + words + 1 < 4) {
+                value |= limbs_[i + words + 1] << (64 - bits);
+            }
+            result.limbs_[i] = value;
+        }
+        return result;
+    }
 
     // Comparison operations
-    bool operator==(const UInt256& other) const;
-    bool operator!=(const UInt256& other) const;
-    bool operator<(const UInt256& other) const;
-    bool operator>(const UInt256& other) const;
-    bool operator<=(const UInt256& other) const;
-    bool operator>=(const UInt256& other) const;
+    constexpr bool operator==(const UInt256& other) const {
+        return limbs_[0] == other.limbs_[0] && limbs_[1] == other.limbs_[1] &&
+               limbs_[2] == other.limbs_[2] && limbs_[3] == other.limbs_[3];
+    }
+
+    constexpr bool operator!=(const UInt256& other) const { return !(*this == other); }
+
+    constexpr bool operator<(const UInt256& other) const {
+        for (size_t i = 4; i-- > 0;) {
+            if (limbs_[i] != other.limbs_[i]) return limbs_[i] < other.limbs_[i];
+        }
+        return false;
+    }
+
+    constexpr bool operator>(const UInt256& other) const { return other < *this; }
+    constexpr bool operator<=(const UInt256& other) const { return !(other < *this); }
+    constexpr bool operator>=(const UInt256& other) const { return !(*this < other); }
 
     // Utility methods
-    bool isZero() const;
-    uint64_t toUint64() const;
+    constexpr bool isZero() const {
+        return (limbs_[0] | limbs_[1] | limbs_[2] | limbs_[3]) == 0;
+    }
+
+    constexpr bool fitsUint64() const { return (limbs_[1] | limbs_[2] | limbs_[3]) == 0; }
+    constexpr uint64_t toUint64() const { return limbs_[0]; }
+
+    /** Number of significant bits (0 for zero). */
+    constexpr unsigned int bitLength() const {
+        for (size_t i = 4; i-- > 0;) {
+            if (limbs_[i] != 0) {
+                unsigned int bits = 0;
+                for (uint64_t v = limbs_[i]; v != 0; v >>= 1) ++bits;
+                return static_cast<unsigned int>(i * 64) + bits;
+            }
+        }
+        return 0;
+    }
+
     Bytes toBytes() const;
-    Bytes32 toBytes32() const;
+
+    /** Big-endian 32-byte encoding. */
+    constexpr Bytes32 toBytes32() const {
+        Bytes32 result{};
+        for (size_t i = 0; i < 32; ++i) {
+            result[31 - i] = static_cast<uint8_t>(limbs_[i / 8] >> (8 * (i % 8)));
+        }
+        return result;
+    }
+
     std::string toString() const;
     std::string toHexString() const;
 
+    /** Decode up to 32 big-endian bytes (shorter input is left-padded with zeros). */
+    static constexpr UInt256 fromBytes(const uint8_t* data, size_t size) {
+        UInt256 result;
+        for (size_t i = 0; i < size && i < 32; ++i) {
+            result.limbs_[i / 8] |= static_cast<uint64_t>(data[size - 1 - i]) << (8 * (i % 8));
+        }
+        return result;
+    }
+
     static UInt256 fromBytes(const Bytes& bytes);
-    static UInt256 fromBytes32(const Bytes32& bytes);
+
+    static constexpr UInt256 fromBytes32(const Bytes32& bytes) {
+        UInt256 result;
+        for (size_t i = 0; i < 32; ++i) {
+            result.limbs_[i / 8] |= static_cast<uint64_t>(bytes[31 - i]) << (8 * (i % 8));
+        }
+        return result;
+    }
+
     static UInt256 fromHexString(const std::string& hex);
 
+    /**
+     * Quotient and remainder in one pass. Division by zero yields zero for both.
+     */
+    static constexpr void divmod(const UInt256& dividend, const UInt256& divisor,
+                                 UInt256& quotient, UInt256& remainder) {
+        quotient = UInt256();
+        remainder = UInt256();
+        if (divisor.isZero()) return;
+        if (dividend < divisor) {
+            remainder = dividend;
+            return;
+        }
+        if (dividend.fitsUint64()) {
+            quotient.limbs_[0] = dividend.limbs_[0] / divisor.limbs_[0];
+            remainder.limbs_[0] = dividend.limbs_[0] % divisor.limbs_[0];
+            return;
+        }
+
+        // Shift-subtract over the bit length difference only
+        const unsigned int divisor_bits = divisor.bitLength();
+        const unsigned int shift = dividend.bitLength() - divisor_bits;
+        remainder = dividend;
+        UInt256 shifted = divisor << shift;
+        for (unsigned int i = shift + 1; i-- > 0;) {
+            if (remainder >= shifted) {
+                remainder -= shifted;
+                quotient.limbs_[i / 64] |= uint64_t(1) << (i % 64);
+            }
+            shifted = shifted >> 1;
+        }
+    }
+
 private:
-    struct Impl;
-    std::unique_ptr<Impl> impl_;
+    /** 64x64 -> 128-bit multiply; returns the low half and stores the high half. */
+    static constexpr uint64_t mul64(uint64_t a, uint64_t b, uint64_t& hi) {
+#ifdef __SIZEOF_INT128__
+        __extension__ typedef unsigned __int128 uint128;
+        uint128 product = static_cast<uint128>(a) * b;
+        hi = static_cast<uint64_t>(product >> 64);
+        return static_cast<uint64_t>(product);
+#else
+        uint64_t a_lo = a & 0xffffffffu, a_hi = a >> 32;
+        uint64_t b_lo = b & 0xffffffffu, b_hi = b >> 32;
+        uint64_t lo_lo = a_lo * b_lo;
+        uint64_t hi_lo = a_hi * b_lo;
+        uint64_t lo_hi = a_lo * b_hi;
+        uint64_t hi_hi = a_hi * b_hi;
+        uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xffffffffu) + lo_hi;
+        hi = hi_hi + (hi_lo >> 32) + (cross >> 32);
+        return (cross << 32) | (lo_lo & 0xffffffffu);
+#endif
+    }
+
+    Limbs limbs_;
 };
 
+static_assert(sizeof(UInt256) == 32, "UInt256 must be 32 bytes");
+static_assert(std::is_trivially_copyable<UInt256>::value, "UInt256 must be trivially copyable");
+
+/**
+ * Wei value (256-bit unsigned integer representing value in wei).
+ * Corresponds to org.hyperledger.besu.datatypes.Wei in Java.
+ *
+ * Same inline representation as UInt256; arithmetic wraps modulo 2^256.
+ */
+class Wei {
+public:
+    constexpr Wei() : value_() {}
+    constexpr explicit Wei(uint64_t value) : value_(value) {}
+    constexpr explicit Wei(const UInt256& value) : value_(value) {}
+    explicit Wei(const Bytes& bytes) : value_(bytes) {}
+
+    constexpr const UInt256& value() const { return value_; }
+    Bytes toBytes() const { return value_.toBytes(); }
+    constexpr Bytes32 toBytes32() const { return value_.toBytes32(); }
+
+    constexpr bool isZero() const { return value_.isZero(); }
+
+    constexpr Wei operator+(const Wei& other) const { return Wei(value_ + other.value_); }
+    constexpr Wei operator-(const Wei& other) const { return Wei(value_ - other.value_); }
+    constexpr Wei operator*(const Wei& other) const { return Wei(value_ * other.value_); }
+    constexpr Wei operator/(const Wei& other) const { return Wei(value_ / other.value_); }
+
+    constexpr bool operator==(const Wei& other) const { return value_ == other.value_; }
+    constexpr bool operator!=(const Wei& other) const { return value_ != other.value_; }
+    constexpr bool operator<(const Wei& other) const { return value_ < other.value_; }
+    constexpr bool operator>(const Wei& other) const { return value_ > other.value_; }
+    constexpr bool operator<=(const Wei& other) const { return value_ <= other.value_; }
+    constexpr bool operator>=(const Wei& other) const { return value_ >= other.value_; }
+
+    std::string toString() const { return value_.toString(); }
+
+private:
+    UInt256 value_;
+};
+
+static_assert(std::is_trivially_copyable<Wei>::value, "Wei must be trivially copyable");
+
 /**
  * Versioned hash for EIP-4844.
  * Corresponds to org.hyperledger.besu.datatypes.VersionedHash in Java.
@@ -194,6 +459,26 @@ private:
     Bytes32 data_;
 };
 
+/**
+ * Log entry emitted by LOG0-LOG4.
+ * Corresponds to org.hyperledger.besu.evm.log.Log in Java.
+ */
+class Log {
+public:
+    Log() = default;
+    Log(const Address& logger, Bytes data, std::vector<Bytes32> topics)
+        : logger_(logger), data_(std::move(data)), topics_(std::move(topics)) {}
+
+    const Address& getLogger() const { return logger_; }
+    const Bytes& getData() const { return data_; }
+    const std::vector<Bytes32>& getTopics() const { return topics_; }
+
+private:
+    Address logger_;
+    Bytes data_;
+    std::vector<Bytes32> topics_;
+};
+
 // Utility functions for hex conversion
 std::string bytesToHex(const Bytes& bytes);
 Bytes hexToBytes(const std::string& hex);
@@ -0,0 +1,256 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "account_witness.h"
+#include "storage_memory.h"
+#include "witness_index.h"
+#include <cstdint>
+#include <cstring>
+
+namespace besu {
+namespace evm {
+
+/**
+ * Witness file: a block's (or a call's) witness on disk, ready to mmap.
+ *
+ * The file holds a TransactionWitness exactly as execution reads it, followed by
+ * the witness_index hash tables over its accounts and storage. Opening one is a
+ * mapping plus a header check: no entries are decoded or copied, the indexes are
+ * not rebuilt, and processes mapping the same file share its page cache pages.
+ *
+ * File layout (host byte order, sections 64-byte aligned):
+ *
+ * ┌─────────────────────────┐
+ * │ WitnessFileHeader       │ 128 bytes
+ * ├─────────────────────────┤
+ * │ TransactionWitness      │ witness_size bytes, offsets relative to its start
+ * │   accounts, code,       │
+ * │   storage               │
+ * ├─────────────────────────┤
+ * │ account index           │ account_index_capacity x uint32_t
+ * ├─────────────────────────┤
+ * │ storage index           │ storage_index_capacity x uint32_t
+ * └─────────────────────────┘
+ *
+ * The witness section can be handed to besu_pipeline_submit() or copied into a
+ * frame as is. Entries are trusted like a witness laid out by Java: the header
+ * and section bounds are checked on open, account code offsets are not.
+ */
+
+constexpr uint64_t WITNESS_FILE_MAGIC = 0x3154495755534542ull;  // "BESUWIT1"
+constexpr uint32_t WITNESS_FILE_VERSION = 1;
+constexpr uint64_t WITNESS_FILE_ALIGNMENT = 64;
+
+struct WitnessFileHeader {
+    uint64_t magic;                   // WITNESS_FILE_MAGIC
+    uint32_t version;                 // WITNESS_FILE_VERSION
+    uint32_t header_size;             // sizeof(WitnessFileHeader)
+    uint32_t account_entry_size;      // sizeof(AccountEntry) of the writer
+    uint32_t storage_entry_size;      // sizeof(StorageEntry) of the writer
+    uint64_t block_number;            // Informational (0 = not a block witness)
+    uint64_t file_size;
+    uint64_t witness_offset;
+    uint64_t witness_size;
+    uint64_t account_index_offset;
+    uint64_t storage_index_offset;
+    uint32_t account_index_capacity;  // Power of two (witness_index::capacity_for)
+    uint32_t storage_index_capacity;
+    uint64_t reserved[6];
+};
+
+static_assert(sizeof(WitnessFileHeader) == 128, "WitnessFileHeader must be 128 bytes");
+
+/** besu_witness_file_open() status values. */
+enum WitnessFileStatus : uint32_t {
+    WITNESS_FILE_OK          = 0,
+    WITNESS_FILE_IO_ERROR    = 1,  // Cannot open, read or map the file
+    WITNESS_FILE_BAD_MAGIC   = 2,  // Not a witness file (or other byte order)
+    WITNESS_FILE_BAD_VERSION = 3,  // Other format version or entry layout
+    WITNESS_FILE_MALFORMED   = 4,  // Sections or counts out of range
+};
+
+/**
+ * An open witness file (shared with Java via Panama FFM, read only).
+ * Pointers are absolute and stay valid until besu_witness_file_close(). The
+ * mapping is private and writable: changes (is_warm, storage values) stay in
+ * this process and never reach the file.
+ */
+struct WitnessFile {
+    uint64_t       block_number;
+    uint32_t       account_count;
+    uint32_t       storage_count;
+    uint8_t*       witness;             // TransactionWitness
+    uint64_t       witness_size;
+    AccountEntry*  accounts;
+    StorageEntry*  storage;
+    uint32_t*      account_index;       // witness_index slots (entry index + 1, 0 = empty)
+    uint32_t*      storage_index;
+    uint32_t       account_index_mask;
+    uint32_t       storage_index_mask;
+    uint8_t*       data;                // Whole file
+    uint64_t       size;
+    uint32_t       mapped;              // 1 = mmap, 0 = read into the heap
+    uint32_t       reserved;
+};
+
+namespace witness_file {
+
+inline uint64_t align(uint64_t n) {
+    return (n + WITNESS_FILE_ALIGNMENT - 1) & ~(WITNESS_FILE_ALIGNMENT - 1);
+}
+
+inline bool fits(uint64_t offset, uint64_t length, uint64_t size) {
+    return offset <= size && length <= size - offset;
+}
+
+/**
+ * Check the TransactionWitness in witness[0, size): its header, account and
+ * storage arrays in range and the accounts aligned.
+ */
+inline bool witness_valid(const uint8_t* witness, uint64_t size) {
+    if (size < sizeof(TransactionWitness)) return false;
+    const TransactionWitness* w = reinterpret_cast<const TransactionWitness*>(witness);
+    return w->account_count <= witness_index::MAX_ENTRIES && w->storage_count <= witness_index::MAX_ENTRIES &&
+           fits(w->accounts_ptr, uint64_t(w->account_count) * sizeof(AccountEntry), size) &&
+           fits(w->storage_ptr, uint64_t(w->storage_count) * sizeof(StorageEntry), size) &&
+           w->accounts_ptr % alignof(AccountEntry) == 0 && w->storage_ptr % alignof(StorageEntry) == 0;
+}
+
+/**
+ * Lay out a file for a valid witness of witness_size bytes.
+ * @return File size; header is filled in
+ */
+inline uint64_t layout(const uint8_t* witness, uint64_t witness_size, uint64_t block_number,
+                       WitnessFileHeader* header) {
+    const TransactionWitness* w = reinterpret_cast<const TransactionWitness*>(witness);
+    memset(header, 0, sizeof(WitnessFileHeader));
+    header->magic = WITNESS_FILE_MAGIC;
+    header->version = WITNESS_FILE_VERSION;
+    header->header_size = sizeof(WitnessFileHeader);
+    header->account_entry_size = sizeof(AccountEntry);
+    header->storage_entry_size = sizeof(StorageEntry);
+    header->block_number = block_number;
+    header->account_index_capacity = witness_index::capacity_for(w->account_count);
+    header->storage_index_capacity = witness_index::capacity_for(w->storage_count);
+    header->witness_offset = align(sizeof(WitnessFileHeader));
+    header->witness_size = witness_size;
+    header->account_index_offset = align(header->witness_offset + witness_size);
+    header->storage_index_offset = align(header->account_index_offset +
+                                         uint64_t(header->account_index_capacity) * sizeof(uint32_t));
+    header->file_size = header->storage_index_offset + uint64_t(header->storage_index_capacity) * sizeof(uint32_t);
+    return header->file_size;
+}
+
+/**
+ * Write a whole file into out (header->file_size bytes, zeroed, 8-byte aligned):
+ * header, witness copy and both indexes.
+ */
+inline void build(const uint8_t* witness, const WitnessFileHeader* header, uint8_t* out) {
+    memcpy(out, header, sizeof(WitnessFileHeader));
+    uint8_t* copy = out + header->witness_offset;
+    memcpy(copy, witness, header->witness_size);
+    const TransactionWitness* w = reinterpret_cast<const TransactionWitness*>(copy);
+    witness_index::build_accounts(reinterpret_cast<const AccountEntry*>(copy + w->accounts_ptr), w->account_count,
+                                  reinterpret_cast<uint32_t*>(out + header->account_index_offset),
+                                  header->account_index_capacity);
+    witness_index::build_storage(reinterpret_cast<const StorageEntry*>(copy + w->storage_ptr), w->storage_count,
+                                 reinterpret_cast<uint32_t*>(out + header->storage_index_offset),
+                                 header->storage_index_capacity);
+}
+
+/**
+ * Check the file in data[0, size) and point file at its sections. O(1): only
+ * the header and section bounds are read. data must be 8-byte aligned.
+ * @return WitnessFileStatus
+ */
+inline uint32_t open_view(uint8_t* data, uint64_t size, WitnessFile* file) {
+    memset(file, 0, sizeof(WitnessFile));
+    if (size < sizeof(WitnessFileHeader)) return WITNESS_FILE_BAD_MAGIC;
+    const WitnessFileHeader* h = reinterpret_cast<const WitnessFileHeader*>(data);
+    if (h->magic != WITNESS_FILE_MAGIC) return WITNESS_FILE_BAD_MAGIC;
+    if (h->version != WITNESS_FILE_VERSION || h->header_size != sizeof(WitnessFileHeader) ||
+        h->account_entry_size != sizeof(AccountEntry) || h->storage_entry_size != sizeof(StorageEntry)) {
+        return WITNESS_FILE_BAD_VERSION;
+    }
+
+    const uint32_t account_capacity = h->account_index_capacity;
+    const uint32_t storage_capacity = h->storage_index_capacity;
+    if (h->file_size > size || h->witness_offset % WITNESS_FILE_ALIGNMENT != 0 ||
+        h->account_index_offset % alignof(uint32_t) != 0 || h->storage_index_offset % alignof(uint32_t) != 0 ||
+        !fits(h->witness_offset, h->witness_size, h->file_size) ||
+        !fits(h->account_index_offset, uint64_t(account_capacity) * sizeof(uint32_t), h->file_size) ||
+        !fits(h->storage_index_offset, uint64_t(storage_capacity) * sizeof(uint32_t), h->file_size) ||
+        !witness_valid(data + h->witness_offset, h->witness_size)) {
+        return WITNESS_FILE_MALFORMED;
+    }
+
+    uint8_t* witness = data + h->witness_offset;
+    const TransactionWitness* w = reinterpret_cast<const TransactionWitness*>(witness);
+    // The index must be a power of two with a free slot, or a miss would probe forever
+    if (account_capacity == 0 || (account_capacity & (account_capacity - 1)) != 0 ||
+        account_capacity <= w->account_count || storage_capacity == 0 ||
+        (storage_capacity & (storage_capacity - 1)) != 0 || storage_capacity <= w->storage_count) {
+        return WITNESS_FILE_MALFORMED;
+    }
+
+    file->block_number = h->block_number;
+    file->account_count = w->account_count;
+    file->storage_count = w->storage_count;
+    file->witness = witness;
+    file->witness_size = h->witness_size;
+    file->accounts = reinterpret_cast<AccountEntry*>(witness + w->accounts_ptr);
+    file->storage = reinterpret_cast<StorageEntry*>(witness + w->storage_ptr);
+    file->account_index = reinterpret_cast<uint32_t*>(data + h->account_index_offset);
+    file->storage_index = reinterpret_cast<uint32_t*>(data + h->storage_index_offset);
+    file->account_index_mask = account_capacity - 1;
+    file->storage_index_mask = storage_capacity - 1;
+    file->data = data;
+    file->size = size;
+    return WITNESS_FILE_OK;
+}
+
+inline AccountEntry* find_account(const WitnessFile* file, const uint8_t* address) {
+    return witness_index::find_account(file->accounts, file->account_index, file->account_index_mask, address);
+}
+
+inline StorageEntry* find_storage(const WitnessFile* file, const uint8_t* address, const uint8_t* key) {
+    return witness_index::find_storage(file->storage, file->storage_index, file->storage_index_mask, address, key);
+}
+
+} // namespace witness_file
+
+extern "C" {
+
+/**
+ * Write witness (a TransactionWitness, offsets relative to its start) to path as
+ * a witness file, building its indexes.
+ * @return false if the witness is malformed or the file cannot be written
+ */
+bool besu_witness_file_write(const char* path, const uint8_t* witness, uint64_t witness_size,
+                             uint64_t block_number);
+
+/**
+ * Map a witness file.
+ * @param status Optional, receives a WitnessFileStatus
+ * @return Open file, or nullptr on failure
+ */
+WitnessFile* besu_witness_file_open(const char* path, uint32_t* status);
+
+/**
+ * Indexed lookups. Return nullptr if not found.
+ */
+AccountEntry* besu_witness_file_find_account(const WitnessFile* file, const uint8_t* address);
+StorageEntry* besu_witness_file_find_storage(const WitnessFile* file, const uint8_t* address,
+                                             const uint8_t* key);
+
+/**
+ * Unmap the file. Pointers into it become invalid.
+ */
+void besu_witness_file_close(WitnessFile* file);
+
+} // extern "C"
+
+} // namespace evm
+} // namespace besu
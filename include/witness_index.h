@@ -0,0 +1,157 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "account_witness.h"
+#include "storage_memory.h"
+#include <cstdint>
+#include <cstring>
+
+namespace besu {
+namespace evm {
+
+/**
+ * Open-addressing hash index over witness entry arrays.
+ *
+ * witness::find_account and storage::find are linear scans, which is fine for a
+ * single transaction but not for a block-level witness with thousands of
+ * accounts and slots. The index is a power-of-two array of uint32_t slots holding
+ * entry index + 1 (0 = empty), probed linearly. Entries are not moved, so the
+ * index can be built over a witness Java has already laid out.
+ *
+ * Duplicate keys keep the first entry, matching the linear scan.
+ */
+namespace witness_index {
+
+constexpr uint32_t EMPTY_SLOT = 0;
+constexpr uint32_t MAX_ENTRIES = 1u << 30;
+
+/**
+ * Slot count for count entries (power of two, load factor <= 0.5).
+ */
+inline uint32_t capacity_for(uint32_t count) {
+    uint32_t capacity = 16;
+    while (capacity < count * 2) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+inline uint64_t load64(const uint8_t* p) {
+    uint64_t value;
+    memcpy(&value, p, 8);
+    return value;
+}
+
+inline uint64_t mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+inline uint64_t rotl(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t hash_address(const uint8_t* address) {
+    uint32_t tail;
+    memcpy(&tail, address + 16, 4);
+    return mix(load64(address) ^ rotl(load64(address + 8), 21) ^ (static_cast<uint64_t>(tail) << 7));
+}
+
+inline uint64_t hash_slot(const uint8_t* address, const uint8_t* key) {
+    uint64_t k = load64(key) ^ rotl(load64(key + 8), 16) ^
+                 rotl(load64(key + 16), 32) ^ rotl(load64(key + 24), 48);
+    return mix(hash_address(address) ^ k);
+}
+
+/**
+ * Build an account index. slots must hold capacity entries (capacity_for(count)).
+ */
+inline void build_accounts(const AccountEntry* entries, uint32_t count,
+                           uint32_t* slots, uint32_t capacity) {
+    memset(slots, 0, capacity * sizeof(uint32_t));
+    uint32_t mask = capacity - 1;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t pos = static_cast<uint32_t>(hash_address(entries[i].address)) & mask;
+        while (true) {
+            uint32_t slot = slots[pos];
+            if (slot == EMPTY_SLOT) {
+                slots[pos] = i + 1;
+                break;
+            }
+            if (memcmp(entries[slot - 1].address, entries[i].address, 20) == 0) {
+                break;  // Duplicate: first entry wins
+            }
+            pos = (pos + 1) & mask;
+        }
+    }
+}
+
+/**
+ * Find account entry by address.
+ * Returns nullptr if not found.
+ */
+inline AccountEntry* find_account(AccountEntry* entries, const uint32_t* slots,
+                                  uint32_t mask, const uint8_t* address) {
+    uint32_t pos = static_cast<uint32_t>(hash_address(address)) & mask;
+    while (true) {
+        uint32_t slot = slots[pos];
+        if (slot == EMPTY_SLOT) return nullptr;
+        AccountEntry* entry = &entries[slot - 1];
+        if (memcmp(entry->address, address, 20) == 0) return entry;
+        pos = (pos + 1) & mask;
+    }
+}
+
+/**
+ * Build a storage index. slots must hold capacity entries (capacity_for(count)).
+ */
+inline void build_storage(const StorageEntry* entries, uint32_t count,
+                          uint32_t* slots, uint32_t capacity) {
+    memset(slots, 0, capacity * sizeof(uint32_t));
+    uint32_t mask = capacity - 1;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t pos = static_cast<uint32_t>(hash_slot(entries[i].address, entries[i].key)) & mask;
+        while (true) {
+            uint32_t slot = slots[pos];
+            if (slot == EMPTY_SLOT) {
+                slots[pos] = i + 1;
+                break;
+            }
+            const StorageEntry* other = &entries[slot - 1];
+            if (memcmp(other->address, entries[i].address, 20) == 0 &&
+                memcmp(other->key, entries[i].key, 32) == 0) {
+                break;
+            }
+            pos = (pos + 1) & mask;
+        }
+    }
+}
+
+/**
+ * Find storage entry for a given address + key.
+ * Returns nullptr if not found.
+ */
+inline StorageEntry* find_storage(StorageEntry* entries, const uint32_t* slots,
+                                  uint32_t mask, const uint8_t* address, const uint8_t* key) {
+    uint32_t pos = static_cast<uint32_t>(hash_slot(address, key)) & mask;
+    while (true) {
+        uint32_t slot = slots[pos];
+        if (slot == EMPTY_SLOT) return nullptr;
+        StorageEntry* entry = &entries[slot - 1];
+        if (memcmp(entry->address, address, 20) == 0 && memcmp(entry->key, key, 32) == 0) {
+            return entry;
+        }
+        pos = (pos + 1) & mask;
+    }
+}
+
+} // namespace witness_index
+
+} // namespace evm
+} // namespace besu
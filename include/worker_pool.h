@@ -0,0 +1,90 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "arena.h"
+#include <cstdint>
+
+namespace besu {
+namespace evm {
+
+struct MessageFrameMemory;
+
+/**
+ * NUMA-aware native worker pool for parallel execution.
+ *
+ * Workers are split into contiguous groups per NUMA node and pinned to that node's
+ * CPUs. Each worker creates its own arena from inside its pinned thread, bound to
+ * the node (mbind) and faulted in by first touch, so frames and witnesses built by
+ * a task stay socket-local.
+ *
+ * Work stealing prefers locality: an idle worker first drains its own queue, then
+ * steals from workers on the same node, and only then crosses sockets.
+ */
+
+/**
+ * Task callback.
+ * @param arg Opaque argument passed to besu_pool_submit
+ * @param arena The executing worker's node-local arena
+ */
+typedef void (*WorkerTask)(void* arg, Arena* arena);
+
+/**
+ * Pool statistics (shared with Java via Panama FFM).
+ */
+struct WorkerPoolStats {
+    uint64_t executed;       // Tasks completed
+    uint64_t stolen_local;   // Tasks stolen from a worker on the same node
+    uint64_t stolen_remote;  // Tasks stolen across nodes
+    uint32_t workers;        // Worker threads
+    uint32_t nodes;          // NUMA nodes the workers are spread across
+};
+
+struct WorkerPool;
+
+extern "C" {
+
+/**
+ * Start a pool.
+ * @param workers Thread count (0 = one per online CPU)
+ * @param arena_bytes Per-worker arena size (0 = no arenas)
+ * @param arena_flags ArenaFlags for the per-worker arenas
+ */
+WorkerPool* besu_pool_create(uint32_t workers, uint64_t arena_bytes, uint32_t arena_flags);
+
+/**
+ * Queue a task.
+ * @param node Preferred NUMA node (-1 = round robin over all workers)
+ * @return false if the pool is shutting down
+ */
+bool besu_pool_submit(WorkerPool* pool, WorkerTask task, void* arg, int32_t node);
+
+/**
+ * Block until every submitted task has completed.
+ */
+void besu_pool_wait(WorkerPool* pool);
+
+/**
+ * Execute independent frames in parallel and wait for completion.
+ * Frames carry no tracer (tracer upcalls are not safe from pool threads).
+ */
+void besu_pool_execute_batch(WorkerPool* pool, MessageFrameMemory** frames, uint32_t count);
+
+/**
+ * Reset every worker arena (call between blocks, after besu_pool_wait).
+ * @return false, resetting nothing, if tasks are still queued or running
+ */
+bool besu_pool_reset_arenas(WorkerPool* pool);
+
+void besu_pool_stats(const WorkerPool* pool, WorkerPoolStats* out);
+
+/**
+ * Stop the workers (after draining queued tasks) and release their arenas.
+ */
+void besu_pool_destroy(WorkerPool* pool);
+
+} // extern "C"
+
+} // namespace evm
+} // namespace besu
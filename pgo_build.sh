@@ -0,0 +1,152 @@
+#!/bin/bash
+# Profile-guided build of Besu Native EVM
+#
+# 1. Instrumented build of besu_native_evm (-DBESU_PGO=GENERATE)
+# 2. Training: the contract workloads and per-opcode blocks from bench/, and any
+#    execution recordings given with --recordings (replayed with evm-replay)
+# 3. Optimized rebuild with the profile (-DBESU_PGO=USE)
+# 4. With --bolt: llvm-bolt instrumentation, the same training, and a relayout of
+#    the optimized library
+#
+# Usage: ./pgo_build.sh [--build-dir DIR] [--recordings FILE|DIR]... [--seconds S] [--bolt]
+
+set -e  # Exit on error
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+YELLOW='\033[1;33m'
+BLUE='\033[0;34m'
+NC='\033[0m' # No Color
+
+BUILD_DIR="build-pgo"
+SECONDS_PER_WORKLOAD="0.5"
+USE_BOLT=false
+RECORDINGS=()
+
+while [ $# -gt 0 ]; do
+    case "$1" in
+        --build-dir) BUILD_DIR="$2"; shift 2 ;;
+        --recordings) RECORDINGS+=("$2"); shift 2 ;;
+        --seconds) SECONDS_PER_WORKLOAD="$2"; shift 2 ;;
+        --bolt) USE_BOLT=true; shift ;;
+        -h|--help)
+            sed -n '2,12p' "$0" | sed 's/^# \{0,1\}//'
+            exit 0
+            ;;
+        *)
+            echo -e "${RED}Unknown option: $1${NC}"
+            exit 2
+            ;;
+    esac
+done
+
+echo -e "${GREEN}=== Besu Native EVM Profile-Guided Build ===${NC}"
+
+COMPILER_ID=$(${CXX:-c++} --version | head -1)
+IS_CLANG=false
+if echo "$COMPILER_ID" | grep -qi clang; then
+    IS_CLANG=true
+fi
+echo -e "${BLUE}Compiler: $COMPILER_ID${NC}"
+
+if [ "$USE_BOLT" = true ] && ! command -v llvm-bolt >/dev/null 2>&1; then
+    echo -e "${RED}Error: --bolt needs llvm-bolt on the PATH${NC}"
+    exit 1
+fi
+
+if [[ "$OSTYPE" == "darwin"* ]]; then
+    LIB_NAME="libbesu_native_evm.dylib"
+else
+    LIB_NAME="libbesu_native_evm.so"
+fi
+PGO_DIR="$(mkdir -p "$BUILD_DIR" && cd "$BUILD_DIR" && pwd)/pgo"
+LIB="$BUILD_DIR/$LIB_NAME"
+
+# Recording files from files and directories (*.rec)
+RECORDING_FILES=()
+for path in "${RECORDINGS[@]}"; do
+    if [ -d "$path" ]; then
+        while IFS= read -r file; do
+            RECORDING_FILES+=("$file")
+        done < <(find "$path" -type f -name '*.rec' | sort)
+    elif [ -f "$path" ]; then
+        RECORDING_FILES+=("$path")
+    else
+        echo -e "${RED}Error: no recording at $path${NC}"
+        exit 1
+    fi
+done
+
+configure() {
+    cmake -S . -B "$BUILD_DIR" -DCMAKE_BUILD_TYPE=Release \
+        -DBESU_PGO="$1" -DBESU_PGO_DIR="$PGO_DIR" -DBESU_BOLT="$USE_BOLT" \
+        -DBESU_BUILD_BENCH=ON -DBESU_BUILD_TOOLS=ON >/dev/null
+}
+
+build() {
+    cmake --build "$BUILD_DIR" -j"$(nproc 2>/dev/null || sysctl -n hw.ncpu)" --target "$@"
+}
+
+# Run the training corpus on the library at $1. Failed runs are reported but do
+# not stop the build: their profile is still useful.
+train() {
+    local lib="$1"
+    echo -e "${BLUE}Training: contract workloads${NC}"
+    "$BUILD_DIR/bench/besu_native_evm_bench" --lib "$lib" --bounds both --seconds "$SECONDS_PER_WORKLOAD" \
+        || echo -e "${YELLOW}Warning: a workload failed${NC}"
+    echo -e "${BLUE}Training: per-opcode blocks${NC}"
+    "$BUILD_DIR/bench/besu_native_evm_opcode_bench" --lib "$lib" --bounds both --repeat 200 --seconds 0.005 \
+        >/dev/null || echo -e "${YELLOW}Warning: an opcode block failed${NC}"
+    for recording in "${RECORDING_FILES[@]}"; do
+        echo -e "${BLUE}Training: replay $recording${NC}"
+        "$BUILD_DIR/tools/evm-replay" --lib "$lib" --repeat 3 --slowest 0 "$recording" \
+            || echo -e "${YELLOW}Warning: replay of $recording failed${NC}"
+    done
+}
+
+# 1. Instrumented build
+echo ""
+echo -e "${GREEN}[1/3] Instrumented build${NC}"
+rm -rf "$PGO_DIR"
+configure GENERATE
+build besu_native_evm besu_native_evm_bench besu_native_evm_opcode_bench evm-replay
+
+# 2. Training
+echo ""
+echo -e "${GREEN}[2/3] Training run${NC}"
+train "$LIB"
+
+if [ "$IS_CLANG" = true ]; then
+    PROFDATA="${LLVM_PROFDATA:-llvm-profdata}"
+    if ! command -v "$PROFDATA" >/dev/null 2>&1; then
+        PROFDATA="xcrun llvm-profdata"
+    fi
+    $PROFDATA merge -o "$PGO_DIR/besu_native_evm.profdata" "$PGO_DIR"/*.profraw
+fi
+
+# 3. Optimized build
+echo ""
+echo -e "${GREEN}[3/3] Optimized build${NC}"
+configure USE
+build besu_native_evm
+
+# 4. BOLT
+if [ "$USE_BOLT" = true ]; then
+    echo ""
+    echo -e "${GREEN}[BOLT] Instrumenting the optimized library${NC}"
+    rm -f "$PGO_DIR/bolt.fdata"
+    llvm-bolt "$LIB" -o "$LIB.instrumented" -instrument -instrumentation-file="$PGO_DIR/bolt.fdata"
+    train "$LIB.instrumented"
+    llvm-bolt "$LIB" -o "$LIB.bolt" -data="$PGO_DIR/bolt.fdata" \
+        -reorder-blocks=ext-tsp -reorder-functions=hfsort -split-functions -split-all-cold -dyno-stats
+    mv "$LIB.bolt" "$LIB"
+    rm -f "$LIB.instrumented"
+fi
+
+echo ""
+echo -e "${GREEN}Build complete!${NC}"
+echo -e "${GREEN}Library: $(cd "$BUILD_DIR" && pwd)/$LIB_NAME${NC}"
+echo ""
+echo "Compare with a plain Release build:"
+echo "  $BUILD_DIR/bench/besu_native_evm_bench --lib $LIB --lib build/$LIB_NAME"
@@ -0,0 +1,283 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Huge-page backed bump arenas for frames, witnesses and code stores.
+ * See include/arena.h for the page selection and fallback order.
+ */
+
+#include "../include/arena.h"
+#include "../include/numa.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define BESU_ARENA_HAS_MMAP 1
+#endif
+
+namespace besu {
+namespace evm {
+
+struct Arena {
+    uint8_t* base;          // First usable byte (2 MB aligned for huge pages)
+    uint64_t capacity;      // Usable bytes from base
+    uint64_t used;
+    uint64_t high_water;
+    uint64_t allocations;
+    uint64_t resets;
+    uint32_t page_type;     // ArenaPageType
+    uint32_t page_size;
+    int32_t  numa_node;     // Bound node, -1 if unbound
+};
+
+static inline uint64_t align_up(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+#ifdef BESU_ARENA_HAS_MMAP
+
+static uint64_t base_page_size() {
+    long size = sysconf(_SC_PAGESIZE);
+    return size > 0 ? static_cast<uint64_t>(size) : 4096;
+}
+
+static uint8_t* map_anonymous(uint64_t size, int extra_flags) {
+    void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | extra_flags, -1, 0);
+    return ptr == MAP_FAILED ? nullptr : static_cast<uint8_t*>(ptr);
+}
+
+static bool map_explicit_huge(Arena* arena, uint64_t size) {
+#if defined(__linux__) && defined(MAP_HUGETLB)
+    int flags = MAP_HUGETLB;
+#ifdef MAP_HUGE_2MB
+    flags |= MAP_HUGE_2MB;
+#endif
+    uint8_t* ptr = map_anonymous(size, flags);
+    if (!ptr) return false;  // hugetlbfs pool empty or not configured
+
+    arena->base = ptr;
+    arena->capacity = size;
+    arena->page_type = ARENA_PAGES_EXPLICIT_HUGE;
+    arena->page_size = HUGE_PAGE_SIZE;
+    return true;
+#else
+    (void)arena;
+    (void)size;
+    return false;
+#endif
+}
+
+static bool map_transparent_huge(Arena* arena, uint64_t size) {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    // Over-map by one huge page so the usable range can start on a 2 MB boundary;
+    // THP only backs naturally aligned 2 MB extents.
+    uint64_t mapped = size + HUGE_PAGE_SIZE;
+    uint8_t* raw = map_anonymous(mapped, 0);
+    if (!raw) return false;
+
+    uint8_t* aligned = reinterpret_cast<uint8_t*>(
+        align_up(reinterpret_cast<uintptr_t>(raw), HUGE_PAGE_SIZE));
+    uint64_t head = aligned - raw;
+    uint64_t tail = mapped - head - size;
+    if (head) munmap(raw, head);
+    if (tail) munmap(aligned + size, tail);
+
+    arena->base = aligned;
+    arena->capacity = size;
+    if (madvise(aligned, size, MADV_HUGEPAGE) == 0) {
+        arena->page_type = ARENA_PAGES_TRANSPARENT_HUGE;
+        arena->page_size = HUGE_PAGE_SIZE;
+    } else {
+        // THP disabled ("never") - still a valid regular mapping
+        arena->page_type = ARENA_PAGES_REGULAR;
+        arena->page_size = static_cast<uint32_t>(base_page_size());
+    }
+    return true;
+#else
+    (void)arena;
+    (void)size;
+    return false;
+#endif
+}
+
+static bool map_regular(Arena* arena, uint64_t capacity) {
+    uint64_t size = align_up(capacity, base_page_size());
+    uint8_t* ptr = map_anonymous(size, 0);
+    if (!ptr) return false;
+
+    arena->base = ptr;
+    arena->capacity = size;
+    arena->page_type = ARENA_PAGES_REGULAR;
+    arena->page_size = static_cast<uint32_t>(base_page_size());
+    return true;
+}
+
+/**
+ * Sum AnonHugePages for the mappings covering the arena.
+ * Cold path (stats only): parses /proc/self/smaps.
+ */
+static uint64_t resident_transparent_huge_bytes(const Arena* arena) {
+#if defined(__linux__)
+    FILE* smaps = fopen("/proc/self/smaps", "r");
+    if (!smaps) return 0;
+
+    uintptr_t lo = reinterpret_cast<uintptr_t>(arena->base);
+    uintptr_t hi = lo + arena->capacity;
+    bool in_range = false;
+    uint64_t total_kb = 0;
+    char line[512];
+
+    while (fgets(line, sizeof(line), smaps)) {
+        unsigned long start = 0, end = 0;
+        if (sscanf(line, "%lx-%lx ", &start, &end) == 2) {
+            in_range = start < hi && end > lo;
+            continue;
+        }
+        unsigned long kb = 0;
+        if (in_range && sscanf(line, "AnonHugePages: %lu kB", &kb) == 1) {
+            total_kb += kb;
+        }
+    }
+    fclose(smaps);
+    return total_kb * 1024;
+#else
+    (void)arena;
+    return 0;
+#endif
+}
+
+#endif // BESU_ARENA_HAS_MMAP
+
+extern "C" {
+
+Arena* besu_arena_create(uint64_t capacity, uint32_t flags) {
+    if (capacity == 0) return nullptr;
+
+    Arena* arena = static_cast<Arena*>(calloc(1, sizeof(Arena)));
+    if (!arena) return nullptr;
+
+    bool mapped = false;
+#ifdef BESU_ARENA_HAS_MMAP
+    uint64_t huge_size = align_up(capacity, HUGE_PAGE_SIZE);
+    if (flags & ARENA_HUGE_EXPLICIT) {
+        mapped = map_explicit_huge(arena, huge_size);
+    }
+    if (!mapped && (flags & (ARENA_HUGE_EXPLICIT | ARENA_HUGE_TRANSPARENT))) {
+        mapped = map_transparent_huge(arena, huge_size);
+    }
+    if (!mapped) {
+        mapped = map_regular(arena, capacity);
+    }
+#else
+    (void)flags;
+#endif
+
+    if (!mapped) {
+        // Last resort: plain heap, zeroed like an anonymous mapping
+        arena->base = static_cast<uint8_t*>(calloc(1, capacity));
+        if (!arena->base) {
+            free(arena);
+            return nullptr;
+        }
+        arena->capacity = capacity;
+        arena->page_type = ARENA_PAGES_HEAP;
+        arena->page_size = 0;
+    }
+
+    arena->numa_node = -1;
+    return arena;
+}
+
+Arena* besu_arena_create_on_node(uint64_t capacity, uint32_t flags, int32_t node) {
+    Arena* arena = besu_arena_create(capacity, flags);
+    if (!arena) return nullptr;
+
+    if (node < 0) {
+        node = numa::current_node();
+    }
+    // Fresh mappings are untouched, so the policy applies to every page's first fault
+    if (arena->page_type != ARENA_PAGES_HEAP &&
+        numa::bind_memory(arena->base, arena->capacity, node)) {
+        arena->numa_node = node;
+    }
+    return arena;
+}
+
+void* besu_arena_alloc(Arena* arena, uint64_t size, uint64_t alignment) {
+    if (!arena) return nullptr;
+    if (alignment == 0) alignment = 64;
+    if ((alignment & (alignment - 1)) != 0) return nullptr;
+
+    // Align the address, not the offset: the heap fallback's base is only malloc aligned
+    const uint64_t misalignment = (reinterpret_cast<uintptr_t>(arena->base) + arena->used) & (alignment - 1);
+    const uint64_t padding = misalignment ? alignment - misalignment : 0;
+    if (padding > arena->capacity - arena->used || size > arena->capacity - arena->used - padding) {
+        return nullptr;
+    }
+    const uint64_t offset = arena->used + padding;
+
+    arena->used = offset + size;
+    if (arena->used > arena->high_water) {
+        arena->high_water = arena->used;
+    }
+    arena->allocations++;
+    return arena->base + offset;
+}
+
+void besu_arena_reset(Arena* arena) {
+    if (!arena) return;
+    arena->used = 0;
+    arena->resets++;
+}
+
+void besu_arena_destroy(Arena* arena) {
+    if (!arena) return;
+
+    if (arena->page_type == ARENA_PAGES_HEAP) {
+        free(arena->base);
+    }
+#ifdef BESU_ARENA_HAS_MMAP
+    else {
+        munmap(arena->base, arena->capacity);
+    }
+#endif
+    free(arena);
+}
+
+void besu_arena_stats(const Arena* arena, ArenaStats* out) {
+    if (!out) return;
+    memset(out, 0, sizeof(ArenaStats));
+    if (!arena) return;
+
+    out->capacity = arena->capacity;
+    out->used = arena->used;
+    out->high_water = arena->high_water;
+    out->allocations = arena->allocations;
+    out->resets = arena->resets;
+    out->page_type = arena->page_type;
+    out->page_size = arena->page_size;
+    out->numa_node = arena->numa_node;
+
+    switch (arena->page_type) {
+        case ARENA_PAGES_EXPLICIT_HUGE:
+            out->huge_bytes = arena->capacity;
+            break;
+#ifdef BESU_ARENA_HAS_MMAP
+        case ARENA_PAGES_TRANSPARENT_HUGE:
+            out->huge_bytes = resident_transparent_huge_bytes(arena);
+            break;
+#endif
+        default:
+            out->huge_bytes = 0;
+            break;
+    }
+}
+
+} // extern "C"
+
+} // namespace evm
+} // namespace besu
@@ -0,0 +1,338 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Double-buffered block pipeline. See include/block_pipeline.h.
+ */
+
+#include "../include/block_pipeline.h"
+#include "../include/code_analysis.h"
+#include "../include/witness_index.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace besu {
+namespace evm {
+
+// Cache lines prefetched per block on acquire
+static constexpr uint32_t HOT_SET_LIMIT = 1024;
+
+enum BufferState {
+    BUFFER_FREE,      // Available to submit
+    BUFFER_QUEUED,    // Submitted, waiting for or in the prepare stage
+    BUFFER_READY,     // Prepared, waiting for acquire
+    BUFFER_ACQUIRED,  // Executing
+};
+
+struct PipelineBuffer {
+    Arena* witness_arena;
+    Arena* frame_arena;
+    PreparedBlock block;
+    BufferState state;
+    const uint8_t* source;
+    uint64_t source_size;
+    const void** hot;
+    uint32_t hot_count;
+};
+
+struct BlockPipeline {
+    // Buffers are used in strict alternation, which keeps blocks in submission order
+    PipelineBuffer buffers[2];
+    uint32_t submit_index;
+    uint32_t prepare_index;
+    uint32_t acquire_index;
+
+    std::mutex lock;
+    std::condition_variable changed;
+    std::thread stage;
+    bool stopping;
+
+    BlockPipelineStats stats;
+};
+
+static uint64_t now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+static bool fits(uint64_t offset, uint64_t length, uint64_t size) {
+    return offset <= size && length <= size - offset;
+}
+
+static void add_hot(PipelineBuffer* buffer, const void* address) {
+    if (buffer->hot && buffer->hot_count < HOT_SET_LIMIT) {
+        buffer->hot[buffer->hot_count++] = address;
+    }
+}
+
+/**
+ * Copy, validate, index and analyse the buffer's witness. Runs on the prepare stage.
+ */
+static uint32_t prepare_block(PipelineBuffer* buffer) {
+    PreparedBlock* block = &buffer->block;
+    Arena* arena = buffer->witness_arena;
+    const uint64_t size = buffer->source_size;
+
+    if (!buffer->source || size < sizeof(TransactionWitness)) return PIPELINE_MALFORMED;
+
+    uint8_t* witness = static_cast<uint8_t*>(besu_arena_alloc(arena, size, 0));
+    if (!witness) return PIPELINE_ARENA_EXHAUSTED;
+    memcpy(witness, buffer->source, size);
+    block->witness = witness;
+    block->witness_size = size;
+
+    const TransactionWitness* header = reinterpret_cast<const TransactionWitness*>(witness);
+    const uint32_t account_count = header->account_count;
+    const uint32_t storage_count = header->storage_count;
+    if (account_count > witness_index::MAX_ENTRIES || storage_count > witness_index::MAX_ENTRIES ||
+        !fits(header->accounts_ptr, (uint64_t)account_count * sizeof(AccountEntry), size) ||
+        !fits(header->storage_ptr, (uint64_t)storage_count * sizeof(StorageEntry), size) ||
+        header->accounts_ptr % alignof(AccountEntry) != 0 ||
+        header->storage_ptr % alignof(StorageEntry) != 0) {
+        return PIPELINE_MALFORMED;
+    }
+
+    block->accounts = reinterpret_cast<AccountEntry*>(witness + header->accounts_ptr);
+    block->storage = reinterpret_cast<StorageEntry*>(witness + header->storage_ptr);
+    block->account_count = account_count;
+    block->storage_count = storage_count;
+
+    // Indexes
+    uint32_t account_capacity = witness_index::capacity_for(account_count);
+    uint32_t storage_capacity = witness_index::capacity_for(storage_count);
+    block->account_index = static_cast<uint32_t*>(
+        besu_arena_alloc(arena, account_capacity * sizeof(uint32_t), 0));
+    block->storage_index = static_cast<uint32_t*>(
+        besu_arena_alloc(arena, storage_capacity * sizeof(uint32_t), 0));
+    buffer->hot = static_cast<const void**>(
+        besu_arena_alloc(arena, HOT_SET_LIMIT * sizeof(void*), 0));
+    if (!block->account_index || !block->storage_index || !buffer->hot) {
+        return PIPELINE_ARENA_EXHAUSTED;
+    }
+    witness_index::build_accounts(block->accounts, account_count,
+                                  block->account_index, account_capacity);
+    witness_index::build_storage(block->storage, storage_count,
+                                 block->storage_index, storage_capacity);
+    block->account_index_mask = account_capacity - 1;
+    block->storage_index_mask = storage_capacity - 1;
+
+    // Code analysis
+    block->jumpdests = static_cast<uint8_t**>(
+        besu_arena_alloc(arena, (uint64_t)account_count * sizeof(uint8_t*), 0));
+    if (!block->jumpdests) return PIPELINE_ARENA_EXHAUSTED;
+
+    for (uint32_t i = 0; i < account_count; i++) {
+        const AccountEntry* account = &block->accounts[i];
+        block->jumpdests[i] = nullptr;
+        if (account->code_size == 0) continue;
+        if (!fits(account->code_offset, account->code_size, size)) return PIPELINE_MALFORMED;
+
+        const uint8_t* code = witness + account->code_offset;
+        uint8_t* bitmap = static_cast<uint8_t*>(besu_arena_alloc(
+            arena, code_analysis::jumpdest_bitmap_size(account->code_size), 0));
+        if (!bitmap) return PIPELINE_ARENA_EXHAUSTED;
+        code_analysis::analyze_jumpdests(code, account->code_size, bitmap);
+        block->jumpdests[i] = bitmap;
+        block->code_count++;
+    }
+
+    // Hot set: entries the access lists already marked warm, then code heads
+    for (uint32_t i = 0; i < account_count; i++) {
+        const AccountEntry* account = &block->accounts[i];
+        if (!account->is_warm) continue;
+        add_hot(buffer, account);
+        add_hot(buffer, reinterpret_cast<const uint8_t*>(account) + 64);
+        if (account->code_size > 0) {
+            add_hot(buffer, witness + account->code_offset);
+            add_hot(buffer, block->jumpdests[i]);
+        }
+    }
+    for (uint32_t i = 0; i < storage_count; i++) {
+        const StorageEntry* entry = &block->storage[i];
+        if (!entry->is_warm) continue;
+        add_hot(buffer, entry);
+        add_hot(buffer, reinterpret_cast<const uint8_t*>(entry) + sizeof(StorageEntry) - 1);
+    }
+    return PIPELINE_OK;
+}
+
+static void prepare_stage(BlockPipeline* pipeline) {
+    while (true) {
+        PipelineBuffer* buffer;
+        {
+            std::unique_lock<std::mutex> guard(pipeline->lock);
+            pipeline->changed.wait(guard, [pipeline] {
+                return pipeline->stopping ||
+                       pipeline->buffers[pipeline->prepare_index].state == BUFFER_QUEUED;
+            });
+            if (pipeline->stopping) return;
+            buffer = &pipeline->buffers[pipeline->prepare_index];
+        }
+
+        uint64_t start = now_ns();
+        uint32_t status = prepare_block(buffer);
+        uint64_t elapsed = now_ns() - start;
+
+        std::lock_guard<std::mutex> guard(pipeline->lock);
+        buffer->block.status = status;
+        buffer->block.prepare_ns = elapsed;
+        buffer->state = BUFFER_READY;
+        pipeline->prepare_index ^= 1;
+        pipeline->stats.prepare_ns += elapsed;
+        (status == PIPELINE_OK ? pipeline->stats.prepared : pipeline->stats.failed)++;
+        pipeline->changed.notify_all();
+    }
+}
+
+static void clear_block(PipelineBuffer* buffer) {
+    memset(&buffer->block, 0, sizeof(buffer->block));
+    buffer->block.frame_arena = buffer->frame_arena;
+    buffer->source = nullptr;
+    buffer->source_size = 0;
+    buffer->hot = nullptr;
+    buffer->hot_count = 0;
+}
+
+extern "C" {
+
+BlockPipeline* besu_pipeline_create(uint64_t witness_bytes, uint64_t frame_bytes,
+                                    uint32_t arena_flags) {
+    BlockPipeline* pipeline = new BlockPipeline();
+    bool ok = true;
+    for (PipelineBuffer& buffer : pipeline->buffers) {
+        buffer.witness_arena = besu_arena_create(witness_bytes, arena_flags);
+        buffer.frame_arena = frame_bytes > 0 ? besu_arena_create(frame_bytes, arena_flags) : nullptr;
+        if (!buffer.witness_arena || (frame_bytes > 0 && !buffer.frame_arena)) ok = false;
+        buffer.state = BUFFER_FREE;
+        clear_block(&buffer);
+    }
+    pipeline->submit_index = 0;
+    pipeline->prepare_index = 0;
+    pipeline->acquire_index = 0;
+    pipeline->stopping = false;
+    memset(&pipeline->stats, 0, sizeof(pipeline->stats));
+
+    if (!ok) {
+        for (PipelineBuffer& buffer : pipeline->buffers) {
+            besu_arena_destroy(buffer.witness_arena);
+            besu_arena_destroy(buffer.frame_arena);
+        }
+        delete pipeline;
+        return nullptr;
+    }
+
+    pipeline->stage = std::thread(prepare_stage, pipeline);
+    return pipeline;
+}
+
+bool besu_pipeline_submit(BlockPipeline* pipeline, uint64_t block_number,
+                          const uint8_t* witness, uint64_t witness_size) {
+    if (!pipeline) return false;
+
+    std::unique_lock<std::mutex> guard(pipeline->lock);
+    PipelineBuffer* buffer = &pipeline->buffers[pipeline->submit_index];
+    if (buffer->state != BUFFER_FREE) {
+        uint64_t start = now_ns();
+        pipeline->changed.wait(guard, [pipeline, buffer] {
+            return pipeline->stopping || buffer->state == BUFFER_FREE;
+        });
+        pipeline->stats.submit_wait_ns += now_ns() - start;
+    }
+    if (pipeline->stopping) return false;
+
+    buffer->block.block_number = block_number;
+    buffer->source = witness;
+    buffer->source_size = witness_size;
+    buffer->state = BUFFER_QUEUED;
+    pipeline->submit_index ^= 1;
+    pipeline->stats.submitted++;
+    pipeline->changed.notify_all();
+    return true;
+}
+
+const PreparedBlock* besu_pipeline_acquire(BlockPipeline* pipeline) {
+    if (!pipeline) return nullptr;
+
+    PipelineBuffer* buffer;
+    {
+        std::unique_lock<std::mutex> guard(pipeline->lock);
+        buffer = &pipeline->buffers[pipeline->acquire_index];
+        if (buffer->state != BUFFER_QUEUED && buffer->state != BUFFER_READY) return nullptr;
+        if (buffer->state != BUFFER_READY) {
+            uint64_t start = now_ns();
+            pipeline->changed.wait(guard, [pipeline, buffer] {
+                return pipeline->stopping || buffer->state == BUFFER_READY;
+            });
+            pipeline->stats.acquire_wait_ns += now_ns() - start;
+            if (buffer->state != BUFFER_READY) return nullptr;
+        }
+        buffer->state = BUFFER_ACQUIRED;
+        pipeline->acquire_index ^= 1;
+    }
+
+    // Pull the hot set into this (the executing) thread's caches
+    for (uint32_t i = 0; i < buffer->hot_count; i++) {
+        __builtin_prefetch(buffer->hot[i], 0, 3);
+    }
+    return &buffer->block;
+}
+
+void besu_pipeline_release(BlockPipeline* pipeline, const PreparedBlock* block) {
+    if (!pipeline || !block) return;
+
+    for (PipelineBuffer& buffer : pipeline->buffers) {
+        if (&buffer.block != block) continue;
+        std::lock_guard<std::mutex> guard(pipeline->lock);
+        if (buffer.state != BUFFER_ACQUIRED) return;
+        besu_arena_reset(buffer.witness_arena);
+        besu_arena_reset(buffer.frame_arena);
+        clear_block(&buffer);
+        buffer.state = BUFFER_FREE;
+        pipeline->changed.notify_all();
+        return;
+    }
+}
+
+AccountEntry* besu_pipeline_find_account(const PreparedBlock* block, const uint8_t* address) {
+    if (!block || block->status != PIPELINE_OK || !address) return nullptr;
+    return witness_index::find_account(block->accounts, block->account_index,
+                                       block->account_index_mask, address);
+}
+
+StorageEntry* besu_pipeline_find_storage(const PreparedBlock* block,
+                                         const uint8_t* address, const uint8_t* key) {
+    if (!block || block->status != PIPELINE_OK || !address || !key) return nullptr;
+    return witness_index::find_storage(block->storage, block->storage_index,
+                                       block->storage_index_mask, address, key);
+}
+
+void besu_pipeline_stats(const BlockPipeline* pipeline, BlockPipelineStats* out) {
+    if (!pipeline || !out) return;
+    std::lock_guard<std::mutex> guard(const_cast<BlockPipeline*>(pipeline)->lock);
+    *out = pipeline->stats;
+}
+
+void besu_pipeline_destroy(BlockPipeline* pipeline) {
+    if (!pipeline) return;
+    {
+        std::lock_guard<std::mutex> guard(pipeline->lock);
+        pipeline->stopping = true;
+        pipeline->changed.notify_all();
+    }
+    if (pipeline->stage.joinable()) {
+        pipeline->stage.join();
+    }
+    for (PipelineBuffer& buffer : pipeline->buffers) {
+        besu_arena_destroy(buffer.witness_arena);
+        besu_arena_destroy(buffer.frame_arena);
+    }
+    delete pipeline;
+}
+
+} // extern "C"
+
+} // namespace evm
+} // namespace besu
@@ -1,570 +0,0 @@
-// Copyright ConsenSys AG.
-// SPDX-License-Identifier: Apache-2.0
-
-/**
- * Jump table based EVM implementation for maximum performance.
- *
- * Uses function pointer array instead of switch statement for O(1) dispatch
- * with no branch prediction overhead.
- */
-
-#include "../include/message_frame_memory.h"
-#include "../include/tracer_callback.h"
-#include <cstdio>
-#include <cstring>
-#include <algorithm>
-
-using namespace besu::evm;
-
-extern "C" {
-
-#define WORD_SIZE 32
-
-// Operation result structure
-struct OpResult {
-    int pc_increment;  // How much to advance PC (-1 = error, 0 = don't advance)
-    int gas_cost;      // Gas cost for this operation
-};
-
-// Forward declarations
-struct ExecutionContext {
-    MessageFrameMemory* frame;
-    uint8_t* stack_base;
-    uint8_t* memory_base;
-    const uint8_t* code;
-};
-
-// Operation handler function pointer type
-typedef OpResult (*OpHandler)(ExecutionContext* ctx);
-
-// Stack helpers
-static inline uint8_t* stack_peek(MessageFrameMemory* frame, uint8_t* stack_base, int offset) {
-    if (offset >= frame->stack_size) {
-        return nullptr;
-    }
-    return stack_base + ((frame->stack_size - 1 - offset) * WORD_SIZE);
-}
-
-static inline bool stack_push(MessageFrameMemory* frame, uint8_t* stack_base, const uint8_t* value) {
-    if (frame->stack_size >= 1024) {
-        return false;
-    }
-    uint8_t* item = stack_base + (frame->stack_size * WORD_SIZE);
-    memcpy(item, value, WORD_SIZE);
-    frame->stack_size++;
-    return true;
-}
-
-static inline bool stack_pop(MessageFrameMemory* frame, uint8_t* stack_base, uint8_t* out) {
-    if (frame->stack_size == 0) {
-        return false;
-    }
-    uint8_t* item = stack_base + ((frame->stack_size - 1) * WORD_SIZE);
-    if (out) {
-        memcpy(out, item, WORD_SIZE);
-    }
-    frame->stack_size--;
-    return true;
-}
-
-// 256-bit arithmetic helpers
-static inline uint64_t word_to_u64(const uint8_t* word) {
-    uint64_t result = 0;
-    for (int i = 24; i < 32; i++) {
-        result = (result << 8) | word[i];
-    }
-    return result;
-}
-
-static inline void u64_to_word(uint64_t value, uint8_t* word) {
-    memset(word, 0, WORD_SIZE);
-    for (int i = 31; i >= 24; i--) {
-        word[i] = value & 0xFF;
-        value >>= 8;
-    }
-}
-
-static inline bool is_zero(const uint8_t* word) {
-    for (int i = 0; i < WORD_SIZE; i++) {
-        if (word[i] != 0) return false;
-    }
-    return true;
-}
-
-// Memory helpers
-static inline bool ensure_memory(MessageFrameMemory* frame, uint8_t* memory_base, uint32_t offset, uint32_t size) {
-    if (size == 0) return true;
-    uint64_t required = (uint64_t)offset + size;
-    if (required > frame->memory_size) {
-        uint32_t new_size = ((required + 31) / 32) * 32;
-        if (new_size > 1024 * 1024) return false;
-        if (new_size > frame->memory_size) {
-            memset(memory_base + frame->memory_size, 0, new_size - frame->memory_size);
-            frame->memory_size = new_size;
-        }
-    }
-    return true;
-}
-
-// ===== OPERATION HANDLERS =====
-
-static OpResult op_stop(ExecutionContext* ctx) {
-    ctx->frame->state = 7; // COMPLETED_SUCCESS
-    return {0, 0}; // don't advance PC, 0 gas
-}
-
-static OpResult op_add(ExecutionContext* ctx) {
-    uint8_t a[WORD_SIZE], b[WORD_SIZE], result[WORD_SIZE];
-    if (!stack_pop(ctx->frame, ctx->stack_base, a)) return {-1, 0};
-    if (!stack_pop(ctx->frame, ctx->stack_base, b)) return {-1, 0};
-
-    uint64_t val_a = word_to_u64(a);
-    uint64_t val_b = word_to_u64(b);
-    u64_to_word(val_a + val_b, result);
-
-    if (!stack_push(ctx->frame, ctx->stack_base, result)) return {-1, 0};
-    return {1, 3};
-}
-
-static OpResult op_mul(ExecutionContext* ctx) {
-    uint8_t a[WORD_SIZE], b[WORD_SIZE], result[WORD_SIZE];
-    if (!stack_pop(ctx->frame, ctx->stack_base, a)) return {-1, 0};
-    if (!stack_pop(ctx->frame, ctx->stack_base, b)) return {-1, 0};
-
-    uint64_t val_a = word_to_u64(a);
-    uint64_t val_b = word_to_u64(b);
-    u64_to_word(val_a * val_b, result);
-
-    if (!stack_push(ctx->frame, ctx->stack_base, result)) return {-1, 0};
-    return {1, 5};
-}
-
-static OpResult op_sub(ExecutionContext* ctx) {
-    uint8_t a[WORD_SIZE], b[WORD_SIZE], result[WORD_SIZE];
-    if (!stack_pop(ctx->frame, ctx->stack_base, a)) return {-1, 0};
-    if (!stack_pop(ctx->frame, ctx->stack_base, b)) return {-1, 0};
-
-    uint64_t val_a = word_to_u64(a);
-    uint64_t val_b = word_to_u64(b);
-    u64_to_word(val_a - val_b, result);
-
-    if (!stack_push(ctx->frame, ctx->stack_base, result)) return {-1, 0};
-    return {1, 3};
-}
-
-static OpResult op_div(ExecutionContext* ctx) {
-    uint8_t a[WORD_SIZE], b[WORD_SIZE], result[WORD_SIZE];
-    if (!stack_pop(ctx->frame, ctx->stack_base, a)) return {-1, 0};
-    if (!stack_pop(ctx->frame, ctx->stack_base, b)) return {-1, 0};
-
-    uint64_t val_a = word_to_u64(a);
-    uint64_t val_b = word_to_u64(b);
-    u64_to_word(val_b == 0 ? 0 : val_a / val_b, result);
-
-    if (!stack_push(ctx->frame, ctx->stack_base, result)) return {-1, 0};
-    return {1, 5};
-}
-
-static OpResult op_mod(ExecutionContext* ctx) {
-    uint8_t a[WORD_SIZE], b[WORD_SIZE], result[WORD_SIZE];
-    if (!stack_pop(ctx->frame, ctx->stack_base, a)) return {-1, 0};
-    if (!stack_pop(ctx->frame, ctx->stack_base, b)) return {-1, 0};
-
-    uint64_t val_a = word_to_u64(a);
-    uint64_t val_b = word_to_u64(b);
-    u64_to_word(val_b == 0 ? 0 : val_a % val_b, result);
-
-    if (!stack_push(ctx->frame, ctx->stack_base, result)) return {-1, 0};
-    return {1, 5};
-}
-
-static OpResult op_lt(ExecutionContext* ctx) {
-    uint8_t a[WORD_SIZE], b[WORD_SIZE], result[WORD_SIZE];
-    if (!stack_pop(ctx->frame, ctx->stack_base, a)) return {-1, 0};
-    if (!stack_pop(ctx->frame, ctx->stack_base, b)) return {-1, 0};
-
-    u64_to_word(word_to_u64(a) < word_to_u64(b) ? 1 : 0, result);
-
-    if (!stack_push(ctx->frame, ctx->stack_base, result)) return {-1, 0};
-    return {1, 3};
-}
-
-static OpResult op_gt(ExecutionContext* ctx) {
-    uint8_t a[WORD_SIZE], b[WORD_SIZE], result[WORD_SIZE];
-    if (!stack_pop(ctx->frame, ctx->stack_base, a)) return {-1, 0};
-    if (!stack_pop(ctx->frame, ctx->stack_base, b)) return {-1, 0};
-
-    u64_to_word(word_to_u64(a) > word_to_u64(b) ? 1 : 0, result);
-
-    if (!stack_push(ctx->frame, ctx->stack_base, result)) return {-1, 0};
-    return {1, 3};
-}
-
-static OpResult op_eq(ExecutionContext* ctx) {
-    uint8_t a[WORD_SIZE], b[WORD_SIZE], result[WORD_SIZE];
-    if (!stack_pop(ctx->frame, ctx->stack_base, a)) return {-1, 0};
-    if (!stack_pop(ctx->frame, ctx->stack_base, b)) return {-1, 0};
-
-    u64_to_word(memcmp(a, b, WORD_SIZE) == 0 ? 1 : 0, result);
-
-    if (!stack_push(ctx->frame, ctx->stack_base, result)) return {-1, 0};
-    return {1, 3};
-}
-
-static OpResult op_iszero(ExecutionContext* ctx) {
-    uint8_t a[WORD_SIZE], result[WORD_SIZE];
-    if (!stack_pop(ctx->frame, ctx->stack_base, a)) return {-1, 0};
-
-    u64_to_word(is_zero(a) ? 1 : 0, result);
-
-    if (!stack_push(ctx->frame, ctx->stack_base, result)) return {-1, 0};
-    return {1, 3};
-}
-
-static OpResult op_and(ExecutionContext* ctx) {
-    uint8_t a[WORD_SIZE], b[WORD_SIZE], result[WORD_SIZE];
-    if (!stack_pop(ctx->frame, ctx->stack_base, a)) return {-1, 0};
-    if (!stack_pop(ctx->frame, ctx->stack_base, b)) return {-1, 0};
-
-    for (int i = 0; i < WORD_SIZE; i++) {
-        result[i] = a[i] & b[i];
-    }
-
-    if (!stack_push(ctx->frame, ctx->stack_base, result)) return {-1, 0};
-    return {1, 3};
-}
-
-static OpResult op_or(ExecutionContext* ctx) {
-    uint8_t a[WORD_SIZE], b[WORD_SIZE], result[WORD_SIZE];
-    if (!stack_pop(ctx->frame, ctx->stack_base, a)) return {-1, 0};
-    if (!stack_pop(ctx->frame, ctx->stack_base, b)) return {-1, 0};
-
-    for (int i = 0; i < WORD_SIZE; i++) {
-        result[i] = a[i] | b[i];
-    }
-
-    if (!stack_push(ctx->frame, ctx->stack_base, result)) return {-1, 0};
-    return {1, 3};
-}
-
-static OpResult op_xor(ExecutionContext* ctx) {
-    uint8_t a[WORD_SIZE], b[WORD_SIZE], result[WORD_SIZE];
-    if (!stack_pop(ctx->frame, ctx->stack_base, a)) return {-1, 0};
-    if (!stack_pop(ctx->frame, ctx->stack_base, b)) return {-1, 0};
-
-    for (int i = 0; i < WORD_SIZE; i++) {
-        result[i] = a[i] ^ b[i];
-    }
-
-    if (!stack_push(ctx->frame, ctx->stack_base, result)) return {-1, 0};
-    return {1, 3};
-}
-
-static OpResult op_not(ExecutionContext* ctx) {
-    uint8_t a[WORD_SIZE], result[WORD_SIZE];
-    if (!stack_pop(ctx->frame, ctx->stack_base, a)) return {-1, 0};
-
-    for (int i = 0; i < WORD_SIZE; i++) {
-        result[i] = ~a[i];
-    }
-
-    if (!stack_push(ctx->frame, ctx->stack_base, result)) return {-1, 0};
-    return {1, 3};
-}
-
-static OpResult op_pop(ExecutionContext* ctx) {
-    if (!stack_pop(ctx->frame, ctx->stack_base, nullptr)) return {-1, 0};
-    return {1, 2};
-}
-
-static OpResult op_mload(ExecutionContext* ctx) {
-    uint8_t offset_word[WORD_SIZE], result[WORD_SIZE];
-    if (!stack_pop(ctx->frame, ctx->stack_base, offset_word)) return {-1, 0};
-
-    uint32_t offset = (uint32_t)word_to_u64(offset_word);
-    if (!ensure_memory(ctx->frame, ctx->memory_base, offset, 32)) return {-1, 0};
-
-    memcpy(result, ctx->memory_base + offset, WORD_SIZE);
-
-    if (!stack_push(ctx->frame, ctx->stack_base, result)) return {-1, 0};
-    return {1, 3};
-}
-
-static OpResult op_mstore(ExecutionContext* ctx) {
-    uint8_t offset_word[WORD_SIZE], value[WORD_SIZE];
-    if (!stack_pop(ctx->frame, ctx->stack_base, offset_word)) return {-1, 0};
-    if (!stack_pop(ctx->frame, ctx->stack_base, value)) return {-1, 0};
-
-    uint32_t offset = (uint32_t)word_to_u64(offset_word);
-    if (!ensure_memory(ctx->frame, ctx->memory_base, offset, 32)) return {-1, 0};
-
-    memcpy(ctx->memory_base + offset, value, WORD_SIZE);
-    return {1, 3};
-}
-
-static OpResult op_mstore8(ExecutionContext* ctx) {
-    uint8_t offset_word[WORD_SIZE], value_word[WORD_SIZE];
-    if (!stack_pop(ctx->frame, ctx->stack_base, offset_word)) return {-1, 0};
-    if (!stack_pop(ctx->frame, ctx->stack_base, value_word)) return {-1, 0};
-
-    uint32_t offset = (uint32_t)word_to_u64(offset_word);
-    if (!ensure_memory(ctx->frame, ctx->memory_base, offset, 1)) return {-1, 0};
-
-    ctx->memory_base[offset] = value_word[31]; // lowest byte
-    return {1, 3};
-}
-
-static OpResult op_jump(ExecutionContext* ctx) {
-    uint8_t dest_word[WORD_SIZE];
-    if (!stack_pop(ctx->frame, ctx->stack_base, dest_word)) return {-1, 0};
-
-    uint32_t dest = (uint32_t)word_to_u64(dest_word);
-    if (dest >= ctx->frame->code_size || ctx->code[dest] != 0x5b) {
-        ctx->frame->state = 4; // EXCEPTIONAL_HALT
-        ctx->frame->halt_reason = 3; // INVALID_JUMP_DESTINATION
-        return {-1, 0};
-    }
-
-    ctx->frame->pc = dest;
-    return {0, 8}; // PC already set, don't advance
-}
-
-static OpResult op_jumpi(ExecutionContext* ctx) {
-    uint8_t dest_word[WORD_SIZE], cond_word[WORD_SIZE];
-    if (!stack_pop(ctx->frame, ctx->stack_base, dest_word)) return {-1, 0};
-    if (!stack_pop(ctx->frame, ctx->stack_base, cond_word)) return {-1, 0};
-
-    if (!is_zero(cond_word)) {
-        uint32_t dest = (uint32_t)word_to_u64(dest_word);
-        if (dest >= ctx->frame->code_size || ctx->code[dest] != 0x5b) {
-            ctx->frame->state = 4;
-            ctx->frame->halt_reason = 3;
-            return {-1, 0};
-        }
-        ctx->frame->pc = dest;
-        return {0, 10};
-    }
-    return {1, 10};
-}
-
-static OpResult op_pc(ExecutionContext* ctx) {
-    uint8_t result[WORD_SIZE];
-    u64_to_word(ctx->frame->pc, result);
-    if (!stack_push(ctx->frame, ctx->stack_base, result)) return {-1, 0};
-    return {1, 2};
-}
-
-static OpResult op_gas(ExecutionContext* ctx) {
-    uint8_t result[WORD_SIZE];
-    u64_to_word(ctx->frame->gas_remaining, result);
-    if (!stack_push(ctx->frame, ctx->stack_base, result)) return {-1, 0};
-    return {1, 2};
-}
-
-static OpResult op_jumpdest(ExecutionContext* ctx) {
-    return {1, 1}; // Valid jump destination marker
-}
-
-static OpResult op_push0(ExecutionContext* ctx) {
-    uint8_t zero[WORD_SIZE] = {0};
-    if (!stack_push(ctx->frame, ctx->stack_base, zero)) return {-1, 0};
-    return {1, 2};
-}
-
-// Generic PUSH handler for PUSH1-PUSH32
-static OpResult op_push_n(ExecutionContext* ctx, int n) {
-    uint8_t value[WORD_SIZE] = {0};
-
-    // Copy n bytes from code after PC
-    int bytes_to_copy = std::min(n, (int)(ctx->frame->code_size - ctx->frame->pc - 1));
-    if (bytes_to_copy > 0) {
-        memcpy(value + (WORD_SIZE - bytes_to_copy),
-               ctx->code + ctx->frame->pc + 1,
-               bytes_to_copy);
-    }
-
-    if (!stack_push(ctx->frame, ctx->stack_base, value)) return {-1, 0};
-    return {1 + n, 3};
-}
-
-// Generic DUP handler
-static OpResult op_dup_n(ExecutionContext* ctx, int n) {
-    uint8_t* item = stack_peek(ctx->frame, ctx->stack_base, n - 1);
-    if (!item) return {-1, 0};
-
-    if (!stack_push(ctx->frame, ctx->stack_base, item)) return {-1, 0};
-    return {1, 3};
-}
-
-// Generic SWAP handler
-static OpResult op_swap_n(ExecutionContext* ctx, int n) {
-    uint8_t* top = stack_peek(ctx->frame, ctx->stack_base, 0);
-    uint8_t* other = stack_peek(ctx->frame, ctx->stack_base, n);
-    if (!top || !other) return {-1, 0};
-
-    uint8_t temp[WORD_SIZE];
-    memcpy(temp, top, WORD_SIZE);
-    memcpy(top, other, WORD_SIZE);
-    memcpy(other, temp, WORD_SIZE);
-    return {1, 3};
-}
-
-static OpResult op_invalid(ExecutionContext* ctx) {
-    ctx->frame->state = 4; // EXCEPTIONAL_HALT
-    ctx->frame->halt_reason = 2; // INVALID_OPERATION
-    return {-1, 0};
-}
-
-// Stub for unimplemented operations
-static OpResult op_stub(ExecutionContext* ctx) {
-    // For now, just push zero for read operations, pop for write operations
-    // This allows tests to continue without full implementation
-    return {1, 3};
-}
-
-// ===== JUMP TABLE =====
-
-// Create wrappers for PUSH1-PUSH32
-#define PUSH_HANDLER(n) static OpResult op_push##n(ExecutionContext* ctx) { return op_push_n(ctx, n); }
-PUSH_HANDLER(1)  PUSH_HANDLER(2)  PUSH_HANDLER(3)  PUSH_HANDLER(4)
-PUSH_HANDLER(5)  PUSH_HANDLER(6)  PUSH_HANDLER(7)  PUSH_HANDLER(8)
-PUSH_HANDLER(9)  PUSH_HANDLER(10) PUSH_HANDLER(11) PUSH_HANDLER(12)
-PUSH_HANDLER(13) PUSH_HANDLER(14) PUSH_HANDLER(15) PUSH_HANDLER(16)
-PUSH_HANDLER(17) PUSH_HANDLER(18) PUSH_HANDLER(19) PUSH_HANDLER(20)
-PUSH_HANDLER(21) PUSH_HANDLER(22) PUSH_HANDLER(23) PUSH_HANDLER(24)
-PUSH_HANDLER(25) PUSH_HANDLER(26) PUSH_HANDLER(27) PUSH_HANDLER(28)
-PUSH_HANDLER(29) PUSH_HANDLER(30) PUSH_HANDLER(31) PUSH_HANDLER(32)
-
-// Create wrappers for DUP1-DUP16
-#define DUP_HANDLER(n) static OpResult op_dup##n(ExecutionContext* ctx) { return op_dup_n(ctx, n); }
-DUP_HANDLER(1)  DUP_HANDLER(2)  DUP_HANDLER(3)  DUP_HANDLER(4)
-DUP_HANDLER(5)  DUP_HANDLER(6)  DUP_HANDLER(7)  DUP_HANDLER(8)
-DUP_HANDLER(9)  DUP_HANDLER(10) DUP_HANDLER(11) DUP_HANDLER(12)
-DUP_HANDLER(13) DUP_HANDLER(14) DUP_HANDLER(15) DUP_HANDLER(16)
-
-// Create wrappers for SWAP1-SWAP16
-#define SWAP_HANDLER(n) static OpResult op_swap##n(ExecutionContext* ctx) { return op_swap_n(ctx, n); }
-SWAP_HANDLER(1)  SWAP_HANDLER(2)  SWAP_HANDLER(3)  SWAP_HANDLER(4)
-SWAP_HANDLER(5)  SWAP_HANDLER(6)  SWAP_HANDLER(7)  SWAP_HANDLER(8)
-SWAP_HANDLER(9)  SWAP_HANDLER(10) SWAP_HANDLER(11) SWAP_HANDLER(12)
-SWAP_HANDLER(13) SWAP_HANDLER(14) SWAP_HANDLER(15) SWAP_HANDLER(16)
-
-// 256-entry jump table
-static const OpHandler JUMP_TABLE[256] = {
-    op_stop,    op_add,     op_mul,     op_sub,     op_div,     op_stub,    op_mod,     op_stub,    // 0x00-0x07
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    // 0x08-0x0f
-    op_lt,      op_gt,      op_stub,    op_stub,    op_eq,      op_iszero,  op_and,     op_or,      // 0x10-0x17
-    op_xor,     op_not,     op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    // 0x18-0x1f
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    // 0x20-0x27
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    // 0x28-0x2f
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    // 0x30-0x37
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    // 0x38-0x3f
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    // 0x40-0x47
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    // 0x48-0x4f
-    op_pop,     op_mload,   op_mstore,  op_mstore8, op_stub,    op_stub,    op_jump,    op_jumpi,   // 0x50-0x57
-    op_pc,      op_stub,    op_gas,     op_jumpdest,op_stub,    op_stub,    op_stub,    op_push0,   // 0x58-0x5f
-    op_push1,   op_push2,   op_push3,   op_push4,   op_push5,   op_push6,   op_push7,   op_push8,   // 0x60-0x67
-    op_push9,   op_push10,  op_push11,  op_push12,  op_push13,  op_push14,  op_push15,  op_push16,  // 0x68-0x6f
-    op_push17,  op_push18,  op_push19,  op_push20,  op_push21,  op_push22,  op_push23,  op_push24,  // 0x70-0x77
-    op_push25,  op_push26,  op_push27,  op_push28,  op_push29,  op_push30,  op_push31,  op_push32,  // 0x78-0x7f
-    op_dup1,    op_dup2,    op_dup3,    op_dup4,    op_dup5,    op_dup6,    op_dup7,    op_dup8,    // 0x80-0x87
-    op_dup9,    op_dup10,   op_dup11,   op_dup12,   op_dup13,   op_dup14,   op_dup15,   op_dup16,   // 0x88-0x8f
-    op_swap1,   op_swap2,   op_swap3,   op_swap4,   op_swap5,   op_swap6,   op_swap7,   op_swap8,   // 0x90-0x97
-    op_swap9,   op_swap10,  op_swap11,  op_swap12,  op_swap13,  op_swap14,  op_swap15,  op_swap16,  // 0x98-0x9f
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    // 0xa0-0xa7
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    // 0xa8-0xaf
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    // 0xb0-0xb7
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    // 0xb8-0xbf
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    // 0xc0-0xc7
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    // 0xc8-0xcf
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    // 0xd0-0xd7
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    // 0xd8-0xdf
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    // 0xe0-0xe7
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    // 0xe8-0xef
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    // 0xf0-0xf7
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_invalid, op_invalid, op_invalid  // 0xf8-0xff
-};
-
-// ===== MAIN EXECUTION LOOP =====
-
-void execute_message(MessageFrameMemory* frame, TracerCallbacks* tracer) {
-    if (!frame) {
-        fprintf(stderr, "ERROR: NULL frame pointer\n");
-        return;
-    }
-
-    // Initialize frame state
-    frame->state = 1; // CODE_EXECUTING
-
-    // Set up execution context
-    uint8_t* base = reinterpret_cast<uint8_t*>(frame);
-    ExecutionContext ctx = {
-        frame,
-        base + frame->stack_ptr,
-        base + frame->memory_ptr,
-        base + frame->code_ptr
-    };
-
-    bool has_tracer = (tracer != nullptr && tracer->trace_pre_execution != nullptr);
-
-    // Main execution loop
-    while (frame->pc < static_cast<int32_t>(frame->code_size) && frame->state == 1) {
-        // Minimum gas check - most operations cost at least 3 gas
-        // This early check catches out-of-gas before expensive operations
-        if (frame->gas_remaining < 3) {
-            frame->state = 4; // EXCEPTIONAL_HALT
-            frame->halt_reason = 1; // INSUFFICIENT_GAS
-            return;
-        }
-
-        uint8_t opcode = ctx.code[frame->pc];
-
-        // Pre-execution trace
-        if (has_tracer) {
-            tracer->trace_pre_execution(frame);
-        }
-
-        // Dispatch to operation handler via jump table
-        OpResult result = JUMP_TABLE[opcode](&ctx);
-
-        // Check for errors
-        if (result.pc_increment < 0) {
-            if (frame->state == 1) { // Not already set by operation
-                frame->state = 4; // EXCEPTIONAL_HALT
-                frame->halt_reason = 4; // STACK_UNDERFLOW or other error
-            }
-            return;
-        }
-
-        // Check gas before consuming
-        if (frame->gas_remaining < result.gas_cost) {
-            frame->state = 4;
-            frame->halt_reason = 1; // INSUFFICIENT_GAS
-            return;
-        }
-
-        // Consume gas
-        frame->gas_remaining -= result.gas_cost;
-
-        // Post-execution trace
-        if (has_tracer) {
-            OperationResult op_result;
-            op_result.gas_cost = result.gas_cost;
-            op_result.halt_reason = 0;
-            op_result.pc_increment = result.pc_increment;
-            tracer->trace_post_execution(frame, &op_result);
-        }
-
-        // Advance PC
-        if (result.pc_increment > 0) {
-            frame->pc += result.pc_increment;
-        }
-    }
-
-    // Set final state if not already set
-    if (frame->state == 1) {
-        frame->state = 7; // COMPLETED_SUCCESS
-    }
-}
-
-} // extern "C"
@@ -2,51 +2,145 @@
 // SPDX-License-Identifier: Apache-2.0
 
 /**
- * Optimized EVM implementation with direct stack writes.
- * Eliminates intermediate copies for maximum performance.
+ * EVM interpreter for Panama FFM frames.
+ *
+ * One handler set, instantiated per
+ * - stack access policy (Bounds): software-checked or guard-page frames
+ * - revision: dispatch table and gas schedule of the fork
+ * - dispatch policy: how the loop gets from an opcode to its handler
+ *
+ * Handlers write results directly into stack slots; every dispatch policy runs
+ * the same handlers, so dispatch strategies can be compared on identical
+ * semantics. The policy used by execute_message is chosen at build time
+ * (BESU_DISPATCH in CMakeLists.txt) and reported by besu_dispatch_policy().
  */
 
 #include "../include/message_frame_memory.h"
 #include "../include/storage_memory.h"
 #include "../include/tracer_callback.h"
+#include "../include/guarded_frame.h"
+#include "../include/opcode_table.h"
+#include "../include/gas_schedule.h"
+#include "../include/keccak.h"
+#include "../include/execution_recorder.h"
+#include "../include/code_analysis.h"
 #include <cstdio>
 #include <cstring>
 #include <algorithm>
+#include <array>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 using namespace besu::evm;
 
-extern "C" {
-
 #define WORD_SIZE 32
 
+// Constant gas of an opcode in the revision R of the handler using it
+#define BASE_GAS(op) (std::integral_constant<int, opcodes::TABLE<R>[opcodes::op].base_gas>::value)
+
 struct OpResult {
     int pc_increment;
     int gas_cost;
 };
 
+/** Analysis of one code in one revision (code_analysis.h), shared by every frame that runs it. */
+struct CodeAnalysis {
+    std::vector<uint8_t> code;                     // Copy, matched by content on later calls
+    Revision revision;
+    std::vector<uint8_t> jumpdests;                // Jumpdest bitmap
+    std::vector<code_analysis::BlockInfo> blocks;  // In pc order
+    std::vector<uint32_t> block_index;             // Per pc: 1 + index of the block starting there, or 0
+};
+
 struct ExecutionContext {
     MessageFrameMemory* frame;
     uint8_t* stack_base;
     uint8_t* memory_base;
     const uint8_t* code;
     StorageEntry* storage_base;
+    uint64_t memory_limit;  // Bytes memory may grow to; past it both bounds policies halt alike
+    const CodeAnalysis* analysis;
+    uint32_t steps;         // Instructions left for run_loop to run
+};
+
+// The checked frame's memory limit; guarded frames are also capped at their capacity
+static constexpr uint64_t MAX_MEMORY_SIZE = 1024 * 1024;
+
+/**
+ * Bounds policies.
+ *
+ * CheckedBounds tests every stack push/peek and the memory limit in software.
+ * GuardedBounds is used for guard-page frames (include/guarded_frame.h): out-of-range
+ * stack and memory accesses fault on a PROT_NONE page and are turned into an
+ * exceptional halt by the fault handler, so those checks compile away.
+ * VerifiedBlock<Bounds> runs a basic block whose constant gas and stack bounds
+ * were checked on entry (run_blocks), so the per-instruction gas check and the
+ * stack checks compile away as well.
+ */
+struct CheckedBounds {
+    static constexpr bool kGuarded = false;
+    static constexpr bool kVerified = false;
+};
+struct GuardedBounds {
+    static constexpr bool kGuarded = true;
+    static constexpr bool kVerified = false;
 };
+template <typename Bounds>
+struct VerifiedBlock {
+    static constexpr bool kGuarded = Bounds::kGuarded;
+    static constexpr bool kVerified = true;
+};
+
+// True if stack accesses need no software check
+template <typename Bounds>
+static constexpr bool kStackSafe = Bounds::kGuarded || Bounds::kVerified;
+
+/**
+ * Halt for a stack access out of range, with the reason the guard pages of a
+ * guarded frame report for it.
+ * @return nullptr, for the stack helpers to pass on
+ */
+static inline uint8_t* stack_halt(ExecutionContext* ctx, uint32_t halt_reason) {
+    ctx->frame->state = 4;
+    ctx->frame->halt_reason = halt_reason;
+    return nullptr;
+}
 
 // Fast stack helpers - return pointers for direct manipulation
+template <typename Bounds>
 static inline uint8_t* stack_top(ExecutionContext* ctx, int offset) {
-    if (offset >= ctx->frame->stack_size) return nullptr;
-    return ctx->stack_base + ((ctx->frame->stack_size - 1 - offset) * WORD_SIZE);
+    if (!kStackSafe<Bounds> && offset >= ctx->frame->stack_size) return stack_halt(ctx, 5);  // STACK_UNDERFLOW
+    uint8_t* item = ctx->stack_base + ((ctx->frame->stack_size - 1 - offset) * WORD_SIZE);
+    if (kStackSafe<Bounds> && item == nullptr) __builtin_unreachable();  // lets callers drop null checks
+    return item;
 }
 
+template <typename Bounds>
 static inline uint8_t* stack_alloc(ExecutionContext* ctx) {
-    if (ctx->frame->stack_size >= 1024) return nullptr;
+    if (!kStackSafe<Bounds> && ctx->frame->stack_size >= 1024) return stack_halt(ctx, 4);  // STACK_OVERFLOW
     uint8_t* item = ctx->stack_base + (ctx->frame->stack_size * WORD_SIZE);
+    if (kStackSafe<Bounds> && item == nullptr) __builtin_unreachable();
     ctx->frame->stack_size++;
     return item;
 }
 
+/**
+ * Touch an operand a guarded handler could halt before reading, so that a
+ * missing operand hits the underflow guard first, as the checked path finds it.
+ */
+template <typename Bounds>
+static inline void stack_probe(const uint8_t* item) {
+    if (Bounds::kGuarded && !Bounds::kVerified) (void)*static_cast<const volatile uint8_t*>(item);
+}
+
+template <typename Bounds>
 static inline bool stack_free(ExecutionContext* ctx, int count) {
-    if (ctx->frame->stack_size < count) return false;
+    if (!kStackSafe<Bounds> && ctx->frame->stack_size < count) {
+        stack_halt(ctx, 5);  // STACK_UNDERFLOW
+        return false;
+    }
     ctx->frame->stack_size -= count;
     return true;
 }
@@ -60,6 +154,14 @@ static inline uint64_t word_to_u64(const uint8_t* word) {
     return result;
 }
 
+/** True if the word is below 2^32, so it can be a memory offset or size. */
+static inline bool fits_u32(const uint8_t* word) {
+    for (int i = 0; i < WORD_SIZE - 4; i++) {
+        if (word[i] != 0) return false;
+    }
+    return true;
+}
+
 static inline void u64_to_word(uint64_t value, uint8_t* word) {
     memset(word, 0, WORD_SIZE);
     for (int i = 31; i >= 24; i--) {
@@ -76,30 +178,56 @@ static inline bool is_zero(const uint8_t* word) {
 }
 
 // Memory helpers
-static inline bool ensure_memory(ExecutionContext* ctx, uint32_t offset, uint32_t size) {
+
+/** Gas for a memory of words 32-byte words: 3 per word plus words^2 / 512. */
+static inline int64_t memory_cost(uint64_t words) {
+    return static_cast<int64_t>(3 * words + words * words / 512);
+}
+
+/**
+ * Grow memory to cover [offset, offset + size).
+ * @param expansion_gas set to the gas of the words added (0 if none)
+ * @return false if the range is past the memory limit
+ */
+template <typename Bounds>
+static inline bool ensure_memory(ExecutionContext* ctx, uint64_t offset, uint64_t size, int& expansion_gas) {
+    expansion_gas = 0;
     if (size == 0) return true;
-    uint64_t required = (uint64_t)offset + size;
-    if (required > ctx->frame->memory_size) {
-        uint32_t new_size = ((required + 31) / 32) * 32;
-        if (new_size > 1024 * 1024) return false;
-        if (new_size > ctx->frame->memory_size) {
-            memset(ctx->memory_base + ctx->frame->memory_size, 0, new_size - ctx->frame->memory_size);
-            ctx->frame->memory_size = new_size;
-        }
+    if (offset > ctx->memory_limit || size > ctx->memory_limit - offset) return false;
+    const uint64_t required = offset + size;
+    const uint64_t old_size = static_cast<uint32_t>(ctx->frame->memory_size);
+    if (required <= old_size) return true;
+    const uint64_t new_size = ((required + 31) / 32) * 32;
+    if (new_size > ctx->memory_limit) return false;
+    if (!Bounds::kGuarded) {
+        // Guarded frames are zero-filled up to their capacity; checked memory is zeroed as it grows
+        memset(ctx->memory_base + old_size, 0, new_size - old_size);
     }
+    ctx->frame->memory_size = static_cast<int32_t>(new_size);
+    // The memory limit keeps this far below int range
+    expansion_gas = static_cast<int>(memory_cost(new_size / 32) - memory_cost(old_size / 32));
     return true;
 }
 
+/** Halt for a memory offset of 2^32 or more: its expansion costs more than any gas limit. */
+static inline OpResult memory_out_of_gas(ExecutionContext* ctx) {
+    ctx->frame->state = 4;
+    ctx->frame->halt_reason = 1;  // INSUFFICIENT_GAS
+    return {-1, 0};
+}
+
 // ===== OPTIMIZED OPERATION HANDLERS (DIRECT STACK WRITES) =====
 
+template <typename Bounds, Revision R>
 static OpResult op_stop(ExecutionContext* ctx) {
     ctx->frame->state = 7;
     return {0, 0};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_add(ExecutionContext* ctx) {
-    uint8_t* a = stack_top(ctx, 0);
-    uint8_t* b = stack_top(ctx, 1);
+    uint8_t* a = stack_top<Bounds>(ctx, 0);
+    uint8_t* b = stack_top<Bounds>(ctx, 1);
     if (!a || !b) return {-1, 0};
 
     uint64_t val_a = word_to_u64(a);
@@ -107,226 +235,287 @@ static OpResult op_add(ExecutionContext* ctx) {
 
     // Write result directly to top-1, then pop top
     u64_to_word(val_a + val_b, b);
-    stack_free(ctx, 1);
+    stack_free<Bounds>(ctx, 1);
 
-    return {1, 3};
+    return {1, BASE_GAS(ADD)};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_mul(ExecutionContext* ctx) {
-    uint8_t* a = stack_top(ctx, 0);
-    uint8_t* b = stack_top(ctx, 1);
+    uint8_t* a = stack_top<Bounds>(ctx, 0);
+    uint8_t* b = stack_top<Bounds>(ctx, 1);
     if (!a || !b) return {-1, 0};
 
     u64_to_word(word_to_u64(a) * word_to_u64(b), b);
-    stack_free(ctx, 1);
+    stack_free<Bounds>(ctx, 1);
 
-    return {1, 5};
+    return {1, BASE_GAS(MUL)};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_sub(ExecutionContext* ctx) {
-    uint8_t* a = stack_top(ctx, 0);
-    uint8_t* b = stack_top(ctx, 1);
+    uint8_t* a = stack_top<Bounds>(ctx, 0);
+    uint8_t* b = stack_top<Bounds>(ctx, 1);
     if (!a || !b) return {-1, 0};
 
     u64_to_word(word_to_u64(a) - word_to_u64(b), b);
-    stack_free(ctx, 1);
+    stack_free<Bounds>(ctx, 1);
 
-    return {1, 3};
+    return {1, BASE_GAS(SUB)};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_div(ExecutionContext* ctx) {
-    uint8_t* a = stack_top(ctx, 0);
-    uint8_t* b = stack_top(ctx, 1);
+    uint8_t* a = stack_top<Bounds>(ctx, 0);
+    uint8_t* b = stack_top<Bounds>(ctx, 1);
     if (!a || !b) return {-1, 0};
 
     uint64_t val_a = word_to_u64(a);
     uint64_t val_b = word_to_u64(b);
     u64_to_word(val_b == 0 ? 0 : val_a / val_b, b);
-    stack_free(ctx, 1);
+    stack_free<Bounds>(ctx, 1);
 
-    return {1, 5};
+    return {1, BASE_GAS(DIV)};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_mod(ExecutionContext* ctx) {
-    uint8_t* a = stack_top(ctx, 0);
-    uint8_t* b = stack_top(ctx, 1);
+    uint8_t* a = stack_top<Bounds>(ctx, 0);
+    uint8_t* b = stack_top<Bounds>(ctx, 1);
     if (!a || !b) return {-1, 0};
 
     uint64_t val_a = word_to_u64(a);
     uint64_t val_b = word_to_u64(b);
     u64_to_word(val_b == 0 ? 0 : val_a % val_b, b);
-    stack_free(ctx, 1);
+    stack_free<Bounds>(ctx, 1);
 
-    return {1, 5};
+    return {1, BASE_GAS(MOD)};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_lt(ExecutionContext* ctx) {
-    uint8_t* a = stack_top(ctx, 0);
-    uint8_t* b = stack_top(ctx, 1);
+    uint8_t* a = stack_top<Bounds>(ctx, 0);
+    uint8_t* b = stack_top<Bounds>(ctx, 1);
     if (!a || !b) return {-1, 0};
 
     u64_to_word(word_to_u64(a) < word_to_u64(b) ? 1 : 0, b);
-    stack_free(ctx, 1);
+    stack_free<Bounds>(ctx, 1);
 
-    return {1, 3};
+    return {1, BASE_GAS(LT)};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_gt(ExecutionContext* ctx) {
-    uint8_t* a = stack_top(ctx, 0);
-    uint8_t* b = stack_top(ctx, 1);
+    uint8_t* a = stack_top<Bounds>(ctx, 0);
+    uint8_t* b = stack_top<Bounds>(ctx, 1);
     if (!a || !b) return {-1, 0};
 
     u64_to_word(word_to_u64(a) > word_to_u64(b) ? 1 : 0, b);
-    stack_free(ctx, 1);
+    stack_free<Bounds>(ctx, 1);
 
-    return {1, 3};
+    return {1, BASE_GAS(GT)};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_eq(ExecutionContext* ctx) {
-    uint8_t* a = stack_top(ctx, 0);
-    uint8_t* b = stack_top(ctx, 1);
+    uint8_t* a = stack_top<Bounds>(ctx, 0);
+    uint8_t* b = stack_top<Bounds>(ctx, 1);
     if (!a || !b) return {-1, 0};
 
     u64_to_word(memcmp(a, b, WORD_SIZE) == 0 ? 1 : 0, b);
-    stack_free(ctx, 1);
+    stack_free<Bounds>(ctx, 1);
 
-    return {1, 3};
+    return {1, BASE_GAS(EQ)};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_iszero(ExecutionContext* ctx) {
-    uint8_t* a = stack_top(ctx, 0);
+    uint8_t* a = stack_top<Bounds>(ctx, 0);
     if (!a) return {-1, 0};
 
     u64_to_word(is_zero(a) ? 1 : 0, a);
 
-    return {1, 3};
+    return {1, BASE_GAS(ISZERO)};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_and(ExecutionContext* ctx) {
-    uint8_t* a = stack_top(ctx, 0);
-    uint8_t* b = stack_top(ctx, 1);
+    uint8_t* a = stack_top<Bounds>(ctx, 0);
+    uint8_t* b = stack_top<Bounds>(ctx, 1);
     if (!a || !b) return {-1, 0};
 
     for (int i = 0; i < WORD_SIZE; i++) {
         b[i] &= a[i];
     }
-    stack_free(ctx, 1);
+    stack_free<Bounds>(ctx, 1);
 
-    return {1, 3};
+    return {1, BASE_GAS(AND)};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_or(ExecutionContext* ctx) {
-    uint8_t* a = stack_top(ctx, 0);
-    uint8_t* b = stack_top(ctx, 1);
+    uint8_t* a = stack_top<Bounds>(ctx, 0);
+    uint8_t* b = stack_top<Bounds>(ctx, 1);
     if (!a || !b) return {-1, 0};
 
     for (int i = 0; i < WORD_SIZE; i++) {
         b[i] |= a[i];
     }
-    stack_free(ctx, 1);
+    stack_free<Bounds>(ctx, 1);
 
-    return {1, 3};
+    return {1, BASE_GAS(OR)};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_xor(ExecutionContext* ctx) {
-    uint8_t* a = stack_top(ctx, 0);
-    uint8_t* b = stack_top(ctx, 1);
+    uint8_t* a = stack_top<Bounds>(ctx, 0);
+    uint8_t* b = stack_top<Bounds>(ctx, 1);
     if (!a || !b) return {-1, 0};
 
     for (int i = 0; i < WORD_SIZE; i++) {
         b[i] ^= a[i];
     }
-    stack_free(ctx, 1);
+    stack_free<Bounds>(ctx, 1);
 
-    return {1, 3};
+    return {1, BASE_GAS(XOR)};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_not(ExecutionContext* ctx) {
-    uint8_t* a = stack_top(ctx, 0);
+    uint8_t* a = stack_top<Bounds>(ctx, 0);
     if (!a) return {-1, 0};
 
     for (int i = 0; i < WORD_SIZE; i++) {
         a[i] = ~a[i];
     }
 
-    return {1, 3};
+    return {1, BASE_GAS(NOT)};
 }
 
+template <typename Bounds, Revision R>
+static OpResult op_keccak256(ExecutionContext* ctx) {
+    uint8_t* offset_word = stack_top<Bounds>(ctx, 0);
+    uint8_t* size_word = stack_top<Bounds>(ctx, 1);
+    if (!offset_word || !size_word) return {-1, 0};
+
+    // A 2^32-byte input costs far more than any gas limit; the offset only matters for a non-empty input
+    if (!fits_u32(size_word) || (!is_zero(size_word) && !fits_u32(offset_word))) {
+        return memory_out_of_gas(ctx);
+    }
+    const uint32_t size = static_cast<uint32_t>(word_to_u64(size_word));
+    const uint32_t offset = size ? static_cast<uint32_t>(word_to_u64(offset_word)) : 0;
+    int expansion_gas;
+    if (!ensure_memory<Bounds>(ctx, offset, size, expansion_gas)) return {-1, 0};
+
+    // Result goes to the size slot, which is below the offset slot
+    keccak::keccak256(ctx->memory_base + offset, size, size_word);
+    stack_free<Bounds>(ctx, 1);
+
+    return {1, BASE_GAS(KECCAK256) + 6 * static_cast<int>((size + 31) / 32) + expansion_gas};
+}
+
+template <typename Bounds, Revision R>
 static OpResult op_pop(ExecutionContext* ctx) {
-    if (!stack_free(ctx, 1)) return {-1, 0};
-    return {1, 2};
+    stack_probe<Bounds>(stack_top<Bounds>(ctx, 0));  // POP touches nothing else
+    if (!stack_free<Bounds>(ctx, 1)) return {-1, 0};
+    return {1, BASE_GAS(POP)};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_mload(ExecutionContext* ctx) {
-    uint8_t* offset_word = stack_top(ctx, 0);
+    uint8_t* offset_word = stack_top<Bounds>(ctx, 0);
     if (!offset_word) return {-1, 0};
 
+    if (!fits_u32(offset_word)) return memory_out_of_gas(ctx);
     uint32_t offset = (uint32_t)word_to_u64(offset_word);
-    if (!ensure_memory(ctx, offset, 32)) return {-1, 0};
+    int expansion_gas;
+    if (!ensure_memory<Bounds>(ctx, offset, 32, expansion_gas)) return {-1, 0};
 
     // Write directly to stack top
     memcpy(offset_word, ctx->memory_base + offset, WORD_SIZE);
 
-    return {1, 3};
+    return {1, BASE_GAS(MLOAD) + expansion_gas};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_mstore(ExecutionContext* ctx) {
-    uint8_t* offset_word = stack_top(ctx, 0);
-    uint8_t* value = stack_top(ctx, 1);
+    uint8_t* offset_word = stack_top<Bounds>(ctx, 0);
+    uint8_t* value = stack_top<Bounds>(ctx, 1);
     if (!offset_word || !value) return {-1, 0};
+    stack_probe<Bounds>(value);
 
+    if (!fits_u32(offset_word)) return memory_out_of_gas(ctx);
     uint32_t offset = (uint32_t)word_to_u64(offset_word);
-    if (!ensure_memory(ctx, offset, 32)) return {-1, 0};
+    int expansion_gas;
+    if (!ensure_memory<Bounds>(ctx, offset, 32, expansion_gas)) return {-1, 0};
 
     memcpy(ctx->memory_base + offset, value, WORD_SIZE);
-    stack_free(ctx, 2);
+    stack_free<Bounds>(ctx, 2);
 
-    return {1, 3};
+    return {1, BASE_GAS(MSTORE) + expansion_gas};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_mstore8(ExecutionContext* ctx) {
-    uint8_t* offset_word = stack_top(ctx, 0);
-    uint8_t* value_word = stack_top(ctx, 1);
+    uint8_t* offset_word = stack_top<Bounds>(ctx, 0);
+    uint8_t* value_word = stack_top<Bounds>(ctx, 1);
     if (!offset_word || !value_word) return {-1, 0};
+    stack_probe<Bounds>(value_word);
 
+    if (!fits_u32(offset_word)) return memory_out_of_gas(ctx);
     uint32_t offset = (uint32_t)word_to_u64(offset_word);
-    if (!ensure_memory(ctx, offset, 1)) return {-1, 0};
+    int expansion_gas;
+    if (!ensure_memory<Bounds>(ctx, offset, 1, expansion_gas)) return {-1, 0};
 
     ctx->memory_base[offset] = value_word[31];
-    stack_free(ctx, 2);
+    stack_free<Bounds>(ctx, 2);
 
-    return {1, 3};
+    return {1, BASE_GAS(MSTORE8) + expansion_gas};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_sload(ExecutionContext* ctx) {
-    uint8_t* key_word = stack_top(ctx, 0);
+    using Gas = GasSchedule<R>;
+    uint8_t* key_word = stack_top<Bounds>(ctx, 0);
     if (!key_word) return {-1, 0};
 
     // Get the current contract address (where storage is being read from)
     const uint8_t* address = ctx->frame->contract;
 
-    // Look up storage entry by (address, key)
+    // Look up storage entry by (address, key); a missing slot is zero and is
+    // added so later accesses see it warm
     StorageEntry* entry = storage::find(
         ctx->storage_base,
         ctx->frame->storage_slot_count,
         address,
         key_word
     );
+    if (!entry) {
+        entry = storage::add(
+            ctx->storage_base,
+            &ctx->frame->storage_slot_count,
+            ctx->frame->max_storage_slots,
+            address,
+            key_word
+        );
+    }
 
-    if (entry) {
-        // Found the entry - copy value to stack
-        memcpy(key_word, entry->value, WORD_SIZE);
-        int gas_cost = entry->is_warm ? 100 : 2100;
-        entry->is_warm = 1;  // Mark as warm
-        return {1, gas_cost};
+    if (!entry) {
+        // No room to record the slot: read zero, always cold
+        memset(key_word, 0, WORD_SIZE);
+        return {1, static_cast<int>(Gas::cold_sload)};
     }
 
-    // Not found - return zero (empty storage slot)
-    memset(key_word, 0, WORD_SIZE);
-    return {1, 2100};  // Cold access
+    const bool cold = Gas::access_lists && !entry->is_warm;
+    memcpy(key_word, entry->value, WORD_SIZE);
+    entry->is_warm = 1;
+    return {1, static_cast<int>(cold ? Gas::cold_sload : Gas::sload)};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_sstore(ExecutionContext* ctx) {
+    using Gas = GasSchedule<R>;
+
     // Static calls cannot modify storage
     if (ctx->frame->is_static) {
         ctx->frame->state = 4;  // EXCEPTIONAL_HALT
@@ -334,68 +523,37 @@ static OpResult op_sstore(ExecutionContext* ctx) {
         return {-1, 0};
     }
 
-    uint8_t* key_word = stack_top(ctx, 0);
-    uint8_t* value_word = stack_top(ctx, 1);
+    // EIP-2200 sentry: SSTORE needs more than the call stipend left
+    if (ctx->frame->gas_remaining <= Gas::sstore_sentry) {
+        ctx->frame->state = 4;
+        ctx->frame->halt_reason = 1;  // INSUFFICIENT_GAS
+        return {-1, 0};
+    }
+
+    uint8_t* key_word = stack_top<Bounds>(ctx, 0);
+    uint8_t* value_word = stack_top<Bounds>(ctx, 1);
     if (!key_word || !value_word) return {-1, 0};
 
     // Get the current contract address (where storage is being written)
     const uint8_t* address = ctx->frame->contract;
 
-    // Look up storage entry by (address, key)
+    // Look up storage entry by (address, key); a missing slot is zero
     StorageEntry* entry = storage::find(
         ctx->storage_base,
         ctx->frame->storage_slot_count,
         address,
         key_word
     );
-
-    if (entry) {
-        // Found existing entry - calculate gas cost (EIP-2200)
-        bool is_zero_value = is_zero(value_word);
-        bool was_zero_original = is_zero(entry->original);
-        bool was_zero_current = is_zero(entry->value);
-
-        int gas_cost;
-        bool is_warm = entry->is_warm;
-
-        if (is_zero_value) {
-            // Setting to zero
-            if (!was_zero_current) {
-                // Clearing storage - refund
-                ctx->frame->gas_refund += 4800;
-            }
-            gas_cost = is_warm ? 100 : 2100;
-        } else {
-            // Setting to non-zero
-            if (was_zero_current && !was_zero_original) {
-                // Re-setting (was cleared earlier)
-                gas_cost = is_warm ? 100 : 2100;
-            } else if (was_zero_current) {
-                // First time setting
-                gas_cost = 20000;
-            } else {
-                // Modifying existing
-                gas_cost = is_warm ? 100 : 2100;
-            }
-        }
-
-        // Update value and mark as warm
-        memcpy(entry->value, value_word, WORD_SIZE);
-        entry->is_warm = 1;
-
-        stack_free(ctx, 2);
-        return {1, gas_cost};
+    if (!entry) {
+        entry = storage::add(
+            ctx->storage_base,
+            &ctx->frame->storage_slot_count,
+            ctx->frame->max_storage_slots,
+            address,
+            key_word
+        );
     }
 
-    // Entry not found - add new entry
-    entry = storage::add(
-        ctx->storage_base,
-        &ctx->frame->storage_slot_count,
-        ctx->frame->max_storage_slots,
-        address,
-        key_word
-    );
-
     if (!entry) {
         // Out of storage space
         ctx->frame->state = 4;
@@ -403,86 +561,138 @@ static OpResult op_sstore(ExecutionContext* ctx) {
         return {-1, 0};
     }
 
-    // Set value in new entry
+    // EIP-2200 net gas metering, with the EIP-2929 cold surcharge and EIP-3529 refunds
+    const bool original_zero = is_zero(entry->original);
+    int64_t gas = (Gas::access_lists && !entry->is_warm) ? Gas::cold_sload : 0;
+
+    if (memcmp(entry->value, value_word, WORD_SIZE) == 0) {
+        // No-op write
+        gas += Gas::sload;
+    } else if (memcmp(entry->original, entry->value, WORD_SIZE) == 0) {
+        // First write to the slot in this transaction
+        if (original_zero) {
+            gas += Gas::sstore_set;
+        } else {
+            gas += Gas::sstore_reset;
+            if (is_zero(value_word)) ctx->frame->gas_refund += Gas::sstore_clears_refund;
+        }
+    } else {
+        // Slot already written: charge a read, adjust earlier refunds
+        gas += Gas::sload;
+        if (!original_zero) {
+            if (is_zero(entry->value)) {
+                ctx->frame->gas_refund -= Gas::sstore_clears_refund;
+            } else if (is_zero(value_word)) {
+                ctx->frame->gas_refund += Gas::sstore_clears_refund;
+            }
+        }
+        if (memcmp(entry->original, value_word, WORD_SIZE) == 0) {
+            // Restored to the original value
+            ctx->frame->gas_refund += (original_zero ? Gas::sstore_set : Gas::sstore_reset) - Gas::sload;
+        }
+    }
+
+    // Update value and mark as warm
     memcpy(entry->value, value_word, WORD_SIZE);
-    memcpy(entry->original, value_word, WORD_SIZE);
     entry->is_warm = 1;
 
-    stack_free(ctx, 2);
+    stack_free<Bounds>(ctx, 2);
+    return {1, static_cast<int>(gas)};
+}
 
-    // New storage slot (cold, non-zero value)
-    return {1, 20000};
+/** True if the word is a JUMPDEST of the code, per its jumpdest bitmap (not PUSH data). */
+static inline bool valid_jump(const ExecutionContext* ctx, const uint8_t* dest_word) {
+    return fits_u32(dest_word) &&
+           code_analysis::is_jumpdest(ctx->analysis->jumpdests.data(), ctx->frame->code_size, word_to_u64(dest_word));
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_jump(ExecutionContext* ctx) {
-    uint8_t* dest_word = stack_top(ctx, 0);
+    uint8_t* dest_word = stack_top<Bounds>(ctx, 0);
     if (!dest_word) return {-1, 0};
 
     uint32_t dest = (uint32_t)word_to_u64(dest_word);
-    if (dest >= ctx->frame->code_size || ctx->code[dest] != 0x5b) {
+    if (!valid_jump(ctx, dest_word)) {
         ctx->frame->state = 4;
         ctx->frame->halt_reason = 3;
         return {-1, 0};
     }
 
-    stack_free(ctx, 1);
+    stack_free<Bounds>(ctx, 1);
     ctx->frame->pc = dest;
-    return {0, 8};
+    return {0, BASE_GAS(JUMP)};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_jumpi(ExecutionContext* ctx) {
-    uint8_t* dest_word = stack_top(ctx, 0);
-    uint8_t* cond_word = stack_top(ctx, 1);
+    uint8_t* dest_word = stack_top<Bounds>(ctx, 0);
+    uint8_t* cond_word = stack_top<Bounds>(ctx, 1);
     if (!dest_word || !cond_word) return {-1, 0};
 
     bool should_jump = !is_zero(cond_word);
     uint32_t dest = (uint32_t)word_to_u64(dest_word);
+    const bool valid = should_jump && valid_jump(ctx, dest_word);
 
-    stack_free(ctx, 2);
+    stack_free<Bounds>(ctx, 2);
 
     if (should_jump) {
-        if (dest >= ctx->frame->code_size || ctx->code[dest] != 0x5b) {
+        if (!valid) {
             ctx->frame->state = 4;
             ctx->frame->halt_reason = 3;
             return {-1, 0};
         }
         ctx->frame->pc = dest;
-        return {0, 10};
+        return {0, BASE_GAS(JUMPI)};
     }
 
-    return {1, 10};
+    return {1, BASE_GAS(JUMPI)};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_pc(ExecutionContext* ctx) {
-    uint8_t* item = stack_alloc(ctx);
+    uint8_t* item = stack_alloc<Bounds>(ctx);
     if (!item) return {-1, 0};
 
     u64_to_word(ctx->frame->pc, item);
-    return {1, 2};
+    return {1, BASE_GAS(PC)};
+}
+
+template <typename Bounds, Revision R>
+static OpResult op_msize(ExecutionContext* ctx) {
+    uint8_t* item = stack_alloc<Bounds>(ctx);
+    if (!item) return {-1, 0};
+
+    u64_to_word(static_cast<uint32_t>(ctx->frame->memory_size), item);
+    return {1, BASE_GAS(MSIZE)};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_gas(ExecutionContext* ctx) {
-    uint8_t* item = stack_alloc(ctx);
+    uint8_t* item = stack_alloc<Bounds>(ctx);
     if (!item) return {-1, 0};
 
-    u64_to_word(ctx->frame->gas_remaining, item);
-    return {1, 2};
+    // GAS reports the remaining gas after its own cost (checked before dispatch)
+    u64_to_word(ctx->frame->gas_remaining - BASE_GAS(GAS), item);
+    return {1, BASE_GAS(GAS)};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_jumpdest(ExecutionContext* ctx) {
-    return {1, 1};
+    return {1, BASE_GAS(JUMPDEST)};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_push0(ExecutionContext* ctx) {
-    uint8_t* item = stack_alloc(ctx);
+    uint8_t* item = stack_alloc<Bounds>(ctx);
     if (!item) return {-1, 0};
 
     memset(item, 0, WORD_SIZE);
-    return {1, 2};
+    return {1, BASE_GAS(PUSH0)};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_push_n(ExecutionContext* ctx, int n) {
-    uint8_t* item = stack_alloc(ctx);
+    uint8_t* item = stack_alloc<Bounds>(ctx);
     if (!item) return {-1, 0};
 
     // Zero entire word first
@@ -496,23 +706,25 @@ static OpResult op_push_n(ExecutionContext* ctx, int n) {
                bytes_to_copy);
     }
 
-    return {1 + n, 3};
+    return {1 + n, BASE_GAS(PUSH1)};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_dup_n(ExecutionContext* ctx, int n) {
-    uint8_t* source = stack_top(ctx, n - 1);
+    uint8_t* source = stack_top<Bounds>(ctx, n - 1);
     if (!source) return {-1, 0};
 
-    uint8_t* dest = stack_alloc(ctx);
+    uint8_t* dest = stack_alloc<Bounds>(ctx);
     if (!dest) return {-1, 0};
 
     memcpy(dest, source, WORD_SIZE);
-    return {1, 3};
+    return {1, BASE_GAS(DUP1)};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_swap_n(ExecutionContext* ctx, int n) {
-    uint8_t* top = stack_top(ctx, 0);
-    uint8_t* other = stack_top(ctx, n);
+    uint8_t* top = stack_top<Bounds>(ctx, 0);
+    uint8_t* other = stack_top<Bounds>(ctx, n);
     if (!top || !other) return {-1, 0};
 
     uint8_t temp[WORD_SIZE];
@@ -520,13 +732,15 @@ static OpResult op_swap_n(ExecutionContext* ctx, int n) {
     memcpy(top, other, WORD_SIZE);
     memcpy(other, temp, WORD_SIZE);
 
-    return {1, 3};
+    return {1, BASE_GAS(SWAP1)};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_stub(ExecutionContext* ctx) {
     return {1, 3};
 }
 
+template <typename Bounds, Revision R>
 static OpResult op_invalid(ExecutionContext* ctx) {
     ctx->frame->state = 4;
     ctx->frame->halt_reason = 2;
@@ -535,130 +749,544 @@ static OpResult op_invalid(ExecutionContext* ctx) {
 
 // ===== PUSH/DUP/SWAP WRAPPERS =====
 
-#define PUSH_HANDLER(n) static OpResult op_push##n(ExecutionContext* ctx) { return op_push_n(ctx, n); }
-PUSH_HANDLER(1)  PUSH_HANDLER(2)  PUSH_HANDLER(3)  PUSH_HANDLER(4)
-PUSH_HANDLER(5)  PUSH_HANDLER(6)  PUSH_HANDLER(7)  PUSH_HANDLER(8)
-PUSH_HANDLER(9)  PUSH_HANDLER(10) PUSH_HANDLER(11) PUSH_HANDLER(12)
-PUSH_HANDLER(13) PUSH_HANDLER(14) PUSH_HANDLER(15) PUSH_HANDLER(16)
-PUSH_HANDLER(17) PUSH_HANDLER(18) PUSH_HANDLER(19) PUSH_HANDLER(20)
-PUSH_HANDLER(21) PUSH_HANDLER(22) PUSH_HANDLER(23) PUSH_HANDLER(24)
-PUSH_HANDLER(25) PUSH_HANDLER(26) PUSH_HANDLER(27) PUSH_HANDLER(28)
-PUSH_HANDLER(29) PUSH_HANDLER(30) PUSH_HANDLER(31) PUSH_HANDLER(32)
-
-#define DUP_HANDLER(n) static OpResult op_dup##n(ExecutionContext* ctx) { return op_dup_n(ctx, n); }
-DUP_HANDLER(1)  DUP_HANDLER(2)  DUP_HANDLER(3)  DUP_HANDLER(4)
-DUP_HANDLER(5)  DUP_HANDLER(6)  DUP_HANDLER(7)  DUP_HANDLER(8)
-DUP_HANDLER(9)  DUP_HANDLER(10) DUP_HANDLER(11) DUP_HANDLER(12)
-DUP_HANDLER(13) DUP_HANDLER(14) DUP_HANDLER(15) DUP_HANDLER(16)
-
-#define SWAP_HANDLER(n) static OpResult op_swap##n(ExecutionContext* ctx) { return op_swap_n(ctx, n); }
-SWAP_HANDLER(1)  SWAP_HANDLER(2)  SWAP_HANDLER(3)  SWAP_HANDLER(4)
-SWAP_HANDLER(5)  SWAP_HANDLER(6)  SWAP_HANDLER(7)  SWAP_HANDLER(8)
-SWAP_HANDLER(9)  SWAP_HANDLER(10) SWAP_HANDLER(11) SWAP_HANDLER(12)
-SWAP_HANDLER(13) SWAP_HANDLER(14) SWAP_HANDLER(15) SWAP_HANDLER(16)
+template <typename Bounds, Revision R, int N> static OpResult op_push(ExecutionContext* ctx) { return op_push_n<Bounds, R>(ctx, N); }
+template <typename Bounds, Revision R, int N> static OpResult op_dup(ExecutionContext* ctx) { return op_dup_n<Bounds, R>(ctx, N); }
+template <typename Bounds, Revision R, int N> static OpResult op_swap(ExecutionContext* ctx) { return op_swap_n<Bounds, R>(ctx, N); }
 
 typedef OpResult (*OpHandler)(ExecutionContext*);
 
-static const OpHandler JUMP_TABLE[256] = {
-    op_stop,    op_add,     op_mul,     op_sub,     op_div,     op_stub,    op_mod,     op_stub,
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,
-    op_lt,      op_gt,      op_stub,    op_stub,    op_eq,      op_iszero,  op_and,     op_or,
-    op_xor,     op_not,     op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,
-    op_stub,    op_stub,    op_stub,    op_stub,    op_sload,   op_sstore,  op_stub,    op_stub,
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,
-    op_pop,     op_mload,   op_mstore,  op_mstore8, op_stub,    op_stub,    op_jump,    op_jumpi,
-    op_pc,      op_stub,    op_gas,     op_jumpdest,op_stub,    op_stub,    op_stub,    op_push0,
-    op_push1,   op_push2,   op_push3,   op_push4,   op_push5,   op_push6,   op_push7,   op_push8,
-    op_push9,   op_push10,  op_push11,  op_push12,  op_push13,  op_push14,  op_push15,  op_push16,
-    op_push17,  op_push18,  op_push19,  op_push20,  op_push21,  op_push22,  op_push23,  op_push24,
-    op_push25,  op_push26,  op_push27,  op_push28,  op_push29,  op_push30,  op_push31,  op_push32,
-    op_dup1,    op_dup2,    op_dup3,    op_dup4,    op_dup5,    op_dup6,    op_dup7,    op_dup8,
-    op_dup9,    op_dup10,   op_dup11,   op_dup12,   op_dup13,   op_dup14,   op_dup15,   op_dup16,
-    op_swap1,   op_swap2,   op_swap3,   op_swap4,   op_swap5,   op_swap6,   op_swap7,   op_swap8,
-    op_swap9,   op_swap10,  op_swap11,  op_swap12,  op_swap13,  op_swap14,  op_swap15,  op_swap16,
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,
-    op_stub,    op_stub,    op_stub,    op_stub,    op_stub,    op_invalid, op_invalid, op_invalid
-};
+// ===== DISPATCH TABLE =====
+
+template <typename Bounds, Revision R, size_t... I>
+static constexpr void set_push_handlers(std::array<OpHandler, 256>& table, std::index_sequence<I...>) {
+    ((table[opcodes::PUSH1 + I] = op_push<Bounds, R, I + 1>), ...);
+}
+
+template <typename Bounds, Revision R, size_t... I>
+static constexpr void set_dup_swap_handlers(std::array<OpHandler, 256>& table, std::index_sequence<I...>) {
+    ((table[opcodes::DUP1 + I] = op_dup<Bounds, R, I + 1>), ...);
+    ((table[opcodes::SWAP1 + I] = op_swap<Bounds, R, I + 1>), ...);
+}
+
+/**
+ * Dispatch table for revision R, generated from the opcode metadata
+ * (opcode_table.h). Opcodes undefined in R halt; defined ones without a native
+ * handler yet get op_stub. Fails to compile unless exactly the opcodes flagged
+ * NATIVE end up with a handler, so the flag tools read cannot drift.
+ */
+template <typename Bounds, Revision R>
+static constexpr std::array<OpHandler, 256> make_jump_table() {
+    std::array<OpHandler, 256> table{};
+    for (int op = 0; op < 256; op++) {
+        table[op] = opcodes::is_defined(R, static_cast<uint8_t>(op)) ? op_stub<Bounds, R> : op_invalid<Bounds, R>;
+    }
+    // Need the call/selfdestruct machinery on the Java side
+    table[opcodes::REVERT] = op_invalid<Bounds, R>;
+    table[opcodes::SELFDESTRUCT] = op_invalid<Bounds, R>;
+
+    table[opcodes::STOP] = op_stop<Bounds, R>;
+    table[opcodes::ADD] = op_add<Bounds, R>;
+    table[opcodes::MUL] = op_mul<Bounds, R>;
+    table[opcodes::SUB] = op_sub<Bounds, R>;
+    table[opcodes::DIV] = op_div<Bounds, R>;
+    table[opcodes::MOD] = op_mod<Bounds, R>;
+    table[opcodes::LT] = op_lt<Bounds, R>;
+    table[opcodes::GT] = op_gt<Bounds, R>;
+    table[opcodes::EQ] = op_eq<Bounds, R>;
+    table[opcodes::ISZERO] = op_iszero<Bounds, R>;
+    table[opcodes::AND] = op_and<Bounds, R>;
+    table[opcodes::OR] = op_or<Bounds, R>;
+    table[opcodes::XOR] = op_xor<Bounds, R>;
+    table[opcodes::NOT] = op_not<Bounds, R>;
+    table[opcodes::KECCAK256] = op_keccak256<Bounds, R>;
+    table[opcodes::POP] = op_pop<Bounds, R>;
+    table[opcodes::MLOAD] = op_mload<Bounds, R>;
+    table[opcodes::MSTORE] = op_mstore<Bounds, R>;
+    table[opcodes::MSTORE8] = op_mstore8<Bounds, R>;
+    table[opcodes::SLOAD] = op_sload<Bounds, R>;
+    table[opcodes::SSTORE] = op_sstore<Bounds, R>;
+    table[opcodes::JUMP] = op_jump<Bounds, R>;
+    table[opcodes::JUMPI] = op_jumpi<Bounds, R>;
+    table[opcodes::PC] = op_pc<Bounds, R>;
+    table[opcodes::MSIZE] = op_msize<Bounds, R>;
+    table[opcodes::GAS] = op_gas<Bounds, R>;
+    table[opcodes::JUMPDEST] = op_jumpdest<Bounds, R>;
+    if (opcodes::is_defined(R, opcodes::PUSH0)) {
+        table[opcodes::PUSH0] = op_push0<Bounds, R>;
+    }
+    set_push_handlers<Bounds, R>(table, std::make_index_sequence<32>{});
+    set_dup_swap_handlers<Bounds, R>(table, std::make_index_sequence<16>{});
+
+    for (int op = 0; op < 256; op++) {
+        const bool handled = table[op] != op_stub<Bounds, R> && table[op] != op_invalid<Bounds, R>;
+        if (handled != opcodes::is_native(R, static_cast<uint8_t>(op))) {
+            throw "NATIVE flag does not match the dispatch table";
+        }
+    }
+    return table;
+}
+
+template <typename Bounds, Revision R>
+static constexpr std::array<OpHandler, 256> JUMP_TABLE = make_jump_table<Bounds, R>();
+
+// ===== EXECUTION RESULT =====
+
+static void write_result(MessageFrameMemory* frame, int64_t initial_gas) {
+    ExecutionResult* result = frame_memory::getResult(frame);
+    if (!result) return;
+
+    const uint8_t* base = reinterpret_cast<const uint8_t*>(frame);
+    const StorageEntry* storage = reinterpret_cast<const StorageEntry*>(base + frame->storage_ptr);
+    uint32_t dirty = 0;
+    for (uint32_t i = 0; i < frame->storage_slot_count; i++) {
+        if (memcmp(storage[i].value, storage[i].original, WORD_SIZE) != 0) {
+            dirty++;
+        }
+    }
+
+    result->state = frame->state;
+    result->halt_reason = frame->halt_reason;
+    result->gas_used = initial_gas - frame->gas_remaining;
+    result->gas_remaining = frame->gas_remaining;
+    result->gas_refund = frame->gas_refund;
+    result->output_ptr = frame->output_ptr;
+    result->output_size = frame->output_size;
+    result->logs_count = frame->logs_count;
+    result->logs_ptr = frame->logs_ptr;
+    result->dirty_storage_count = dirty;
+    result->storage_slot_count = frame->storage_slot_count;
+}
 
 // ===== MAIN EXECUTION LOOP =====
 
-void execute_message(MessageFrameMemory* frame, TracerCallbacks* tracer) {
-    if (!frame) return;
+/**
+ * Dispatch policies. Each runs the same handlers from JUMP_TABLE<Bounds, R>:
+ *
+ * - TableDispatch: one indirect call through the table per instruction
+ * - SwitchDispatch: a 256-way switch with each handler inlined into its case
+ * - GotoDispatch: computed goto (GNU C), handlers inlined and the dispatch
+ *   jump replicated after each one; falls back to SwitchDispatch elsewhere
+ * - TailCallDispatch: handlers tail-call the next one ([[clang::musttail]]),
+ *   so there is no loop at all; falls back to TableDispatch where guaranteed
+ *   tail calls are not available
+ */
+struct TableDispatch { static constexpr const char* kName = "table"; };
+struct SwitchDispatch { static constexpr const char* kName = "switch"; };
+struct GotoDispatch { static constexpr const char* kName = "goto"; };
+
+#if defined(__has_cpp_attribute)
+#if __has_cpp_attribute(clang::musttail)
+#define BESU_MUSTTAIL [[clang::musttail]]
+#endif
+#endif
+
+// Keeps a run_loop out of run_blocks: inlined there, the verified and checked
+// loops of every revision share one function and lose their registers to it
+#if defined(__GNUC__)
+#define BESU_NOINLINE __attribute__((noinline))
+#else
+#define BESU_NOINLINE
+#endif
+
+#ifdef BESU_MUSTTAIL
+struct TailCallDispatch { static constexpr const char* kName = "tailcall"; };
+#else
+using TailCallDispatch = TableDispatch;
+#endif
+
+#if defined(BESU_DISPATCH_TABLE)
+using DefaultDispatch = TableDispatch;
+#elif defined(BESU_DISPATCH_SWITCH)
+using DefaultDispatch = SwitchDispatch;
+#elif defined(BESU_DISPATCH_GOTO)
+using DefaultDispatch = GotoDispatch;
+#elif defined(BESU_DISPATCH_TAILCALL)
+using DefaultDispatch = TailCallDispatch;
+#else
+// Fastest on x86-64 with GCC: inlining every handler into a switch or goto
+// body costs more in register pressure than the indirect call saves
+using DefaultDispatch = TableDispatch;
+#endif
+
+// Expands M(hi, lo) for every opcode 0x00..0xff, as two hex digits
+#define BESU_OPCODE_ROW(M, hi) \
+    M(hi, 0) M(hi, 1) M(hi, 2) M(hi, 3) M(hi, 4) M(hi, 5) M(hi, 6) M(hi, 7) \
+    M(hi, 8) M(hi, 9) M(hi, a) M(hi, b) M(hi, c) M(hi, d) M(hi, e) M(hi, f)
+#define BESU_FOR_EACH_OPCODE(M) \
+    BESU_OPCODE_ROW(M, 0) BESU_OPCODE_ROW(M, 1) BESU_OPCODE_ROW(M, 2) BESU_OPCODE_ROW(M, 3) \
+    BESU_OPCODE_ROW(M, 4) BESU_OPCODE_ROW(M, 5) BESU_OPCODE_ROW(M, 6) BESU_OPCODE_ROW(M, 7) \
+    BESU_OPCODE_ROW(M, 8) BESU_OPCODE_ROW(M, 9) BESU_OPCODE_ROW(M, a) BESU_OPCODE_ROW(M, b) \
+    BESU_OPCODE_ROW(M, c) BESU_OPCODE_ROW(M, d) BESU_OPCODE_ROW(M, e) BESU_OPCODE_ROW(M, f)
+
+/** Direct call of the handler for a constant opcode, so it can be inlined. */
+template <typename Bounds, Revision R, uint8_t OP>
+static inline OpResult call_handler(ExecutionContext* ctx) {
+    constexpr OpHandler handler = JUMP_TABLE<Bounds, R>[OP];
+    return handler(ctx);
+}
 
-    frame->state = 1; // CODE_EXECUTING
+static inline bool running(const MessageFrameMemory* frame) {
+    return frame->pc < static_cast<int32_t>(frame->code_size) && frame->state == 1;
+}
 
-    uint8_t* base = reinterpret_cast<uint8_t*>(frame);
-    ExecutionContext ctx = {
-        frame,
-        base + frame->stack_ptr,
-        base + frame->memory_ptr,
-        base + frame->code_ptr,
-        reinterpret_cast<StorageEntry*>(base + frame->storage_ptr)
-    };
+/**
+ * True while run_loop has instructions left; counts one down. Only the last
+ * instruction of a block stops the frame without halting (STOP), so the frame
+ * state needs no check before then.
+ */
+static inline bool in_block(uint32_t& steps) {
+    return --steps != 0;
+}
 
-    bool has_tracer = (tracer != nullptr && tracer->trace_pre_execution != nullptr);
+/** The block starting at pc, or nullptr if pc is inside one. */
+static inline const code_analysis::BlockInfo* block_at(const ExecutionContext* ctx) {
+    const uint32_t index = ctx->analysis->block_index[ctx->frame->pc];
+    return index == 0 ? nullptr : &ctx->analysis->blocks[index - 1];
+}
 
-    while (frame->pc < static_cast<int32_t>(frame->code_size) && frame->state == 1) {
-        if (frame->gas_remaining < 3) {
+/** True if the block's constant gas and stack bounds hold on entry. */
+static inline bool block_verified(const MessageFrameMemory* frame, const code_analysis::BlockInfo& block) {
+    return frame->gas_remaining >= block.base_gas && frame->stack_size >= block.stack_required &&
+           frame->stack_size + block.stack_max_growth <= code_analysis::STACK_LIMIT;
+}
+
+/**
+ * Once a verified block ran to its end: true if the next block verifies as well,
+ * with steps set to its length, so run_loop carries on without returning.
+ */
+template <typename Bounds>
+static inline bool next_block(const ExecutionContext* ctx, uint32_t& steps) {
+    if (!Bounds::kVerified || !running(ctx->frame)) return false;
+    const code_analysis::BlockInfo* block = block_at(ctx);
+    if (!block || !block_verified(ctx->frame, *block)) return false;
+    steps = block->length;
+    return true;
+}
+
+/**
+ * Constant gas check and pre-execution trace for the instruction at pc. A
+ * verified block had the gas of all its instructions checked on entry.
+ * @return false if the frame halted
+ */
+template <typename Bounds, Revision R>
+static inline bool pre_execute(ExecutionContext* ctx, TracerCallbacks* tracer, uint8_t opcode) {
+    MessageFrameMemory* frame = ctx->frame;
+    if (!Bounds::kVerified && frame->gas_remaining < opcodes::TABLE<R>[opcode].base_gas) {
+        frame->state = 4;
+        frame->halt_reason = 1;
+        return false;
+    }
+    if (tracer) {
+        tracer->trace_pre_execution(frame);
+    }
+    return true;
+}
+
+/**
+ * Charge gas and advance pc after a handler ran.
+ * @return false if the frame halted
+ */
+static inline bool post_execute(ExecutionContext* ctx, TracerCallbacks* tracer, OpResult result) {
+    MessageFrameMemory* frame = ctx->frame;
+    if (result.pc_increment < 0) {
+        if (frame->state == 1) {
             frame->state = 4;
-            frame->halt_reason = 1;
-            return;
+            frame->halt_reason = 4;
         }
+        return false;
+    }
 
-        uint8_t opcode = ctx.code[frame->pc];
+    if (frame->gas_remaining < result.gas_cost) {
+        frame->state = 4;
+        frame->halt_reason = 1;
+        return false;
+    }
 
-        if (has_tracer) {
-            tracer->trace_pre_execution(frame);
-        }
+    frame->gas_remaining -= result.gas_cost;
 
-        OpResult result = JUMP_TABLE[opcode](&ctx);
+    if (tracer) {
+        OperationResult op_result;
+        op_result.gas_cost = result.gas_cost;
+        op_result.halt_reason = 0;
+        op_result.pc_increment = result.pc_increment;
+        tracer->trace_post_execution(frame, &op_result);
+    }
 
-        if (result.pc_increment < 0) {
-            if (frame->state == 1) {
-                frame->state = 4;
-                frame->halt_reason = 4;
-            }
-            return;
+    if (result.pc_increment > 0) {
+        frame->pc += result.pc_increment;
+    }
+    return true;
+}
+
+/*
+ * Each run_loop starts with the instruction at pc, which the caller has checked
+ * is in the code, and stops after ctx->steps instructions, or at the end of the
+ * last of a run of verified blocks.
+ */
+template <typename Bounds, Revision R>
+BESU_NOINLINE static void run_loop(ExecutionContext* ctx, TracerCallbacks* tracer, TableDispatch) {
+    MessageFrameMemory* frame = ctx->frame;
+    uint32_t steps = ctx->steps;
+    do {
+        uint8_t opcode = ctx->code[frame->pc];
+        if (!pre_execute<Bounds, R>(ctx, tracer, opcode)) break;
+        if (!post_execute(ctx, tracer, JUMP_TABLE<Bounds, R>[opcode](ctx))) break;
+    } while (in_block(steps) || next_block<Bounds>(ctx, steps));
+}
+
+template <typename Bounds, Revision R>
+static void run_loop(ExecutionContext* ctx, TracerCallbacks* tracer, SwitchDispatch) {
+    MessageFrameMemory* frame = ctx->frame;
+    uint32_t steps = ctx->steps;
+    do {
+        uint8_t opcode = ctx->code[frame->pc];
+        if (!pre_execute<Bounds, R>(ctx, tracer, opcode)) break;
+
+        OpResult result;
+        switch (opcode) {
+#define BESU_SWITCH_CASE(hi, lo) \
+            case 0x##hi##lo: result = call_handler<Bounds, R, 0x##hi##lo>(ctx); break;
+            BESU_FOR_EACH_OPCODE(BESU_SWITCH_CASE)
+#undef BESU_SWITCH_CASE
         }
 
-        if (frame->gas_remaining < result.gas_cost) {
-            frame->state = 4;
-            frame->halt_reason = 1;
-            return;
+        if (!post_execute(ctx, tracer, result)) break;
+    } while (in_block(steps) || next_block<Bounds>(ctx, steps));
+}
+
+#if defined(__GNUC__)
+// Labels as values are a GNU extension
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+template <typename Bounds, Revision R>
+static void run_loop(ExecutionContext* ctx, TracerCallbacks* tracer, GotoDispatch) {
+#define BESU_GOTO_TARGET(hi, lo) &&op_##hi##lo,
+    static void* const targets[256] = { BESU_FOR_EACH_OPCODE(BESU_GOTO_TARGET) };
+#undef BESU_GOTO_TARGET
+
+    MessageFrameMemory* frame = ctx->frame;
+    uint32_t steps = ctx->steps;
+    uint8_t opcode;
+
+#define BESU_DISPATCH()                                             \
+    opcode = ctx->code[frame->pc];                                  \
+    if (!pre_execute<Bounds, R>(ctx, tracer, opcode)) return;       \
+    goto *targets[opcode]
+
+    BESU_DISPATCH();
+
+#define BESU_GOTO_HANDLER(hi, lo)                                                           \
+    op_##hi##lo:                                                                            \
+    if (!post_execute(ctx, tracer, call_handler<Bounds, R, 0x##hi##lo>(ctx))) return;       \
+    if (!in_block(steps) && !next_block<Bounds>(ctx, steps)) return;                        \
+    BESU_DISPATCH();
+    BESU_FOR_EACH_OPCODE(BESU_GOTO_HANDLER)
+#undef BESU_GOTO_HANDLER
+#undef BESU_DISPATCH
+}
+#pragma GCC diagnostic pop
+#else
+template <typename Bounds, Revision R>
+static void run_loop(ExecutionContext* ctx, TracerCallbacks* tracer, GotoDispatch) {
+    run_loop<Bounds, R>(ctx, tracer, SwitchDispatch{});
+}
+#endif
+
+#ifdef BESU_MUSTTAIL
+typedef void (*TailHandler)(ExecutionContext*, TracerCallbacks*);
+
+template <typename Bounds, Revision R, uint8_t OP>
+static void tail_handler(ExecutionContext* ctx, TracerCallbacks* tracer);
+
+template <typename Bounds, Revision R, size_t... I>
+static constexpr std::array<TailHandler, 256> make_tail_table(std::index_sequence<I...>) {
+    return {{ tail_handler<Bounds, R, static_cast<uint8_t>(I)>... }};
+}
+
+template <typename Bounds, Revision R>
+static constexpr std::array<TailHandler, 256> TAIL_TABLE =
+    make_tail_table<Bounds, R>(std::make_index_sequence<256>{});
+
+/** Run the handler for OP, then tail-call the handler of the next instruction. */
+template <typename Bounds, Revision R, uint8_t OP>
+static void tail_handler(ExecutionContext* ctx, TracerCallbacks* tracer) {
+    if (!post_execute(ctx, tracer, call_handler<Bounds, R, OP>(ctx))) return;
+    if (!in_block(ctx->steps) && !next_block<Bounds>(ctx, ctx->steps)) return;
+    uint8_t opcode = ctx->code[ctx->frame->pc];
+    if (!pre_execute<Bounds, R>(ctx, tracer, opcode)) return;
+    BESU_MUSTTAIL return TAIL_TABLE<Bounds, R>[opcode](ctx, tracer);
+}
+
+template <typename Bounds, Revision R>
+static void run_loop(ExecutionContext* ctx, TracerCallbacks* tracer, TailCallDispatch) {
+    uint8_t opcode = ctx->code[ctx->frame->pc];
+    if (!pre_execute<Bounds, R>(ctx, tracer, opcode)) return;
+    TAIL_TABLE<Bounds, R>[opcode](ctx, tracer);
+}
+#endif
+
+// ===== CODE ANALYSIS =====
+
+/**
+ * Analysis of code, from a small per-thread cache: transactions in a block call
+ * the same few contracts, so most frames only compare their code with a copy.
+ * Entries are shared so a frame keeps its analysis if a nested run evicts it.
+ */
+static std::shared_ptr<const CodeAnalysis> analyze_code(const uint8_t* code, uint32_t size, Revision revision) {
+    static constexpr size_t CACHE_ENTRIES = 8;
+    thread_local std::array<std::shared_ptr<const CodeAnalysis>, CACHE_ENTRIES> cache;
+    thread_local size_t next = 0;
+
+    for (const auto& entry : cache) {
+        if (entry && entry->revision == revision && entry->code.size() == size &&
+            (size == 0 || memcmp(entry->code.data(), code, size) == 0)) {
+            return entry;
         }
+    }
 
-        frame->gas_remaining -= result.gas_cost;
+    auto analysis = std::make_shared<CodeAnalysis>();
+    analysis->code.assign(code, code + size);
+    analysis->revision = revision;
+    analysis->jumpdests.resize(code_analysis::jumpdest_bitmap_size(size));
+    code_analysis::analyze_jumpdests(code, size, analysis->jumpdests.data());
+    code_analysis::analyze_blocks(code, size, revision, analysis->blocks);
+    analysis->block_index.assign(size, 0);
+    for (size_t i = 0; i < analysis->blocks.size(); i++) {
+        analysis->block_index[analysis->blocks[i].start] = static_cast<uint32_t>(i + 1);
+    }
+    cache[next] = analysis;
+    next = (next + 1) % CACHE_ENTRIES;
+    return analysis;
+}
 
-        if (has_tracer) {
-            OperationResult op_result;
-            op_result.gas_cost = result.gas_cost;
-            op_result.halt_reason = 0;
-            op_result.pc_increment = result.pc_increment;
-            tracer->trace_post_execution(frame, &op_result);
+/**
+ * Run the frame block by block. A block whose constant gas and stack bounds hold
+ * on entry runs as VerifiedBlock<Bounds>, without per-instruction gas and stack
+ * checks. A block that fails them halts somewhere inside, so it runs checked and
+ * halts at the same instruction, for the same reason, as before. Traced runs are
+ * checked throughout, so tracers see every step from an identical state.
+ */
+template <typename Bounds, Revision R, typename Dispatch>
+static void run_blocks(ExecutionContext* ctx, TracerCallbacks* tracer, Dispatch dispatch) {
+    MessageFrameMemory* frame = ctx->frame;
+    while (running(frame)) {
+        // Traced, or started inside a block (a frame resumed at pc): checked, one instruction
+        const code_analysis::BlockInfo* block = tracer ? nullptr : block_at(ctx);
+        ctx->steps = block ? block->length : 1;
+        if (block && block_verified(frame, *block)) {
+            run_loop<VerifiedBlock<Bounds>, R>(ctx, nullptr, dispatch);
+        } else {
+            run_loop<Bounds, R>(ctx, tracer, dispatch);
         }
+    }
+}
+
+/**
+ * Run the interpreter instantiation for the frame's revision. The switch runs
+ * once per frame; everything inside run_loop is specialized for the revision.
+ */
+template <typename Bounds>
+static void run_revision(ExecutionContext* ctx, TracerCallbacks* tracer) {
+    // Trace only when a pre-execution hook is installed
+    if (tracer != nullptr && tracer->trace_pre_execution == nullptr) tracer = nullptr;
+
+    constexpr DefaultDispatch dispatch{};
+    switch (static_cast<Revision>(ctx->frame->revision)) {
+        case Revision::ISTANBUL: run_blocks<Bounds, Revision::ISTANBUL>(ctx, tracer, dispatch); break;
+        case Revision::BERLIN:   run_blocks<Bounds, Revision::BERLIN>(ctx, tracer, dispatch); break;
+        case Revision::LONDON:   run_blocks<Bounds, Revision::LONDON>(ctx, tracer, dispatch); break;
+        case Revision::SHANGHAI: run_blocks<Bounds, Revision::SHANGHAI>(ctx, tracer, dispatch); break;
+        case Revision::CANCUN:   run_blocks<Bounds, Revision::CANCUN>(ctx, tracer, dispatch); break;
+        case Revision::PRAGUE:   run_blocks<Bounds, Revision::PRAGUE>(ctx, tracer, dispatch); break;
+    }
+}
 
-        if (result.pc_increment > 0) {
-            frame->pc += result.pc_increment;
+#ifdef BESU_HAS_GUARDED_FRAMES
+/**
+ * Run a guarded frame. A stack or memory guard hit longjmps back here with the
+ * halt reason; the frame state is then rewritten as an exceptional halt.
+ */
+static void run_guarded(ExecutionContext* ctx, TracerCallbacks* tracer,
+                        const GuardedFrameControl* control) {
+    GuardTrap trap;
+    trap.control = control;
+    trap.previous = guard::active();
+    guard::active() = &trap;
+
+    int halt_reason = sigsetjmp(trap.env, 0);
+    if (halt_reason == 0) {
+        run_revision<GuardedBounds>(ctx, tracer);
+    } else {
+        MessageFrameMemory* frame = ctx->frame;
+        frame->state = 4;
+        frame->halt_reason = halt_reason;
+        // The faulting op may have bumped the sizes past the usable ranges
+        frame->stack_size = std::min(std::max(frame->stack_size, 0), 1024);
+        if (static_cast<uint32_t>(frame->memory_size) > control->memory_capacity) {
+            frame->memory_size = static_cast<int32_t>(control->memory_capacity);
         }
     }
 
+    guard::active() = trap.previous;
+}
+#endif
+
+extern "C" {
+
+void execute_message(MessageFrameMemory* frame, TracerCallbacks* tracer) {
+    if (!frame) return;
+    if (recorder::active()) recorder::record(frame, tracer != nullptr);
+
+    frame->state = 1; // CODE_EXECUTING
+    const int64_t initial_gas = frame->gas_remaining;
+
+    if (frame->revision >= REVISION_COUNT) {
+        frame->state = 4;
+        frame->halt_reason = 2;  // INVALID_OPERATION: no instruction set for it
+        write_result(frame, initial_gas);
+        return;
+    }
+
+    uint8_t* base = reinterpret_cast<uint8_t*>(frame);
+    ExecutionContext ctx = {
+        frame,
+        base + frame->stack_ptr,
+        base + frame->memory_ptr,
+        base + frame->code_ptr,
+        reinterpret_cast<StorageEntry*>(base + frame->storage_ptr),
+        MAX_MEMORY_SIZE,
+        nullptr,
+        0
+    };
+    const std::shared_ptr<const CodeAnalysis> analysis =
+        analyze_code(ctx.code, frame->code_size, static_cast<Revision>(frame->revision));
+    ctx.analysis = analysis.get();
+
+#ifdef BESU_HAS_GUARDED_FRAMES
+    if (const GuardedFrameControl* control = guard::control(frame)) {
+        ctx.memory_limit = std::min(ctx.memory_limit, control->memory_capacity);
+        run_guarded(&ctx, tracer, control);
+    } else {
+        run_revision<CheckedBounds>(&ctx, tracer);
+    }
+#else
+    run_revision<CheckedBounds>(&ctx, tracer);
+#endif
+
     if (frame->state == 1) {
         frame->state = 7;
     }
+
+    write_result(frame, initial_gas);
+}
+
+const char* besu_dispatch_policy(void) {
+    return DefaultDispatch::kName;
+}
+
+const OpcodeInfo* besu_opcode_info(uint8_t revision, uint8_t opcode) {
+    if (revision >= REVISION_COUNT) return nullptr;
+    return &opcodes::info(static_cast<Revision>(revision), opcode);
 }
 
 } // extern "C"
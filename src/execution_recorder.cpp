@@ -0,0 +1,130 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Execution recorder. See include/execution_recorder.h for the file layout.
+ */
+
+#include "../include/execution_recorder.h"
+#include "../include/guarded_frame.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace besu {
+namespace evm {
+
+std::atomic<bool> recorder::g_recording{false};
+
+static std::mutex g_mutex;
+static FILE* g_file = nullptr;
+static uint64_t g_sequence = 0;
+
+// Records are assembled per thread and written under the lock in one piece
+static thread_local std::vector<uint8_t> t_record;
+
+static inline uint64_t align8(uint64_t n) {
+    return (n + 7) & ~uint64_t(7);
+}
+
+static void append(std::vector<uint8_t>& out, const void* data, uint64_t size) {
+    const size_t at = out.size();
+    out.resize(at + align8(size), 0);
+    if (size) std::memcpy(out.data() + at, data, size);
+}
+
+void recorder::record(const MessageFrameMemory* frame, bool traced) {
+    const uint8_t* base = reinterpret_cast<const uint8_t*>(frame);
+    const uint8_t* sections[RECORD_SECTION_COUNT] = {};
+    RecordedFrame header = {};
+    header.magic = RECORDED_FRAME_MAGIC;
+    header.flags = (traced ? RECORD_FLAG_TRACED : 0) | (frame->flags & FRAME_FLAG_GUARDED ? RECORD_FLAG_GUARDED : 0);
+
+    const uint32_t stack_size = frame->stack_size > 0 ? static_cast<uint32_t>(frame->stack_size) : 0;
+    sections[RECORD_STACK] = base + frame->stack_ptr;
+    header.section_size[RECORD_STACK] = uint64_t(stack_size < MAX_STACK_SIZE ? stack_size : MAX_STACK_SIZE) * STACK_ITEM_SIZE;
+    sections[RECORD_MEMORY] = base + frame->memory_ptr;
+    header.section_size[RECORD_MEMORY] = frame->memory_size > 0 ? static_cast<uint32_t>(frame->memory_size) : 0;
+    sections[RECORD_CODE] = base + frame->code_ptr;
+    header.section_size[RECORD_CODE] = frame->code_size;
+    sections[RECORD_INPUT] = base + frame->input_ptr;
+    header.section_size[RECORD_INPUT] = frame->input_size;
+    if (frame->storage_ptr) {
+        sections[RECORD_STORAGE] = base + frame->storage_ptr;
+        header.section_size[RECORD_STORAGE] = uint64_t(frame->storage_slot_count) * sizeof(StorageEntry);
+    }
+    if (frame->witness_ptr) {
+        sections[RECORD_WITNESS] = base + frame->witness_ptr;
+        header.section_size[RECORD_WITNESS] = witness_extent(sections[RECORD_WITNESS]);
+    }
+
+    std::vector<uint8_t>& out = t_record;
+    out.clear();
+    append(out, &header, sizeof(header));
+    append(out, frame, sizeof(MessageFrameMemory));
+    for (uint32_t s = 0; s < RECORD_SECTION_COUNT; s++) append(out, sections[s], header.section_size[s]);
+    RecordedFrame* written = reinterpret_cast<RecordedFrame*>(out.data());
+    written->size = out.size();
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (!g_file) return;  // Stopped since the check in execute_message
+    written->sequence = g_sequence;
+    if (std::fwrite(out.data(), 1, out.size(), g_file) != out.size()) {
+        // Disk full or similar: keep what was written and stop recording
+        g_recording.store(false, std::memory_order_relaxed);
+        std::fclose(g_file);
+        g_file = nullptr;
+        return;
+    }
+    g_sequence++;
+}
+
+// Start from the environment when the library loads
+static const bool g_started_from_env = [] {
+    const char* path = std::getenv("BESU_EVM_RECORD");
+    return path && *path && besu_recorder_start(path);
+}();
+
+extern "C" {
+
+bool besu_recorder_start(const char* path) {
+    besu_recorder_stop();
+    FILE* file = std::fopen(path, "wb");
+    if (!file) return false;
+
+    RecordingHeader header = {};
+    header.magic = RECORDING_MAGIC;
+    header.version = RECORDING_VERSION;
+    header.frame_header_size = sizeof(MessageFrameMemory);
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1) {
+        std::fclose(file);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_file = file;
+    g_sequence = 0;
+    recorder::g_recording.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void besu_recorder_stop(void) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    recorder::g_recording.store(false, std::memory_order_relaxed);
+    if (g_file) {
+        std::fclose(g_file);
+        g_file = nullptr;
+    }
+}
+
+uint64_t besu_recorder_count(void) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    return g_sequence;
+}
+
+} // extern "C"
+
+} // namespace evm
+} // namespace besu
@@ -0,0 +1,196 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Guard-page protected frames and the fault handler that turns guard hits
+ * into exceptional halts. See include/guarded_frame.h for the layout.
+ */
+
+#include "../include/guarded_frame.h"
+#include "../include/opcode_table.h"
+#include <cstring>
+
+#ifdef BESU_HAS_GUARDED_FRAMES
+#include <csignal>
+#include <mutex>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace besu {
+namespace evm {
+
+#ifdef BESU_HAS_GUARDED_FRAMES
+
+static thread_local GuardTrap* t_active_trap = nullptr;
+
+GuardTrap*& guard::active() {
+    return t_active_trap;
+}
+
+static struct sigaction g_previous_segv;
+static struct sigaction g_previous_bus;
+
+static void chain_to_previous(int sig, siginfo_t* info, void* context) {
+    const struct sigaction* previous = (sig == SIGBUS) ? &g_previous_bus : &g_previous_segv;
+
+    if (previous->sa_flags & SA_SIGINFO) {
+        previous->sa_sigaction(sig, info, context);
+        return;
+    }
+    if (previous->sa_handler == SIG_IGN) {
+        return;
+    }
+    if (previous->sa_handler == SIG_DFL) {
+        // Restore default disposition; returning re-executes the faulting access
+        signal(sig, SIG_DFL);
+        return;
+    }
+    previous->sa_handler(sig);
+}
+
+static void guard_fault_handler(int sig, siginfo_t* info, void* context) {
+    GuardTrap* trap = t_active_trap;
+    if (trap) {
+        uintptr_t addr = reinterpret_cast<uintptr_t>(info->si_addr);
+        const GuardedFrameControl* control = trap->control;
+
+        int halt_reason = 0;
+        if (addr >= control->underflow_lo && addr < control->underflow_hi) {
+            halt_reason = 5;  // STACK_UNDERFLOW
+        } else if (addr >= control->overflow_lo && addr < control->overflow_hi) {
+            halt_reason = 4;  // STACK_OVERFLOW
+        } else if (addr >= control->memory_guard_lo && addr < control->memory_guard_hi) {
+            halt_reason = 1;  // INSUFFICIENT_GAS, as for memory past the limit on the checked path
+        }
+
+        if (halt_reason != 0) {
+            // SA_NODEFER keeps the signal unblocked, so no mask restore is needed
+            siglongjmp(trap->env, halt_reason);
+        }
+    }
+    chain_to_previous(sig, info, context);
+}
+
+static void install_fault_handler() {
+    static std::once_flag installed;
+    std::call_once(installed, [] {
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_sigaction = guard_fault_handler;
+        action.sa_flags = SA_SIGINFO | SA_NODEFER | SA_ONSTACK;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGSEGV, &action, &g_previous_segv);
+        sigaction(SIGBUS, &action, &g_previous_bus);
+    });
+}
+
+static inline uint64_t page_align(uint64_t value, uint64_t page) {
+    return (value + page - 1) & ~(page - 1);
+}
+
+static GuardedFrameControl* mutable_control(MessageFrameMemory* frame) {
+    return reinterpret_cast<GuardedFrameControl*>(
+        reinterpret_cast<uint8_t*>(frame) + sizeof(MessageFrameMemory));
+}
+
+#endif // BESU_HAS_GUARDED_FRAMES
+
+extern "C" {
+
+MessageFrameMemory* besu_guarded_frame_create(uint64_t memory_capacity, uint64_t tail_size) {
+#ifdef BESU_HAS_GUARDED_FRAMES
+    const uint64_t page = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    const uint64_t stack_bytes = page_align(MAX_STACK_SIZE * STACK_ITEM_SIZE, page);
+    memory_capacity = page_align(memory_capacity, page);
+    tail_size = page_align(tail_size, page);
+    // ensure_memory keeps accesses within memory_capacity; the page only catches overruns
+    const uint64_t memory_guard = page;
+
+    const uint64_t stack_off = 2 * page;                    // header page + underflow guard
+    const uint64_t overflow_off = stack_off + stack_bytes;
+    const uint64_t memory_off = overflow_off + page;
+    const uint64_t memory_guard_off = memory_off + memory_capacity;
+    const uint64_t tail_off = memory_guard_off + memory_guard;
+    const uint64_t total = tail_off + tail_size;
+
+    // Reserve everything as PROT_NONE (address space only), then open the usable ranges
+    void* mapping = mmap(nullptr, total, PROT_NONE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (mapping == MAP_FAILED) return nullptr;
+
+    uint8_t* base = static_cast<uint8_t*>(mapping);
+    if (mprotect(base, page, PROT_READ | PROT_WRITE) != 0 ||
+        mprotect(base + stack_off, stack_bytes, PROT_READ | PROT_WRITE) != 0 ||
+        (memory_capacity > 0 &&
+         mprotect(base + memory_off, memory_capacity, PROT_READ | PROT_WRITE) != 0) ||
+        (tail_size > 0 &&
+         mprotect(base + tail_off, tail_size, PROT_READ | PROT_WRITE) != 0)) {
+        munmap(mapping, total);
+        return nullptr;
+    }
+
+    install_fault_handler();
+
+    MessageFrameMemory* frame = reinterpret_cast<MessageFrameMemory*>(base);
+    frame->stack_ptr = stack_off;
+    frame->memory_ptr = memory_off;
+    frame->code_ptr = tail_off;
+    frame->flags = FRAME_FLAG_GUARDED;
+    frame->revision = static_cast<uint8_t>(LATEST_REVISION);
+
+    GuardedFrameControl* control = mutable_control(frame);
+    control->magic = GUARDED_FRAME_MAGIC;
+    control->mapping_size = total;
+    control->memory_capacity = memory_capacity;
+    control->tail_size = tail_size;
+    control->underflow_lo = reinterpret_cast<uintptr_t>(base + page);
+    control->underflow_hi = reinterpret_cast<uintptr_t>(base + stack_off);
+    control->overflow_lo = reinterpret_cast<uintptr_t>(base + overflow_off);
+    control->overflow_hi = reinterpret_cast<uintptr_t>(base + memory_off);
+    control->memory_guard_lo = reinterpret_cast<uintptr_t>(base + memory_guard_off);
+    control->memory_guard_hi = reinterpret_cast<uintptr_t>(base + tail_off);
+    return frame;
+#else
+    (void)memory_capacity;
+    (void)tail_size;
+    return nullptr;
+#endif
+}
+
+void besu_guarded_frame_reset(MessageFrameMemory* frame) {
+#ifdef BESU_HAS_GUARDED_FRAMES
+    if (!frame || !guard::control(frame)) return;
+
+    // The guarded interpreter relies on memory past memory_size being zero
+    uint8_t* memory = reinterpret_cast<uint8_t*>(frame) + frame->memory_ptr;
+    uint64_t touched = static_cast<uint32_t>(frame->memory_size);
+    uint64_t capacity = guard::control(frame)->memory_capacity;
+    memset(memory, 0, touched < capacity ? touched : capacity);
+
+    frame->pc = 0;
+    frame->gas_refund = 0;
+    frame->stack_size = 0;
+    frame->memory_size = 0;
+    frame->state = 0;
+    frame->halt_reason = 0;
+#else
+    (void)frame;
+#endif
+}
+
+void besu_guarded_frame_destroy(MessageFrameMemory* frame) {
+#ifdef BESU_HAS_GUARDED_FRAMES
+    if (!frame) return;
+    const GuardedFrameControl* control = guard::control(frame);
+    if (!control) return;
+    munmap(frame, control->mapping_size);
+#else
+    (void)frame;
+#endif
+}
+
+} // extern "C"
+
+} // namespace evm
+} // namespace besu
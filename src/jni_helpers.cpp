@@ -0,0 +1,272 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "jni_helpers.h"
+
+#include <stdexcept>
+#include <string>
+
+namespace besu {
+namespace evm {
+namespace jni {
+
+// ============================================================================
+// LocalFrame
+// ============================================================================
+
+LocalFrame::LocalFrame(JNIEnv* env, jint capacity) : env_(env) {
+    if (env_->PushLocalFrame(capacity) != JNI_OK) {
+        env_ = nullptr;
+    }
+}
+
+LocalFrame::~LocalFrame() {
+    if (env_ != nullptr) {
+        env_->PopLocalFrame(nullptr);
+    }
+}
+
+// ============================================================================
+// Exceptions
+// ============================================================================
+
+namespace exception {
+
+bool checkAndClear(JNIEnv* env) {
+    if (!env->ExceptionCheck()) return false;
+    env->ExceptionClear();
+    return true;
+}
+
+void checkAndThrow(JNIEnv* env, const char* context) {
+    if (!env->ExceptionCheck()) return;
+    env->ExceptionClear();
+    std::string message = "Java exception pending";
+    if (context != nullptr) {
+        message += ": ";
+        message += context;
+    }
+    throw std::runtime_error(message);
+}
+
+void throwJava(JNIEnv* env, const char* className, const char* message) {
+    jclass clazz = env->FindClass(className);
+    if (clazz == nullptr) return;  // NoClassDefFoundError is already pending
+    env->ThrowNew(clazz, message);
+    env->DeleteLocalRef(clazz);
+}
+
+void throwRuntimeException(JNIEnv* env, const char* message) {
+    throwJava(env, "java/lang/RuntimeException", message);
+}
+
+void throwIllegalArgumentException(JNIEnv* env, const char* message) {
+    throwJava(env, "java/lang/IllegalArgumentException", message);
+}
+
+void throwIllegalStateException(JNIEnv* env, const char* message) {
+    throwJava(env, "java/lang/IllegalStateException", message);
+}
+
+}  // namespace exception
+
+// ============================================================================
+// JniCache
+// ============================================================================
+
+std::unique_ptr<JniCache> JniCache::instance_;
+
+namespace {
+
+#define BESU_BYTES "Lorg/apache/tuweni/bytes/Bytes;"
+#define BESU_BYTES32 "Lorg/apache/tuweni/bytes/Bytes32;"
+#define BESU_UINT256 "Lorg/apache/tuweni/units/bigints/UInt256;"
+#define BESU_ADDRESS "Lorg/hyperledger/besu/datatypes/Address;"
+#define BESU_WEI "Lorg/hyperledger/besu/datatypes/Wei;"
+#define BESU_OPTIONAL "Ljava/util/Optional;"
+#define BESU_FRAME "Lorg/hyperledger/besu/evm/frame/MessageFrame;"
+#define BESU_FRAME_STATE "Lorg/hyperledger/besu/evm/frame/MessageFrame$State;"
+#define BESU_HALT_REASON "Lorg/hyperledger/besu/evm/frame/ExceptionalHaltReason;"
+#define BESU_OPERATION_RESULT "Lorg/hyperledger/besu/evm/operation/Operation$OperationResult;"
+
+/** Global ref to the class, or nullptr (with the exception cleared) if not found. */
+jclass findClass(JNIEnv* env, const char* name) {
+    jclass local = env->FindClass(name);
+    if (local == nullptr) {
+        exception::checkAndClear(env);
+        return nullptr;
+    }
+    jclass global = static_cast<jclass>(env->NewGlobalRef(local));
+    env->DeleteLocalRef(local);
+    return global;
+}
+
+jmethodID method(JNIEnv* env, jclass clazz, const char* name, const char* signature) {
+    if (clazz == nullptr) return nullptr;
+    jmethodID id = env->GetMethodID(clazz, name, signature);
+    if (id == nullptr) exception::checkAndClear(env);
+    return id;
+}
+
+jmethodID staticMethod(JNIEnv* env, jclass clazz, const char* name, const char* signature) {
+    if (clazz == nullptr) return nullptr;
+    jmethodID id = env->GetStaticMethodID(clazz, name, signature);
+    if (id == nullptr) exception::checkAndClear(env);
+    return id;
+}
+
+}  // namespace
+
+JniCache::JniCache(JNIEnv* env) {
+    initialize(env);
+}
+
+void JniCache::initialize(JNIEnv* env) {
+    bytesClass = findClass(env, "org/apache/tuweni/bytes/Bytes");
+    addressClass = findClass(env, "org/hyperledger/besu/datatypes/Address");
+    weiClass = findClass(env, "org/hyperledger/besu/datatypes/Wei");
+    uint256Class = findClass(env, "org/apache/tuweni/units/bigints/UInt256");
+    optionalClass = findClass(env, "java/util/Optional");
+    messageFrameClass = findClass(env, "org/hyperledger/besu/evm/frame/MessageFrame");
+    operationTracerClass = findClass(env, "org/hyperledger/besu/evm/tracing/OperationTracer");
+    operationClass = findClass(env, "org/hyperledger/besu/evm/operation/Operation");
+    operationResultClass = findClass(env, "org/hyperledger/besu/evm/operation/Operation$OperationResult");
+    exceptionalHaltReasonClass = findClass(env, "org/hyperledger/besu/evm/frame/ExceptionalHaltReason");
+    codeClass = findClass(env, "org/hyperledger/besu/evm/Code");
+    worldUpdaterClass = findClass(env, "org/hyperledger/besu/evm/worldstate/WorldUpdater");
+    blockValuesClass = findClass(env, "org/hyperledger/besu/evm/frame/BlockValues");
+    nativeFrameBridgeClass = findClass(env, "org/hyperledger/besu/evm/frame/NativeFrameBridge");
+
+    bytesWrap = staticMethod(env, bytesClass, "wrap", "([B)" BESU_BYTES);
+    bytesToArray = method(env, bytesClass, "toArrayUnsafe", "()[B");
+    bytesSize = method(env, bytesClass, "size", "()I");
+
+    addressWrap = staticMethod(env, addressClass, "wrap", "(" BESU_BYTES ")" BESU_ADDRESS);
+    addressToBytes = method(env, addressClass, "toArrayUnsafe", "()[B");
+
+    weiOf = staticMethod(env, weiClass, "of", "(" BESU_UINT256 ")" BESU_WEI);
+    weiGetValue = method(env, weiClass, "toBytes", "()" BESU_BYTES32);
+
+    uint256Of = staticMethod(env, uint256Class, "fromBytes", "(" BESU_BYTES ")" BESU_UINT256);
+    uint256ToBytes = method(env, uint256Class, "toBytes", "()" BESU_BYTES32);
+
+    optionalOf = staticMethod(env, optionalClass, "of", "(Ljava/lang/Object;)" BESU_OPTIONAL);
+    optionalEmpty = staticMethod(env, optionalClass, "empty", "()" BESU_OPTIONAL);
+    optionalIsPresent = method(env, optionalClass, "isPresent", "()Z");
+    optionalGet = method(env, optionalClass, "get", "()Ljava/lang/Object;");
+
+    jclass mf = messageFrameClass;
+    mfGetPC = method(env, mf, "getPC", "()I");
+    mfSetPC = method(env, mf, "setPC", "(I)V");
+    mfGetRemainingGas = method(env, mf, "getRemainingGas", "()J");
+    mfSetGasRemaining = method(env, mf, "setGasRemaining", "(J)V");
+    mfDecrementRemainingGas = method(env, mf, "decrementRemainingGas", "(J)J");
+    mfGetStackItem = method(env, mf, "getStackItem", "(I)" BESU_BYTES);
+    mfPopStackItem = method(env, mf, "popStackItem", "()" BESU_BYTES);
+    mfPushStackItem = method(env, mf, "pushStackItem", "(" BESU_BYTES ")V");
+    mfStackSize = method(env, mf, "stackSize", "()I");
+    mfReadMemory = method(env, mf, "readMemory", "(JJ)" BESU_BYTES);
+    mfWriteMemory = method(env, mf, "writeMemory", "(JJ" BESU_BYTES ")V");
+    mfExpandMemory = method(env, mf, "expandMemory", "(JJ)V");
+    mfGetState = method(env, mf, "getState", "()" BESU_FRAME_STATE);
+    mfSetState = method(env, mf, "setState", "(" BESU_FRAME_STATE ")V");
+    mfGetCode = method(env, mf, "getCode", "()Lorg/hyperledger/besu/evm/Code;");
+    mfGetWorldUpdater = method(env, mf, "getWorldUpdater",
+                               "()Lorg/hyperledger/besu/evm/worldstate/WorldUpdater;");
+    mfSetExceptionalHaltReason = method(env, mf, "setExceptionalHaltReason", "(" BESU_OPTIONAL ")V");
+    mfGetExceptionalHaltReason = method(env, mf, "getExceptionalHaltReason", "()" BESU_OPTIONAL);
+    mfGetRecipientAddress = method(env, mf, "getRecipientAddress", "()" BESU_ADDRESS);
+    mfGetSenderAddress = method(env, mf, "getSenderAddress", "()" BESU_ADDRESS);
+    mfGetContractAddress = method(env, mf, "getContractAddress", "()" BESU_ADDRESS);
+    mfGetBlockValues = method(env, mf, "getBlockValues", "()Lorg/hyperledger/besu/evm/frame/BlockValues;");
+
+    bridgeExportFrame = staticMethod(env, nativeFrameBridgeClass, "exportFrame", "(" BESU_FRAME ")[B");
+    bridgeImportFrame = staticMethod(env, nativeFrameBridgeClass, "importFrame", "(" BESU_FRAME "[B)V");
+    bridgeLoadStorage = staticMethod(env, nativeFrameBridgeClass, "loadStorage",
+                                     "(Lorg/hyperledger/besu/evm/worldstate/WorldUpdater;[B)[B");
+
+    jclass ot = operationTracerClass;
+    otTracePreExecution = method(env, ot, "tracePreExecution", "(" BESU_FRAME ")V");
+    otTracePostExecution = method(env, ot, "tracePostExecution",
+                                  "(" BESU_FRAME BESU_OPERATION_RESULT ")V");
+    otTraceContextEnter = method(env, ot, "traceContextEnter", "(" BESU_FRAME ")V");
+    otTraceContextReEnter = method(env, ot, "traceContextReEnter", "(" BESU_FRAME ")V");
+    otTraceContextExit = method(env, ot, "traceContextExit", "(" BESU_FRAME ")V");
+
+    operationResultInit = method(env, operationResultClass, "<init>", "(J" BESU_HALT_REASON ")V");
+
+    codeGetSize = method(env, codeClass, "getSize", "()I");
+    codeGetBytes = method(env, codeClass, "getBytes", "()" BESU_BYTES);
+}
+
+#undef BESU_BYTES
+#undef BESU_BYTES32
+#undef BESU_UINT256
+#undef BESU_ADDRESS
+#undef BESU_WEI
+#undef BESU_OPTIONAL
+#undef BESU_FRAME
+#undef BESU_FRAME_STATE
+#undef BESU_HALT_REASON
+#undef BESU_OPERATION_RESULT
+
+JniCache& JniCache::getInstance(JNIEnv* env) {
+    // Normally built by JNI_OnLoad; fall back to a lazy build for embedders
+    // that load the library without it
+    if (!instance_) {
+        load(env);
+    }
+    return *instance_;
+}
+
+void JniCache::load(JNIEnv* env) {
+    instance_.reset(new JniCache(env));
+}
+
+void JniCache::unload(JNIEnv* env) {
+    if (!instance_) return;
+    jclass* classes[] = {
+        &instance_->bytesClass, &instance_->addressClass, &instance_->weiClass,
+        &instance_->uint256Class, &instance_->optionalClass, &instance_->messageFrameClass,
+        &instance_->operationTracerClass, &instance_->operationClass,
+        &instance_->operationResultClass, &instance_->exceptionalHaltReasonClass,
+        &instance_->codeClass, &instance_->worldUpdaterClass, &instance_->blockValuesClass,
+        &instance_->nativeFrameBridgeClass,
+    };
+    for (jclass* clazz : classes) {
+        if (*clazz != nullptr) {
+            env->DeleteGlobalRef(*clazz);
+            *clazz = nullptr;
+        }
+    }
+    instance_.reset();
+}
+
+}  // namespace jni
+}  // namespace evm
+}  // namespace besu
+
+// ============================================================================
+// Library lifecycle
+// ============================================================================
+
+extern "C" {
+
+JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void* /*reserved*/) {
+    JNIEnv* env = nullptr;
+    if (vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_8) != JNI_OK) {
+        return JNI_ERR;
+    }
+    besu::evm::jni::JniCache::load(env);
+    return JNI_VERSION_1_8;
+}
+
+JNIEXPORT void JNICALL JNI_OnUnload(JavaVM* vm, void* /*reserved*/) {
+    JNIEnv* env = nullptr;
+    if (vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_8) != JNI_OK) {
+        return;
+    }
+    besu::evm::jni::JniCache::unload(env);
+}
+
+}  // extern "C"
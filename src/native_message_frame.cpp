@@ -0,0 +1,381 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "native_message_frame.h"
+#include "code_analysis.h"
+#include "frame_codec.h"
+#include "jni_helpers.h"
+
+#include <cstring>
+
+namespace besu {
+namespace evm {
+
+// ============================================================================
+// Java boundary: one packed byte[] each way (see frame_codec.h)
+// ============================================================================
+
+namespace {
+
+constexpr size_t WORD_SIZE = 32;
+constexpr size_t SLOT_ENTRY_SIZE = Address::SIZE + WORD_SIZE;
+
+Address readAddress(const uint8_t* data) {
+    Address::DataType bytes;
+    memcpy(bytes.data(), data, Address::SIZE);
+    return Address(bytes);
+}
+
+Wei readWei(const uint8_t* data) {
+    return Wei(UInt256::fromBytes(data, WORD_SIZE));
+}
+
+/** Global ref to the object returned by a no-arg getter, or nullptr. */
+jobject globalRefFrom(JNIEnv* env, jobject target, jmethodID getter) {
+    if (getter == nullptr) return nullptr;
+    jobject local = env->CallObjectMethod(target, getter);
+    if (local == nullptr || env->ExceptionCheck()) return nullptr;
+    jobject global = env->NewGlobalRef(local);
+    env->DeleteLocalRef(local);
+    return global;
+}
+
+/**
+ * Loads storage cache misses through NativeFrameBridge.loadStorage: keys go out as
+ * [address 20][slot 32] entries, values come back as [current 32][original 32].
+ */
+class JniStorageLoader : public StorageLoader {
+public:
+    JniStorageLoader(JNIEnv* env, jobject worldUpdater) : env_(env), worldUpdater_(worldUpdater) {}
+
+    bool load(const AddressSlot* keys, size_t count, StorageValue* out) override {
+        auto& cache = jni::JniCache::getInstance(env_);
+        if (cache.bridgeLoadStorage == nullptr || worldUpdater_ == nullptr) return false;
+
+        jbyteArray jkeys = env_->NewByteArray(static_cast<jsize>(count * SLOT_ENTRY_SIZE));
+        if (jkeys == nullptr) return false;
+        {
+            jni::CriticalArray<uint8_t> bytes(env_, jkeys);
+            if (bytes.get() == nullptr) return false;
+            for (size_t i = 0; i < count; i++) {
+                uint8_t* entry = bytes.get() + i * SLOT_ENTRY_SIZE;
+                memcpy(entry, keys[i].first.data().data(), Address::SIZE);
+                memcpy(entry + Address::SIZE, keys[i].second.data(), WORD_SIZE);
+            }
+        }
+
+        jbyteArray jvalues = static_cast<jbyteArray>(env_->CallStaticObjectMethod(
+            cache.nativeFrameBridgeClass, cache.bridgeLoadStorage, worldUpdater_, jkeys));
+        env_->DeleteLocalRef(jkeys);
+        if (jvalues == nullptr || env_->ExceptionCheck()) return false;
+
+        bool loaded = false;
+        {
+            jni::CriticalArray<uint8_t> bytes(env_, jvalues, true);
+            if (bytes.get() != nullptr &&
+                static_cast<size_t>(bytes.length()) >= count * 2 * WORD_SIZE) {
+                for (size_t i = 0; i < count; i++) {
+                    const uint8_t* entry = bytes.get() + i * 2 * WORD_SIZE;
+                    memcpy(out[i].current.data(), entry, WORD_SIZE);
+                    memcpy(out[i].original.data(), entry + WORD_SIZE, WORD_SIZE);
+                }
+                loaded = true;
+            }
+        }
+        env_->DeleteLocalRef(jvalues);
+        return loaded;
+    }
+
+private:
+    JNIEnv* env_;
+    jobject worldUpdater_;
+};
+
+}  // namespace
+
+std::unique_ptr<NativeMessageFrame> NativeMessageFrame::fromJava(JNIEnv* env, jobject jframe) {
+    auto& cache = jni::JniCache::getInstance(env);
+    if (cache.bridgeExportFrame == nullptr) {
+        jni::exception::throwIllegalStateException(env, "NativeFrameBridge.exportFrame not available");
+        return nullptr;
+    }
+
+    // One upcall serialises the whole frame on the Java side
+    jbyteArray packed = static_cast<jbyteArray>(
+        env->CallStaticObjectMethod(cache.nativeFrameBridgeClass, cache.bridgeExportFrame, jframe));
+    if (packed == nullptr || env->ExceptionCheck()) {
+        return nullptr;  // Leave the Java exception pending for the caller
+    }
+
+    std::unique_ptr<NativeMessageFrame> frame(new NativeMessageFrame());
+    frame->env_ = env;
+
+    bool decoded;
+    {
+        // One pinned read of the whole message; no JNI calls inside this scope
+        jni::CriticalArray<uint8_t> bytes(env, packed, true);
+        decoded = bytes.get() != nullptr &&
+                  frame->decodePacked(bytes.get(), static_cast<size_t>(bytes.length()));
+    }
+    env->DeleteLocalRef(packed);
+
+    if (!decoded) {
+        jni::exception::throwIllegalArgumentException(env, "Malformed packed MessageFrame");
+        return nullptr;
+    }
+
+    // Object references stay in Java; only their handles cross the boundary
+    frame->jcode_ = globalRefFrom(env, jframe, cache.mfGetCode);
+    frame->jworldUpdater_ = globalRefFrom(env, jframe, cache.mfGetWorldUpdater);
+    frame->jblockValues_ = globalRefFrom(env, jframe, cache.mfGetBlockValues);
+    if (env->ExceptionCheck()) {
+        return nullptr;
+    }
+
+    // Storage misses load in batches; the first one also fetches every slot the
+    // code addresses with a constant key
+    frame->storageLoader_.reset(new JniStorageLoader(env, frame->jworldUpdater_));
+    frame->storage_.reset(frame->storageLoader_.get());
+    const Address storageAddress = frame->recipient_;
+    code_analysis::for_each_constant_slot(
+        frame->codeBytes_.data(), static_cast<uint32_t>(frame->codeBytes_.size()),
+        [&frame, &storageAddress](const uint8_t* key, uint32_t length) {
+            Bytes32 slot{};
+            memcpy(slot.data() + WORD_SIZE - length, key, length);
+            frame->storage_.prefetch(storageAddress, slot);
+        });
+
+    return frame;
+}
+
+bool NativeMessageFrame::syncToJava(JNIEnv* env, jobject jframe) const {
+    auto& cache = jni::JniCache::getInstance(env);
+    if (cache.bridgeImportFrame == nullptr) {
+        jni::exception::throwIllegalStateException(env, "NativeFrameBridge.importFrame not available");
+        return false;
+    }
+
+    // Reused per thread so steady-state syncs do not allocate on the native side
+    thread_local std::vector<uint8_t> buffer;
+    encodePacked(buffer);
+
+    jbyteArray packed = env->NewByteArray(static_cast<jsize>(buffer.size()));
+    if (packed == nullptr) {
+        return false;  // OutOfMemoryError pending
+    }
+    bool copied;
+    {
+        jni::CriticalArray<uint8_t> bytes(env, packed);
+        copied = bytes.get() != nullptr;
+        if (copied) {
+            memcpy(bytes.get(), buffer.data(), buffer.size());
+        }
+    }
+    if (!copied) {
+        // Importing the zero-filled array would wipe the Java frame
+        env->DeleteLocalRef(packed);
+        jni::exception::throwIllegalStateException(env, "Could not pin the packed MessageFrame");
+        return false;
+    }
+
+    env->CallStaticVoidMethod(cache.nativeFrameBridgeClass, cache.bridgeImportFrame, jframe, packed);
+    env->DeleteLocalRef(packed);
+    return !env->ExceptionCheck();
+}
+
+bool NativeMessageFrame::decodePacked(const uint8_t* data, size_t size) {
+    frame_codec::Reader in(data, size);
+    const PackedFrameIn* header = in.header<PackedFrameIn>();
+    if (header == nullptr ||
+        header->magic != PACKED_FRAME_IN_MAGIC ||
+        header->version != PACKED_FRAME_VERSION ||
+        header->max_stack_size < 0 || header->max_stack_size > STACK_CAPACITY ||
+        header->stack_size > static_cast<uint32_t>(header->max_stack_size)) {
+        return false;
+    }
+
+    pc_ = header->pc;
+    section_ = header->section;
+    gasRemaining_ = header->gas_remaining;
+    gasRefund_ = header->gas_refund;
+    depth_ = header->depth;
+    maxStackSize_ = header->max_stack_size;
+    isStatic_ = (header->flags & PACKED_IN_STATIC) != 0;
+    type_ = (header->flags & PACKED_IN_CONTRACT_CREATION) != 0
+                ? MessageFrameType::CONTRACT_CREATION : MessageFrameType::MESSAGE_CALL;
+    state_ = MessageFrameState::CODE_EXECUTING;
+
+    recipient_ = readAddress(header->recipient);
+    sender_ = readAddress(header->sender);
+    contract_ = readAddress(header->contract);
+    originator_ = readAddress(header->originator);
+    miningBeneficiary_ = readAddress(header->mining_beneficiary);
+    value_ = readWei(header->value);
+    apparentValue_ = readWei(header->apparent_value);
+    gasPrice_ = readWei(header->gas_price);
+
+    // Copy the counts out before the header pointer's sections are consumed
+    const uint32_t stackSize = header->stack_size;
+    const uint32_t memorySize = header->memory_size;
+    const uint32_t codeSize = header->code_size;
+    const uint32_t inputSize = header->input_size;
+    const uint32_t returnDataSize = header->return_data_size;
+    const uint32_t warmAddressCount = header->warm_address_count;
+    const uint32_t warmSlotCount = header->warm_slot_count;
+
+    const uint8_t* stack = in.take(static_cast<size_t>(stackSize) * WORD_SIZE);
+    if (!stack) return false;
+    memcpy(stack_.data(), stack, static_cast<size_t>(stackSize) * WORD_SIZE);
+    stackSize_ = static_cast<int>(stackSize);
+    in.end_section();
+
+    const uint8_t* memory = in.take(memorySize);
+    if (!memory) return false;
+    memory_.assign(memory, memory + memorySize);
+    in.end_section();
+
+    const uint8_t* code = in.take(codeSize);
+    if (!code) return false;
+    codeBytes_.assign(code, code + codeSize);
+    in.end_section();
+
+    const uint8_t* input = in.take(inputSize);
+    if (!input) return false;
+    inputData_.assign(input, input + inputSize);
+    in.end_section();
+
+    const uint8_t* returnData = in.take(returnDataSize);
+    if (!returnData) return false;
+    returnData_.assign(returnData, returnData + returnDataSize);
+    in.end_section();
+
+    clearAccessTracking();
+
+    const uint8_t* warmAddresses = in.take(static_cast<size_t>(warmAddressCount) * Address::SIZE);
+    if (!warmAddresses) return false;
+    for (uint32_t i = 0; i < warmAddressCount; i++) {
+        warmAddresses_.insert(readAddress(warmAddresses + i * Address::SIZE));
+    }
+    in.end_section();
+
+    const uint8_t* warmSlots = in.take(static_cast<size_t>(warmSlotCount) * SLOT_ENTRY_SIZE);
+    if (!warmSlots) return false;
+    for (uint32_t i = 0; i < warmSlotCount; i++) {
+        const uint8_t* entry = warmSlots + i * SLOT_ENTRY_SIZE;
+        Bytes32 slot;
+        memcpy(slot.data(), entry + Address::SIZE, WORD_SIZE);
+        warmStorage_.insert(AddressSlot(readAddress(entry), slot));
+    }
+
+    outputData_.clear();
+    revertReason_.reset();
+    haltReason_.reset();
+    logs_.clear();
+    return true;
+}
+
+void NativeMessageFrame::encodePacked(std::vector<uint8_t>& out) const {
+    frame_codec::Writer w(out);
+    const size_t headerOffset = w.header<PackedFrameOut>();
+
+    w.bytes(stack_.data(), static_cast<size_t>(stackSize_) * WORD_SIZE);
+    w.end_section();
+    w.bytes(memory_.data(), memory_.size());
+    w.end_section();
+    w.bytes(outputData_.data(), outputData_.size());
+    w.end_section();
+    w.bytes(returnData_.data(), returnData_.size());
+    w.end_section();
+    if (revertReason_) {
+        w.bytes(revertReason_->data(), revertReason_->size());
+    }
+    w.end_section();
+
+    for (const Log& log : logs_) {
+        w.bytes(log.getLogger().data().data(), Address::SIZE);
+        w.value(static_cast<uint32_t>(log.getTopics().size()));
+        w.value(static_cast<uint32_t>(log.getData().size()));
+        for (const Bytes32& topic : log.getTopics()) {
+            w.bytes(topic.data(), WORD_SIZE);
+        }
+        w.bytes(log.getData().data(), log.getData().size());
+        w.end_section();
+    }
+
+    selfDestructs_.forEach([&w](const Address& address) {
+        w.bytes(address.data().data(), Address::SIZE);
+    });
+    w.end_section();
+    creates_.forEach([&w](const Address& address) {
+        w.bytes(address.data().data(), Address::SIZE);
+    });
+    w.end_section();
+    refunds_.forEach([&w](const Address& address, const Wei& amount) {
+        w.bytes(address.data().data(), Address::SIZE);
+        const Bytes32 value = amount.toBytes32();
+        w.bytes(value.data(), WORD_SIZE);
+    });
+    w.end_section();
+    warmAddresses_.forEach([&w](const Address& address) {
+        w.bytes(address.data().data(), Address::SIZE);
+    });
+    w.end_section();
+    warmStorage_.forEach([&w](const AddressSlot& key) {
+        w.bytes(key.first.data().data(), Address::SIZE);
+        w.bytes(key.second.data(), WORD_SIZE);
+    });
+    w.end_section();
+    storage_.forEachDirty([&w](const AddressSlot& key, const Bytes32& value) {
+        w.bytes(key.first.data().data(), Address::SIZE);
+        w.bytes(key.second.data(), WORD_SIZE);
+        w.bytes(value.data(), WORD_SIZE);
+    });
+    w.end_section();
+
+    // Fill the header last; earlier appends may have moved the buffer
+    PackedFrameOut* header = w.at<PackedFrameOut>(headerOffset);
+    header->magic = PACKED_FRAME_OUT_MAGIC;
+    header->version = PACKED_FRAME_VERSION;
+    header->flags = revertReason_ ? PACKED_OUT_HAS_REVERT_REASON : 0;
+    header->pc = pc_;
+    header->section = section_;
+    header->gas_remaining = gasRemaining_;
+    header->gas_refund = gasRefund_;
+    header->state = static_cast<uint32_t>(state_);
+    header->halt_reason = static_cast<uint32_t>(haltReason_.value_or(ExceptionalHaltReason::NONE));
+    header->stack_size = static_cast<uint32_t>(stackSize_);
+    header->memory_size = static_cast<uint32_t>(memory_.size());
+    header->output_size = static_cast<uint32_t>(outputData_.size());
+    header->return_data_size = static_cast<uint32_t>(returnData_.size());
+    header->revert_reason_size = revertReason_ ? static_cast<uint32_t>(revertReason_->size()) : 0;
+    header->log_count = static_cast<uint32_t>(logs_.size());
+    header->self_destruct_count = static_cast<uint32_t>(selfDestructs_.size());
+    header->create_count = static_cast<uint32_t>(creates_.size());
+    header->refund_count = static_cast<uint32_t>(refunds_.size());
+    header->warm_address_count = static_cast<uint32_t>(warmAddresses_.size());
+    header->warm_slot_count = static_cast<uint32_t>(warmStorage_.size());
+    header->storage_write_count = static_cast<uint32_t>(storage_.dirtyCount());
+}
+
+// ============================================================================
+// Rollback
+// ============================================================================
+
+void NativeMessageFrame::rollback() {
+    // Storage writes have not reached Java yet: dropping them from the cache
+    // keeps them out of the sync-out message
+    storage_.rollback();
+}
+
+void NativeMessageFrame::releaseJavaRefs() {
+    if (env_ == nullptr) return;
+    for (jobject* ref : {&jcode_, &jworldUpdater_, &jblockValues_}) {
+        if (*ref != nullptr) {
+            env_->DeleteGlobalRef(*ref);
+            *ref = nullptr;
+        }
+    }
+}
+
+}  // namespace evm
+}  // namespace besu
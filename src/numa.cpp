@@ -0,0 +1,135 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * NUMA topology from /sys/devices/system/node, thread pinning via
+ * sched_setaffinity and memory binding via the raw mbind syscall.
+ */
+
+#include "../include/numa.h"
+#include <cstdio>
+#include <cstring>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace besu {
+namespace evm {
+namespace numa {
+
+#if defined(__linux__)
+
+// From <linux/mempolicy.h>; spelled out to avoid depending on kernel headers
+static constexpr int MPOL_BIND_MODE = 2;
+static constexpr unsigned MPOL_MF_MOVE_FLAG = 1u << 1;
+
+/**
+ * Parse a sysfs cpulist ("0-3,8-11") into a cpu_set_t.
+ * @return number of CPUs set
+ */
+static int read_node_cpus(int node, cpu_set_t* set) {
+    char path[96];
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+    FILE* file = fopen(path, "r");
+    if (!file) return 0;
+
+    char list[4096];
+    size_t len = fread(list, 1, sizeof(list) - 1, file);
+    fclose(file);
+    list[len] = '\0';
+
+    CPU_ZERO(set);
+    int count = 0;
+    const char* p = list;
+    while (*p) {
+        int lo = 0, hi = 0, consumed = 0;
+        if (sscanf(p, "%d-%d%n", &lo, &hi, &consumed) == 2) {
+            p += consumed;
+        } else if (sscanf(p, "%d%n", &lo, &consumed) == 1) {
+            hi = lo;
+            p += consumed;
+        } else {
+            break;
+        }
+        for (int cpu = lo; cpu <= hi && cpu < CPU_SETSIZE; cpu++) {
+            CPU_SET(cpu, set);
+            count++;
+        }
+        if (*p == ',') p++;
+        else break;
+    }
+    return count;
+}
+
+int node_count() {
+    static const int cached = [] {
+        int count = 0;
+        cpu_set_t set;
+        for (int node = 0; node < MAX_NODES; node++) {
+            if (read_node_cpus(node, &set) > 0) {
+                count = node + 1;
+            }
+        }
+        return count > 0 ? count : 1;
+    }();
+    return cached;
+}
+
+int current_node() {
+    unsigned cpu = 0, node = 0;
+#ifdef SYS_getcpu
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+        return static_cast<int>(node);
+    }
+#endif
+    return 0;
+}
+
+int cpu_count(int node) {
+    cpu_set_t set;
+    return read_node_cpus(node, &set);
+}
+
+bool pin_thread_to_node(int node) {
+    cpu_set_t set;
+    if (read_node_cpus(node, &set) == 0) return false;
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+bool bind_memory(void* addr, size_t size, int node) {
+#ifdef SYS_mbind
+    if (node < 0 || node >= MAX_NODES || node_count() < 2) return false;
+
+    unsigned long mask = 1ul << node;
+    long rc = syscall(SYS_mbind, addr, size, MPOL_BIND_MODE, &mask,
+                      static_cast<unsigned long>(MAX_NODES + 1), MPOL_MF_MOVE_FLAG);
+    return rc == 0;
+#else
+    (void)addr;
+    (void)size;
+    (void)node;
+    return false;
+#endif
+}
+
+#else // !__linux__
+
+int node_count() { return 1; }
+int current_node() { return 0; }
+int cpu_count(int node) { (void)node; return 0; }
+bool pin_thread_to_node(int node) { (void)node; return false; }
+bool bind_memory(void* addr, size_t size, int node) {
+    (void)addr;
+    (void)size;
+    (void)node;
+    return false;
+}
+
+#endif
+
+} // namespace numa
+} // namespace evm
+} // namespace besu
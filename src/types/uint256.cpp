@@ -1,215 +1,88 @@
 // Copyright ConsenSys AG.
 // SPDX-License-Identifier: Apache-2.0
 
+// Out-of-line UInt256 conversions. Arithmetic is inline in types.h.
+
 #include "types.h"
-#include <cstring>
 #include <stdexcept>
-#include <sstream>
-#include <iomanip>
 
 namespace besu {
 namespace evm {
 
-// Internal implementation using four 64-bit limbs (little-endian)
-// For production, consider using boost::multiprecision or intx library
-struct UInt256::Impl {
-    uint64_t limbs[4];  // limbs[0] = least significant
-
-    Impl() : limbs{0, 0, 0, 0} {}
+static const char HEX_DIGITS[] = "0123456789abcdef";
 
-    explicit Impl(uint64_t value) : limbs{value, 0, 0, 0} {}
-
-    Impl(const Impl& other) {
-        std::memcpy(limbs, other.limbs, sizeof(limbs));
-    }
-
-    Impl& operator=(const Impl& other) {
-        if (this != &other) {
-            std::memcpy(limbs, other.limbs, sizeof(limbs));
-        }
-        return *this;
-    }
-};
-
-UInt256::UInt256() : impl_(std::make_unique<Impl>()) {}
-
-UInt256::UInt256(uint64_t value) : impl_(std::make_unique<Impl>(value)) {}
-
-UInt256::UInt256(const Bytes& bytes) : impl_(std::make_unique<Impl>()) {
-    // TODO: Implement conversion from bytes (big-endian)
+UInt256::UInt256(const Bytes& bytes) : limbs_{} {
     if (bytes.size() > 32) {
         throw std::invalid_argument("Bytes too large for UInt256");
     }
+    *this = fromBytes(bytes.data(), bytes.size());
 }
 
-UInt256::UInt256(const UInt256& other) : impl_(std::make_unique<Impl>(*other.impl_)) {}
-
-UInt256::UInt256(UInt256&& other) noexcept = default;
-
-UInt256::~UInt256() = default;
-
-UInt256& UInt256::operator=(const UInt256& other) {
-    if (this != &other) {
-        *impl_ = *other.impl_;
-    }
-    return *this;
-}
-
-UInt256& UInt256::operator=(UInt256&& other) noexcept = default;
-
-// Arithmetic operations (stubs - implement with proper 256-bit arithmetic)
-UInt256 UInt256::operator+(const UInt256& other) const {
-    UInt256 result;
-    // TODO: Implement addition with carry
-    return result;
-}
-
-UInt256 UInt256::operator-(const UInt256& other) const {
-    UInt256 result;
-    // TODO: Implement subtraction with borrow
-    return result;
-}
-
-UInt256 UInt256::operator*(const UInt256& other) const {
-    UInt256 result;
-    // TODO: Implement multiplication
-    return result;
-}
-
-UInt256 UInt256::operator/(const UInt256& other) const {
-    UInt256 result;
-    // TODO: Implement division
-    return result;
-}
-
-UInt256 UInt256::operator%(const UInt256& other) const {
-    UInt256 result;
-    // TODO: Implement modulo
-    return result;
-}
-
-// Bitwise operations (stubs)
-UInt256 UInt256::operator&(const UInt256& other) const {
-    UInt256 result;
-    for (int i = 0; i < 4; ++i) {
-        result.impl_->limbs[i] = impl_->limbs[i] & other.impl_->limbs[i];
-    }
-    return result;
-}
-
-UInt256 UInt256::operator|(const UInt256& other) const {
-    UInt256 result;
-    for (int i = 0; i < 4; ++i) {
-        result.impl_->limbs[i] = impl_->limbs[i] | other.impl_->limbs[i];
-    }
-    return result;
-}
-
-UInt256 UInt256::operator^(const UInt256& other) const {
-    UInt256 result;
-    for (int i = 0; i < 4; ++i) {
-        result.impl_->limbs[i] = impl_->limbs[i] ^ other.impl_->limbs[i];
-    }
-    return result;
+Bytes UInt256::toBytes() const {
+    Bytes32 encoded = toBytes32();
+    return Bytes(encoded.begin(), encoded.end());
 }
 
-UInt256 UInt256::operator~() const {
-    UInt256 result;
-    for (int i = 0; i < 4; ++i) {
-        result.impl_->limbs[i] = ~impl_->limbs[i];
+std::string UInt256::toString() const {
+    if (isZero()) {
+        return "0";
     }
-    return result;
-}
-
-UInt256 UInt256::operator<<(unsigned int shift) const {
-    UInt256 result;
-    // TODO: Implement left shift
-    return result;
-}
-
-UInt256 UInt256::operator>>(unsigned int shift) const {
-    UInt256 result;
-    // TODO: Implement right shift
-    return result;
-}
 
-// Comparison operations
-bool UInt256::operator==(const UInt256& other) const {
-    return std::memcmp(impl_->limbs, other.impl_->limbs, sizeof(impl_->limbs)) == 0;
-}
-
-bool UInt256::operator!=(const UInt256& other) const {
-    return !(*this == other);
-}
-
-bool UInt256::operator<(const UInt256& other) const {
-    // TODO: Implement proper comparison
-    for (int i = 3; i >= 0; --i) {
-        if (impl_->limbs[i] < other.impl_->limbs[i]) return true;
-        if (impl_->limbs[i] > other.impl_->limbs[i]) return false;
+    // Peel off 19 decimal digits at a time (10^19 is the largest power of ten in 64 bits)
+    const UInt256 chunk_divisor(10000000000000000000ULL);
+    std::string digits;
+    UInt256 value = *this;
+    while (!value.isZero()) {
+        UInt256 quotient;
+        UInt256 remainder;
+        divmod(value, chunk_divisor, quotient, remainder);
+        uint64_t chunk = remainder.toUint64();
+        for (int i = 0; i < 19 && (chunk != 0 || !quotient.isZero()); ++i) {
+            digits.push_back(static_cast<char>('0' + chunk % 10));
+            chunk /= 10;
+        }
+        value = quotient;
     }
-    return false;
-}
-
-bool UInt256::operator>(const UInt256& other) const {
-    return other < *this;
-}
-
-bool UInt256::operator<=(const UInt256& other) const {
-    return !(*this > other);
-}
-
-bool UInt256::operator>=(const UInt256& other) const {
-    return !(*this < other);
-}
-
-bool UInt256::isZero() const {
-    return impl_->limbs[0] == 0 && impl_->limbs[1] == 0 &&
-           impl_->limbs[2] == 0 && impl_->limbs[3] == 0;
-}
-
-uint64_t UInt256::toUint64() const {
-    return impl_->limbs[0];
-}
-
-Bytes UInt256::toBytes() const {
-    // TODO: Convert to big-endian bytes
-    Bytes result(32, 0);
-    return result;
-}
-
-Bytes32 UInt256::toBytes32() const {
-    // TODO: Convert to big-endian Bytes32
-    Bytes32 result{};
-    return result;
-}
-
-std::string UInt256::toString() const {
-    // TODO: Convert to decimal string
-    return "0";
+    return std::string(digits.rbegin(), digits.rend());
 }
 
 std::string UInt256::toHexString() const {
-    std::ostringstream oss;
-    oss << "0x";
+    std::string result = "0x";
+    result.reserve(66);
     for (int i = 3; i >= 0; --i) {
-        oss << std::hex << std::setfill('0') << std::setw(16) << impl_->limbs[i];
+        for (int shift = 60; shift >= 0; shift -= 4) {
+            result.push_back(HEX_DIGITS[(limbs_[i] >> shift) & 0xf]);
+        }
     }
-    return oss.str();
+    return result;
 }
 
 UInt256 UInt256::fromBytes(const Bytes& bytes) {
     return UInt256(bytes);
 }
 
-UInt256 UInt256::fromBytes32(const Bytes32& bytes) {
-    Bytes b(bytes.begin(), bytes.end());
-    return UInt256(b);
-}
-
 UInt256 UInt256::fromHexString(const std::string& hex) {
-    // TODO: Parse hex string
-    return UInt256();
+    size_t start = (hex.size() >= 2 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) ? 2 : 0;
+    if (hex.size() - start > 64) {
+        throw std::invalid_argument("Hex string too large for UInt256");
+    }
+
+    UInt256 result;
+    for (size_t i = start; i < hex.size(); ++i) {
+        char c = hex[i];
+        uint64_t nibble;
+        if (c >= '0' && c <= '9') {
+            nibble = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            nibble = c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            nibble = c - 'A' + 10;
+        } else {
+            throw std::invalid_argument("Invalid hex digit in UInt256");
+        }
+        result = (result << 4) | UInt256(nibble);
+    }
+    return result;
 }
 
 }  // namespace evm
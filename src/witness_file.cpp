@@ -0,0 +1,132 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Witness files. See include/witness_file.h.
+ */
+
+#include "../include/witness_file.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define BESU_WITNESS_FILE_HAS_MMAP 1
+#endif
+
+namespace besu {
+namespace evm {
+
+// Fallback when the file cannot be mapped: read it into an aligned heap buffer
+static uint8_t* read_whole(const char* path, uint64_t* size) {
+    FILE* in = fopen(path, "rb");
+    if (!in) return nullptr;
+    uint8_t* data = nullptr;
+    if (fseek(in, 0, SEEK_END) == 0) {
+        long length = ftell(in);
+        if (length > 0 && fseek(in, 0, SEEK_SET) == 0) {
+            uint64_t capacity = witness_file::align(static_cast<uint64_t>(length));
+            data = static_cast<uint8_t*>(aligned_alloc(WITNESS_FILE_ALIGNMENT, capacity));
+            if (data && fread(data, 1, static_cast<size_t>(length), in) != static_cast<size_t>(length)) {
+                free(data);
+                data = nullptr;
+            }
+            *size = static_cast<uint64_t>(length);
+        }
+    }
+    fclose(in);
+    return data;
+}
+
+extern "C" {
+
+bool besu_witness_file_write(const char* path, const uint8_t* witness, uint64_t witness_size,
+                             uint64_t block_number) {
+    if (!path || !witness || !witness_file::witness_valid(witness, witness_size)) return false;
+
+    WitnessFileHeader header;
+    const uint64_t size = witness_file::layout(witness, witness_size, block_number, &header);
+    uint8_t* out = static_cast<uint8_t*>(calloc(1, size));
+    if (!out) return false;
+    witness_file::build(witness, &header, out);
+
+    FILE* file = fopen(path, "wb");
+    bool ok = file && fwrite(out, 1, size, file) == size;
+    if (file) ok = fclose(file) == 0 && ok;
+    free(out);
+    return ok;
+}
+
+WitnessFile* besu_witness_file_open(const char* path, uint32_t* status) {
+    uint32_t result = WITNESS_FILE_IO_ERROR;
+    WitnessFile* file = static_cast<WitnessFile*>(calloc(1, sizeof(WitnessFile)));
+    uint8_t* data = nullptr;
+    uint64_t size = 0;
+    bool mapped = false;
+
+#ifdef BESU_WITNESS_FILE_HAS_MMAP
+    int fd = path ? open(path, O_RDONLY) : -1;
+    if (fd >= 0) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            size = static_cast<uint64_t>(st.st_size);
+            // Private and writable: pages stay shared until this process writes one
+            void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            if (ptr != MAP_FAILED) {
+                data = static_cast<uint8_t*>(ptr);
+                mapped = true;
+            }
+        }
+        close(fd);
+    }
+#endif
+    if (!data && path) data = read_whole(path, &size);
+
+    if (file && data) {
+        result = witness_file::open_view(data, size, file);
+        file->mapped = mapped ? 1 : 0;
+    }
+    if (result != WITNESS_FILE_OK) {
+#ifdef BESU_WITNESS_FILE_HAS_MMAP
+        if (mapped) munmap(data, size);
+#endif
+        if (!mapped) free(data);
+        free(file);
+        file = nullptr;
+    }
+    if (status) *status = result;
+    return file;
+}
+
+AccountEntry* besu_witness_file_find_account(const WitnessFile* file, const uint8_t* address) {
+    if (!file || !address) return nullptr;
+    return witness_file::find_account(file, address);
+}
+
+StorageEntry* besu_witness_file_find_storage(const WitnessFile* file, const uint8_t* address,
+                                             const uint8_t* key) {
+    if (!file || !address || !key) return nullptr;
+    return witness_file::find_storage(file, address, key);
+}
+
+void besu_witness_file_close(WitnessFile* file) {
+    if (!file) return;
+#ifdef BESU_WITNESS_FILE_HAS_MMAP
+    if (file->mapped) {
+        munmap(file->data, file->size);
+        free(file);
+        return;
+    }
+#endif
+    free(file->data);
+    free(file);
+}
+
+} // extern "C"
+
+} // namespace evm
+} // namespace besu
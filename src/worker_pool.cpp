@@ -0,0 +1,248 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * NUMA-aware worker pool with node-local work stealing.
+ * See include/worker_pool.h for the placement policy.
+ */
+
+#include "../include/worker_pool.h"
+#include "../include/message_frame_memory.h"
+#include "../include/numa.h"
+#include "../include/tracer_callback.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+extern "C" void execute_message(besu::evm::MessageFrameMemory* frame,
+                                besu::evm::TracerCallbacks* tracer);
+
+namespace besu {
+namespace evm {
+
+struct PoolTask {
+    WorkerTask fn;
+    void* arg;
+};
+
+struct Worker {
+    int node;
+    Arena* arena;
+    std::mutex lock;
+    std::deque<PoolTask> queue;
+    std::thread thread;
+};
+
+struct WorkerPool {
+    std::vector<std::unique_ptr<Worker>> workers;
+    int nodes;
+    uint64_t arena_bytes;
+    uint32_t arena_flags;
+
+    // Idle workers sleep here; submitters and finishers signal
+    std::mutex idle_lock;
+    std::condition_variable work_available;
+    std::condition_variable all_done;
+
+    std::atomic<uint64_t> queued{0};     // Submitted, not yet taken
+    std::atomic<uint64_t> in_flight{0};  // Submitted, not yet finished
+    std::atomic<uint32_t> next_worker{0};
+    std::atomic<bool> stopping{false};
+
+    std::atomic<uint64_t> executed{0};
+    std::atomic<uint64_t> stolen_local{0};
+    std::atomic<uint64_t> stolen_remote{0};
+};
+
+static bool take_own(Worker* worker, PoolTask* out) {
+    std::lock_guard<std::mutex> guard(worker->lock);
+    if (worker->queue.empty()) return false;
+    *out = worker->queue.back();  // LIFO for the owner: hottest data first
+    worker->queue.pop_back();
+    return true;
+}
+
+static bool steal(Worker* victim, PoolTask* out) {
+    std::lock_guard<std::mutex> guard(victim->lock);
+    if (victim->queue.empty()) return false;
+    *out = victim->queue.front();  // FIFO for thieves: oldest work, least contention
+    victim->queue.pop_front();
+    return true;
+}
+
+/**
+ * Find work for worker self: own queue, then same-node victims, then remote nodes.
+ */
+static bool find_task(WorkerPool* pool, size_t self, PoolTask* out) {
+    Worker* me = pool->workers[self].get();
+    if (take_own(me, out)) return true;
+
+    size_t count = pool->workers.size();
+    for (int pass = 0; pass < 2; pass++) {
+        bool local_pass = (pass == 0);
+        for (size_t i = 1; i < count; i++) {
+            Worker* victim = pool->workers[(self + i) % count].get();
+            if ((victim->node == me->node) != local_pass) continue;
+            if (steal(victim, out)) {
+                (local_pass ? pool->stolen_local : pool->stolen_remote)++;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static void worker_main(WorkerPool* pool, size_t self) {
+    Worker* me = pool->workers[self].get();
+
+    // Pin first so the arena's first touch (and mbind) land on our node
+    numa::pin_thread_to_node(me->node);
+    if (pool->arena_bytes > 0) {
+        Arena* arena = besu_arena_create_on_node(pool->arena_bytes, pool->arena_flags, me->node);
+        std::lock_guard<std::mutex> guard(pool->idle_lock);  // Published to besu_pool_reset_arenas
+        me->arena = arena;
+    }
+
+    while (true) {
+        PoolTask task;
+        if (find_task(pool, self, &task)) {
+            pool->queued--;
+            task.fn(task.arg, me->arena);
+            pool->executed++;
+            if (--pool->in_flight == 0) {
+                std::lock_guard<std::mutex> guard(pool->idle_lock);
+                pool->all_done.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard(pool->idle_lock);
+        pool->work_available.wait(guard, [pool] {
+            return pool->queued.load() > 0 || pool->stopping.load();
+        });
+        if (pool->stopping.load() && pool->queued.load() == 0) {
+            break;
+        }
+    }
+
+    besu_arena_destroy(me->arena);
+    me->arena = nullptr;
+}
+
+static void execute_frame_task(void* arg, Arena* arena) {
+    (void)arena;
+    execute_message(static_cast<MessageFrameMemory*>(arg), nullptr);
+}
+
+extern "C" {
+
+WorkerPool* besu_pool_create(uint32_t workers, uint64_t arena_bytes, uint32_t arena_flags) {
+    if (workers == 0) {
+        workers = std::thread::hardware_concurrency();
+        if (workers == 0) workers = 1;
+    }
+
+    WorkerPool* pool = new WorkerPool();
+    pool->nodes = numa::node_count();
+    pool->arena_bytes = arena_bytes;
+    pool->arena_flags = arena_flags;
+
+    // Contiguous worker ranges per node: workers [0, n/k) on node 0, and so on
+    for (uint32_t i = 0; i < workers; i++) {
+        auto worker = std::make_unique<Worker>();
+        worker->node = static_cast<int>((uint64_t)i * pool->nodes / workers);
+        worker->arena = nullptr;
+        pool->workers.push_back(std::move(worker));
+    }
+    for (uint32_t i = 0; i < workers; i++) {
+        pool->workers[i]->thread = std::thread(worker_main, pool, i);
+    }
+    return pool;
+}
+
+bool besu_pool_submit(WorkerPool* pool, WorkerTask task, void* arg, int32_t node) {
+    if (!pool || !task || pool->stopping.load()) return false;
+
+    size_t count = pool->workers.size();
+    size_t target = pool->next_worker++ % count;
+    if (node >= 0 && node < pool->nodes) {
+        // Round robin within the node's worker range
+        size_t first = (static_cast<size_t>(node) * count + pool->nodes - 1) / pool->nodes;
+        size_t last = (static_cast<size_t>(node + 1) * count + pool->nodes - 1) / pool->nodes;
+        if (last > first) {
+            target = first + (target % (last - first));
+        }
+    }
+
+    // Counted and queued under idle_lock, so besu_pool_reset_arenas never sees an
+    // idle pool while a task is being published
+    std::lock_guard<std::mutex> guard(pool->idle_lock);
+    // Count before publishing so a fast thief can never drive the counters below zero
+    pool->in_flight++;
+    pool->queued++;
+    {
+        Worker* worker = pool->workers[target].get();
+        std::lock_guard<std::mutex> worker_guard(worker->lock);
+        worker->queue.push_back({task, arg});
+    }
+    pool->work_available.notify_all();
+    return true;
+}
+
+void besu_pool_wait(WorkerPool* pool) {
+    if (!pool) return;
+    std::unique_lock<std::mutex> guard(pool->idle_lock);
+    pool->all_done.wait(guard, [pool] { return pool->in_flight.load() == 0; });
+}
+
+void besu_pool_execute_batch(WorkerPool* pool, MessageFrameMemory** frames, uint32_t count) {
+    if (!pool || !frames) return;
+    for (uint32_t i = 0; i < count; i++) {
+        besu_pool_submit(pool, execute_frame_task, frames[i], -1);
+    }
+    besu_pool_wait(pool);
+}
+
+bool besu_pool_reset_arenas(WorkerPool* pool) {
+    if (!pool) return false;
+    // Holding idle_lock keeps submitters out until the arenas are reset
+    std::lock_guard<std::mutex> guard(pool->idle_lock);
+    if (pool->in_flight.load() != 0) return false;
+    for (auto& worker : pool->workers) {
+        besu_arena_reset(worker->arena);
+    }
+    return true;
+}
+
+void besu_pool_stats(const WorkerPool* pool, WorkerPoolStats* out) {
+    if (!pool || !out) return;
+    out->executed = pool->executed.load();
+    out->stolen_local = pool->stolen_local.load();
+    out->stolen_remote = pool->stolen_remote.load();
+    out->workers = static_cast<uint32_t>(pool->workers.size());
+    out->nodes = static_cast<uint32_t>(pool->nodes);
+}
+
+void besu_pool_destroy(WorkerPool* pool) {
+    if (!pool) return;
+    {
+        std::lock_guard<std::mutex> guard(pool->idle_lock);
+        pool->stopping = true;
+        pool->work_available.notify_all();
+    }
+    for (auto& worker : pool->workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+    delete pool;
+}
+
+} // extern "C"
+
+} // namespace evm
+} // namespace besu
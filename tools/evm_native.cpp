@@ -0,0 +1,414 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * evm-native: run bytecode on the native interpreter from the command line.
+ *
+ * Executes one message call without a JVM, in the spirit of geth's `evm run`:
+ *
+ *   evm-native [options] <hex code>
+ *   evm-native --codefile contract.hex --input 0xa9059cbb... --gas 100000
+ *   evm-native --witness state.txt --to 0x<contract> --trace steps
+ *   evm-native --witness state.txt --save-witness state.wit --to 0x<contract>
+ *
+ * Prints the final state, gas and timing; --trace steps writes an EIP-3155
+ * JSON line per instruction to stderr, --bench N times N runs from the same
+ * initial state.
+ *
+ * Opcodes without a native handler yet run as stubs that only charge gas. The
+ * first run is always traced for them: if one ran, a warning names it and the
+ * exit status is 3 (unsupported) whatever the frame state.
+ */
+
+#include "tool_engine.h"
+#include "tool_util.h"
+#include "witness_file.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace besu::evm;
+using namespace besu::evm::tools;
+
+namespace {
+
+enum class TraceMode { NONE, COUNT, STEPS };
+
+struct Options {
+    Call call;
+    std::string code_arg;
+    std::string witness_path;
+    std::string save_witness_path;
+    std::string engine;
+    std::string lib;
+    TraceMode trace = TraceMode::NONE;
+    int bench = 0;
+    bool json = false;
+    bool have_to = false;
+};
+
+void usage(const char* argv0) {
+    std::fprintf(stderr,
+        "Usage: %s [options] [<hex code>]\n"
+        "\n"
+        "Code and state:\n"
+        "  --code HEX           Bytecode to run (or the positional argument)\n"
+        "  --codefile FILE      Bytecode file, hex text or binary ('-' for stdin)\n"
+        "  --input HEX          Calldata\n"
+        "  --inputfile FILE     Calldata file, hex text or binary\n"
+        "  --witness FILE       Pre-state: 'account <addr> [balance=] [nonce=] [code=]'\n"
+        "                       and 'storage <addr> <key> <value>' lines, or a witness file\n"
+        "  --save-witness FILE  Write the pre-state as a witness file (include/witness_file.h)\n"
+        "  --to ADDR            Called contract (its witness code runs if no code is given)\n"
+        "\n"
+        "Message and block context:\n"
+        "  --gas N              Gas limit (default 10000000)\n"
+        "  --sender ADDR        Caller\n"
+        "  --origin ADDR        Transaction origin (default: sender)\n"
+        "  --value N            Wei transferred\n"
+        "  --gas-price N        Gas price in wei\n"
+        "  --coinbase ADDR      Block beneficiary\n"
+        "  --fork NAME          istanbul, berlin, london, shanghai, cancun, prague (default)\n"
+        "  --static             Static call (no state changes)\n"
+        "\n"
+        "Execution:\n"
+        "  --engine NAME        Dispatch variant: table, switch, goto, tailcall (needs BESU_BUILD_BENCH)\n"
+        "  --lib PATH           Interpreter library to load\n"
+        "  --trace MODE         none (default), count (per-opcode totals), steps (EIP-3155 on stderr)\n"
+        "  --bench N            Time N runs from the same initial state\n"
+        "  --json               Print the result as JSON\n",
+        argv0);
+}
+
+bool parse(int argc, char** argv, Options& options, std::string& error) {
+    bool have_origin = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") return false;
+        if (arg == "--static") {
+            options.call.is_static = true;
+            continue;
+        }
+        if (arg == "--json") {
+            options.json = true;
+            continue;
+        }
+        if (arg.compare(0, 2, "--") != 0) {
+            options.code_arg = arg;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            error = arg + " needs a value";
+            return false;
+        }
+        std::string value = argv[++i];
+        bool ok = true;
+        if (arg == "--code") {
+            options.code_arg = value;
+        } else if (arg == "--codefile") {
+            ok = read_hex_or_binary_file(value, options.call.code);
+            if (!ok) error = "cannot read " + value;
+        } else if (arg == "--input") {
+            ok = parse_hex(value, options.call.input);
+        } else if (arg == "--inputfile") {
+            ok = read_hex_or_binary_file(value, options.call.input);
+            if (!ok) error = "cannot read " + value;
+        } else if (arg == "--witness") {
+            options.witness_path = value;
+        } else if (arg == "--save-witness") {
+            options.save_witness_path = value;
+        } else if (arg == "--to") {
+            ok = parse_address(value, options.call.to);
+            options.have_to = true;
+        } else if (arg == "--gas") {
+            uint8_t word[32];
+            bool fits = false;
+            ok = parse_u256(value, word);
+            options.call.gas = static_cast<int64_t>(word_u64(word, &fits));
+            ok = ok && fits && options.call.gas >= 0;
+        } else if (arg == "--sender") {
+            ok = parse_address(value, options.call.sender);
+        } else if (arg == "--origin") {
+            ok = parse_address(value, options.call.origin);
+            have_origin = true;
+        } else if (arg == "--value") {
+            ok = parse_u256(value, options.call.value);
+        } else if (arg == "--gas-price") {
+            ok = parse_u256(value, options.call.gas_price);
+        } else if (arg == "--coinbase") {
+            ok = parse_address(value, options.call.coinbase);
+        } else if (arg == "--fork") {
+            ok = parse_revision(value, options.call.revision);
+        } else if (arg == "--engine") {
+            options.engine = value;
+        } else if (arg == "--lib") {
+            options.lib = value;
+        } else if (arg == "--trace") {
+            if (value == "none") {
+                options.trace = TraceMode::NONE;
+            } else if (value == "count") {
+                options.trace = TraceMode::COUNT;
+            } else if (value == "steps") {
+                options.trace = TraceMode::STEPS;
+            } else {
+                ok = false;
+            }
+        } else if (arg == "--bench") {
+            options.bench = std::atoi(value.c_str());
+            ok = options.bench > 0;
+        } else {
+            error = "unknown option " + arg;
+            return false;
+        }
+        if (!ok) {
+            if (error.empty()) error = "bad value for " + arg + ": " + value;
+            return false;
+        }
+    }
+    if (!have_origin) std::memcpy(options.call.origin, options.call.sender, 20);
+    if (!options.code_arg.empty() && !parse_hex(options.code_arg, options.call.code)) {
+        error = "code is not hex";
+        return false;
+    }
+    return true;
+}
+
+// ===== TRACERS =====
+
+// The tracer callbacks carry no context pointer: the active tracer state is global
+struct TraceState {
+    TraceMode mode = TraceMode::NONE;
+    Revision revision = LATEST_REVISION;
+    uint64_t counts[256] = {};
+    int64_t gas[256] = {};
+    uint64_t steps = 0;
+
+    // Pre-execution snapshot, printed with the cost once the instruction ran
+    int32_t pc = 0;
+    uint8_t opcode = 0;
+    int64_t gas_before = 0;
+    int64_t refund = 0;
+    int32_t memory_size = 0;
+    std::vector<std::string> stack;
+};
+
+TraceState g_trace;
+
+const uint8_t* frame_at(const MessageFrameMemory* frame, uint64_t offset) {
+    return reinterpret_cast<const uint8_t*>(frame) + offset;
+}
+
+void trace_pre(MessageFrameMemory* frame) {
+    stub_trace_pre(frame);
+    g_trace.pc = frame->pc;
+    g_trace.opcode = frame_at(frame, frame->code_ptr)[frame->pc];
+    if (g_trace.mode != TraceMode::STEPS) return;
+    g_trace.gas_before = frame->gas_remaining;
+    g_trace.refund = frame->gas_refund;
+    g_trace.memory_size = frame->memory_size;
+    g_trace.stack.clear();
+    for (int32_t i = 0; i < frame->stack_size; i++) {
+        g_trace.stack.push_back(to_quantity(frame_at(frame, frame->stack_ptr + uint64_t(i) * STACK_ITEM_SIZE)));
+    }
+}
+
+void trace_post(MessageFrameMemory* frame, OperationResult* result) {
+    (void)frame;
+    g_trace.steps++;
+    g_trace.counts[g_trace.opcode]++;
+    g_trace.gas[g_trace.opcode] += result->gas_cost;
+    if (g_trace.mode != TraceMode::STEPS) return;
+
+    const char* name = opcodes::info(g_trace.revision, g_trace.opcode).name;
+    std::string stack;
+    for (size_t i = 0; i < g_trace.stack.size(); i++) {
+        stack += (i ? ",\"" : "\"") + g_trace.stack[i] + "\"";
+    }
+    std::fprintf(stderr,
+                 "{\"pc\":%d,\"op\":%u,\"gas\":\"0x%llx\",\"gasCost\":\"0x%llx\",\"memSize\":%d,"
+                 "\"stack\":[%s],\"depth\":1,\"refund\":%lld,\"opName\":\"%s\"}\n",
+                 g_trace.pc, g_trace.opcode, static_cast<unsigned long long>(g_trace.gas_before),
+                 static_cast<unsigned long long>(result->gas_cost), g_trace.memory_size, stack.c_str(),
+                 static_cast<long long>(g_trace.refund), name ? name : "opcode");
+}
+
+void print_counts() {
+    std::vector<int> ops;
+    for (int op = 0; op < 256; op++) {
+        if (g_trace.counts[op]) ops.push_back(op);
+    }
+    std::sort(ops.begin(), ops.end(), [](int a, int b) { return g_trace.counts[a] > g_trace.counts[b]; });
+    std::printf("\n%-14s %12s %12s\n", "opcode", "count", "gas");
+    for (int op : ops) {
+        const char* name = opcodes::info(g_trace.revision, static_cast<uint8_t>(op)).name;
+        std::printf("%-14s %12llu %12lld\n", name ? name : "?", static_cast<unsigned long long>(g_trace.counts[op]),
+                    static_cast<long long>(g_trace.gas[op]));
+    }
+    std::printf("%-14s %12llu\n", "total", static_cast<unsigned long long>(g_trace.steps));
+}
+
+// ===== OUTPUT =====
+
+void print_result(ExecFrame& exec, double run_ns, bool json) {
+    const MessageFrameMemory* f = exec.frame();
+    const ExecutionResult& r = exec.result();
+    const int shown = std::min<int32_t>(f->stack_size, 16);
+
+    std::vector<const StorageEntry*> changed;
+    for (uint32_t i = 0; i < exec.storageCount(); i++) {
+        const StorageEntry* e = &exec.storage()[i];
+        if (std::memcmp(e->value, e->original, 32) != 0) changed.push_back(e);
+    }
+
+    if (json) {
+        std::printf("{\"state\":\"%s\",\"haltReason\":\"%s\",\"gasUsed\":%lld,\"gasRemaining\":%lld,"
+                    "\"gasRefund\":%lld,\"memorySize\":%d,\"timeNs\":%.0f,\"stack\":[",
+                    state_name(r.state), halt_name(r.halt_reason), static_cast<long long>(r.gas_used),
+                    static_cast<long long>(r.gas_remaining), static_cast<long long>(r.gas_refund),
+                    f->memory_size, run_ns);
+        for (int i = 0; i < f->stack_size; i++) {
+            std::printf("%s\"%s\"", i ? "," : "", to_quantity(exec.stackItem(i)).c_str());
+        }
+        std::printf("],\"storage\":{");
+        for (size_t i = 0; i < changed.size(); i++) {
+            std::printf("%s\"%s\":\"%s\"", i ? "," : "", to_quantity(changed[i]->key).c_str(),
+                        to_quantity(changed[i]->value).c_str());
+        }
+        std::printf("}");
+        if (first_stub() >= 0) std::printf(",\"unsupported\":\"%s\"", first_stub_name(static_cast<Revision>(f->revision)));
+        std::printf("}\n");
+        return;
+    }
+
+    std::printf("state:         %s\n", state_name(r.state));
+    if (r.halt_reason) std::printf("halt reason:   %s\n", halt_name(r.halt_reason));
+    std::printf("gas used:      %lld\n", static_cast<long long>(r.gas_used));
+    std::printf("gas remaining: %lld\n", static_cast<long long>(r.gas_remaining));
+    std::printf("gas refund:    %lld\n", static_cast<long long>(r.gas_refund));
+    std::printf("memory:        %d bytes\n", f->memory_size);
+    std::printf("stack:         %d items%s\n", f->stack_size, f->stack_size > shown ? " (top 16)" : "");
+    for (int i = 0; i < shown; i++) {
+        std::printf("  [%d] %s\n", i, to_quantity(exec.stackItem(i)).c_str());
+    }
+    if (!changed.empty()) {
+        std::printf("storage:       %zu changed\n", changed.size());
+        for (const StorageEntry* e : changed) {
+            std::printf("  %s: %s -> %s\n", to_quantity(e->key).c_str(), to_quantity(e->original).c_str(),
+                        to_quantity(e->value).c_str());
+        }
+    }
+    std::printf("execution:     %.1f us\n", run_ns / 1e3);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    std::string error;
+    if (!parse(argc, argv, options, error)) {
+        if (!error.empty()) std::fprintf(stderr, "evm-native: %s\n", error.c_str());
+        usage(argv[0]);
+        return 2;
+    }
+
+    // Pre-state as the frame takes it: a laid out TransactionWitness and its storage
+    Bytes witness_bytes;
+    std::vector<StorageEntry> storage;
+    if (!options.witness_path.empty()) {
+        Bytes data;
+        if (!read_file(options.witness_path, data)) {
+            std::fprintf(stderr, "evm-native: cannot read %s\n", options.witness_path.c_str());
+            return 1;
+        }
+        WitnessFile file;
+        const uint32_t status = witness_file::open_view(data.data(), data.size(), &file);
+        if (status == WITNESS_FILE_OK) {
+            witness_bytes.assign(file.witness, file.witness + file.witness_size);
+            storage.assign(file.storage, file.storage + file.storage_count);
+            const AccountEntry* account =
+                options.have_to ? witness_file::find_account(&file, options.call.to) : nullptr;
+            if (options.call.code.empty() && account && account->code_size > 0 &&
+                witness_file::fits(account->code_offset, account->code_size, file.witness_size)) {
+                const uint8_t* code = file.witness + account->code_offset;
+                options.call.code.assign(code, code + account->code_size);
+            }
+        } else if (status != WITNESS_FILE_BAD_MAGIC) {
+            std::fprintf(stderr, "evm-native: %s: unsupported or malformed witness file\n",
+                         options.witness_path.c_str());
+            return 1;
+        } else {
+            Witness witness;
+            if (!parse_witness_text(std::string(data.begin(), data.end()), witness, error)) {
+                std::fprintf(stderr, "evm-native: %s\n", error.c_str());
+                return 1;
+            }
+            if (options.call.code.empty() && options.have_to) {
+                if (const Witness::Account* account = witness.find(options.call.to)) options.call.code = account->code;
+            }
+            witness_bytes = serialize_witness(witness);
+            storage = witness.storage;
+        }
+    } else {
+        witness_bytes = serialize_witness(Witness());
+    }
+    if (!options.save_witness_path.empty() && !write_witness_file(options.save_witness_path, witness_bytes)) {
+        std::fprintf(stderr, "evm-native: cannot write %s\n", options.save_witness_path.c_str());
+        return 1;
+    }
+    if (options.call.code.empty()) {
+        std::fprintf(stderr, "evm-native: no code (give --code, --codefile, or --to with a witness)\n");
+        return 2;
+    }
+
+    bench::Engine engine;
+    if (!load_tool_engine(options.engine, options.lib, engine, error)) {
+        std::fprintf(stderr, "evm-native: %s\n", error.c_str());
+        return 1;
+    }
+
+    ExecFrame exec(options.call, witness_bytes, storage);
+
+    TracerCallbacks callbacks = {trace_pre, trace_post};
+    g_trace.mode = options.trace;
+    g_trace.revision = options.call.revision;
+    TracerCallbacks* tracer = options.trace == TraceMode::NONE ? stub_tracer() : &callbacks;
+
+    using Clock = std::chrono::steady_clock;
+    auto t0 = Clock::now();
+    engine.execute(exec.frame(), tracer);
+    const double run_ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+
+    print_result(exec, run_ns, options.json);
+    if (first_stub() >= 0) {
+        std::fprintf(stderr, "evm-native: warning: ran %s without a native handler (stub only charges gas); "
+                             "the result is unsupported\n",
+                     first_stub_name(options.call.revision));
+    }
+    if (options.trace == TraceMode::COUNT && !options.json) print_counts();
+
+    if (options.bench > 0) {
+        std::vector<double> times;
+        times.reserve(options.bench);
+        for (int i = 0; i < options.bench; i++) {
+            exec.reset();
+            auto start = Clock::now();
+            engine.execute(exec.frame(), nullptr);
+            times.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+        }
+        std::sort(times.begin(), times.end());
+        double total = 0;
+        for (double t : times) total += t;
+        const double median = times[times.size() / 2];
+        const double gas = static_cast<double>(exec.result().gas_used);
+        std::fprintf(options.json ? stderr : stdout,
+                     "\nbench (%s, %d runs): min %.1f us, median %.1f us, mean %.1f us, p99 %.1f us, %.1f Mgas/s\n",
+                     engine.name.c_str(), options.bench, times.front() / 1e3, median / 1e3,
+                     total / times.size() / 1e3, times[std::min(times.size() - 1, times.size() * 99 / 100)] / 1e3,
+                     median > 0 ? gas / median * 1e3 : 0.0);
+    }
+
+    if (first_stub() >= 0) return 3;
+    return exec.result().state == 7 ? 0 : 1;
+}
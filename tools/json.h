@@ -0,0 +1,269 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace besu {
+namespace evm {
+namespace tools {
+
+/**
+ * Minimal JSON document for the test fixture tools.
+ *
+ * Numbers keep their source text: fixtures encode quantities as strings anyway,
+ * and the tools parse them as 256-bit values, so nothing is lost to doubles.
+ * Objects keep member order.
+ */
+class Json {
+public:
+    enum Type { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT };
+
+    Json() = default;
+    static Json string(std::string value) {
+        Json j;
+        j.type_ = STRING;
+        j.text_ = std::move(value);
+        return j;
+    }
+
+    Type type() const { return type_; }
+    bool isNull() const { return type_ == NUL; }
+    bool isString() const { return type_ == STRING; }
+    bool isArray() const { return type_ == ARRAY; }
+    bool isObject() const { return type_ == OBJECT; }
+    bool boolean() const { return type_ == BOOL && text_ == "true"; }
+
+    /** Text of a string or number, empty otherwise. */
+    const std::string& text() const { return text_; }
+
+    const std::vector<Json>& items() const { return items_; }
+    const std::vector<std::pair<std::string, Json>>& members() const { return members_; }
+    size_t size() const { return type_ == ARRAY ? items_.size() : members_.size(); }
+
+    /** Member by name, or a null value. */
+    const Json& operator[](const std::string& name) const {
+        for (const auto& member : members_) {
+            if (member.first == name) return member.second;
+        }
+        return null_value();
+    }
+
+    /** Array item, or a null value when out of range. */
+    const Json& at(size_t index) const { return index < items_.size() ? items_[index] : null_value(); }
+
+    bool has(const std::string& name) const {
+        for (const auto& member : members_) {
+            if (member.first == name) return true;
+        }
+        return false;
+    }
+
+    /**
+     * Parse a document.
+     * @return false with error set (including the byte offset) on malformed input
+     */
+    static bool parse(const std::string& input, Json& out, std::string& error) {
+        Parser parser{input, 0, error};
+        parser.space();
+        if (!parser.value(out, 0)) return false;
+        parser.space();
+        if (parser.pos != input.size()) return parser.fail("trailing characters");
+        return true;
+    }
+
+private:
+    static const Json& null_value() {
+        static const Json null;
+        return null;
+    }
+
+    struct Parser {
+        const std::string& in;
+        size_t pos;
+        std::string& error;
+
+        static constexpr int MAX_DEPTH = 256;
+
+        bool fail(const char* what) {
+            error = std::string(what) + " at offset " + std::to_string(pos);
+            return false;
+        }
+
+        void space() {
+            while (pos < in.size() && (in[pos] == ' ' || in[pos] == '\n' || in[pos] == '\r' || in[pos] == '\t')) pos++;
+        }
+
+        bool literal(const char* word) {
+            size_t n = std::char_traits<char>::length(word);
+            if (in.compare(pos, n, word) != 0) return fail("invalid literal");
+            pos += n;
+            return true;
+        }
+
+        bool value(Json& out, int depth) {
+            if (depth > MAX_DEPTH) return fail("nesting too deep");
+            if (pos >= in.size()) return fail("unexpected end");
+            char c = in[pos];
+            if (c == '{') return object(out, depth);
+            if (c == '[') return array(out, depth);
+            if (c == '"') {
+                out.type_ = STRING;
+                return string(out.text_);
+            }
+            if (c == 't' || c == 'f') {
+                out.type_ = BOOL;
+                out.text_ = c == 't' ? "true" : "false";
+                return literal(c == 't' ? "true" : "false");
+            }
+            if (c == 'n') {
+                out.type_ = NUL;
+                return literal("null");
+            }
+            size_t start = pos;
+            while (pos < in.size() && (std::string("+-.eE").find(in[pos]) != std::string::npos ||
+                                       (in[pos] >= '0' && in[pos] <= '9'))) {
+                pos++;
+            }
+            if (pos == start) return fail("unexpected character");
+            out.type_ = NUMBER;
+            out.text_ = in.substr(start, pos - start);
+            return true;
+        }
+
+        bool string(std::string& out) {
+            pos++;  // Opening quote
+            out.clear();
+            while (pos < in.size() && in[pos] != '"') {
+                char c = in[pos++];
+                if (c != '\\') {
+                    out += c;
+                    continue;
+                }
+                if (pos >= in.size()) break;
+                char e = in[pos++];
+                switch (e) {
+                    case 'n': out += '\n'; break;
+                    case 't': out += '\t'; break;
+                    case 'r': out += '\r'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'u': {
+                        if (pos + 4 > in.size()) return fail("bad escape");
+                        unsigned code = std::stoul(in.substr(pos, 4), nullptr, 16);
+                        pos += 4;
+                        // Fixtures only escape ASCII; encode the BMP as UTF-8 for completeness
+                        if (code < 0x80) {
+                            out += static_cast<char>(code);
+                        } else if (code < 0x800) {
+                            out += static_cast<char>(0xc0 | (code >> 6));
+                            out += static_cast<char>(0x80 | (code & 0x3f));
+                        } else {
+                            out += static_cast<char>(0xe0 | (code >> 12));
+                            out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+                            out += static_cast<char>(0x80 | (code & 0x3f));
+                        }
+                        break;
+                    }
+                    default: out += e; break;
+                }
+            }
+            if (pos >= in.size()) return fail("unterminated string");
+            pos++;  // Closing quote
+            return true;
+        }
+
+        bool array(Json& out, int depth) {
+            out.type_ = ARRAY;
+            pos++;
+            space();
+            if (pos < in.size() && in[pos] == ']') {
+                pos++;
+                return true;
+            }
+            while (true) {
+                out.items_.emplace_back();
+                space();
+                if (!value(out.items_.back(), depth + 1)) return false;
+                space();
+                if (pos < in.size() && in[pos] == ',') {
+                    pos++;
+                    continue;
+                }
+                if (pos < in.size() && in[pos] == ']') {
+                    pos++;
+                    return true;
+                }
+                return fail("expected ',' or ']'");
+            }
+        }
+
+        bool object(Json& out, int depth) {
+            out.type_ = OBJECT;
+            pos++;
+            space();
+            if (pos < in.size() && in[pos] == '}') {
+                pos++;
+                return true;
+            }
+            while (true) {
+                space();
+                if (pos >= in.size() || in[pos] != '"') return fail("expected member name");
+                std::string name;
+                if (!string(name)) return false;
+                space();
+                if (pos >= in.size() || in[pos] != ':') return fail("expected ':'");
+                pos++;
+                space();
+                out.members_.emplace_back(std::move(name), Json());
+                if (!value(out.members_.back().second, depth + 1)) return false;
+                space();
+                if (pos < in.size() && in[pos] == ',') {
+                    pos++;
+                    continue;
+                }
+                if (pos < in.size() && in[pos] == '}') {
+                    pos++;
+                    return true;
+                }
+                return fail("expected ',' or '}'");
+            }
+        }
+    };
+
+    Type type_ = NUL;
+    std::string text_;
+    std::vector<Json> items_;
+    std::vector<std::pair<std::string, Json>> members_;
+};
+
+/** Quote and escape a string for JSON output. */
+inline std::string json_quote(const std::string& value) {
+    std::string out = "\"";
+    for (char c : value) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            case '\r': out += "\\r"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    out += buffer;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out + "\"";
+}
+
+} // namespace tools
+} // namespace evm
+} // namespace besu
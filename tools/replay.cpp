@@ -0,0 +1,474 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * evm-replay: re-run an execution recording (include/execution_recorder.h)
+ * offline, with timing.
+ *
+ *   BESU_EVM_RECORD=calls.rec <anything that loads the library>
+ *   evm-replay [options] calls.rec
+ *   evm-replay --engine table,goto,tailcall --repeat 20 calls.rec
+ *
+ * Every recorded call is rebuilt as a checked frame and run from its recorded
+ * input; with several engines each one runs every frame in turn and the outcomes
+ * (state, halt reason, gas, refund, stack, storage) must agree. Guarded frames
+ * replay as checked frames, so a recording from a guarded production setup can
+ * be compared against any build.
+ */
+
+#include "execution_recorder.h"
+#include "guarded_frame.h"
+#include "json.h"
+#include "tool_engine.h"
+#include "tool_util.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace besu::evm;
+using namespace besu::evm::tools;
+
+namespace {
+
+struct Options {
+    std::string path;
+    std::vector<std::string> engines;
+    std::vector<std::string> libs;
+    std::string json_path;
+    int repeat = 5;
+    size_t limit = 0;
+    int slowest = 10;
+};
+
+void usage(const char* argv0) {
+    std::fprintf(stderr,
+        "Usage: %s [options] <recording>\n"
+        "\n"
+        "  --engine LIST        Dispatch variants to compare, comma-separated (needs BESU_BUILD_BENCH)\n"
+        "  --lib PATH           Interpreter library to load (repeatable)\n"
+        "  --repeat N           Time each frame as the median of N runs (default 5)\n"
+        "  --limit N            Only replay the first N frames\n"
+        "  --slowest N          List the N slowest frames (default 10, 0 = none)\n"
+        "  --json FILE          Write every frame with its outcome and timing per engine\n"
+        "\n"
+        "Record with BESU_EVM_RECORD=<file> in the environment of any process that\n"
+        "loads the library, or with besu_recorder_start().\n",
+        argv0);
+}
+
+bool parse(int argc, char** argv, Options& options, std::string& error) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") return false;
+        if (arg.compare(0, 2, "--") != 0) {
+            options.path = arg;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            error = arg + " needs a value";
+            return false;
+        }
+        std::string value = argv[++i];
+        bool ok = true;
+        if (arg == "--engine") {
+            size_t start = 0;
+            while (start <= value.size()) {
+                size_t comma = value.find(',', start);
+                if (comma == std::string::npos) comma = value.size();
+                if (comma > start) options.engines.push_back(value.substr(start, comma - start));
+                start = comma + 1;
+            }
+        } else if (arg == "--lib") {
+            options.libs.push_back(value);
+        } else if (arg == "--repeat") {
+            options.repeat = std::atoi(value.c_str());
+            ok = options.repeat > 0;
+        } else if (arg == "--limit") {
+            options.limit = static_cast<size_t>(std::atoll(value.c_str()));
+        } else if (arg == "--slowest") {
+            options.slowest = std::atoi(value.c_str());
+            ok = options.slowest >= 0;
+        } else if (arg == "--json") {
+            options.json_path = value;
+        } else {
+            error = "unknown option " + arg;
+            return false;
+        }
+        if (!ok) {
+            error = "bad value for " + arg + ": " + value;
+            return false;
+        }
+    }
+    if (options.path.empty()) {
+        error = "no recording given";
+        return false;
+    }
+    return true;
+}
+
+// ===== FRAMES =====
+
+/** What a run left behind, compared across engines. */
+struct Outcome {
+    uint32_t state = 0;
+    uint32_t halt_reason = 0;
+    int64_t gas_remaining = 0;
+    int64_t gas_refund = 0;
+    Bytes stack;
+    Bytes storage;
+
+    bool operator==(const Outcome& o) const {
+        return state == o.state && halt_reason == o.halt_reason && gas_remaining == o.gas_remaining &&
+               gas_refund == o.gas_refund && stack == o.stack && storage == o.storage;
+    }
+    bool operator!=(const Outcome& o) const { return !(*this == o); }
+};
+
+/**
+ * One recorded call laid out again as a checked frame (the ExecFrame layout),
+ * restored to its recorded input before every run.
+ */
+class ReplayFrame {
+public:
+    static constexpr uint64_t MEMORY_CAPACITY = 1024 * 1024;
+
+    /** record points at a RecordedFrame whose size has been checked against the file. */
+    explicit ReplayFrame(const uint8_t* record) {
+        const RecordedFrame* rec = reinterpret_cast<const RecordedFrame*>(record);
+        sequence_ = rec->sequence;
+        flags_ = rec->flags;
+        std::memcpy(&initial_, record + sizeof(RecordedFrame), sizeof(MessageFrameMemory));
+
+        const uint8_t* sections[RECORD_SECTION_COUNT];
+        const uint8_t* at = record + sizeof(RecordedFrame) + sizeof(MessageFrameMemory);
+        for (uint32_t s = 0; s < RECORD_SECTION_COUNT; s++) {
+            sections[s] = at;
+            at += align(rec->section_size[s], 8);
+        }
+        stack_.assign(sections[RECORD_STACK], sections[RECORD_STACK] + rec->section_size[RECORD_STACK]);
+        memory_.assign(sections[RECORD_MEMORY], sections[RECORD_MEMORY] + rec->section_size[RECORD_MEMORY]);
+        const uint64_t slots = rec->section_size[RECORD_STORAGE] / sizeof(StorageEntry);
+        storage_.resize(slots);
+        if (slots) std::memcpy(storage_.data(), sections[RECORD_STORAGE], slots * sizeof(StorageEntry));
+        code_size_ = rec->section_size[RECORD_CODE];
+
+        const uint32_t max_slots = std::max<uint32_t>(initial_.max_storage_slots, static_cast<uint32_t>(slots));
+        const uint64_t memory_capacity = std::max<uint64_t>(MEMORY_CAPACITY, memory_.size());
+        const bool has_storage = initial_.storage_ptr != 0;
+        const bool has_witness = initial_.witness_ptr != 0;
+
+        uint64_t pos = sizeof(MessageFrameMemory);
+        const uint64_t stack_off = pos;
+        pos += MAX_STACK_SIZE * STACK_ITEM_SIZE;
+        const uint64_t memory_off = pos;
+        pos += memory_capacity;
+        const uint64_t code_off = pos;
+        pos = align(pos + rec->section_size[RECORD_CODE]);
+        const uint64_t input_off = pos;
+        pos = align(pos + rec->section_size[RECORD_INPUT]);
+        const uint64_t storage_off = pos;
+        pos = align(pos + (has_storage ? uint64_t(max_slots) * sizeof(StorageEntry) : 0));
+        const uint64_t witness_off = pos;
+        pos = align(pos + rec->section_size[RECORD_WITNESS]);
+        const uint64_t result_off = pos;
+        pos += sizeof(ExecutionResult);
+
+        const uint64_t size = align(pos, 4096);
+        base_ = static_cast<uint8_t*>(std::aligned_alloc(4096, size));
+        std::memset(base_, 0, pos);
+
+        MessageFrameMemory& f = initial_;
+        f.stack_ptr = stack_off;
+        f.memory_ptr = memory_off;
+        f.code_ptr = code_off;
+        f.input_ptr = input_off;
+        f.storage_ptr = has_storage ? storage_off : 0;
+        f.max_storage_slots = has_storage ? max_slots : 0;
+        f.witness_ptr = has_witness ? witness_off : 0;
+        f.result_ptr = result_off;
+        f.code_size = static_cast<uint32_t>(rec->section_size[RECORD_CODE]);
+        f.input_size = static_cast<uint32_t>(rec->section_size[RECORD_INPUT]);
+        f.flags &= ~FRAME_FLAG_GUARDED;  // No GuardedFrameControl behind this header
+
+        std::memcpy(base_ + code_off, sections[RECORD_CODE], rec->section_size[RECORD_CODE]);
+        std::memcpy(base_ + input_off, sections[RECORD_INPUT], rec->section_size[RECORD_INPUT]);
+        if (has_witness) std::memcpy(base_ + witness_off, sections[RECORD_WITNESS], rec->section_size[RECORD_WITNESS]);
+    }
+
+    ~ReplayFrame() { std::free(base_); }
+
+    ReplayFrame(const ReplayFrame&) = delete;
+    ReplayFrame& operator=(const ReplayFrame&) = delete;
+
+    void reset() {
+        std::memcpy(base_, &initial_, sizeof(MessageFrameMemory));
+        if (!stack_.empty()) std::memcpy(base_ + initial_.stack_ptr, stack_.data(), stack_.size());
+        // Memory past memory_size is zeroed again by the interpreter as it grows
+        if (!memory_.empty()) std::memcpy(base_ + initial_.memory_ptr, memory_.data(), memory_.size());
+        if (!storage_.empty()) {
+            std::memcpy(base_ + initial_.storage_ptr, storage_.data(), storage_.size() * sizeof(StorageEntry));
+        }
+    }
+
+    MessageFrameMemory* frame() { return reinterpret_cast<MessageFrameMemory*>(base_); }
+
+    Outcome outcome() const {
+        const MessageFrameMemory* f = reinterpret_cast<const MessageFrameMemory*>(base_);
+        Outcome o;
+        o.state = f->state;
+        o.halt_reason = f->halt_reason;
+        o.gas_remaining = f->gas_remaining;
+        o.gas_refund = f->gas_refund;
+        const uint64_t stack_bytes = uint64_t(std::max<int32_t>(f->stack_size, 0)) * STACK_ITEM_SIZE;
+        o.stack.assign(base_ + f->stack_ptr, base_ + f->stack_ptr + stack_bytes);
+        if (f->storage_ptr) {
+            const uint8_t* storage = base_ + f->storage_ptr;
+            o.storage.assign(storage, storage + uint64_t(f->storage_slot_count) * sizeof(StorageEntry));
+        }
+        return o;
+    }
+
+    uint64_t sequence() const { return sequence_; }
+    uint32_t flags() const { return flags_; }
+    uint64_t codeSize() const { return code_size_; }
+    int64_t gasLimit() const { return initial_.gas_remaining; }
+    const MessageFrameMemory& initial() const { return initial_; }
+
+private:
+    static uint64_t align(uint64_t n, uint64_t to = 64) { return (n + to - 1) / to * to; }
+
+    MessageFrameMemory initial_;
+    Bytes stack_;
+    Bytes memory_;
+    std::vector<StorageEntry> storage_;
+    uint8_t* base_ = nullptr;
+    uint64_t sequence_ = 0;
+    uint64_t code_size_ = 0;
+    uint32_t flags_ = 0;
+};
+
+/**
+ * Split a recording into frames.
+ * @return false with error set on a bad header or a truncated or corrupt record
+ */
+bool load_recording(const Bytes& data, size_t limit, std::vector<ReplayFrame*>& frames, std::string& error) {
+    if (data.size() < sizeof(RecordingHeader)) {
+        error = "not a recording (too short)";
+        return false;
+    }
+    RecordingHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != RECORDING_MAGIC) {
+        error = "not a recording (bad magic)";
+        return false;
+    }
+    if (header.version != RECORDING_VERSION) {
+        error = "unsupported recording version " + std::to_string(header.version);
+        return false;
+    }
+    if (header.frame_header_size != sizeof(MessageFrameMemory)) {
+        error = "recorded with a " + std::to_string(header.frame_header_size) + "-byte frame header, this build uses " +
+                std::to_string(sizeof(MessageFrameMemory));
+        return false;
+    }
+
+    size_t at = sizeof(RecordingHeader);
+    while (at < data.size() && (limit == 0 || frames.size() < limit)) {
+        const size_t left = data.size() - at;
+        RecordedFrame rec;
+        if (left < sizeof(rec)) {
+            error = "truncated record at byte " + std::to_string(at);
+            return false;
+        }
+        std::memcpy(&rec, data.data() + at, sizeof(rec));
+        uint64_t needed = sizeof(RecordedFrame) + sizeof(MessageFrameMemory);
+        for (uint64_t size : rec.section_size) needed += (size + 7) & ~uint64_t(7);
+        if (rec.magic == RECORDED_FRAME_MAGIC && rec.size == needed && rec.size > left) {
+            error = "truncated record at byte " + std::to_string(at);
+            return false;
+        }
+        if (rec.magic != RECORDED_FRAME_MAGIC || rec.size != needed ||
+            rec.section_size[RECORD_STACK] > MAX_STACK_SIZE * STACK_ITEM_SIZE ||
+            rec.section_size[RECORD_STORAGE] % sizeof(StorageEntry) != 0) {
+            error = "corrupt record at byte " + std::to_string(at);
+            return false;
+        }
+        // Records are 8-byte aligned in the file; copy out so the frame header is too
+        Bytes copy(data.begin() + at, data.begin() + at + rec.size);
+        frames.push_back(new ReplayFrame(copy.data()));
+        at += rec.size;
+    }
+    return true;
+}
+
+// ===== RUNS =====
+
+struct FrameRun {
+    ReplayFrame* frame = nullptr;
+    int64_t gas_used = 0;
+    uint32_t state = 0;
+    std::vector<double> median_ns;  // Per engine
+    bool mismatch = false;
+};
+
+double median_run(const bench::Engine& engine, ReplayFrame& frame, int repeat, std::vector<double>& times) {
+    using Clock = std::chrono::steady_clock;
+    times.clear();
+    for (int i = 0; i < repeat; i++) {
+        frame.reset();
+        auto start = Clock::now();
+        engine.execute(frame.frame(), nullptr);
+        times.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+void write_json(const std::string& path, const std::vector<bench::Engine>& engines, const std::vector<FrameRun>& runs) {
+    FILE* out = std::fopen(path.c_str(), "w");
+    if (!out) {
+        std::fprintf(stderr, "evm-replay: cannot write %s\n", path.c_str());
+        return;
+    }
+    std::fprintf(out, "{\"engines\":[");
+    for (size_t e = 0; e < engines.size(); e++) {
+        std::fprintf(out, "%s%s", e ? "," : "", json_quote(engines[e].name).c_str());
+    }
+    std::fprintf(out, "],\"frames\":[");
+    for (size_t i = 0; i < runs.size(); i++) {
+        const FrameRun& r = runs[i];
+        std::fprintf(out, "%s\n{\"sequence\":%llu,\"codeSize\":%llu,\"gasUsed\":%lld,\"state\":\"%s\",\"match\":%s,\"timeNs\":[",
+                     i ? "," : "", static_cast<unsigned long long>(r.frame->sequence()),
+                     static_cast<unsigned long long>(r.frame->codeSize()), static_cast<long long>(r.gas_used),
+                     state_name(r.state), r.mismatch ? "false" : "true");
+        for (size_t e = 0; e < r.median_ns.size(); e++) std::fprintf(out, "%s%.0f", e ? "," : "", r.median_ns[e]);
+        std::fprintf(out, "]}");
+    }
+    std::fprintf(out, "\n]}\n");
+    std::fclose(out);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    std::string error;
+    if (!parse(argc, argv, options, error)) {
+        if (!error.empty()) std::fprintf(stderr, "evm-replay: %s\n", error.c_str());
+        usage(argv[0]);
+        return 2;
+    }
+
+    // The engines loaded below must not append to a recording of their own
+    unsetenv("BESU_EVM_RECORD");
+
+    std::vector<bench::Engine> engines;
+    for (const std::string& name : options.engines) {
+        bench::Engine engine;
+        if (!load_tool_engine(name, "", engine, error)) {
+            std::fprintf(stderr, "evm-replay: %s\n", error.c_str());
+            return 1;
+        }
+        engines.push_back(engine);
+    }
+    for (const std::string& lib : options.libs) {
+        bench::Engine engine;
+        if (!load_tool_engine("", lib, engine, error)) {
+            std::fprintf(stderr, "evm-replay: %s\n", error.c_str());
+            return 1;
+        }
+        engines.push_back(engine);
+    }
+    if (engines.empty()) {
+        bench::Engine engine;
+        if (!load_tool_engine("", "", engine, error)) {
+            std::fprintf(stderr, "evm-replay: %s\n", error.c_str());
+            return 1;
+        }
+        engines.push_back(engine);
+    }
+
+    Bytes data;
+    if (!read_file(options.path, data)) {
+        std::fprintf(stderr, "evm-replay: cannot read %s\n", options.path.c_str());
+        return 1;
+    }
+    std::vector<ReplayFrame*> frames;
+    if (!load_recording(data, options.limit, frames, error)) {
+        std::fprintf(stderr, "evm-replay: %s: %s\n", options.path.c_str(), error.c_str());
+        for (ReplayFrame* frame : frames) delete frame;
+        return 1;
+    }
+    data = Bytes();
+
+    // Engines take turns on each frame, so drift (thermal, frequency) hits all of them alike
+    std::vector<FrameRun> runs(frames.size());
+    std::vector<double> times;
+    size_t mismatches = 0;
+    for (size_t i = 0; i < frames.size(); i++) {
+        FrameRun& run = runs[i];
+        run.frame = frames[i];
+        Outcome reference;
+        for (size_t e = 0; e < engines.size(); e++) {
+            run.frame->reset();
+            engines[e].execute(run.frame->frame(), nullptr);
+            Outcome outcome = run.frame->outcome();
+            if (e == 0) {
+                reference = outcome;
+                run.state = outcome.state;
+                run.gas_used = run.frame->gasLimit() - outcome.gas_remaining;
+            } else if (outcome != reference && !run.mismatch) {
+                run.mismatch = true;
+                mismatches++;
+                std::printf("MISMATCH frame %llu: %s gives %s/%s gas %lld, %s gives %s/%s gas %lld\n",
+                            static_cast<unsigned long long>(run.frame->sequence()), engines[0].name.c_str(),
+                            state_name(reference.state), halt_name(reference.halt_reason),
+                            static_cast<long long>(reference.gas_remaining), engines[e].name.c_str(),
+                            state_name(outcome.state), halt_name(outcome.halt_reason),
+                            static_cast<long long>(outcome.gas_remaining));
+            }
+            run.median_ns.push_back(median_run(engines[e], *run.frame, options.repeat, times));
+        }
+    }
+
+    uint64_t total_gas = 0, guarded = 0;
+    for (const FrameRun& run : runs) {
+        total_gas += static_cast<uint64_t>(std::max<int64_t>(run.gas_used, 0));
+        guarded += (run.frame->flags() & RECORD_FLAG_GUARDED) != 0;
+    }
+    std::printf("%zu frames (%llu recorded as guarded), %llu gas, median of %d runs\n\n", runs.size(),
+                static_cast<unsigned long long>(guarded), static_cast<unsigned long long>(total_gas), options.repeat);
+    std::printf("%-12s %14s %12s\n", "engine", "time (ms)", "Mgas/s");
+    for (size_t e = 0; e < engines.size(); e++) {
+        double ns = 0;
+        for (const FrameRun& run : runs) ns += run.median_ns[e];
+        std::printf("%-12s %14.3f %12.1f\n", engines[e].name.c_str(), ns / 1e6,
+                    ns > 0 ? static_cast<double>(total_gas) / ns * 1e3 : 0.0);
+    }
+
+    std::vector<const FrameRun*> slowest;
+    for (const FrameRun& run : runs) slowest.push_back(&run);
+    std::sort(slowest.begin(), slowest.end(),
+              [](const FrameRun* a, const FrameRun* b) { return a->median_ns[0] > b->median_ns[0]; });
+    if (options.slowest > 0 && !slowest.empty()) {
+        std::printf("\nslowest frames (%s):\n", engines[0].name.c_str());
+        for (size_t i = 0; i < slowest.size() && i < static_cast<size_t>(options.slowest); i++) {
+            const FrameRun* run = slowest[i];
+            const MessageFrameMemory& f = run->frame->initial();
+            std::printf("  %10.1f us %10lld gas  frame %llu, %s, %llu bytes of code [%s]\n", run->median_ns[0] / 1e3,
+                        static_cast<long long>(run->gas_used), static_cast<unsigned long long>(run->frame->sequence()),
+                        to_hex(f.contract, 20).c_str(), static_cast<unsigned long long>(run->frame->codeSize()),
+                        state_name(run->state));
+        }
+    }
+    if (engines.size() > 1) {
+        std::printf("\n%zu of %zu frames differ between engines\n", mismatches, runs.size());
+    }
+
+    if (!options.json_path.empty()) write_json(options.json_path, engines, runs);
+    for (ReplayFrame* frame : frames) delete frame;
+    return mismatches ? 1 : 0;
+}
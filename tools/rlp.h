@@ -0,0 +1,171 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "keccak.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace besu {
+namespace evm {
+namespace tools {
+
+/**
+ * RLP encoding and Merkle Patricia trie roots, enough to hash post-states and
+ * logs the way the test fixtures do. Tries are built from the full key set in
+ * one pass; nothing is stored or updated incrementally.
+ */
+namespace rlp {
+
+typedef std::vector<uint8_t> Bytes;
+
+inline void append_length(Bytes& out, size_t length, uint8_t short_base, uint8_t long_base) {
+    if (length < 56) {
+        out.push_back(static_cast<uint8_t>(short_base + length));
+        return;
+    }
+    uint8_t digits[8];
+    int n = 0;
+    for (size_t v = length; v; v >>= 8) digits[n++] = static_cast<uint8_t>(v);
+    out.push_back(static_cast<uint8_t>(long_base + n));
+    while (n) out.push_back(digits[--n]);
+}
+
+/** Encode a byte string. */
+inline Bytes string(const uint8_t* data, size_t size) {
+    Bytes out;
+    if (size == 1 && data[0] < 0x80) {
+        out.push_back(data[0]);
+        return out;
+    }
+    append_length(out, size, 0x80, 0xb7);
+    out.insert(out.end(), data, data + size);
+    return out;
+}
+
+inline Bytes string(const Bytes& data) { return string(data.data(), data.size()); }
+
+/** Encode a big-endian integer without its leading zero bytes. */
+inline Bytes integer(const uint8_t* data, size_t size) {
+    while (size && *data == 0) {
+        data++;
+        size--;
+    }
+    return string(data, size);
+}
+
+inline Bytes integer(uint64_t value) {
+    uint8_t bytes[8];
+    for (int i = 7; i >= 0; i--) {
+        bytes[i] = static_cast<uint8_t>(value);
+        value >>= 8;
+    }
+    return integer(bytes, 8);
+}
+
+/** Encode a list of already encoded items. */
+inline Bytes list(const std::vector<Bytes>& items) {
+    size_t payload = 0;
+    for (const Bytes& item : items) payload += item.size();
+    Bytes out;
+    out.reserve(payload + 9);
+    append_length(out, payload, 0xc0, 0xf7);
+    for (const Bytes& item : items) out.insert(out.end(), item.begin(), item.end());
+    return out;
+}
+
+// ===== TRIE =====
+
+namespace detail {
+
+struct Item {
+    Bytes nibbles;
+    const Bytes* value;
+};
+
+/** Hex-prefix encoding of a nibble path (Yellow Paper appendix C). */
+inline Bytes hex_prefix(const Bytes& nibbles, size_t from, size_t to, bool leaf) {
+    const size_t n = to - from;
+    Bytes out;
+    out.push_back(static_cast<uint8_t>((leaf ? 0x20 : 0) | (n % 2 ? 0x10 | nibbles[from] : 0)));
+    for (size_t i = from + n % 2; i < to; i += 2) out.push_back(static_cast<uint8_t>(nibbles[i] << 4 | nibbles[i + 1]));
+    return out;
+}
+
+/** Reference to a child node: inline if its encoding is under 32 bytes, else its hash. */
+inline Bytes reference(const Bytes& node) {
+    if (node.size() < 32) return node;
+    uint8_t hash[32];
+    keccak::keccak256(node.data(), node.size(), hash);
+    return string(hash, 32);
+}
+
+/** Encode the node for items[begin, end), sorted, sharing their first depth nibbles. */
+inline Bytes node(const std::vector<Item>& items, size_t begin, size_t end, size_t depth) {
+    if (end - begin == 1) {
+        const Item& item = items[begin];
+        return list({string(hex_prefix(item.nibbles, depth, item.nibbles.size(), true)), string(*item.value)});
+    }
+
+    // Extension over the prefix every key shares beyond depth
+    const Bytes& first = items[begin].nibbles;
+    const Bytes& last = items[end - 1].nibbles;
+    size_t common = depth;
+    while (common < first.size() && common < last.size() && first[common] == last[common]) common++;
+    if (common > depth) {
+        return list({string(hex_prefix(first, depth, common, false)), reference(node(items, begin, end, common))});
+    }
+
+    // Branch: a key ending here holds the value slot (sorted first), the rest split by nibble
+    std::vector<Bytes> slots(17, string(nullptr, 0));
+    size_t i = begin;
+    if (items[i].nibbles.size() == depth) {
+        slots[16] = string(*items[i].value);
+        i++;
+    }
+    while (i < end) {
+        const uint8_t nibble = items[i].nibbles[depth];
+        size_t j = i;
+        while (j < end && items[j].nibbles[depth] == nibble) j++;
+        slots[nibble] = reference(node(items, i, j, depth + 1));
+        i = j;
+    }
+    return list(slots);
+}
+
+} // namespace detail
+
+/**
+ * Root hash of the trie holding the given key/value pairs. Keys must be unique;
+ * secure tries (state, storage) pass hashed keys. Empty values are not inserted.
+ */
+inline void trie_root(const std::vector<std::pair<Bytes, Bytes>>& entries, uint8_t root[32]) {
+    std::vector<detail::Item> items;
+    items.reserve(entries.size());
+    for (const auto& entry : entries) {
+        if (entry.second.empty()) continue;
+        detail::Item item;
+        for (uint8_t b : entry.first) {
+            item.nibbles.push_back(b >> 4);
+            item.nibbles.push_back(b & 0xf);
+        }
+        item.value = &entry.second;
+        items.push_back(std::move(item));
+    }
+    std::sort(items.begin(), items.end(),
+              [](const detail::Item& a, const detail::Item& b) { return a.nibbles < b.nibbles; });
+
+    // The root is always hashed, however short its encoding
+    const Bytes encoded = items.empty() ? string(nullptr, 0) : detail::node(items, 0, items.size(), 0);
+    keccak::keccak256(encoded.data(), encoded.size(), root);
+}
+
+} // namespace rlp
+
+} // namespace tools
+} // namespace evm
+} // namespace besu
@@ -0,0 +1,265 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "keccak.h"
+#include <cstdint>
+#include <cstring>
+
+namespace besu {
+namespace evm {
+namespace tools {
+
+/**
+ * secp256k1 for the fixture tools: addresses from secret keys and sender
+ * recovery from transaction signatures.
+ *
+ * Plain variable-time arithmetic on four 64-bit limbs, Jacobian coordinates and
+ * double-and-add. Fine for test vectors and fuzz inputs; never use it on a key
+ * that matters.
+ */
+namespace secp256k1 {
+
+struct U256 {
+    uint64_t limb[4];  // limb[0] = least significant
+};
+
+inline U256 from_bytes(const uint8_t in[32]) {
+    U256 out = {};
+    for (int i = 0; i < 32; i++) out.limb[3 - i / 8] = (out.limb[3 - i / 8] << 8) | in[i];
+    return out;
+}
+
+inline void to_bytes(const U256& in, uint8_t out[32]) {
+    for (int i = 0; i < 32; i++) out[i] = static_cast<uint8_t>(in.limb[3 - i / 8] >> (56 - 8 * (i % 8)));
+}
+
+inline bool is_zero(const U256& a) { return (a.limb[0] | a.limb[1] | a.limb[2] | a.limb[3]) == 0; }
+
+inline int compare(const U256& a, const U256& b) {
+    for (int i = 3; i >= 0; i--) {
+        if (a.limb[i] != b.limb[i]) return a.limb[i] < b.limb[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+/** a - b mod 2^256, returning the borrow. */
+inline uint64_t sub(const U256& a, const U256& b, U256& out) {
+    uint64_t borrow = 0;
+    for (int i = 0; i < 4; i++) {
+        const uint64_t d = a.limb[i] - b.limb[i];
+        const uint64_t b1 = a.limb[i] < b.limb[i];
+        out.limb[i] = d - borrow;
+        borrow = b1 | (d < borrow);
+    }
+    return borrow;
+}
+
+/** a + b mod 2^256, returning the carry. */
+inline uint64_t add(const U256& a, const U256& b, U256& out) {
+    uint64_t carry = 0;
+    for (int i = 0; i < 4; i++) {
+        const uint64_t s = a.limb[i] + carry;
+        const uint64_t c1 = s < carry;
+        out.limb[i] = s + b.limb[i];
+        carry = c1 | (out.limb[i] < s);
+    }
+    return carry;
+}
+
+/**
+ * A prime modulus of the form 2^256 - c: both the field prime and the group
+ * order of secp256k1 are, so 2^256 folds down as c when reducing.
+ */
+struct Modulus {
+    U256 m;
+    U256 c;  // 2^256 - m
+
+    U256 add(const U256& a, const U256& b) const {
+        U256 out;
+        // On carry out of 2^256, adding c subtracts m
+        if (secp256k1::add(a, b, out)) secp256k1::add(out, c, out);
+        if (compare(out, m) >= 0) secp256k1::sub(out, m, out);
+        return out;
+    }
+
+    U256 sub(const U256& a, const U256& b) const {
+        U256 out;
+        if (secp256k1::sub(a, b, out)) secp256k1::add(out, m, out);
+        return out;
+    }
+
+    U256 mul(const U256& a, const U256& b) const {
+        __extension__ typedef unsigned __int128 uint128;
+        uint64_t wide[9] = {};
+        for (int i = 0; i < 4; i++) {
+            uint64_t carry = 0;
+            for (int j = 0; j < 4; j++) {
+                uint128 t = static_cast<uint128>(a.limb[i]) * b.limb[j] + wide[i + j] + carry;
+                wide[i + j] = static_cast<uint64_t>(t);
+                carry = static_cast<uint64_t>(t >> 64);
+            }
+            wide[i + 4] = carry;
+        }
+        // Fold hi * 2^256 into hi * c until the high half is gone; c < 2^129 so
+        // this takes at most three rounds
+        while (wide[4] | wide[5] | wide[6] | wide[7] | wide[8]) {
+            uint64_t next[9] = {wide[0], wide[1], wide[2], wide[3], 0, 0, 0, 0, 0};
+            for (int i = 0; i < 5; i++) {
+                uint64_t carry = 0;
+                for (int j = 0; j < 4; j++) {
+                    uint128 t = static_cast<uint128>(wide[4 + i]) * c.limb[j] + next[i + j] + carry;
+                    next[i + j] = static_cast<uint64_t>(t);
+                    carry = static_cast<uint64_t>(t >> 64);
+                }
+                for (int k = i + 4; carry && k < 9; k++) {
+                    next[k] += carry;
+                    carry = next[k] < carry;
+                }
+            }
+            std::memcpy(wide, next, sizeof(wide));
+        }
+        U256 out = {{wide[0], wide[1], wide[2], wide[3]}};
+        while (compare(out, m) >= 0) secp256k1::sub(out, m, out);
+        return out;
+    }
+
+    U256 pow(U256 base, const U256& exponent) const {
+        U256 result = {{1, 0, 0, 0}};
+        for (int bit = 0; bit < 256; bit++) {
+            if (exponent.limb[bit / 64] >> (bit % 64) & 1) result = mul(result, base);
+            base = mul(base, base);
+        }
+        return result;
+    }
+
+    /** Inverse by Fermat's little theorem (m is prime). */
+    U256 inverse(const U256& a) const {
+        U256 e;
+        secp256k1::sub(m, U256{{2, 0, 0, 0}}, e);
+        return pow(a, e);
+    }
+};
+
+inline const Modulus& field() {
+    static const Modulus p = {{{0xfffffffefffffc2full, ~0ull, ~0ull, ~0ull}}, {{0x1000003d1ull, 0, 0, 0}}};
+    return p;
+}
+
+inline const Modulus& order() {
+    static const Modulus n = {{{0xbfd25e8cd0364141ull, 0xbaaedce6af48a03bull, 0xfffffffffffffffeull, ~0ull}},
+                              {{0x402da1732fc9bebfull, 0x4551231950b75fc4ull, 1, 0}}};
+    return n;
+}
+
+// ===== CURVE =====
+
+/** Jacobian point (X / Z^2, Y / Z^3); Z = 0 is infinity. */
+struct Point {
+    U256 x, y, z;
+};
+
+inline Point generator() {
+    return {{{0x59f2815b16f81798ull, 0x029bfcdb2dce28d9ull, 0x55a06295ce870b07ull, 0x79be667ef9dcbbacull}},
+            {{0x9c47d08ffb10d4b8ull, 0xfd17b448a6855419ull, 0x5da4fbfc0e1108a8ull, 0x483ada7726a3c465ull}},
+            {{1, 0, 0, 0}}};
+}
+
+inline Point twice(const Point& p) {
+    const Modulus& f = field();
+    if (is_zero(p.z) || is_zero(p.y)) return {{}, {}, {}};
+    const U256 yy = f.mul(p.y, p.y);
+    const U256 s = f.mul(U256{{4, 0, 0, 0}}, f.mul(p.x, yy));
+    const U256 m = f.mul(U256{{3, 0, 0, 0}}, f.mul(p.x, p.x));  // a = 0
+    Point r;
+    r.x = f.sub(f.mul(m, m), f.add(s, s));
+    r.y = f.sub(f.mul(m, f.sub(s, r.x)), f.mul(U256{{8, 0, 0, 0}}, f.mul(yy, yy)));
+    r.z = f.mul(U256{{2, 0, 0, 0}}, f.mul(p.y, p.z));
+    return r;
+}
+
+inline Point plus(const Point& p, const Point& q) {
+    const Modulus& f = field();
+    if (is_zero(p.z)) return q;
+    if (is_zero(q.z)) return p;
+    const U256 pz2 = f.mul(p.z, p.z), qz2 = f.mul(q.z, q.z);
+    const U256 u1 = f.mul(p.x, qz2), u2 = f.mul(q.x, pz2);
+    const U256 s1 = f.mul(p.y, f.mul(q.z, qz2)), s2 = f.mul(q.y, f.mul(p.z, pz2));
+    if (compare(u1, u2) == 0) return compare(s1, s2) == 0 ? twice(p) : Point{{}, {}, {}};
+    const U256 h = f.sub(u2, u1), r = f.sub(s2, s1);
+    const U256 hh = f.mul(h, h), hhh = f.mul(h, hh), v = f.mul(u1, hh);
+    Point out;
+    out.x = f.sub(f.sub(f.mul(r, r), hhh), f.add(v, v));
+    out.y = f.sub(f.mul(r, f.sub(v, out.x)), f.mul(s1, hhh));
+    out.z = f.mul(h, f.mul(p.z, q.z));
+    return out;
+}
+
+inline Point multiply(const Point& p, const U256& k) {
+    Point result = {{}, {}, {}};
+    for (int bit = 255; bit >= 0; bit--) {
+        result = twice(result);
+        if (k.limb[bit / 64] >> (bit % 64) & 1) result = plus(result, p);
+    }
+    return result;
+}
+
+/** Address of an affine public key: the last 20 bytes of keccak256(x || y). */
+inline bool address_of(const Point& p, uint8_t address[20]) {
+    if (is_zero(p.z)) return false;
+    const Modulus& f = field();
+    const U256 zi = f.inverse(p.z), zi2 = f.mul(zi, zi);
+    uint8_t key[64], hash[32];
+    to_bytes(f.mul(p.x, zi2), key);
+    to_bytes(f.mul(p.y, f.mul(zi, zi2)), key + 32);
+    keccak::keccak256(key, 64, hash);
+    std::memcpy(address, hash + 12, 20);
+    return true;
+}
+
+/** Address controlled by a secret key; false if the key is out of range. */
+inline bool secret_to_address(const uint8_t secret[32], uint8_t address[20]) {
+    const U256 d = from_bytes(secret);
+    if (is_zero(d) || compare(d, order().m) >= 0) return false;
+    return address_of(multiply(generator(), d), address);
+}
+
+/**
+ * Recover the signer's address from a message hash and signature (ecrecover).
+ * recovery_id is the y parity of R (0 or 1). Enforces EIP-2's low s.
+ * @return false for an invalid signature
+ */
+inline bool recover(const uint8_t hash[32], const uint8_t r_bytes[32], const uint8_t s_bytes[32], unsigned recovery_id,
+                    uint8_t address[20]) {
+    const Modulus& f = field();
+    const Modulus& n = order();
+    const U256 r = from_bytes(r_bytes), s = from_bytes(s_bytes);
+    U256 half_n = n.m;
+    for (int i = 0; i < 4; i++) half_n.limb[i] = (n.m.limb[i] >> 1) | (i < 3 ? n.m.limb[i + 1] << 63 : 0);
+    if (recovery_id > 1 || is_zero(r) || is_zero(s) || compare(r, n.m) >= 0 || compare(s, half_n) > 0) return false;
+
+    // R = (r, y) with y^2 = r^3 + 7 and the requested parity; p = 3 mod 4, so sqrt = a^((p+1)/4)
+    const U256 rhs = f.add(f.mul(r, f.mul(r, r)), U256{{7, 0, 0, 0}});
+    U256 exponent;
+    secp256k1::add(f.m, U256{{1, 0, 0, 0}}, exponent);
+    for (int i = 0; i < 4; i++) exponent.limb[i] = (exponent.limb[i] >> 2) | (i < 3 ? exponent.limb[i + 1] << 62 : 0);
+    U256 y = f.pow(rhs, exponent);
+    if (compare(f.mul(y, y), rhs) != 0) return false;
+    if ((y.limb[0] & 1) != recovery_id) y = f.sub(U256{}, y);
+
+    // Q = r^-1 (s R - z G)
+    const U256 r_inv = n.inverse(r);
+    U256 z = from_bytes(hash);
+    if (compare(z, n.m) >= 0) secp256k1::sub(z, n.m, z);
+    const U256 u1 = n.sub(U256{}, n.mul(z, r_inv));
+    const U256 u2 = n.mul(s, r_inv);
+    const Point q = plus(multiply(generator(), u1), multiply(Point{r, y, {{1, 0, 0, 0}}}, u2));
+    return address_of(q, address);
+}
+
+} // namespace secp256k1
+
+} // namespace tools
+} // namespace evm
+} // namespace besu
@@ -0,0 +1,382 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * evm-statetest: run GeneralStateTests fixtures on the native interpreter.
+ *
+ *   evm-statetest [options] <fixture.json | directory>...
+ *
+ * Every (test, fork, data/gas/value index) case builds its state from `pre`,
+ * applies the transaction (state_transition.h) and compares the post-state root
+ * and logs hash with the fixture. execute_message is timed per case, so the
+ * slowest cases double as a performance corpus.
+ *
+ * Cases the native path cannot run are reported as unsupported, not failed:
+ * forks before Istanbul, contract creation, precompiles, blob and set-code
+ * transactions, and failures after the code ran an opcode that has no native
+ * handler yet (its stub only charges gas).
+ */
+
+#include "secp256k1.h"
+#include "state_transition.h"
+#include "tool_engine.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace besu::evm;
+using namespace besu::evm::tools;
+
+namespace {
+
+struct Options {
+    std::vector<std::string> paths;
+    std::string engine;
+    std::string lib;
+    std::string fork;
+    std::string filter;
+    std::string json_path;
+    int repeat = 1;
+    int slowest = 10;
+    bool verbose = false;
+};
+
+void usage(const char* argv0) {
+    std::fprintf(stderr,
+        "Usage: %s [options] <fixture.json | directory>...\n"
+        "\n"
+        "  --fork NAME          Only run this fork (Istanbul ... Prague, Paris)\n"
+        "  --run TEXT           Only run tests whose name contains TEXT\n"
+        "  --repeat N           Time each case as the median of N runs (default 1)\n"
+        "  --slowest N          List the N slowest cases (default 10, 0 = none)\n"
+        "  --json FILE          Write every case with its status and timing\n"
+        "  --engine NAME        Dispatch variant: table, switch, goto, tailcall (needs BESU_BUILD_BENCH)\n"
+        "  --lib PATH           Interpreter library to load\n"
+        "  -v, --verbose        Print every case, not only failures\n",
+        argv0);
+}
+
+bool parse(int argc, char** argv, Options& options, std::string& error) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") return false;
+        if (arg == "--verbose" || arg == "-v") {
+            options.verbose = true;
+            continue;
+        }
+        if (arg.compare(0, 2, "--") != 0) {
+            options.paths.push_back(arg);
+            continue;
+        }
+        if (i + 1 >= argc) {
+            error = arg + " needs a value";
+            return false;
+        }
+        std::string value = argv[++i];
+        bool ok = true;
+        if (arg == "--fork") {
+            options.fork = value;
+        } else if (arg == "--run") {
+            options.filter = value;
+        } else if (arg == "--repeat") {
+            options.repeat = std::atoi(value.c_str());
+            ok = options.repeat > 0;
+        } else if (arg == "--slowest") {
+            options.slowest = std::atoi(value.c_str());
+            ok = options.slowest >= 0;
+        } else if (arg == "--json") {
+            options.json_path = value;
+        } else if (arg == "--engine") {
+            options.engine = value;
+        } else if (arg == "--lib") {
+            options.lib = value;
+        } else {
+            error = "unknown option " + arg;
+            return false;
+        }
+        if (!ok) {
+            error = "bad value for " + arg + ": " + value;
+            return false;
+        }
+    }
+    if (options.paths.empty()) {
+        error = "no fixtures given";
+        return false;
+    }
+    return true;
+}
+
+/** Fixture fork names; Paris (the Merge) changes nothing the native path models over London. */
+bool fixture_revision(const std::string& fork, Revision& out) {
+    if (fork == "Paris" || fork == "Merge") {
+        out = Revision::LONDON;
+        return true;
+    }
+    return parse_revision(fork, out);
+}
+
+// ===== CASES =====
+
+struct Case {
+    std::string file;
+    std::string test;
+    std::string fork;
+    std::string index;  // d<data>g<gas>v<value>
+    std::string status;  // pass, fail, unsupported
+    std::string reason;
+    uint64_t gas_used = 0;
+    double exec_ns = 0;
+};
+
+struct Runner {
+    const Options& options;
+    Executor executor;
+    std::vector<Case> cases;
+
+    void report(const Case& c) {
+        if (!options.verbose && c.status != "fail") return;
+        std::printf("%-11s %s %s %s %s%s%s\n", c.status == "pass" ? "PASS" : c.status == "fail" ? "FAIL" : "UNSUPPORTED",
+                    c.test.c_str(), c.fork.c_str(), c.index.c_str(), c.file.c_str(), c.reason.empty() ? "" : ": ",
+                    c.reason.c_str());
+    }
+
+    void add(Case c) {
+        report(c);
+        cases.push_back(std::move(c));
+    }
+
+    /** A whole fixture file; false if it is not readable JSON. */
+    bool run_file(const std::string& path, std::string& error) {
+        Bytes raw;
+        if (!read_file(path, raw)) {
+            error = "cannot read " + path;
+            return false;
+        }
+        Json root;
+        if (!Json::parse(std::string(raw.begin(), raw.end()), root, error)) {
+            error = path + ": " + error;
+            return false;
+        }
+        for (const auto& test : root.members()) {
+            if (!options.filter.empty() && test.first.find(options.filter) == std::string::npos) continue;
+            run_test(path, test.first, test.second);
+        }
+        return true;
+    }
+
+    void run_test(const std::string& file, const std::string& name, const Json& test) {
+        Case base;
+        base.file = file;
+        base.test = name;
+
+        State pre;
+        BlockEnv env;
+        Transaction tx;
+        std::string error;
+        const Json& e = test["env"];
+        const Json& t = test["transaction"];
+        bool ok = pre.load(test["pre"], error) && json_address(e["currentCoinbase"], env.coinbase) &&
+                  json_u64(e["currentNumber"], env.number) && json_u64(e["currentTimestamp"], env.timestamp) &&
+                  json_u64(e["currentGasLimit"], env.gas_limit) && json_u64(t["nonce"], tx.nonce);
+        if (e.has("currentBaseFee")) ok = ok && json_word(e["currentBaseFee"], env.base_fee);
+        if (t.has("maxFeePerGas")) {
+            tx.dynamic_fee = true;
+            ok = ok && json_word(t["maxFeePerGas"], tx.max_fee) && json_word(t["maxPriorityFeePerGas"], tx.max_priority_fee);
+        } else {
+            ok = ok && json_word(t["gasPrice"], tx.gas_price);
+        }
+        tx.create = t["to"].text().empty();
+        if (!tx.create) ok = ok && json_address(t["to"], tx.to);
+        tx.has_blobs = t.has("blobVersionedHashes");
+        tx.has_authorizations = t.has("authorizationList");
+        Word secret;
+        const bool have_sender =
+            t.has("sender") ? json_address(t["sender"], tx.sender)
+                            : json_word(t["secretKey"], secret) && secp256k1::secret_to_address(secret.data(), tx.sender.data());
+
+        for (const auto& fork : test["post"].members()) {
+            if (!options.fork.empty() && fork.first != options.fork) continue;
+            Revision rev = LATEST_REVISION;
+            const bool known_fork = fixture_revision(fork.first, rev);
+            for (const Json& post : fork.second.items()) {
+                Case c = base;
+                c.fork = fork.first;
+                const Json& indexes = post["indexes"];
+                uint64_t d = 0, g = 0, v = 0;
+                json_u64(indexes["data"], d);
+                json_u64(indexes["gas"], g);
+                json_u64(indexes["value"], v);
+                c.index = "d" + std::to_string(d) + "g" + std::to_string(g) + "v" + std::to_string(v);
+
+                if (!ok) {
+                    c.status = "fail";
+                    c.reason = "malformed fixture" + (error.empty() ? "" : " (" + error + ")");
+                } else if (!known_fork) {
+                    c.status = "unsupported";
+                    c.reason = "fork " + fork.first;
+                } else if (!have_sender) {
+                    c.status = "unsupported";
+                    c.reason = "no sender or secretKey";
+                } else {
+                    run_case(c, pre, env, tx, t, d, g, v, rev, post);
+                }
+                add(std::move(c));
+            }
+        }
+    }
+
+    void run_case(Case& c, const State& pre, const BlockEnv& env, Transaction tx, const Json& t, uint64_t d,
+                  uint64_t g, uint64_t v, Revision rev, const Json& post) {
+        if (!json_bytes(t["data"].at(d), tx.data) || !json_u64(t["gasLimit"].at(g), tx.gas_limit) ||
+            !json_word(t["value"].at(v), tx.value) ||
+            (!t["accessLists"].at(d).isNull() && !parse_access_list(t["accessLists"].at(d), tx))) {
+            c.status = "fail";
+            c.reason = "malformed transaction for " + c.index;
+            return;
+        }
+
+        State state = pre;
+        first_stub() = -1;
+        const TransactionResult result = apply_transaction(state, env, tx, rev, executor);
+        c.gas_used = result.gas_used;
+        c.exec_ns = result.exec_ns;
+
+        const bool expect_exception = post.has("expectException");
+        if (result.status == TransactionResult::UNSUPPORTED) {
+            c.status = "unsupported";
+            c.reason = result.error;
+            return;
+        }
+        if (result.status == TransactionResult::INVALID && !expect_exception) {
+            c.status = "fail";
+            c.reason = "unexpected exception " + result.error;
+            return;
+        }
+        if (result.status != TransactionResult::INVALID && expect_exception) {
+            c.status = "fail";
+            c.reason = "expected exception " + post["expectException"].text();
+            return;
+        }
+
+        Word expected_root, expected_logs;
+        if (!json_word(post["hash"], expected_root) || !json_word(post["logs"], expected_logs)) {
+            c.status = "fail";
+            c.reason = "malformed post entry";
+            return;
+        }
+        const Word root = state.root();
+        if (root == expected_root && logs_hash() == expected_logs) {
+            c.status = "pass";
+            return;
+        }
+        if (first_stub() >= 0) {
+            c.status = "unsupported";
+            c.reason = std::string("ran ") + first_stub_name(rev) + " without a native handler";
+            return;
+        }
+        c.status = "fail";
+        c.reason = root != expected_root ? "state root " + to_hex(root.data(), 32) + ", expected " +
+                                               to_hex(expected_root.data(), 32)
+                                         : "logs hash mismatch";
+        if (result.state) c.reason += std::string(" (frame ") + state_name(result.state) + ")";
+    }
+};
+
+/** Fixture files: the given files, and the *.json files under given directories, sorted. */
+std::vector<std::string> collect(const std::vector<std::string>& paths) {
+    std::vector<std::string> files;
+    for (const std::string& path : paths) {
+        std::error_code ec;
+        if (!std::filesystem::is_directory(path, ec)) {
+            files.push_back(path);
+            continue;
+        }
+        std::vector<std::string> found;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(path, ec)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".json") found.push_back(entry.path().string());
+        }
+        std::sort(found.begin(), found.end());
+        files.insert(files.end(), found.begin(), found.end());
+    }
+    return files;
+}
+
+void write_json(const std::string& path, const std::string& engine, const std::vector<Case>& cases) {
+    FILE* out = std::fopen(path.c_str(), "w");
+    if (!out) {
+        std::fprintf(stderr, "evm-statetest: cannot write %s\n", path.c_str());
+        return;
+    }
+    std::fprintf(out, "{\"engine\":%s,\"cases\":[", json_quote(engine).c_str());
+    for (size_t i = 0; i < cases.size(); i++) {
+        const Case& c = cases[i];
+        std::fprintf(out, "%s\n{\"file\":%s,\"test\":%s,\"fork\":%s,\"index\":\"%s\",\"status\":\"%s\",",
+                     i ? "," : "", json_quote(c.file).c_str(), json_quote(c.test).c_str(), json_quote(c.fork).c_str(),
+                     c.index.c_str(), c.status.c_str());
+        std::fprintf(out, "\"reason\":%s,\"gasUsed\":%llu,\"timeNs\":%.0f}", json_quote(c.reason).c_str(),
+                     static_cast<unsigned long long>(c.gas_used), c.exec_ns);
+    }
+    std::fprintf(out, "\n]}\n");
+    std::fclose(out);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    std::string error;
+    if (!parse(argc, argv, options, error)) {
+        if (!error.empty()) std::fprintf(stderr, "evm-statetest: %s\n", error.c_str());
+        usage(argv[0]);
+        return 2;
+    }
+
+    bench::Engine engine;
+    if (!load_tool_engine(options.engine, options.lib, engine, error)) {
+        std::fprintf(stderr, "evm-statetest: %s\n", error.c_str());
+        return 1;
+    }
+
+    Runner runner{options, Executor{engine.execute, stub_tracer(), options.repeat}, {}};
+
+    auto start = std::chrono::steady_clock::now();
+    int unreadable = 0;
+    for (const std::string& file : collect(options.paths)) {
+        if (!runner.run_file(file, error)) {
+            std::fprintf(stderr, "evm-statetest: %s\n", error.c_str());
+            unreadable++;
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t passed = 0, failed = 0, unsupported = 0;
+    for (const Case& c : runner.cases) {
+        passed += c.status == "pass";
+        failed += c.status == "fail";
+        unsupported += c.status == "unsupported";
+    }
+    std::printf("\n%zu passed, %zu failed, %zu unsupported (%zu cases, %.2f s)\n", passed, failed, unsupported,
+                runner.cases.size(), seconds);
+
+    // Slowest cases that ran code, by execute_message time
+    std::vector<const Case*> timed;
+    for (const Case& c : runner.cases) {
+        if (c.exec_ns > 0) timed.push_back(&c);
+    }
+    std::sort(timed.begin(), timed.end(), [](const Case* a, const Case* b) { return a->exec_ns > b->exec_ns; });
+    if (options.slowest > 0 && !timed.empty()) {
+        std::printf("\nslowest cases (%s, median of %d):\n", engine.name.c_str(), options.repeat);
+        for (size_t i = 0; i < timed.size() && i < static_cast<size_t>(options.slowest); i++) {
+            const Case* c = timed[i];
+            std::printf("  %10.1f us %10llu gas  %s %s %s [%s]\n", c->exec_ns / 1e3,
+                        static_cast<unsigned long long>(c->gas_used), c->test.c_str(), c->fork.c_str(),
+                        c->index.c_str(), c->status.c_str());
+        }
+    }
+
+    if (!options.json_path.empty()) write_json(options.json_path, engine.name, runner.cases);
+    return failed || unreadable ? 1 : 0;
+}
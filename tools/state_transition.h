@@ -0,0 +1,482 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "json.h"
+#include "rlp.h"
+#include "tool_util.h"
+#include "tracer_callback.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace besu {
+namespace evm {
+
+/**
+ * World state and transaction processing for the fixture tools (state tests, t8n).
+ *
+ * The native interpreter runs one message frame; this supplies what Besu does
+ * around it for a plain call transaction: validation, intrinsic gas, the up-front
+ * gas purchase, value transfer, refunds, fee payment, EIP-161 cleanup and the
+ * post-state root. What needs the Java side (contract creation, nested calls,
+ * precompiles, blob and set-code transactions) is reported as unsupported rather
+ * than approximated.
+ */
+namespace tools {
+
+typedef std::array<uint8_t, 20> Address;
+typedef std::array<uint8_t, 32> Word;
+
+// ===== 256-BIT BALANCES =====
+
+inline bool word_is_zero(const Word& a) {
+    for (uint8_t b : a) {
+        if (b) return false;
+    }
+    return true;
+}
+
+/** a + b; false on overflow. */
+inline bool word_add(const Word& a, const Word& b, Word& out) {
+    unsigned carry = 0;
+    for (int i = 31; i >= 0; i--) {
+        unsigned v = a[i] + b[i] + carry;
+        out[i] = static_cast<uint8_t>(v);
+        carry = v >> 8;
+    }
+    return carry == 0;
+}
+
+/** a - b; false if b > a. */
+inline bool word_sub(const Word& a, const Word& b, Word& out) {
+    int borrow = 0;
+    for (int i = 31; i >= 0; i--) {
+        int v = a[i] - b[i] - borrow;
+        borrow = v < 0;
+        out[i] = static_cast<uint8_t>(v + (borrow << 8));
+    }
+    return borrow == 0;
+}
+
+/** a * m; false on overflow. */
+inline bool word_mul(const Word& a, uint64_t m, Word& out) {
+    // Schoolbook over bytes into a 40-byte product
+    uint32_t product[40] = {};
+    for (int j = 0; j < 8; j++) {
+        const uint32_t digit = static_cast<uint8_t>(m >> (8 * (7 - j)));
+        for (int i = 0; i < 32; i++) product[i + j + 1] += a[i] * digit;
+    }
+    uint32_t carry = 0;
+    for (int k = 39; k >= 0; k--) {
+        const uint32_t v = product[k] + carry;
+        product[k] = v & 0xff;
+        carry = v >> 8;
+    }
+    for (int k = 0; k < 8; k++) {
+        if (product[k]) return false;
+    }
+    for (int i = 0; i < 32; i++) out[i] = static_cast<uint8_t>(product[i + 8]);
+    return true;
+}
+
+// ===== JSON FIELDS =====
+
+inline bool json_word(const Json& value, Word& out) { return value.type() != Json::NUL && parse_u256(value.text(), out.data()); }
+
+inline bool json_u64(const Json& value, uint64_t& out) {
+    Word w;
+    bool fits = false;
+    if (!json_word(value, w)) return false;
+    out = word_u64(w.data(), &fits);
+    return fits;
+}
+
+inline bool json_address(const Json& value, Address& out) { return parse_address(value.text(), out.data()); }
+
+inline bool json_bytes(const Json& value, Bytes& out) { return value.isString() && parse_hex(value.text(), out); }
+
+// ===== STATE =====
+
+struct Account {
+    Word balance = {};
+    uint64_t nonce = 0;
+    Bytes code;
+    std::map<Word, Word> storage;  // Non-zero slots only
+
+    /** EIP-161 emptiness. */
+    bool empty() const { return nonce == 0 && word_is_zero(balance) && code.empty(); }
+};
+
+struct State {
+    std::map<Address, Account> accounts;
+
+    Account* find(const Address& address) {
+        auto it = accounts.find(address);
+        return it == accounts.end() ? nullptr : &it->second;
+    }
+
+    /**
+     * Load an allocation: {address: {balance, nonce, code, storage: {key: value}}},
+     * the `pre` of a state test and the `alloc` of t8n.
+     */
+    bool load(const Json& alloc, std::string& error) {
+        for (const auto& member : alloc.members()) {
+            Address address;
+            if (!json_address(Json::string(member.first), address)) {
+                error = "bad address " + member.first;
+                return false;
+            }
+            const Json& fields = member.second;
+            Account& account = accounts[address];
+            if ((fields.has("balance") && !json_word(fields["balance"], account.balance)) ||
+                (fields.has("nonce") && !json_u64(fields["nonce"], account.nonce)) ||
+                (fields.has("code") && !json_bytes(fields["code"], account.code))) {
+                error = "bad account " + member.first;
+                return false;
+            }
+            for (const auto& slot : fields["storage"].members()) {
+                Word key, value;
+                if (!parse_u256(slot.first, key.data()) || !json_word(slot.second, value)) {
+                    error = "bad storage slot " + slot.first + " of " + member.first;
+                    return false;
+                }
+                if (!word_is_zero(value)) account.storage[key] = value;
+            }
+        }
+        return true;
+    }
+
+    /** State root: the secure trie of RLP([nonce, balance, storageRoot, codeHash]). */
+    Word root() const {
+        std::vector<std::pair<Bytes, Bytes>> entries;
+        entries.reserve(accounts.size());
+        for (const auto& it : accounts) {
+            const Account& account = it.second;
+            std::vector<std::pair<Bytes, Bytes>> slots;
+            slots.reserve(account.storage.size());
+            for (const auto& slot : account.storage) {
+                slots.emplace_back(hash(slot.first.data(), 32), rlp::string(rlp::integer(slot.second.data(), 32)));
+            }
+            uint8_t storage_root[32], code_hash[32];
+            rlp::trie_root(slots, storage_root);
+            keccak::keccak256(account.code.data(), account.code.size(), code_hash);
+            entries.emplace_back(hash(it.first.data(), 20),
+                                 rlp::list({rlp::integer(account.nonce), rlp::integer(account.balance.data(), 32),
+                                            rlp::string(storage_root, 32), rlp::string(code_hash, 32)}));
+        }
+        Word out;
+        rlp::trie_root(entries, out.data());
+        return out;
+    }
+
+    /**
+     * Witness for a call to contract: every account, and the contract's storage
+     * (the only storage a native frame reads).
+     */
+    Witness witness(const Address& contract) const {
+        Witness witness;
+        witness.accounts.reserve(accounts.size());
+        for (const auto& it : accounts) {
+            Witness::Account a = {};
+            std::memcpy(a.address, it.first.data(), 20);
+            std::memcpy(a.balance, it.second.balance.data(), 32);
+            a.nonce = it.second.nonce;
+            a.code = it.second.code;
+            witness.accounts.push_back(std::move(a));
+        }
+        auto it = accounts.find(contract);
+        if (it != accounts.end()) {
+            for (const auto& slot : it->second.storage) witness.set_storage(contract.data(), slot.first.data(), slot.second.data());
+        }
+        return witness;
+    }
+
+private:
+    static Bytes hash(const uint8_t* data, size_t size) {
+        Bytes out(32);
+        keccak::keccak256(data, size, out.data());
+        return out;
+    }
+};
+
+/** keccak256(RLP(logs)). The native interpreter emits no logs, so this is the empty list's hash. */
+inline Word logs_hash() {
+    const Bytes encoded = rlp::list({});
+    Word out;
+    keccak::keccak256(encoded.data(), encoded.size(), out.data());
+    return out;
+}
+
+// ===== TRANSACTIONS =====
+
+struct BlockEnv {
+    Address coinbase = {};
+    uint64_t number = 0;
+    uint64_t timestamp = 0;
+    uint64_t gas_limit = 0;
+    Word base_fee = {};
+};
+
+struct Transaction {
+    uint64_t nonce = 0;
+    uint64_t gas_limit = 0;
+    Word gas_price = {};              // Legacy and access-list transactions
+    Word max_fee = {};                // EIP-1559
+    Word max_priority_fee = {};
+    bool dynamic_fee = false;
+    bool create = false;
+    Address to = {};
+    Address sender = {};
+    Word value = {};
+    Bytes data;
+    std::vector<std::pair<Address, std::vector<Word>>> access_list;
+    bool has_access_list = false;
+    bool has_blobs = false;           // EIP-4844 blob hashes
+    bool has_authorizations = false;  // EIP-7702 authorization list
+};
+
+/** Parse an access list: [{address, storageKeys: [...]}]. */
+inline bool parse_access_list(const Json& list, Transaction& tx) {
+    tx.has_access_list = true;
+    for (const Json& entry : list.items()) {
+        std::pair<Address, std::vector<Word>> item;
+        if (!json_address(entry["address"], item.first)) return false;
+        for (const Json& key : entry["storageKeys"].items()) {
+            Word w;
+            if (!json_word(key, w)) return false;
+            item.second.push_back(w);
+        }
+        tx.access_list.push_back(std::move(item));
+    }
+    return true;
+}
+
+struct TransactionResult {
+    enum Status { EXECUTED, INVALID, UNSUPPORTED };
+
+    Status status = EXECUTED;
+    std::string error;      // INVALID: exception name; UNSUPPORTED: what is missing
+    bool success = false;   // Top-level frame completed
+    uint32_t state = 0;     // Frame state and halt reason, if code ran
+    uint32_t halt_reason = 0;
+    uint64_t gas_used = 0;
+    double exec_ns = 0;     // Median execute_message time, 0 if no code ran
+};
+
+/** How the frame of a transaction is run. */
+struct Executor {
+    void (*execute)(MessageFrameMemory*, TracerCallbacks*) = nullptr;
+    TracerCallbacks* tracer = nullptr;  // Used for one extra, untimed run first
+    int timing_runs = 1;
+};
+
+/** Price paid per gas: the legacy gas price, or min(max fee, base fee + priority fee). */
+inline Word effective_gas_price(const Transaction& tx, const BlockEnv& env) {
+    if (!tx.dynamic_fee) return tx.gas_price;
+    Word capped;
+    return word_add(env.base_fee, tx.max_priority_fee, capped) && std::memcmp(capped.data(), tx.max_fee.data(), 32) < 0
+               ? capped
+               : tx.max_fee;
+}
+
+namespace detail {
+
+inline bool is_precompile(const Address& address, Revision rev) {
+    for (int i = 0; i < 19; i++) {
+        if (address[i]) return false;
+    }
+    const uint8_t last = rev >= Revision::PRAGUE ? 0x11 : rev >= Revision::CANCUN ? 0x0a : 0x09;
+    return address[19] >= 1 && address[19] <= last;
+}
+
+inline TransactionResult invalid(const char* exception) {
+    TransactionResult result;
+    result.status = TransactionResult::INVALID;
+    result.error = exception;
+    return result;
+}
+
+inline TransactionResult unsupported(const char* what) {
+    TransactionResult result;
+    result.status = TransactionResult::UNSUPPORTED;
+    result.error = what;
+    return result;
+}
+
+} // namespace detail
+
+/**
+ * Apply a transaction to state.
+ *
+ * Invalid transactions leave the state untouched and name the exception the way
+ * execution-spec-tests fixtures do (without the TransactionException. prefix).
+ * Unsupported ones are detected before anything changes.
+ */
+inline TransactionResult apply_transaction(State& state, const BlockEnv& env, const Transaction& tx, Revision rev,
+                                           const Executor& executor) {
+    using namespace detail;
+    const bool london = rev >= Revision::LONDON;
+
+    if (tx.create) return unsupported("contract creation");
+    if (tx.has_blobs) return unsupported("blob transaction");
+    if (tx.has_authorizations) return unsupported("set-code transaction");
+    if (is_precompile(tx.to, rev)) return unsupported("precompile call");
+
+    // Intrinsic gas, and the EIP-7623 calldata floor from Prague
+    uint64_t zero_bytes = 0;
+    for (uint8_t b : tx.data) zero_bytes += b == 0;
+    const uint64_t tokens = zero_bytes + (tx.data.size() - zero_bytes) * 4;
+    uint64_t intrinsic = 21000 + tokens * 4;
+    for (const auto& entry : tx.access_list) intrinsic += 2400 + 1900 * entry.second.size();
+    const uint64_t floor = rev >= Revision::PRAGUE ? 21000 + tokens * 10 : 0;
+
+    // Validation, in the order Besu's transaction validator reports
+    if (tx.has_access_list && rev < Revision::BERLIN) return invalid("TYPE_1_TX_PRE_FORK");
+    if (tx.dynamic_fee && !london) return invalid("TYPE_2_TX_PRE_FORK");
+    if (tx.gas_limit > env.gas_limit) return invalid("GAS_ALLOCATION_EXCEEDED");
+    if (std::max(intrinsic, floor) > tx.gas_limit) return invalid("INTRINSIC_GAS_TOO_LOW");
+
+    if (tx.dynamic_fee && std::memcmp(tx.max_priority_fee.data(), tx.max_fee.data(), 32) > 0) {
+        return invalid("PRIORITY_GREATER_THAN_MAX_FEE_PER_GAS");
+    }
+    const Word price = effective_gas_price(tx, env);
+    if (london && std::memcmp((tx.dynamic_fee ? tx.max_fee : price).data(), env.base_fee.data(), 32) < 0) {
+        return invalid("INSUFFICIENT_MAX_FEE_PER_GAS");
+    }
+
+    Account empty_sender;
+    const Account* sender = state.find(tx.sender);
+    if (!sender) sender = &empty_sender;
+    if (!sender->code.empty()) return invalid("SENDER_NOT_EOA");
+    if (sender->nonce == UINT64_MAX) return invalid("NONCE_IS_MAX");
+    if (tx.nonce < sender->nonce) return invalid("NONCE_MISMATCH_TOO_LOW");
+    if (tx.nonce > sender->nonce) return invalid("NONCE_MISMATCH_TOO_HIGH");
+
+    // The balance must cover the gas at the maximum price plus the value
+    Word max_cost, upfront, total;
+    if (!word_mul(tx.dynamic_fee ? tx.max_fee : price, tx.gas_limit, max_cost) ||
+        !word_add(max_cost, tx.value, total) || std::memcmp(sender->balance.data(), total.data(), 32) < 0) {
+        return invalid("INSUFFICIENT_ACCOUNT_FUNDS");
+    }
+    word_mul(price, tx.gas_limit, upfront);
+
+    // Buy the gas and bump the nonce; these survive a failed execution
+    Account& from = state.accounts[tx.sender];
+    from.nonce++;
+    word_sub(from.balance, upfront, from.balance);
+
+    // Value transfer and execution revert together
+    const State snapshot = state;
+    word_sub(state.accounts[tx.sender].balance, tx.value, state.accounts[tx.sender].balance);
+    Account& to = state.accounts[tx.to];
+    word_add(to.balance, tx.value, to.balance);
+
+    TransactionResult result;
+    int64_t gas_left = static_cast<int64_t>(tx.gas_limit - intrinsic);
+    int64_t refund = 0;
+    result.success = true;
+
+    if (!to.code.empty()) {
+        Call call;
+        call.code = to.code;
+        call.input = tx.data;
+        call.gas = gas_left;
+        std::memcpy(call.to, tx.to.data(), 20);
+        std::memcpy(call.sender, tx.sender.data(), 20);
+        std::memcpy(call.origin, tx.sender.data(), 20);
+        std::memcpy(call.coinbase, env.coinbase.data(), 20);
+        std::memcpy(call.value, tx.value.data(), 32);
+        std::memcpy(call.gas_price, price.data(), 32);
+        call.revision = rev;
+
+        // Access-listed slots of the called contract start warm (EIP-2930)
+        Witness witness = state.witness(tx.to);
+        for (const auto& entry : tx.access_list) {
+            if (entry.first != tx.to) continue;
+            for (const Word& key : entry.second) {
+                auto slot = to.storage.find(key);
+                witness.set_storage(tx.to.data(), key.data(), slot == to.storage.end() ? Word{}.data() : slot->second.data());
+            }
+        }
+        for (StorageEntry& entry : witness.storage) {
+            for (const auto& listed : tx.access_list) {
+                if (std::memcmp(entry.address, listed.first.data(), 20) != 0) continue;
+                for (const Word& key : listed.second) {
+                    if (std::memcmp(entry.key, key.data(), 32) == 0) entry.is_warm = 1;
+                }
+            }
+        }
+
+        ExecFrame exec(call, witness);
+        if (executor.tracer) executor.execute(exec.frame(), executor.tracer);
+        std::vector<double> times;
+        for (int i = 0; i < std::max(executor.timing_runs, 1); i++) {
+            exec.reset();
+            auto start = std::chrono::steady_clock::now();
+            executor.execute(exec.frame(), nullptr);
+            times.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+        }
+        std::sort(times.begin(), times.end());
+        result.exec_ns = times[times.size() / 2];
+
+        const ExecutionResult& r = exec.result();
+        result.state = r.state;
+        result.halt_reason = r.halt_reason;
+        result.success = r.state == 7;  // COMPLETED_SUCCESS
+        if (result.success) {
+            gas_left = r.gas_remaining;
+            refund = r.gas_refund;
+            for (uint32_t i = 0; i < exec.storageCount(); i++) {
+                const StorageEntry& entry = exec.storage()[i];
+                Word key, value;
+                std::memcpy(key.data(), entry.key, 32);
+                std::memcpy(value.data(), entry.value, 32);
+                if (word_is_zero(value)) {
+                    to.storage.erase(key);
+                } else {
+                    to.storage[key] = value;
+                }
+            }
+        } else {
+            // An exceptional halt consumes all gas; REVERT halts natively, so it does too
+            gas_left = 0;
+            state = snapshot;
+        }
+    }
+
+    // Refund (capped by EIP-3529 from London), the calldata floor, then the fee
+    uint64_t gas_used = tx.gas_limit - static_cast<uint64_t>(gas_left);
+    gas_used -= std::min<uint64_t>(static_cast<uint64_t>(refund), gas_used / (london ? 5 : 2));
+    gas_used = std::max(gas_used, floor);
+    result.gas_used = gas_used;
+
+    Account& payer = state.accounts[tx.sender];
+    Word returned;
+    word_mul(price, tx.gas_limit - gas_used, returned);
+    word_add(payer.balance, returned, payer.balance);
+
+    Word tip = price, reward;
+    if (london) word_sub(price, env.base_fee, tip);
+    word_mul(tip, gas_used, reward);
+    if (!word_is_zero(reward)) {
+        Account& coinbase = state.accounts[env.coinbase];
+        word_add(coinbase.balance, reward, coinbase.balance);
+    }
+
+    // EIP-161: touched accounts left empty are removed
+    for (const Address& touched : {tx.sender, tx.to, env.coinbase}) {
+        const Account* account = state.find(touched);
+        if (account && account->empty()) state.accounts.erase(touched);
+    }
+    return result;
+}
+
+} // namespace tools
+
+} // namespace evm
+} // namespace besu
@@ -0,0 +1,629 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * evm-t8n: the state transition tool interface (alloc/env/txs in, result/alloc
+ * out) on the native interpreter, command-line compatible with geth's `evm t8n`:
+ *
+ *   evm-t8n --input.alloc alloc.json --input.env env.json --input.txs txs.json \
+ *           --state.fork Cancun --output.result result.json --output.alloc alloc.json
+ *   evm-t8n --input.alloc stdin --input.env stdin --input.txs stdin \
+ *           --output.result stdout --output.alloc stdout < input.json
+ *
+ * The block runs the way block execution does: system contract updates, then
+ * each transaction in order against a shared gas pool (state_transition.h),
+ * then withdrawals and the block reward. Transactions the native path cannot
+ * execute (contract creation, precompile targets, blob and set-code
+ * transactions, and code that ran an opcode with no native handler yet, whose
+ * stub only charges gas) are listed as rejected with an "unsupported" error
+ * and leave the state untouched.
+ */
+
+#include "secp256k1.h"
+#include "state_transition.h"
+#include "tool_engine.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace besu::evm;
+using namespace besu::evm::tools;
+
+namespace {
+
+// Exit codes, as geth's t8n uses them
+constexpr int EXIT_CONFIG = 3;
+constexpr int EXIT_JSON = 10;
+constexpr int EXIT_IO = 11;
+
+struct Options {
+    std::string alloc_in = "alloc.json";
+    std::string env_in = "env.json";
+    std::string txs_in = "txs.json";
+    std::string basedir;
+    std::string result_out = "result.json";
+    std::string alloc_out = "alloc.json";
+    std::string fork = "Prague";
+    int64_t reward = 0;
+    uint64_t chain_id = 1;
+    std::string engine;
+    std::string lib;
+};
+
+void usage(const char* argv0) {
+    std::fprintf(stderr,
+        "Usage: %s [options]\n"
+        "\n"
+        "  --input.alloc FILE   Pre-state (default alloc.json; 'stdin' reads {alloc, env, txs})\n"
+        "  --input.env FILE     Block environment (default env.json)\n"
+        "  --input.txs FILE     Transactions as a JSON array (default txs.json)\n"
+        "  --output.basedir DIR Directory for the output files\n"
+        "  --output.result FILE Result (default result.json; 'stdout' or 'stderr')\n"
+        "  --output.alloc FILE  Post-state (default alloc.json; 'stdout' or 'stderr')\n"
+        "  --state.fork NAME    Istanbul, Berlin, London, Paris, Shanghai, Cancun, Prague (default)\n"
+        "  --state.reward N     Block reward before Paris (default 0, -1 = none)\n"
+        "  --state.chainid N    Chain id for signature checks (default 1)\n"
+        "  --engine NAME        Dispatch variant: table, switch, goto, tailcall (needs BESU_BUILD_BENCH)\n"
+        "  --lib PATH           Interpreter library to load\n",
+        argv0);
+}
+
+bool parse(int argc, char** argv, Options& options, std::string& error) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i], value;
+        if (arg == "--help" || arg == "-h") return false;
+        // Both --flag=value and --flag value, as geth accepts
+        const size_t eq = arg.find('=');
+        if (eq != std::string::npos) {
+            value = arg.substr(eq + 1);
+            arg = arg.substr(0, eq);
+        } else if (i + 1 < argc) {
+            value = argv[++i];
+        } else {
+            error = arg + " needs a value";
+            return false;
+        }
+        if (arg == "--input.alloc") {
+            options.alloc_in = value;
+        } else if (arg == "--input.env") {
+            options.env_in = value;
+        } else if (arg == "--input.txs") {
+            options.txs_in = value;
+        } else if (arg == "--output.basedir") {
+            options.basedir = value;
+        } else if (arg == "--output.result") {
+            options.result_out = value;
+        } else if (arg == "--output.alloc") {
+            options.alloc_out = value;
+        } else if (arg == "--state.fork") {
+            options.fork = value;
+        } else if (arg == "--state.reward") {
+            options.reward = std::atoll(value.c_str());
+        } else if (arg == "--state.chainid") {
+            options.chain_id = std::strtoull(value.c_str(), nullptr, 0);
+        } else if (arg == "--engine") {
+            options.engine = value;
+        } else if (arg == "--lib") {
+            options.lib = value;
+        } else {
+            error = "unknown option " + arg;
+            return false;
+        }
+    }
+    return true;
+}
+
+// ===== TRANSACTIONS =====
+
+/** A transaction as t8n receives it: the fields state_transition.h needs plus type and signature. */
+struct SignedTransaction {
+    Transaction tx;
+    unsigned type = 0;
+    uint64_t chain_id = 0;
+    Word v = {}, r = {}, s = {};
+    bool is_signed = false;
+    bool have_sender = false;
+};
+
+Bytes access_list_rlp(const Transaction& tx) {
+    std::vector<Bytes> entries;
+    for (const auto& entry : tx.access_list) {
+        std::vector<Bytes> keys;
+        for (const Word& key : entry.second) keys.push_back(rlp::string(key.data(), 32));
+        entries.push_back(rlp::list({rlp::string(entry.first.data(), 20), rlp::list(keys)}));
+    }
+    return rlp::list(entries);
+}
+
+/**
+ * Canonical encoding: typed transactions are type || RLP(fields), legacy ones
+ * RLP(fields). for_signing drops the signature (adding EIP-155's chain id to
+ * legacy transactions that carry one).
+ */
+Bytes encode(const SignedTransaction& st, bool for_signing) {
+    const Transaction& tx = st.tx;
+    const Bytes to = tx.create ? rlp::string(nullptr, 0) : rlp::string(tx.to.data(), 20);
+    std::vector<Bytes> fields;
+    if (st.type != 0) fields.push_back(rlp::integer(st.chain_id));
+    fields.push_back(rlp::integer(tx.nonce));
+    if (st.type == 2) {
+        fields.push_back(rlp::integer(tx.max_priority_fee.data(), 32));
+        fields.push_back(rlp::integer(tx.max_fee.data(), 32));
+    } else {
+        fields.push_back(rlp::integer(tx.gas_price.data(), 32));
+    }
+    fields.push_back(rlp::integer(tx.gas_limit));
+    fields.push_back(to);
+    fields.push_back(rlp::integer(tx.value.data(), 32));
+    fields.push_back(rlp::string(tx.data));
+    if (st.type != 0) fields.push_back(access_list_rlp(tx));
+
+    if (!for_signing) {
+        fields.push_back(rlp::integer(st.v.data(), 32));
+        fields.push_back(rlp::integer(st.r.data(), 32));
+        fields.push_back(rlp::integer(st.s.data(), 32));
+    } else if (st.type == 0 && st.chain_id) {
+        fields.push_back(rlp::integer(st.chain_id));
+        fields.push_back(rlp::integer(0));
+        fields.push_back(rlp::integer(0));
+    }
+    Bytes out;
+    if (st.type != 0) out.push_back(static_cast<uint8_t>(st.type));
+    const Bytes body = rlp::list(fields);
+    out.insert(out.end(), body.begin(), body.end());
+    return out;
+}
+
+Word hash_of(const Bytes& data) {
+    Word out;
+    keccak::keccak256(data.data(), data.size(), out.data());
+    return out;
+}
+
+/** Parse one JSON transaction; false with error set if a field is malformed. */
+bool parse_transaction(const Json& j, SignedTransaction& st, std::string& error) {
+    Transaction& tx = st.tx;
+    uint64_t type = 0;
+    if (j.has("type")) {
+        json_u64(j["type"], type);
+    } else if (j.has("maxFeePerGas")) {
+        type = 2;
+    } else if (j.has("accessList")) {
+        type = 1;
+    }
+    st.type = static_cast<unsigned>(type);
+    tx.has_blobs = type == 3 || j.has("blobVersionedHashes");
+    tx.has_authorizations = type == 4 || j.has("authorizationList");
+    tx.dynamic_fee = type >= 2;
+
+    const Json& input = j.has("input") ? j["input"] : j["data"];
+    bool ok = json_u64(j["nonce"], tx.nonce) && json_u64(j["gas"], tx.gas_limit) &&
+              (!j.has("value") || json_word(j["value"], tx.value)) && (input.isNull() || json_bytes(input, tx.data));
+    if (tx.dynamic_fee) {
+        ok = ok && json_word(j["maxFeePerGas"], tx.max_fee) && json_word(j["maxPriorityFeePerGas"], tx.max_priority_fee);
+    } else {
+        ok = ok && json_word(j["gasPrice"], tx.gas_price);
+    }
+    tx.create = j["to"].isNull() || j["to"].text().empty();
+    if (!tx.create) ok = ok && json_address(j["to"], tx.to);
+    if (j.has("accessList") && !j["accessList"].isNull()) ok = ok && parse_access_list(j["accessList"], tx);
+    if (j.has("chainId")) ok = ok && json_u64(j["chainId"], st.chain_id);
+    for (const char* name : {"v", "r", "s"}) {
+        if (j.has(name) && !json_word(j[name], name[0] == 'v' ? st.v : name[0] == 'r' ? st.r : st.s)) ok = false;
+    }
+    if (!ok) {
+        error = "malformed transaction";
+        return false;
+    }
+    st.is_signed = !word_is_zero(st.r) || !word_is_zero(st.s);
+
+    // Legacy v carries the EIP-155 chain id
+    bool v_fits = false;
+    const uint64_t v = word_u64(st.v.data(), &v_fits);
+    if (st.type == 0 && v_fits && v >= 35) st.chain_id = (v - 35) / 2;
+
+    if (j.has("sender")) {
+        st.have_sender = json_address(j["sender"], tx.sender);
+    } else if (!st.is_signed && j.has("secretKey")) {
+        Word secret;
+        st.have_sender = json_word(j["secretKey"], secret) && secp256k1::secret_to_address(secret.data(), tx.sender.data());
+    }
+    return true;
+}
+
+/** Resolve the sender from the signature; false with error set if it does not verify. */
+bool recover_sender(SignedTransaction& st, uint64_t chain_id, std::string& error) {
+    if (!st.is_signed) {
+        if (!st.have_sender) error = "transaction has no signature, sender or secretKey";
+        return st.have_sender;
+    }
+    bool fits = false;
+    const uint64_t v = word_u64(st.v.data(), &fits);
+    unsigned recovery_id;
+    if (st.type != 0) {
+        recovery_id = static_cast<unsigned>(v);
+    } else if (v == 27 || v == 28) {
+        recovery_id = static_cast<unsigned>(v - 27);
+    } else {
+        recovery_id = static_cast<unsigned>((v - 35) % 2);
+    }
+    if ((st.type != 0 || v >= 35) && st.chain_id != chain_id) {
+        error = "invalid chain id " + std::to_string(st.chain_id);
+        return false;
+    }
+    const Word signing_hash = hash_of(encode(st, true));
+    if (!fits || !secp256k1::recover(signing_hash.data(), st.r.data(), st.s.data(), recovery_id, st.tx.sender.data())) {
+        error = "invalid signature";
+        return false;
+    }
+    return true;
+}
+
+// ===== BLOCK =====
+
+struct Fork {
+    Revision revision;
+    bool merged;  // Paris and later: no block reward, PREVRANDAO
+};
+
+bool parse_fork(const std::string& name, Fork& out) {
+    if (name == "Paris" || name == "Merge") {
+        out = {Revision::LONDON, true};
+        return true;
+    }
+    if (!parse_revision(name, out.revision)) return false;
+    out.merged = out.revision >= Revision::SHANGHAI;
+    return true;
+}
+
+/** EIP-1559 base fee from the parent header when env has no currentBaseFee. */
+Word next_base_fee(const Json& env) {
+    __extension__ typedef unsigned __int128 uint128;
+    uint64_t parent_fee = 0, parent_used = 0, parent_limit = 0;
+    json_u64(env["parentBaseFee"], parent_fee);
+    json_u64(env["parentGasUsed"], parent_used);
+    json_u64(env["parentGasLimit"], parent_limit);
+    const uint64_t target = parent_limit / 2;
+    uint64_t fee = parent_fee;
+    if (target && parent_used > target) {
+        const uint64_t delta = static_cast<uint64_t>(static_cast<uint128>(parent_fee) * (parent_used - target) / target / 8);
+        fee = parent_fee + std::max<uint64_t>(delta, 1);
+    } else if (target && parent_used < target) {
+        fee = parent_fee - static_cast<uint64_t>(static_cast<uint128>(parent_fee) * (target - parent_used) / target / 8);
+    }
+    Word out;
+    u64_word(fee, out.data());
+    return out;
+}
+
+/**
+ * System contract updates at the start of a block, applied directly as their
+ * bytecode would (the contracts read CALLER and TIMESTAMP, which have no native
+ * handlers yet): EIP-4788 beacon roots from Cancun, EIP-2935 block hashes from
+ * Prague. Skipped when the contract is not in the pre-state.
+ */
+void apply_system_contracts(State& state, const Json& env, const BlockEnv& block, Revision rev) {
+    constexpr uint64_t RING = 8191;
+    Address beacon_roots, history;
+    parse_address("0x000F3df6D732807Ef1319fB7B8bB8522d0Beac02", beacon_roots.data());
+    parse_address("0x0000F90827F1C53a10cb7A02335B175320002935", history.data());
+
+    Word root;
+    Account* account = state.find(beacon_roots);
+    if (rev >= Revision::CANCUN && account && !account->code.empty() && json_word(env["parentBeaconBlockRoot"], root)) {
+        Word key, timestamp;
+        u64_word(block.timestamp, timestamp.data());
+        u64_word(block.timestamp % RING, key.data());
+        account->storage[key] = timestamp;
+        u64_word(block.timestamp % RING + RING, key.data());
+        if (word_is_zero(root)) {
+            account->storage.erase(key);
+        } else {
+            account->storage[key] = root;
+        }
+    }
+
+    Word parent_hash;
+    account = state.find(history);
+    if (rev >= Revision::PRAGUE && account && !account->code.empty() && block.number > 0 &&
+        json_word(env["blockHashes"][std::to_string(block.number - 1)], parent_hash) && !word_is_zero(parent_hash)) {
+        Word key;
+        u64_word((block.number - 1) % RING, key.data());
+        account->storage[key] = parent_hash;
+    }
+}
+
+struct Receipt {
+    unsigned type;
+    bool success;
+    uint64_t cumulative_gas;
+    uint64_t gas_used;
+    Word tx_hash;
+    Word effective_price;
+    size_t index;
+};
+
+struct Rejected {
+    size_t index;
+    std::string error;
+};
+
+/** Root of an index-keyed trie (transactions, receipts, withdrawals). */
+Word list_root(const std::vector<Bytes>& values) {
+    std::vector<std::pair<Bytes, Bytes>> entries;
+    for (size_t i = 0; i < values.size(); i++) entries.emplace_back(rlp::integer(i), values[i]);
+    Word out;
+    rlp::trie_root(entries, out.data());
+    return out;
+}
+
+Bytes receipt_rlp(const Receipt& r) {
+    const Bytes bloom(256, 0);
+    Bytes out;
+    if (r.type != 0) out.push_back(static_cast<uint8_t>(r.type));
+    const Bytes body = rlp::list({rlp::integer(r.success ? 1 : 0), rlp::integer(r.cumulative_gas), rlp::string(bloom),
+                                  rlp::list({})});
+    out.insert(out.end(), body.begin(), body.end());
+    return out;
+}
+
+// ===== OUTPUT =====
+
+std::string quantity(uint64_t value) {
+    char buffer[24];
+    std::snprintf(buffer, sizeof(buffer), "0x%llx", static_cast<unsigned long long>(value));
+    return buffer;
+}
+
+std::string alloc_json(const State& state) {
+    std::string out = "{";
+    bool first = true;
+    for (const auto& it : state.accounts) {
+        const Account& a = it.second;
+        out += std::string(first ? "\n" : ",\n") + "  \"" + to_hex(it.first.data(), 20) + "\": {";
+        first = false;
+        out += "\"balance\": \"" + to_quantity(a.balance.data()) + "\"";
+        if (a.nonce) out += ", \"nonce\": \"" + quantity(a.nonce) + "\"";
+        if (!a.code.empty()) out += ", \"code\": \"" + to_hex(a.code.data(), a.code.size()) + "\"";
+        if (!a.storage.empty()) {
+            out += ", \"storage\": {";
+            bool first_slot = true;
+            for (const auto& slot : a.storage) {
+                out += std::string(first_slot ? "" : ", ") + "\"" + to_hex(slot.first.data(), 32) + "\": \"" +
+                       to_hex(slot.second.data(), 32) + "\"";
+                first_slot = false;
+            }
+            out += "}";
+        }
+        out += "}";
+    }
+    return out + "\n}";
+}
+
+bool write_output(const Options& options, const std::string& target, const std::string& content,
+                  std::vector<std::pair<std::string, std::string>>& to_stdout, const char* key) {
+    if (target == "stdout") {
+        to_stdout.emplace_back(key, content);
+        return true;
+    }
+    if (target == "stderr") {
+        std::fprintf(stderr, "%s\n", content.c_str());
+        return true;
+    }
+    const std::string path = options.basedir.empty() ? target : options.basedir + "/" + target;
+    FILE* out = std::fopen(path.c_str(), "w");
+    if (!out) {
+        std::fprintf(stderr, "evm-t8n: cannot write %s\n", path.c_str());
+        return false;
+    }
+    std::fprintf(out, "%s\n", content.c_str());
+    std::fclose(out);
+    return true;
+}
+
+bool load_json(const std::string& path, Json& out, std::string& error) {
+    Bytes raw;
+    if (!read_file(path == "stdin" ? "-" : path, raw)) {
+        error = "cannot read " + path;
+        return false;
+    }
+    if (!Json::parse(std::string(raw.begin(), raw.end()), out, error)) {
+        error = path + ": " + error;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    std::string error;
+    if (!parse(argc, argv, options, error)) {
+        if (!error.empty()) std::fprintf(stderr, "evm-t8n: %s\n", error.c_str());
+        usage(argv[0]);
+        return 2;
+    }
+    Fork fork;
+    if (!parse_fork(options.fork, fork)) {
+        std::fprintf(stderr, "evm-t8n: unsupported fork %s\n", options.fork.c_str());
+        return EXIT_CONFIG;
+    }
+
+    // Inputs: 'stdin' for any of them reads one {alloc, env, txs} object
+    Json stdin_json, alloc_file, env_file, txs_file;
+    const bool any_stdin = options.alloc_in == "stdin" || options.env_in == "stdin" || options.txs_in == "stdin";
+    if (any_stdin && !load_json("stdin", stdin_json, error)) {
+        std::fprintf(stderr, "evm-t8n: %s\n", error.c_str());
+        return EXIT_JSON;
+    }
+    auto input = [&](const std::string& path, const char* key, Json& file) -> const Json* {
+        if (path == "stdin") return &stdin_json[key];
+        if (!load_json(path, file, error)) return nullptr;
+        return &file;
+    };
+    const Json* alloc = input(options.alloc_in, "alloc", alloc_file);
+    const Json* env = alloc ? input(options.env_in, "env", env_file) : nullptr;
+    const Json* txs = env ? input(options.txs_in, "txs", txs_file) : nullptr;
+    if (!txs) {
+        std::fprintf(stderr, "evm-t8n: %s\n", error.c_str());
+        return error.compare(0, 6, "cannot") == 0 ? EXIT_IO : EXIT_JSON;
+    }
+
+    State state;
+    BlockEnv block;
+    const Json& e = *env;
+    if (!state.load(*alloc, error) || !json_address(e["currentCoinbase"], block.coinbase) ||
+        !json_u64(e["currentNumber"], block.number) || !json_u64(e["currentTimestamp"], block.timestamp) ||
+        !json_u64(e["currentGasLimit"], block.gas_limit)) {
+        std::fprintf(stderr, "evm-t8n: malformed alloc or env%s\n", error.empty() ? "" : (": " + error).c_str());
+        return EXIT_JSON;
+    }
+    if (fork.revision >= Revision::LONDON) {
+        if (e.has("currentBaseFee")) {
+            json_word(e["currentBaseFee"], block.base_fee);
+        } else {
+            block.base_fee = next_base_fee(e);
+        }
+    }
+
+    bench::Engine engine;
+    if (!load_tool_engine(options.engine, options.lib, engine, error)) {
+        std::fprintf(stderr, "evm-t8n: %s\n", error.c_str());
+        return 1;
+    }
+    const Executor executor{engine.execute, stub_tracer(), 1};
+
+    apply_system_contracts(state, e, block, fork.revision);
+
+    // Transactions in order against the block gas pool
+    std::vector<Receipt> receipts;
+    std::vector<Rejected> rejected;
+    std::vector<Bytes> included;
+    uint64_t gas_used = 0;
+    for (size_t i = 0; i < txs->items().size(); i++) {
+        SignedTransaction st;
+        if (!parse_transaction(txs->items()[i], st, error) || !recover_sender(st, options.chain_id, error)) {
+            rejected.push_back({i, error});
+            continue;
+        }
+        BlockEnv tx_env = block;
+        tx_env.gas_limit = block.gas_limit - gas_used;  // Gas left in the block's pool
+        const State before = state;
+        first_stub() = -1;
+        const TransactionResult result = apply_transaction(state, tx_env, st.tx, fork.revision, executor);
+        if (result.status == TransactionResult::INVALID) {
+            rejected.push_back({i, result.error});
+            continue;
+        }
+        if (result.status == TransactionResult::UNSUPPORTED) {
+            rejected.push_back({i, "unsupported: " + result.error});
+            continue;
+        }
+        if (first_stub() >= 0) {
+            state = before;
+            rejected.push_back({i, std::string("unsupported: ran ") + first_stub_name(fork.revision) +
+                                       " without a native handler"});
+            continue;
+        }
+        gas_used += result.gas_used;
+
+        Receipt receipt = {};
+        receipt.type = st.type;
+        receipt.success = result.success;
+        receipt.cumulative_gas = gas_used;
+        receipt.gas_used = result.gas_used;
+        receipt.index = receipts.size();
+        const Bytes encoded = encode(st, false);
+        receipt.tx_hash = hash_of(encoded);
+        receipt.effective_price = effective_gas_price(st.tx, block);
+        receipts.push_back(receipt);
+        included.push_back(encoded);
+    }
+
+    // Withdrawals (amounts in Gwei), then the pre-merge block reward
+    std::vector<Bytes> withdrawals;
+    for (const Json& w : e["withdrawals"].items()) {
+        uint64_t index = 0, validator = 0, amount = 0;
+        Address address;
+        if (!json_u64(w["index"], index) || !json_u64(w["validatorIndex"], validator) ||
+            !json_address(w["address"], address) || !json_u64(w["amount"], amount)) {
+            std::fprintf(stderr, "evm-t8n: malformed withdrawal\n");
+            return EXIT_JSON;
+        }
+        withdrawals.push_back(rlp::list({rlp::integer(index), rlp::integer(validator),
+                                         rlp::string(address.data(), 20), rlp::integer(amount)}));
+        Word gwei, wei;
+        u64_word(amount, gwei.data());
+        if (amount && word_mul(gwei, 1000000000ull, wei)) {
+            Account& account = state.accounts[address];
+            word_add(account.balance, wei, account.balance);
+        }
+    }
+    if (!fork.merged && options.reward > 0) {
+        Word reward;
+        u64_word(static_cast<uint64_t>(options.reward), reward.data());
+        Account& coinbase = state.accounts[block.coinbase];
+        word_add(coinbase.balance, reward, coinbase.balance);
+    }
+
+    // Result
+    std::vector<Bytes> receipt_bytes;
+    for (const Receipt& r : receipts) receipt_bytes.push_back(receipt_rlp(r));
+    const std::string zero_bloom = "0x" + std::string(512, '0');
+    std::string result = "{\n  \"stateRoot\": \"" + to_hex(state.root().data(), 32) + "\",\n";
+    result += "  \"txRoot\": \"" + to_hex(list_root(included).data(), 32) + "\",\n";
+    result += "  \"receiptsRoot\": \"" + to_hex(list_root(receipt_bytes).data(), 32) + "\",\n";
+    result += "  \"logsHash\": \"" + to_hex(logs_hash().data(), 32) + "\",\n";
+    result += "  \"logsBloom\": \"" + zero_bloom + "\",\n  \"receipts\": [";
+    for (size_t i = 0; i < receipts.size(); i++) {
+        const Receipt& r = receipts[i];
+        result += std::string(i ? "," : "") + "\n    {\"type\": \"" + quantity(r.type) + "\", \"root\": \"0x\", \"status\": \"" +
+                  quantity(r.success) + "\", \"cumulativeGasUsed\": \"" + quantity(r.cumulative_gas) +
+                  "\", \"logsBloom\": \"" + zero_bloom + "\", \"logs\": null, \"transactionHash\": \"" +
+                  to_hex(r.tx_hash.data(), 32) + "\", \"contractAddress\": \"0x" + std::string(40, '0') +
+                  "\", \"gasUsed\": \"" + quantity(r.gas_used) + "\", \"effectiveGasPrice\": \"" +
+                  to_quantity(r.effective_price.data()) + "\", \"blockHash\": \"0x" + std::string(64, '0') +
+                  "\", \"transactionIndex\": \"" + quantity(r.index) + "\"}";
+    }
+    result += receipts.empty() ? "],\n" : "\n  ],\n";
+    if (!rejected.empty()) {
+        result += "  \"rejected\": [";
+        for (size_t i = 0; i < rejected.size(); i++) {
+            result += std::string(i ? "," : "") + "\n    {\"index\": " + std::to_string(rejected[i].index) +
+                      ", \"error\": " + json_quote(rejected[i].error) + "}";
+        }
+        result += "\n  ],\n";
+    }
+    result += "  \"currentDifficulty\": " +
+              (e.has("currentDifficulty") ? json_quote(e["currentDifficulty"].text()) : std::string("null")) + ",\n";
+    if (fork.revision >= Revision::LONDON) result += "  \"currentBaseFee\": \"" + to_quantity(block.base_fee.data()) + "\",\n";
+    if (fork.revision >= Revision::SHANGHAI) {
+        result += "  \"withdrawalsRoot\": \"" + to_hex(list_root(withdrawals).data(), 32) + "\",\n";
+    }
+    if (fork.revision >= Revision::CANCUN) {
+        // No blob transactions run natively, so excess blob gas only decays toward the target
+        uint64_t parent_excess = 0, parent_used = 0;
+        json_u64(e["parentExcessBlobGas"], parent_excess);
+        json_u64(e["parentBlobGasUsed"], parent_used);
+        const uint64_t target = fork.revision >= Revision::PRAGUE ? 786432 : 393216;
+        uint64_t excess = parent_excess + parent_used > target ? parent_excess + parent_used - target : 0;
+        if (e.has("currentExcessBlobGas")) json_u64(e["currentExcessBlobGas"], excess);
+        result += "  \"currentExcessBlobGas\": \"" + quantity(excess) + "\",\n  \"blobGasUsed\": \"0x0\",\n";
+    }
+    result += "  \"gasUsed\": \"" + quantity(gas_used) + "\"\n}";
+
+    std::vector<std::pair<std::string, std::string>> to_stdout;
+    if (!write_output(options, options.alloc_out, alloc_json(state), to_stdout, "alloc") ||
+        !write_output(options, options.result_out, result, to_stdout, "result")) {
+        return EXIT_IO;
+    }
+    if (!to_stdout.empty()) {
+        std::printf("{");
+        for (size_t i = 0; i < to_stdout.size(); i++) {
+            std::printf("%s\"%s\": %s", i ? ",\n" : "", to_stdout[i].first.c_str(), to_stdout[i].second.c_str());
+        }
+        std::printf("}\n");
+    }
+    return 0;
+}
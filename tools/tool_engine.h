@@ -0,0 +1,84 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "bench_util.h"
+#include "message_frame_memory.h"
+#include "opcode_table.h"
+#include "tracer_callback.h"
+#include <string>
+#include <vector>
+
+#if defined(__APPLE__)
+#define BESU_NATIVE_EVM_NAME "libbesu_native_evm.dylib"
+#else
+#define BESU_NATIVE_EVM_NAME "libbesu_native_evm.so"
+#endif
+#ifndef BESU_NATIVE_EVM_LIB
+#define BESU_NATIVE_EVM_LIB BESU_NATIVE_EVM_NAME
+#endif
+#ifndef BESU_BENCH_VARIANT_DIR
+#define BESU_BENCH_VARIANT_DIR "."
+#endif
+
+namespace besu {
+namespace evm {
+namespace tools {
+
+/**
+ * Load the interpreter a tool runs on: a dispatch variant by name (built with
+ * BESU_BUILD_BENCH), an explicit library, or the library built with the tool,
+ * then the installed one found through the rpath.
+ * @return false with error set if nothing could be loaded
+ */
+inline bool load_tool_engine(const std::string& variant, const std::string& lib, bench::Engine& engine,
+                             std::string& error) {
+    if (!variant.empty()) {
+        std::vector<bench::Engine> engines = bench::load_engines({}, BESU_BENCH_VARIANT_DIR, variant, error);
+        if (engines.empty()) {
+            error = "engine '" + variant + "' not found (configure with -DBESU_BUILD_BENCH=ON)";
+            return false;
+        }
+        engine = engines.front();
+        return true;
+    }
+    if (!lib.empty()) return bench::load_engine(lib, engine, error);
+    return bench::load_engine(BESU_NATIVE_EVM_LIB, engine, error) ||
+           bench::load_engine(BESU_NATIVE_EVM_NAME, engine, error);
+}
+
+/**
+ * First defined opcode the last run executed without a native handler (not
+ * flagged NATIVE in opcode_table.h), or -1. Its stub only charges gas, so a
+ * result that depends on it cannot be trusted. The tracer callbacks carry no
+ * context pointer, so this is process-wide: reset it before each run.
+ */
+inline int& first_stub() {
+    static int op = -1;
+    return op;
+}
+
+inline void stub_trace_pre(MessageFrameMemory* frame) {
+    const uint8_t op = frame_memory::getCode(frame)[frame->pc];
+    const Revision rev = static_cast<Revision>(frame->revision);
+    if (first_stub() < 0 && opcodes::is_defined(rev, op) && !opcodes::is_native(rev, op)) first_stub() = op;
+}
+
+inline void stub_trace_post(MessageFrameMemory*, OperationResult*) {}
+
+/** Tracer that records first_stub(); pass it to engine.execute. */
+inline TracerCallbacks* stub_tracer() {
+    static TracerCallbacks callbacks = {stub_trace_pre, stub_trace_post};
+    return &callbacks;
+}
+
+/** Name of first_stub() for messages, or "?". */
+inline const char* first_stub_name(Revision rev) {
+    const char* name = first_stub() < 0 ? nullptr : opcodes::info(rev, static_cast<uint8_t>(first_stub())).name;
+    return name ? name : "?";
+}
+
+} // namespace tools
+} // namespace evm
+} // namespace besu
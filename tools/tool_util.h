@@ -0,0 +1,522 @@
+// Copyright ConsenSys AG.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "account_witness.h"
+#include "execution_result.h"
+#include "keccak.h"
+#include "message_frame_memory.h"
+#include "opcode_table.h"
+#include "storage_memory.h"
+#include "witness_file.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace besu {
+namespace evm {
+
+/**
+ * Shared pieces of the command-line tools (tools/).
+ *
+ * - Parsing: hex, 256-bit numbers, addresses, files
+ * - Witness: accounts, code and storage as a tool builds them, laid out as a
+ *   TransactionWitness for the frame, or saved as a witness file
+ * - ExecFrame: a checked frame for one call that can be re-run from its
+ *   initial state
+ */
+namespace tools {
+
+typedef std::vector<uint8_t> Bytes;
+
+// ===== PARSING =====
+
+inline int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * Decode hex with an optional 0x prefix. Whitespace is skipped.
+ * @return false on a non-hex character or an odd digit count
+ */
+inline bool parse_hex(const std::string& text, Bytes& out) {
+    out.clear();
+    size_t i = text.compare(0, 2, "0x") == 0 || text.compare(0, 2, "0X") == 0 ? 2 : 0;
+    int high = -1;
+    for (; i < text.size(); i++) {
+        char c = text[i];
+        if (c == ' ' || c == '\n' || c == '\r' || c == '\t') continue;
+        int digit = hex_digit(c);
+        if (digit < 0) return false;
+        if (high < 0) {
+            high = digit;
+        } else {
+            out.push_back(static_cast<uint8_t>(high << 4 | digit));
+            high = -1;
+        }
+    }
+    return high < 0;
+}
+
+/**
+ * Parse a 256-bit unsigned number, decimal or 0x-prefixed hex, into a
+ * big-endian word.
+ * @return false if malformed or wider than 256 bits
+ */
+inline bool parse_u256(const std::string& text, uint8_t out[32]) {
+    std::memset(out, 0, 32);
+    if (text.empty()) return false;
+    if (text.compare(0, 2, "0x") == 0 || text.compare(0, 2, "0X") == 0) {
+        std::string digits = text.substr(2);
+        if (digits.empty()) return true;  // "0x" is zero, as in the JSON fixtures
+        if (digits.size() % 2) digits = "0" + digits;
+        Bytes bytes;
+        if (!parse_hex(digits, bytes)) return false;
+        size_t skip = 0;
+        while (skip < bytes.size() && bytes[skip] == 0) skip++;
+        if (bytes.size() - skip > 32) return false;
+        std::memcpy(out + 32 - (bytes.size() - skip), bytes.data() + skip, bytes.size() - skip);
+        return true;
+    }
+    for (char c : text) {
+        if (c < '0' || c > '9') return false;
+        unsigned carry = static_cast<unsigned>(c - '0');
+        for (int i = 31; i >= 0; i--) {
+            unsigned v = out[i] * 10u + carry;
+            out[i] = static_cast<uint8_t>(v);
+            carry = v >> 8;
+        }
+        if (carry) return false;
+    }
+    return true;
+}
+
+/** Parse a 20-byte address (hex, 0x optional). */
+inline bool parse_address(const std::string& text, uint8_t out[20]) {
+    Bytes bytes;
+    if (!parse_hex(text, bytes) || bytes.size() != 20) return false;
+    std::memcpy(out, bytes.data(), 20);
+    return true;
+}
+
+/** Low 64 bits of a big-endian word, and whether the rest is zero. */
+inline uint64_t word_u64(const uint8_t word[32], bool* fits = nullptr) {
+    uint64_t value = 0;
+    bool high = false;
+    for (int i = 0; i < 24; i++) high = high || word[i] != 0;
+    for (int i = 24; i < 32; i++) value = (value << 8) | word[i];
+    if (fits) *fits = !high;
+    return value;
+}
+
+inline void u64_word(uint64_t value, uint8_t out[32]) {
+    std::memset(out, 0, 32);
+    for (int i = 31; i >= 24; i--) {
+        out[i] = static_cast<uint8_t>(value);
+        value >>= 8;
+    }
+}
+
+inline std::string to_hex(const uint8_t* data, size_t size, bool prefix = true) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out = prefix ? "0x" : "";
+    for (size_t i = 0; i < size; i++) {
+        out += digits[data[i] >> 4];
+        out += digits[data[i] & 0xf];
+    }
+    return out;
+}
+
+/** Word as minimal hex (0x0 for zero), the form EIP-3155 traces use. */
+inline std::string to_quantity(const uint8_t word[32]) {
+    size_t first = 0;
+    while (first < 31 && word[first] == 0) first++;
+    std::string hex = to_hex(word + first, 32 - first, false);
+    size_t nonzero = hex.find_first_not_of('0');
+    return "0x" + (nonzero == std::string::npos ? "0" : hex.substr(nonzero));
+}
+
+/** Read a whole file ("-" for stdin). */
+inline bool read_file(const std::string& path, Bytes& out) {
+    FILE* in = path == "-" ? stdin : std::fopen(path.c_str(), "rb");
+    if (!in) return false;
+    out.clear();
+    uint8_t buffer[65536];
+    size_t n;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), in)) > 0) out.insert(out.end(), buffer, buffer + n);
+    bool ok = !std::ferror(in);
+    if (in != stdin) std::fclose(in);
+    return ok;
+}
+
+/** Bytes from a file holding hex text, or the raw bytes if it is not hex. */
+inline bool read_hex_or_binary_file(const std::string& path, Bytes& out) {
+    Bytes raw;
+    if (!read_file(path, raw)) return false;
+    std::string text(raw.begin(), raw.end());
+    if (parse_hex(text, out)) return true;
+    out = raw;
+    return true;
+}
+
+inline bool parse_revision(const std::string& name, Revision& out) {
+    static const char* names[REVISION_COUNT] = {"istanbul", "berlin", "london", "shanghai", "cancun", "prague"};
+    std::string lower;
+    for (char c : name) lower += static_cast<char>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+    for (size_t i = 0; i < REVISION_COUNT; i++) {
+        if (lower == names[i]) {
+            out = static_cast<Revision>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+/** Names of MessageFrameMemory::state values (MessageFrame.State). */
+inline const char* state_name(uint32_t state) {
+    static const char* names[] = {"NOT_STARTED", "CODE_EXECUTING", "CODE_SUCCESS", "CODE_SUSPENDED",
+                                  "EXCEPTIONAL_HALT", "REVERT", "COMPLETED_FAILED", "COMPLETED_SUCCESS"};
+    return state < 8 ? names[state] : "UNKNOWN";
+}
+
+/** Names of MessageFrameMemory::halt_reason values (ExceptionalHaltReason). */
+inline const char* halt_name(uint32_t reason) {
+    static const char* names[] = {"NONE", "INSUFFICIENT_GAS", "INVALID_OPERATION", "INVALID_JUMP_DESTINATION",
+                                  "STACK_OVERFLOW", "STACK_UNDERFLOW", "ILLEGAL_STATE_CHANGE", "OUT_OF_BOUNDS",
+                                  "CODE_TOO_LARGE", "INVALID_CODE", "PRECOMPILE_ERROR"};
+    return reason < 11 ? names[reason] : "UNKNOWN";
+}
+
+// ===== WITNESS =====
+
+/** Pre-state of one call: accounts with their code, and storage slots. */
+struct Witness {
+    struct Account {
+        uint8_t address[20];
+        uint8_t balance[32];
+        uint64_t nonce;
+        Bytes code;
+    };
+
+    std::vector<Account> accounts;
+    std::vector<StorageEntry> storage;
+
+    Account& account(const uint8_t address[20]) {
+        for (Account& a : accounts) {
+            if (std::memcmp(a.address, address, 20) == 0) return a;
+        }
+        accounts.push_back(Account{});
+        std::memcpy(accounts.back().address, address, 20);
+        return accounts.back();
+    }
+
+    const Account* find(const uint8_t address[20]) const {
+        for (const Account& a : accounts) {
+            if (std::memcmp(a.address, address, 20) == 0) return &a;
+        }
+        return nullptr;
+    }
+
+    void set_storage(const uint8_t address[20], const uint8_t key[32], const uint8_t value[32]) {
+        StorageEntry* entry = storage::find(storage.data(), static_cast<uint32_t>(storage.size()), address, key);
+        if (!entry) {
+            storage.push_back(StorageEntry{});
+            entry = &storage.back();
+            std::memcpy(entry->address, address, 20);
+            std::memcpy(entry->key, key, 32);
+        }
+        std::memcpy(entry->value, value, 32);
+        std::memcpy(entry->original, value, 32);
+    }
+};
+
+/**
+ * Parse a text witness:
+ *
+ *   # comment
+ *   account <address> [balance=<n>] [nonce=<n>] [code=<hex>]
+ *   storage <address> <key> <value>
+ *
+ * Numbers are decimal or 0x hex.
+ * @return false with error set (including the line number) on malformed input
+ */
+inline bool parse_witness_text(const std::string& text, Witness& witness, std::string& error) {
+    size_t line_no = 0, pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find('\n', pos);
+        if (end == std::string::npos) end = text.size();
+        std::string line = text.substr(pos, end - pos);
+        pos = end + 1;
+        line_no++;
+
+        std::vector<std::string> words;
+        size_t i = 0;
+        while (i < line.size() && line[i] != '#') {
+            while (i < line.size() && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r')) i++;
+            size_t start = i;
+            while (i < line.size() && line[i] != ' ' && line[i] != '\t' && line[i] != '\r' && line[i] != '#') i++;
+            if (i > start) words.push_back(line.substr(start, i - start));
+        }
+        if (words.empty()) continue;
+
+        const std::string where = "witness line " + std::to_string(line_no) + ": ";
+        uint8_t address[20];
+        if (words.size() < 2 || !parse_address(words[1], address)) {
+            error = where + "expected '<account|storage> <address> ...'";
+            return false;
+        }
+        if (words[0] == "account") {
+            Witness::Account& account = witness.account(address);
+            for (size_t w = 2; w < words.size(); w++) {
+                size_t eq = words[w].find('=');
+                std::string key = words[w].substr(0, eq);
+                std::string value = eq == std::string::npos ? "" : words[w].substr(eq + 1);
+                uint8_t word[32];
+                bool ok;
+                if (key == "balance") {
+                    ok = parse_u256(value, account.balance);
+                } else if (key == "nonce") {
+                    bool fits = false;
+                    ok = parse_u256(value, word);
+                    account.nonce = word_u64(word, &fits);
+                    ok = ok && fits;
+                } else if (key == "code") {
+                    ok = parse_hex(value, account.code);
+                } else {
+                    ok = false;
+                }
+                if (!ok) {
+                    error = where + "bad account field '" + words[w] + "'";
+                    return false;
+                }
+            }
+        } else if (words[0] == "storage") {
+            uint8_t key[32], value[32];
+            if (words.size() != 4 || !parse_u256(words[2], key) || !parse_u256(words[3], value)) {
+                error = where + "expected 'storage <address> <key> <value>'";
+                return false;
+            }
+            witness.set_storage(address, key, value);
+        } else {
+            error = where + "unknown entry '" + words[0] + "'";
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Lay a witness out as a TransactionWitness (header, accounts, code entries,
+ * storage), all offsets relative to the start of the returned bytes.
+ */
+inline Bytes serialize_witness(const Witness& witness) {
+    auto align = [](uint64_t n) { return (n + 63) / 64 * 64; };
+    const uint64_t accounts_off = align(sizeof(TransactionWitness));
+    uint64_t codes_off = accounts_off + witness.accounts.size() * sizeof(AccountEntry);
+    uint64_t codes_size = 0;
+    uint32_t code_count = 0;
+    for (const Witness::Account& a : witness.accounts) {
+        if (a.code.empty()) continue;
+        codes_size += sizeof(CodeEntry) + (a.code.size() + 7) / 8 * 8;
+        code_count++;
+    }
+    const uint64_t storage_off = align(codes_off + codes_size);
+    Bytes out(storage_off + witness.storage.size() * sizeof(StorageEntry), 0);
+
+    TransactionWitness header = {};
+    header.account_count = header.max_accounts = static_cast<uint32_t>(witness.accounts.size());
+    header.accounts_ptr = accounts_off;
+    header.code_count = code_count;
+    header.codes_ptr = codes_off;
+    header.codes_size = codes_size;
+    header.storage_count = header.max_storage = static_cast<uint32_t>(witness.storage.size());
+    header.storage_ptr = storage_off;
+    std::memcpy(out.data(), &header, sizeof(header));
+
+    uint64_t code_at = codes_off;
+    for (size_t i = 0; i < witness.accounts.size(); i++) {
+        const Witness::Account& a = witness.accounts[i];
+        AccountEntry entry = {};
+        std::memcpy(entry.address, a.address, 20);
+        std::memcpy(entry.balance, a.balance, 32);
+        entry.nonce = a.nonce;
+        keccak::keccak256(a.code.data(), a.code.size(), entry.code_hash);
+        entry.code_size = static_cast<uint32_t>(a.code.size());
+        if (!a.code.empty()) {
+            CodeEntry code = {};
+            std::memcpy(code.address, a.address, 20);
+            code.size = entry.code_size;
+            std::memcpy(out.data() + code_at, &code, sizeof(code));
+            std::memcpy(out.data() + code_at + sizeof(code), a.code.data(), a.code.size());
+            entry.code_offset = code_at + sizeof(code);
+            code_at += sizeof(code) + (a.code.size() + 7) / 8 * 8;
+        }
+        std::memcpy(out.data() + accounts_off + i * sizeof(AccountEntry), &entry, sizeof(entry));
+    }
+    if (!witness.storage.empty()) {
+        std::memcpy(out.data() + storage_off, witness.storage.data(), witness.storage.size() * sizeof(StorageEntry));
+    }
+    return out;
+}
+
+/**
+ * Write a laid out witness (serialize_witness, or a witness file's witness
+ * section) as a witness file with its indexes.
+ * @return false if it is malformed or cannot be written
+ */
+inline bool write_witness_file(const std::string& path, const Bytes& witness, uint64_t block_number = 0) {
+    if (!witness_file::witness_valid(witness.data(), witness.size())) return false;
+    WitnessFileHeader header;
+    std::vector<uint64_t> out((witness_file::layout(witness.data(), witness.size(), block_number, &header) + 7) / 8);
+    witness_file::build(witness.data(), &header, reinterpret_cast<uint8_t*>(out.data()));
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    bool ok = std::fwrite(out.data(), 1, header.file_size, file) == header.file_size;
+    return std::fclose(file) == 0 && ok;
+}
+
+// ===== FRAMES =====
+
+/** Inputs of one message call. */
+struct Call {
+    Bytes code;
+    Bytes input;
+    int64_t gas = 10000000;
+    uint8_t to[20] = {};
+    uint8_t sender[20] = {};
+    uint8_t origin[20] = {};
+    uint8_t coinbase[20] = {};
+    uint8_t value[32] = {};
+    uint8_t gas_price[32] = {};
+    bool is_static = false;
+    Revision revision = LATEST_REVISION;
+};
+
+/**
+ * A checked frame for one call: header, stack, 1 MB of memory (the checked
+ * interpreter's limit), code, input, the flat storage array the interpreter
+ * reads, the serialized witness and an ExecutionResult block.
+ *
+ * Storage starts as the witness' slots; writes add entries up to extra_slots.
+ * reset() restores the initial state, so the same call can be timed repeatedly.
+ */
+class ExecFrame {
+public:
+    static constexpr uint64_t MEMORY_CAPACITY = 1024 * 1024;
+
+    ExecFrame(const Call& call, const Witness& witness, uint32_t extra_slots = 1024)
+        : ExecFrame(call, serialize_witness(witness), witness.storage, extra_slots) {}
+
+    /** A frame over an already laid out TransactionWitness and its storage slots. */
+    ExecFrame(const Call& call, const Bytes& witness_bytes, const std::vector<StorageEntry>& storage,
+              uint32_t extra_slots = 1024)
+        : call_(call), initial_storage_(storage) {
+        max_slots_ = static_cast<uint32_t>(storage.size()) + extra_slots;
+
+        uint64_t at = sizeof(MessageFrameMemory);
+        const uint64_t stack_off = at;
+        at += MAX_STACK_SIZE * STACK_ITEM_SIZE;
+        const uint64_t memory_off = at;
+        at += MEMORY_CAPACITY;
+        const uint64_t code_off = at;
+        at = align(at + call.code.size());
+        const uint64_t input_off = at;
+        at = align(at + call.input.size());
+        const uint64_t storage_off = at;
+        at = align(at + uint64_t(max_slots_) * sizeof(StorageEntry));
+        const uint64_t witness_off = at;
+        at = align(at + witness_bytes.size());
+        const uint64_t result_off = at;
+        at += sizeof(ExecutionResult);
+
+        size_ = align(at, 4096);
+        base_ = static_cast<uint8_t*>(std::aligned_alloc(4096, size_));
+        std::memset(base_, 0, at);
+
+        MessageFrameMemory* f = frame();
+        f->stack_ptr = stack_off;
+        f->memory_ptr = memory_off;
+        f->code_ptr = code_off;
+        f->input_ptr = input_off;
+        f->storage_ptr = storage_off;
+        f->witness_ptr = witness_off;
+        f->result_ptr = result_off;
+        f->code_size = static_cast<uint32_t>(call.code.size());
+        f->input_size = static_cast<uint32_t>(call.input.size());
+        f->max_storage_slots = max_slots_;
+        f->type = 1;  // MESSAGE_CALL
+        f->is_static = call.is_static ? 1 : 0;
+        f->revision = static_cast<uint8_t>(call.revision);
+        std::memcpy(f->recipient, call.to, 20);
+        std::memcpy(f->contract, call.to, 20);
+        std::memcpy(f->sender, call.sender, 20);
+        std::memcpy(f->originator, call.origin, 20);
+        std::memcpy(f->mining_beneficiary, call.coinbase, 20);
+        std::memcpy(f->value, call.value, 32);
+        std::memcpy(f->apparent_value, call.value, 32);
+        std::memcpy(f->gas_price, call.gas_price, 32);
+        if (!call.code.empty()) std::memcpy(base_ + code_off, call.code.data(), call.code.size());
+        if (!call.input.empty()) std::memcpy(base_ + input_off, call.input.data(), call.input.size());
+        if (!witness_bytes.empty()) std::memcpy(base_ + witness_off, witness_bytes.data(), witness_bytes.size());
+        reset();
+    }
+
+    ~ExecFrame() { std::free(base_); }
+
+    ExecFrame(const ExecFrame&) = delete;
+    ExecFrame& operator=(const ExecFrame&) = delete;
+
+    void reset() {
+        MessageFrameMemory* f = frame();
+        f->pc = 0;
+        f->gas_remaining = call_.gas;
+        f->gas_refund = 0;
+        f->stack_size = 0;
+        f->memory_size = 0;  // Memory is zeroed as it grows
+        f->state = 0;
+        f->halt_reason = 0;
+        f->storage_slot_count = static_cast<uint32_t>(initial_storage_.size());
+        if (!initial_storage_.empty()) {
+            std::memcpy(storage(), initial_storage_.data(), initial_storage_.size() * sizeof(StorageEntry));
+        }
+    }
+
+    MessageFrameMemory* frame() { return reinterpret_cast<MessageFrameMemory*>(base_); }
+    const MessageFrameMemory* frame() const { return reinterpret_cast<const MessageFrameMemory*>(base_); }
+
+    const ExecutionResult& result() const {
+        return *reinterpret_cast<const ExecutionResult*>(base_ + frame()->result_ptr);
+    }
+
+    StorageEntry* storage() { return reinterpret_cast<StorageEntry*>(base_ + frame()->storage_ptr); }
+    uint32_t storageCount() const { return frame()->storage_slot_count; }
+
+    /** Stack item index (0 = top). */
+    const uint8_t* stackItem(int index) const {
+        return base_ + frame()->stack_ptr + uint64_t(frame()->stack_size - 1 - index) * STACK_ITEM_SIZE;
+    }
+
+    const uint8_t* memory() const { return base_ + frame()->memory_ptr; }
+    int64_t gasLimit() const { return call_.gas; }
+
+private:
+    static uint64_t align(uint64_t n, uint64_t to = 64) { return (n + to - 1) / to * to; }
+
+    const Call call_;
+    const std::vector<StorageEntry> initial_storage_;
+    uint8_t* base_ = nullptr;
+    uint64_t size_ = 0;
+    uint32_t max_slots_ = 0;
+};
+
+} // namespace tools
+
+} // namespace evm
+} // namespace besu